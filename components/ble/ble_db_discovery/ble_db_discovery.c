@@ -28,21 +28,7 @@ static struct
     ble_db_discovery_evt_handler_t evt_handler;  /**< The event handler of the application module to be called in case there are any events.*/
 } m_registered_handlers[DB_DISCOVERY_MAX_USERS];
 
-/**@brief   Array of structures containing pending events to be sent to the application modules.
- *
- * @details Whenever a discovery related event is to be raised to a user module, it will be stored
- *          in this array first. When all services needed to be discovered have been
- *          discovered, all pending events will be sent to the corresponding user modules.
- **/
-static struct
-{
-    ble_db_discovery_evt_t         evt;          /**< The pending event. */
-    ble_db_discovery_evt_handler_t evt_handler;  /**< The event handler which should be called to raise this event. */
-} m_pending_user_evts[DB_DISCOVERY_MAX_USERS];
-
-static uint32_t m_pending_usr_evt_index;    /**< The index to the pending user event array, pointing to the last added pending user event. */
 static uint32_t m_num_of_handlers_reg;      /**< The number of handlers registered with the DB Discovery module. */
-static uint32_t m_num_of_discoveries_made;  /**< The total number of service discoveries (successful or unsuccessful) made since initialization. */
 static bool     m_initialized = false;      /**< This variable Indicates if the module is initialized or not. */
 
 /**@brief     Function for fetching the event handler provided by a registered application module.
@@ -85,7 +71,7 @@ static uint32_t registered_handler_set(const ble_uuid_t * const       p_srv_uuid
         m_registered_handlers[m_num_of_handlers_reg].evt_handler = p_evt_handler;
 
         m_num_of_handlers_reg++;
-				//printf("m_num_of_handlers_reg=%d\r\n",m_num_of_handlers_reg);
+
         return NRF_SUCCESS;
     }
     else
@@ -95,28 +81,11 @@ static uint32_t registered_handler_set(const ble_uuid_t * const       p_srv_uuid
 }
 
 
-/**@brief Function for sending all pending discovery events to the corresponding user modules.
- */
-static void pending_user_evts_send(void)
-{
-    uint32_t i;
-
-    for (i = 0; i < m_num_of_handlers_reg; i++)
-    {
-        // Pass the event to the corresponding event handler.
-			  //printf("call m_pending_user_evts[%d].evt_handler\r\n",i);
-        m_pending_user_evts[i].evt_handler(&(m_pending_user_evts[i].evt));
-    }
-    
-    m_pending_usr_evt_index = 0;
-}
-
-
 /**@brief     Function for indicating error to the application.
  *
  * @details   This function will fetch the event handler based on the UUID of the service being
  *            discovered. (The event handler is registered by the application beforehand).
- *            The error code is added to the pending events together with the event handler.
+ *            The error code is then provided to the event handler.
  *            If no event handler was found, then this function will do nothing.
  *
  * @param[in] p_db_discovery Pointer to the DB discovery structure.
@@ -126,7 +95,6 @@ static void pending_user_evts_send(void)
 static void discovery_error_evt_trigger(ble_db_discovery_t * const p_db_discovery,
                                         uint32_t                   err_code)
 {
-	//printf("discovery_error_evt_trigger\r\n");
     ble_db_discovery_evt_handler_t p_evt_handler;
     ble_db_discovery_srv_t       * p_srv_being_discovered;
 
@@ -136,29 +104,13 @@ static void discovery_error_evt_trigger(ble_db_discovery_t * const p_db_discover
 
     if (p_evt_handler != NULL)
     {
-        if (m_pending_usr_evt_index < DB_DISCOVERY_MAX_USERS)
-        {
-            // Insert an event into the pending event list.
-            m_pending_user_evts[m_pending_usr_evt_index].evt.conn_handle     =
-                p_db_discovery->conn_handle;
-            m_pending_user_evts[m_pending_usr_evt_index].evt.evt_type        =
-                BLE_DB_DISCOVERY_ERROR;
-            m_pending_user_evts[m_pending_usr_evt_index].evt.params.err_code = err_code;
-            m_pending_user_evts[m_pending_usr_evt_index].evt_handler         = p_evt_handler;
+        ble_db_discovery_evt_t evt;
 
-            m_pending_usr_evt_index++;
+        evt.conn_handle     = p_db_discovery->conn_handle;
+        evt.evt_type        = BLE_DB_DISCOVERY_ERROR;
+        evt.params.err_code = err_code;
 
-            if (m_pending_usr_evt_index == m_num_of_handlers_reg)
-            {
-                // All registered modules have pending events.
-                // Send all pending events to the user modules.
-                pending_user_evts_send();
-            }
-        }
-        else
-        {
-            // Too many events pending. Do nothing. (Ideally this should not happen.)
-        }
+        p_evt_handler(&evt);
     }
 }
 
@@ -169,6 +121,8 @@ static void discovery_error_evt_trigger(ble_db_discovery_t * const p_db_discover
  * @details   This function will fetch the event handler based on the UUID of the service being
  *            discovered. (The event handler is registered by the application beforehand).
  *            It then triggers an event indicating the completion of the service discovery.
+ *            The event is sent as soon as the service is done, so the user module can use the
+ *            service while the next ones are being discovered.
  *            If no event handler was found, then this function will do nothing.
  *
  * @param[in] p_db_discovery Pointer to the DB discovery structure.
@@ -182,47 +136,89 @@ static void discovery_complete_evt_trigger(ble_db_discovery_t * const p_db_disco
 
     p_srv_being_discovered = &(p_db_discovery->services[p_db_discovery->curr_srv_ind]);
 
+    // The database is updated before the event is sent, so that the users can get the cache
+    // from their event handlers.
+    p_db_discovery->srv_count = p_db_discovery->curr_srv_ind + 1;
+
+    if (p_db_discovery->srv_count == m_num_of_handlers_reg)
+    {
+        p_db_discovery->discovery_in_progress = false;
+    }
+
     p_evt_handler = registered_handler_get(&(p_srv_being_discovered->srv_uuid));
-	  if (p_evt_handler != NULL)
+
+    if (p_evt_handler != NULL)
     {
-			
-	      if (m_pending_usr_evt_index < DB_DISCOVERY_MAX_USERS)
+        ble_db_discovery_evt_t evt;
+
+        evt.conn_handle = p_db_discovery->conn_handle;
+
+        if (is_srv_found)
+        {
+            evt.evt_type             = BLE_DB_DISCOVERY_COMPLETE;
+            evt.params.discovered_db = *p_srv_being_discovered;
+        }
+        else
         {
-            // Insert an event into the pending event list.
-            m_pending_user_evts[m_pending_usr_evt_index].evt.conn_handle =
-                p_db_discovery->conn_handle;
+            evt.evt_type = BLE_DB_DISCOVERY_SRV_NOT_FOUND;
+        }
 
-            if (is_srv_found)
-            {
-							
-                m_pending_user_evts[m_pending_usr_evt_index].evt.evt_type =
-                    BLE_DB_DISCOVERY_COMPLETE;
+        p_evt_handler(&evt);
+    }
+}
 
-                m_pending_user_evts[m_pending_usr_evt_index].evt.params.discovered_db =
-                    *p_srv_being_discovered;
-            }
-            else
-            {
-                m_pending_user_evts[m_pending_usr_evt_index].evt.evt_type =
-                    BLE_DB_DISCOVERY_SRV_NOT_FOUND;
-            }
-            m_pending_user_evts[m_pending_usr_evt_index].evt_handler = p_evt_handler;
 
-            m_pending_usr_evt_index++;
+/**@brief     Function for starting the discovery of the current service.
+ *
+ * @details   The SoftDevice performs one GATT Client procedure at a time on a connection. If a user
+ *            module started a procedure, for example from the event of the previous service, the
+ *            discovery is marked pending and started again on the next GATT Client event or
+ *            TX complete event of the connection.
+ *
+ * @param[in] p_db_discovery Pointer to the DB Discovery structure.
+ *
+ * @return    NRF_SUCCESS if the discovery was started or is pending. Otherwise an error code
+ *            returned by the SoftDevice API @ref sd_ble_gattc_primary_services_discover.
+ */
+static uint32_t srv_discovery_start(ble_db_discovery_t * const p_db_discovery)
+{
+    ble_db_discovery_srv_t * p_srv_being_discovered;
+    uint32_t                 err_code;
+
+    p_srv_being_discovered = &(p_db_discovery->services[p_db_discovery->curr_srv_ind]);
 
-            if (m_pending_usr_evt_index == m_num_of_handlers_reg)
-            {
-                // All registered modules have pending events. Send all pending events to the user
-                // modules.
-                pending_user_evts_send();
-            }
-            else
-            {
-							//printf("m_pending_usr_evt_index=%d,but > %d \r\n",m_pending_usr_evt_index, m_num_of_handlers_reg);
-							//pending_user_evts_send();
-                // Too many events pending. Do nothing. (Ideally this should not happen.)
-            }
-        }
+    err_code = sd_ble_gattc_primary_services_discover(p_db_discovery->conn_handle,
+                                                      SRV_DISC_START_HANDLE,
+                                                      &(p_srv_being_discovered->srv_uuid));
+
+    if (err_code == NRF_ERROR_BUSY)
+    {
+        p_db_discovery->discovery_pending = true;
+
+        return NRF_SUCCESS;
+    }
+
+    p_db_discovery->discovery_pending = false;
+
+    return err_code;
+}
+
+
+/**@brief     Function for starting again a discovery marked pending.
+ *
+ * @details   Called when the GATT procedure which delayed the discovery may have ended.
+ *
+ * @param[in] p_db_discovery Pointer to the DB Discovery structure.
+ */
+static void pending_discovery_restart(ble_db_discovery_t * const p_db_discovery)
+{
+    uint32_t err_code = srv_discovery_start(p_db_discovery);
+
+    if (err_code != NRF_SUCCESS)
+    {
+        p_db_discovery->discovery_in_progress = false;
+
+        discovery_error_evt_trigger(p_db_discovery, err_code);
     }
 }
 
@@ -236,10 +232,8 @@ static void discovery_complete_evt_trigger(ble_db_discovery_t * const p_db_disco
  */
 static void on_srv_disc_completion(ble_db_discovery_t * p_db_discovery)
 {
-    m_num_of_discoveries_made++;
-
     // Check if more services need to be discovered.
-    if (m_num_of_discoveries_made < m_num_of_handlers_reg)
+    if ((p_db_discovery->curr_srv_ind + 1) < m_num_of_handlers_reg)
     {
         // Reset the current characteristic index since a new service discovery is about to start.
         p_db_discovery->curr_char_ind = 0;
@@ -258,19 +252,13 @@ static void on_srv_disc_completion(ble_db_discovery_t * p_db_discovery)
         // discovery is about to start.
         p_srv_being_discovered->char_count = 0;
 
-        //DB_LOG("[DB]: Starting discovery of service with UUID 0x%x for Connection handle %d\r\n",
-        //       p_srv_being_discovered->srv_uuid.uuid, p_db_discovery->conn_handle);
-				//printf("[DB]: Starting discovery of service with UUID 0x%x for Connection handle %d\r\n",
-        //       p_srv_being_discovered->srv_uuid.uuid, p_db_discovery->conn_handle);
-				
+        DB_LOG("[DB]: Starting discovery of service with UUID 0x%x for Connection handle %d\r\n",
+               p_srv_being_discovered->srv_uuid.uuid, p_db_discovery->conn_handle);
+
         uint32_t err_code;
 
-        err_code = sd_ble_gattc_primary_services_discover
-                   (
-                   p_db_discovery->conn_handle,
-                   SRV_DISC_START_HANDLE,
-                   &(p_srv_being_discovered->srv_uuid)
-                   );
+        err_code = srv_discovery_start(p_db_discovery);
+
         if (err_code != NRF_SUCCESS)
         {
             p_db_discovery->discovery_in_progress = false;
@@ -557,6 +545,15 @@ static void on_primary_srv_discovery_rsp(ble_db_discovery_t * const    p_db_disc
     }
     else
     {
+        ble_db_discovery_srv_t * p_srv_being_discovered;
+
+        p_srv_being_discovered = &(p_db_discovery->services[p_db_discovery->curr_srv_ind]);
+
+        // Mark the service as not found, so that the cache tells it apart from a found service.
+        p_srv_being_discovered->char_count                = 0;
+        p_srv_being_discovered->handle_range.start_handle = BLE_GATT_HANDLE_INVALID;
+        p_srv_being_discovered->handle_range.end_handle   = BLE_GATT_HANDLE_INVALID;
+
         // Trigger Service Not Found event to the application.
         discovery_complete_evt_trigger(p_db_discovery, false);
 
@@ -689,45 +686,6 @@ static void on_characteristic_discovery_rsp(ble_db_discovery_t * const    p_db_d
     }
 }
 
-//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-#include "ble_hrs_c.h"
-#include "ble_bp_c.h"
-extern void hrs_c_evt_handler(ble_hrs_c_t * p_hrs_c, ble_hrs_c_evt_t * p_hrs_c_evt);
-extern void bp_c_evt_handler(ble_bp_c_t * p_bp_c, ble_bp_c_evt_t * p_bp_c_evt);
-ble_bp_c_t neotmp;
-ble_bp_c_evt_t neoevt;	 
-static void neo_discovery_complete_evt_trigger()
-{
-	bp_log("neo_discovery_complete_evt_trigger\r\n");
-	/*
-	 ble_hrs_c_t tmp;
-	 tmp.conn_handle = 0x0;
-	 tmp.hrm_cccd_handle = 0x47;
-	 tmp.evt_handler = hrs_c_evt_handler;
-	 tmp.hrm_handle = 0x46;
-	 ble_hrs_c_evt_t evt;
-   evt.evt_type = BLE_HRS_C_EVT_DISCOVERY_COMPLETE;
-	
-	hrs_c_evt_handler(&tmp, &evt);
-	*/
-
-  // ble_bp_c_t tmp;
-	 neotmp.conn_handle = BLE_BP_CONN_HANDLE;
-	 neotmp.bp_CUFF_cccd_handle = BLE_CUFF_CCCD_HANDLE;
-	 neotmp.evt_handler = bp_c_evt_handler;
-	 neotmp.bp_CUFF_handle = BLE_CUFF_HANDLE;
-	 neotmp.bp_MEA_cccd_handle = BLE_BP_MEASUREMENT_CCCD_HANDLE;
-	 neotmp.bp_MEA_handle = BLE_BP_MEASUREMENT_HANDLE;
-   neoevt.evt_type = BLE_BP_C_EVT_DISCOVERY_COMPLETE;
-	 //ble_bp_c_evt_t evt;
-	bp_c_evt_handler(&neotmp, &neoevt);
-	
-   //mp_ble_hrs_c->evt_handler(mp_ble_hrs_c, &evt);
-}
-//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-bool is_BLE_GATTC_EVT_PRIM_SRVC_DISC_RSP_done = 1;
-bool is_BLE_GATTC_EVT_CHAR_DISC_RSP_done = 1;
-bool is_BLE_GATTC_EVT_DESC_DISC_RSP_done = 1;
 
 /**@brief     Function for handling descriptor discovery response.
  *
@@ -763,7 +721,6 @@ static void on_descriptor_discovery_rsp(ble_db_discovery_t * const    p_db_disco
                )
             {
                 p_char_being_discovered->cccd_handle = p_desc_disc_rsp_evt->descs[i].handle;
-							  bp_log("[DB] p_char_being_discovered->cccd_handle=0x%x\r\n", p_char_being_discovered->cccd_handle);
 
                 break;
             }
@@ -802,26 +759,13 @@ static void on_descriptor_discovery_rsp(ble_db_discovery_t * const    p_db_disco
 
     if (raise_discov_complete)
     {
-			/*
-			 is_BLE_GATTC_EVT_PRIM_SRVC_DISC_RSP_done = 0;
-       is_BLE_GATTC_EVT_CHAR_DISC_RSP_done = 0;
-       is_BLE_GATTC_EVT_DESC_DISC_RSP_done = 0;
-*/
         DB_LOG("[DB]: Discovery of service with UUID 0x%x completed with success for Connection"
                "handle %d\r\n", p_srv_being_discovered->srv_uuid.uuid,
                p_db_discovery->conn_handle);
- bp_log("[DB]: Discovery of service with UUID 0x%x completed with success for Connection"
-               "handle %d\r\n", p_srv_being_discovered->srv_uuid.uuid,
-               p_db_discovery->conn_handle);
-			  neo_discovery_complete_evt_trigger();
-       // discovery_complete_evt_trigger(p_db_discovery, true);
-       
+
+        discovery_complete_evt_trigger(p_db_discovery, true);
+
         on_srv_disc_completion(p_db_discovery);
-			
-			//
-			
-			
-			//
     }
 }
 
@@ -830,8 +774,6 @@ uint32_t ble_db_discovery_init(void)
 {
     m_num_of_handlers_reg      = 0;
     m_initialized              = true;
-    m_num_of_discoveries_made  = 0;
-    m_pending_usr_evt_index    = 0;
 
     return NRF_SUCCESS;
 }
@@ -841,8 +783,6 @@ uint32_t ble_db_discovery_close()
 {
     m_num_of_handlers_reg      = 0;
     m_initialized              = false;
-    m_num_of_discoveries_made  = 0;
-    m_pending_usr_evt_index    = 0;
 
     return NRF_SUCCESS;
 }
@@ -897,25 +837,23 @@ uint32_t ble_db_discovery_start(ble_db_discovery_t * const p_db_discovery,
 
     ble_db_discovery_srv_t * p_srv_being_discovered;
 
-    m_num_of_discoveries_made = 0;
-    m_pending_usr_evt_index   = 0;
-
-    p_db_discovery->curr_srv_ind = 0;
-    p_db_discovery->conn_handle  = conn_handle;
+    p_db_discovery->curr_srv_ind  = 0;
+    p_db_discovery->curr_char_ind = 0;
+    p_db_discovery->srv_count     = 0;
+    p_db_discovery->conn_handle   = conn_handle;
 
     p_srv_being_discovered = &(p_db_discovery->services[p_db_discovery->curr_srv_ind]);
 
-    p_srv_being_discovered->srv_uuid = m_registered_handlers[p_db_discovery->curr_srv_ind].srv_uuid;
-    
+    p_srv_being_discovered->srv_uuid   = m_registered_handlers[p_db_discovery->curr_srv_ind].srv_uuid;
+    p_srv_being_discovered->char_count = 0;
+
     DB_LOG("[DB]: Starting discovery of service with UUID 0x%x for Connection handle %d\r\n",
            p_srv_being_discovered->srv_uuid.uuid, p_db_discovery->conn_handle);
     
     uint32_t err_code;
 
-    err_code = sd_ble_gattc_primary_services_discover(p_db_discovery->conn_handle,
-                                                      SRV_DISC_START_HANDLE,
-                                                      &(p_srv_being_discovered->srv_uuid));
-		//printf("call sd_ble_gattc_primary_services_discover,p_db_discovery->conn_handle=0x%x, error=0x%x\r\n",p_db_discovery->conn_handle,err_code);																									
+    err_code = srv_discovery_start(p_db_discovery);
+
     if (err_code != NRF_SUCCESS)
     {
         return err_code;
@@ -926,6 +864,115 @@ uint32_t ble_db_discovery_start(ble_db_discovery_t * const p_db_discovery,
 }
 
 
+/**@brief     Function for checking if a cache holds the services registered to this module.
+ *
+ * @param[in] p_cache Pointer to the cache.
+ *
+ * @retval    True if the cache can be used instead of a discovery.
+ * @retval    False if a discovery is needed.
+ */
+static bool is_cache_valid(const ble_db_discovery_cache_t * const p_cache)
+{
+    uint32_t i;
+
+    if (p_cache->srv_count != m_num_of_handlers_reg)
+    {
+        return false;
+    }
+
+    for (i = 0; i < m_num_of_handlers_reg; i++)
+    {
+        if (!BLE_UUID_EQ(&(p_cache->services[i].srv_uuid), &(m_registered_handlers[i].srv_uuid)) ||
+            (p_cache->services[i].char_count > BLE_DB_DISCOVERY_MAX_CHAR_PER_SRV))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+uint32_t ble_db_discovery_start_cached(ble_db_discovery_t * const             p_db_discovery,
+                                       uint16_t                               conn_handle,
+                                       const ble_db_discovery_cache_t * const p_cache)
+{
+    if ((p_db_discovery == NULL) || (p_cache == NULL))
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if (!m_initialized)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if (m_num_of_handlers_reg == 0)
+    {
+        // No user modules were registered. There are no services to discover.
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if (p_db_discovery->discovery_in_progress)
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    if (!is_cache_valid(p_cache))
+    {
+        DB_LOG("[DB]: Cache does not match the registered services, starting discovery for "
+               "Connection handle %d\r\n", conn_handle);
+
+        return ble_db_discovery_start(p_db_discovery, conn_handle);
+    }
+
+    DB_LOG("[DB]: Using cached database for Connection handle %d\r\n", conn_handle);
+
+    memcpy(p_db_discovery->services, p_cache->services, sizeof(p_db_discovery->services));
+
+    p_db_discovery->srv_count     = 0;
+    p_db_discovery->curr_char_ind = 0;
+    p_db_discovery->conn_handle   = conn_handle;
+
+    // Raise the event of each service as if it had just been discovered.
+    for (p_db_discovery->curr_srv_ind = 0;
+         p_db_discovery->curr_srv_ind < m_num_of_handlers_reg;
+         p_db_discovery->curr_srv_ind++)
+    {
+        discovery_complete_evt_trigger(
+            p_db_discovery,
+            (p_cache->services[p_db_discovery->curr_srv_ind].handle_range.start_handle !=
+             BLE_GATT_HANDLE_INVALID));
+    }
+
+    p_db_discovery->curr_srv_ind = 0;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ble_db_discovery_cache_get(const ble_db_discovery_t * const p_db_discovery,
+                                    ble_db_discovery_cache_t * const p_cache)
+{
+    if ((p_db_discovery == NULL) || (p_cache == NULL))
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if ((m_num_of_handlers_reg == 0)                             ||
+        (p_db_discovery->srv_count != m_num_of_handlers_reg)     ||
+        p_db_discovery->discovery_in_progress)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    p_cache->srv_count = p_db_discovery->srv_count;
+    memcpy(p_cache->services, p_db_discovery->services, sizeof(p_cache->services));
+
+    return NRF_SUCCESS;
+}
+
+
 void ble_db_discovery_on_ble_evt(ble_db_discovery_t * const p_db_discovery,
                                  const ble_evt_t * const    p_ble_evt)
 {
@@ -939,42 +986,54 @@ void ble_db_discovery_on_ble_evt(ble_db_discovery_t * const p_db_discovery,
     {
         return;
     }
-    //printf("p_ble_evt->header.evt_id=0x%x\r\n",p_ble_evt->header.evt_id);
+    if ((p_ble_evt->header.evt_id >= BLE_GATTC_EVT_BASE) &&
+        (p_ble_evt->header.evt_id <= BLE_GATTC_EVT_LAST))
+    {
+        if (!p_db_discovery->discovery_in_progress ||
+            (p_ble_evt->evt.gattc_evt.conn_handle != p_db_discovery->conn_handle))
+        {
+            // The event is not for a discovery of this instance.
+            return;
+        }
+
+        if (p_db_discovery->discovery_pending)
+        {
+            // The GATT procedure which delayed the discovery has ended. Try again.
+            pending_discovery_restart(p_db_discovery);
+            return;
+        }
+    }
+
     switch (p_ble_evt->header.evt_id)
     {
-        case BLE_GAP_EVT_CONNECTED:
-					 //printf("BLE_GAP_EVT_CONNECTED\r\n");
-            p_db_discovery->conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
+        case BLE_EVT_TX_COMPLETE:
+            if (p_db_discovery->discovery_in_progress &&
+                p_db_discovery->discovery_pending &&
+                (p_ble_evt->evt.common_evt.conn_handle == p_db_discovery->conn_handle))
+            {
+                // A write without response which delayed the discovery has been sent. Try again.
+                pending_discovery_restart(p_db_discovery);
+            }
             break;
-        
+
         case BLE_GAP_EVT_DISCONNECTED:
-					 //printf("BLE_GAP_EVT_DISCONNECTED\r\n");
-            memset(p_db_discovery, 0, sizeof(ble_db_discovery_t));
-            p_db_discovery->conn_handle = BLE_CONN_HANDLE_INVALID;
+            if (p_ble_evt->evt.gap_evt.conn_handle == p_db_discovery->conn_handle)
+            {
+                memset(p_db_discovery, 0, sizeof(ble_db_discovery_t));
+                p_db_discovery->conn_handle = BLE_CONN_HANDLE_INVALID;
+            }
             break;
 
         case BLE_GATTC_EVT_PRIM_SRVC_DISC_RSP:
-					  bp_log("BLE_GATTC_EVT_PRIM_SRVC_DISC_RSP\r\n");
-				    if (is_BLE_GATTC_EVT_PRIM_SRVC_DISC_RSP_done){
             on_primary_srv_discovery_rsp(p_db_discovery, &(p_ble_evt->evt.gattc_evt));
-							//is_BLE_GATTC_EVT_PRIM_SRVC_DISC_RSP_done = 0;
-						}
             break;
 
         case BLE_GATTC_EVT_CHAR_DISC_RSP:
-					 bp_log("BLE_GATTC_EVT_CHAR_DISC_RSP\r\n");
-				  if (is_BLE_GATTC_EVT_CHAR_DISC_RSP_done){
             on_characteristic_discovery_rsp(p_db_discovery, &(p_ble_evt->evt.gattc_evt));
-						//is_BLE_GATTC_EVT_CHAR_DISC_RSP_done = 0;
-					}
             break;
 
         case BLE_GATTC_EVT_DESC_DISC_RSP:
-					bp_log("BLE_GATTC_EVT_DESC_DISC_RSP\r\n");
-				  if (is_BLE_GATTC_EVT_DESC_DISC_RSP_done){
             on_descriptor_discovery_rsp(p_db_discovery, &(p_ble_evt->evt.gattc_evt));
-						//is_BLE_GATTC_EVT_DESC_DISC_RSP_done = 0;
-					}
             break;
 
         default:
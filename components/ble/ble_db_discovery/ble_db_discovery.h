@@ -20,7 +20,11 @@
  * @details  This module contains the APIs and types exposed by the DB Discovery module. These APIs
  *           and types can be used by the application to perform discovery of a service and its
  *           characteristics at the peer server. This module can also be used to discover the 
- *           desired services in multiple remote devices.
+ *           desired services in multiple remote devices, concurrently, with one instance of
+ *           @ref ble_db_discovery_t per connection.
+ *           The event of each service is sent as soon as the service is discovered. If the user
+ *           module then starts a GATT procedure, the discovery of the next service is resumed when
+ *           that procedure is complete.
  *           A typical use of this library is described in the figure below.
  *           @image html db_discovery.jpg
  *
@@ -53,8 +57,13 @@
  * @{
  */
 
-#define BLE_DB_DISCOVERY_MAX_SRV          2  /**< Maximum number of services supported by this module. This also indicates the maximum number of users allowed to be registered to this module. (one user per service). */
-#define BLE_DB_DISCOVERY_MAX_CHAR_PER_SRV 3  /**< Maximum number of characteristics per service supported by this module. */
+#ifndef BLE_DB_DISCOVERY_MAX_SRV
+#define BLE_DB_DISCOVERY_MAX_SRV          2  /**< Maximum number of services supported by this module. This also indicates the maximum number of users allowed to be registered to this module. (one user per service). Can be set by the application in the project settings. */
+#endif
+
+#ifndef BLE_DB_DISCOVERY_MAX_CHAR_PER_SRV
+#define BLE_DB_DISCOVERY_MAX_CHAR_PER_SRV 3  /**< Maximum number of characteristics per service supported by this module. Can be set by the application in the project settings. */
+#endif
 
 /** @} */
 
@@ -110,13 +119,28 @@ typedef struct
 {
     ble_db_discovery_srv_t services[BLE_DB_DISCOVERY_MAX_SRV];  /**< Information related to the current service being discovered. This is intended for internal use during service discovery.*/
     uint16_t               conn_handle;                         /**< Connection handle as provided by the SoftDevice. */
-    uint8_t                srv_count;                           /**< Number of services at the peers GATT database.*/
+    uint8_t                srv_count;                           /**< Number of registered services for which discovery is complete.*/
     uint8_t                curr_char_ind;                       /**< Index of the current characteristic being discovered. This is intended for internal use during service discovery.*/
     uint8_t                curr_srv_ind;                        /**< Index of the current service being discovered. This is intended for internal use during service discovery.*/
     bool                   discovery_in_progress;               /**< Variable to indicate if there is a service discovery in progress. */
+    bool                   discovery_pending;                   /**< Variable to indicate that the discovery of the current service waits for a GATT procedure of a user module to complete. This is intended for internal use during service discovery.*/
 } ble_db_discovery_t;
 
 
+/**@brief   Structure for holding the GATT database found at a peer, so that it can be used on a
+ *          later connection instead of a new discovery.
+ *
+ * @details The cache of a bonded peer can be stored in its GATT Client context in the Device
+ *          Manager. It is valid as long as the same services are registered to this module and the
+ *          peer does not change its GATT database.
+ */
+typedef struct
+{
+    uint32_t               srv_count;                           /**< Number of services in the cache. */
+    ble_db_discovery_srv_t services[BLE_DB_DISCOVERY_MAX_SRV];  /**< Services, in the order they were registered. The handle range of a service not found at the peer is invalid. */
+} ble_db_discovery_cache_t;
+
+
 /**@brief   Structure containing the event from the DB discovery module to the application.
  */
 typedef struct
@@ -218,7 +242,49 @@ uint32_t ble_db_discovery_evt_register(const ble_uuid_t * const             p_uu
 uint32_t ble_db_discovery_start(ble_db_discovery_t * const p_db_discovery,
                                 uint16_t                   conn_handle);
 
-                                
+
+/**@brief Function for starting the discovery of the GATT database at the server from a cache.
+ *
+ * @details If the cache matches the registered services, the events of a completed discovery are
+ *          sent to the registered modules before this function returns, and no GATT procedure is
+ *          performed. Otherwise, a discovery is started as by @ref ble_db_discovery_start.
+ *
+ * @note    The cache of a peer must be discarded if the peer indicates that its services changed.
+ *
+ * @param[out] p_db_discovery    Pointer to the DB Discovery structure.
+ * @param[in]  conn_handle       The handle of the connection for which the discovery should be
+ *                               started.
+ * @param[in]  p_cache           Cache obtained with @ref ble_db_discovery_cache_get on an earlier
+ *                               connection to the same peer.
+ *
+ * @retval    NRF_SUCCESS               Operation success.
+ * @retval    NRF_ERROR_NULL            When a NULL pointer is passed as input.
+ * @retval    NRF_ERROR_INVALID_STATE   If this function is called without calling the
+ *                                      @ref ble_db_discovery_init, or without calling
+ *                                      @ref ble_db_discovery_evt_register.
+ * @retval    NRF_ERROR_BUSY            If a discovery is already in progress for the current
+ *                                      connection.
+ *
+ * @return                              This API propagates the error code returned by the
+ *                                      SoftDevice API @ref sd_ble_gattc_primary_services_discover.
+ */
+uint32_t ble_db_discovery_start_cached(ble_db_discovery_t * const             p_db_discovery,
+                                       uint16_t                               conn_handle,
+                                       const ble_db_discovery_cache_t * const p_cache);
+
+
+/**@brief Function for getting the GATT database found at the server, to be cached.
+ *
+ * @param[in]  p_db_discovery    Pointer to the DB Discovery structure.
+ * @param[out] p_cache           Cache of the GATT database.
+ *
+ * @retval    NRF_SUCCESS               Operation success.
+ * @retval    NRF_ERROR_NULL            When a NULL pointer is passed as input.
+ * @retval    NRF_ERROR_INVALID_STATE   If the discovery of all registered services is not complete.
+ */
+uint32_t ble_db_discovery_cache_get(const ble_db_discovery_t * const p_db_discovery,
+                                    ble_db_discovery_cache_t * const p_cache);
+
 /**@brief Function for handling the Application's BLE Stack events.
  *
  * @param[in,out] p_db_discovery Pointer to the DB Discovery structure.
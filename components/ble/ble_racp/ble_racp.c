@@ -11,6 +11,7 @@
  
 #include "ble_racp.h"
 #include <stdlib.h>
+#include <string.h>
 
 
 void ble_racp_decode(uint8_t data_len, uint8_t * p_data, ble_racp_value_t * p_racp_val)
@@ -54,3 +55,562 @@ uint8_t ble_racp_encode(const ble_racp_value_t * p_racp_val, uint8_t * p_data)
 
     return len;
 }
+
+
+/**@brief Function for reporting an error to the service.
+ *
+ * @param[in] p_engine  Engine structure.
+ * @param[in] err_code  Error code.
+ */
+static void engine_error_report(ble_racp_engine_t * p_engine, uint32_t err_code)
+{
+    if (p_engine->error_handler != NULL)
+    {
+        p_engine->error_handler(err_code);
+    }
+}
+
+
+/**@brief Function for sending a response from the Record Access Control Point.
+ *
+ * @details The response waits for the next TX_COMPLETE event if records have been reported since
+ *          the previous one, so that it is not sent ahead of them.
+ *
+ * @param[in] p_engine  Engine structure.
+ */
+static void engine_response_send(ble_racp_engine_t * p_engine)
+{
+    uint32_t               err_code;
+    uint8_t                encoded_resp[25];
+    uint8_t                len;
+    uint16_t               hvx_len;
+    ble_gatts_hvx_params_t hvx_params;
+
+    if (
+        (p_engine->state != BLE_RACP_ENGINE_STATE_RESPONSE_PENDING)
+        &&
+        (p_engine->proc_records_reported_since_txcomplete > 0)
+       )
+    {
+        p_engine->state = BLE_RACP_ENGINE_STATE_RESPONSE_PENDING;
+        return;
+    }
+
+    // Send indication
+    len     = ble_racp_encode(&p_engine->pending_response, encoded_resp);
+    hvx_len = len;
+
+    memset(&hvx_params, 0, sizeof(hvx_params));
+
+    hvx_params.handle = p_engine->racp_value_handle;
+    hvx_params.type   = BLE_GATT_HVX_INDICATION;
+    hvx_params.offset = 0;
+    hvx_params.p_len  = &hvx_len;
+    hvx_params.p_data = encoded_resp;
+
+    err_code = sd_ble_gatts_hvx(p_engine->conn_handle, &hvx_params);
+
+    // Error handling
+    if ((err_code == NRF_SUCCESS) && (hvx_len != len))
+    {
+        err_code = NRF_ERROR_DATA_SIZE;
+    }
+    switch (err_code)
+    {
+        case NRF_SUCCESS:
+            // Wait for HVC event
+            p_engine->state = BLE_RACP_ENGINE_STATE_RESPONSE_IND_VERIF;
+            break;
+
+        case BLE_ERROR_NO_TX_BUFFERS:
+            // Wait for TX_COMPLETE event to retry transmission
+            p_engine->state = BLE_RACP_ENGINE_STATE_RESPONSE_PENDING;
+            break;
+
+        case NRF_ERROR_INVALID_STATE:
+            // Make sure state machine returns to the default state
+            p_engine->state = BLE_RACP_ENGINE_STATE_NO_COMM;
+            break;
+
+        default:
+            engine_error_report(p_engine, err_code);
+
+            // Make sure state machine returns to the default state
+            p_engine->state = BLE_RACP_ENGINE_STATE_NO_COMM;
+            break;
+    }
+}
+
+
+/**@brief Function for sending a RACP response containing a Response Code Op Code and a Response
+ *        Code Value.
+ *
+ * @param[in] p_engine  Engine structure.
+ * @param[in] opcode    RACP Op Code.
+ * @param[in] value     RACP Response Code Value.
+ */
+static void engine_response_code_send(ble_racp_engine_t * p_engine, uint8_t opcode, uint8_t value)
+{
+    p_engine->pending_response.opcode      = RACP_OPCODE_RESPONSE_CODE;
+    p_engine->pending_response.operator    = RACP_OPERATOR_NULL;
+    p_engine->pending_response.operand_len = 2;
+    p_engine->pending_response.p_operand   = p_engine->pending_response_operand;
+
+    p_engine->pending_response_operand[0] = opcode;
+    p_engine->pending_response_operand[1] = value;
+
+    engine_response_send(p_engine);
+}
+
+
+/**@brief Function for checking the filter of a request using a LESS_OR_EQUAL, GREATER_OR_EQUAL or
+ *        RANGE operator.
+ *
+ * @param[in] p_engine   Engine structure.
+ * @param[in] p_request  Request to be checked.
+ *
+ * @return RACP_RESPONSE_RESERVED if the filter is valid, otherwise the response code to be
+ *         returned to the central.
+ */
+static uint8_t engine_filter_check(ble_racp_engine_t * p_engine, const ble_racp_value_t * p_request)
+{
+    uint8_t value_len;
+    uint8_t value_count = (p_request->operator == RACP_OPERATOR_RANGE) ? 2 : 1;
+
+    if (p_request->operand_len == 0)
+    {
+        return RACP_RESPONSE_INVALID_OPERAND;
+    }
+
+    value_len = p_engine->p_backend->filter_value_len_get(p_request->p_operand[0]);
+    if (value_len == 0)
+    {
+        if ((p_request->p_operand[0] == RACP_FILTER_TYPE_SEQ_NUM)     ||
+            (p_request->p_operand[0] == RACP_FILTER_TYPE_FACING_TIME) ||
+            (p_request->p_operand[0] >= RACP_FILTER_TYPE_RFU_START))
+        {
+            return RACP_RESPONSE_OPERAND_UNSUPPORTED;
+        }
+        return RACP_RESPONSE_INVALID_OPERAND;
+    }
+
+    if (p_request->operand_len != (1 + (value_count * value_len)))
+    {
+        return RACP_RESPONSE_INVALID_OPERAND;
+    }
+
+    if ((p_request->operator == RACP_OPERATOR_RANGE) &&
+        (p_engine->p_backend->filter_range_is_valid != NULL) &&
+        !p_engine->p_backend->filter_range_is_valid(p_request->p_operand[0],
+                                                    &p_request->p_operand[1],
+                                                    &p_request->p_operand[1 + value_len]))
+    {
+        return RACP_RESPONSE_INVALID_OPERAND;
+    }
+
+    return RACP_RESPONSE_RESERVED;
+}
+
+
+/**@brief Function for getting the range of positions matching a request.
+ *
+ * @details The records matching a filter are found by the backend (by binary search), so that the
+ *          request is executed without reading every record of the store.
+ *
+ * @param[in]  p_engine     Engine structure.
+ * @param[in]  p_request    Request to be executed.
+ * @param[out] p_first_pos  First position matching the request.
+ * @param[out] p_end_pos    Position following the last position matching the request.
+ */
+static void engine_request_range_get(ble_racp_engine_t      * p_engine,
+                                     const ble_racp_value_t * p_request,
+                                     uint16_t               * p_first_pos,
+                                     uint16_t               * p_end_pos)
+{
+    ble_racp_backend_t const * p_backend   = p_engine->p_backend;
+    uint16_t                   pos_count   = p_backend->pos_count_get();
+    uint8_t                    filter_type = 0;
+    uint8_t                    value_len   = 0;
+
+    if (p_request->operand_len > 0)
+    {
+        filter_type = p_request->p_operand[0];
+        value_len   = p_backend->filter_value_len_get(filter_type);
+    }
+
+    *p_first_pos = 0;
+    *p_end_pos   = pos_count;
+
+    switch (p_request->operator)
+    {
+        case RACP_OPERATOR_FIRST:
+            while ((*p_first_pos < pos_count) &&
+                   (p_backend->num_records_in_range_get(*p_first_pos, *p_first_pos + 1) == 0))
+            {
+                (*p_first_pos)++;
+            }
+            *p_end_pos = (*p_first_pos < pos_count) ? (*p_first_pos + 1) : pos_count;
+            break;
+
+        case RACP_OPERATOR_LAST:
+            while ((*p_end_pos > 0) &&
+                   (p_backend->num_records_in_range_get(*p_end_pos - 1, *p_end_pos) == 0))
+            {
+                (*p_end_pos)--;
+            }
+            *p_first_pos = (*p_end_pos > 0) ? (*p_end_pos - 1) : 0;
+            break;
+
+        case RACP_OPERATOR_LESS_OR_EQUAL:
+            *p_end_pos = p_backend->filter_pos_find(filter_type, &p_request->p_operand[1], true);
+            break;
+
+        case RACP_OPERATOR_GREATER_OR_EQUAL:
+            *p_first_pos = p_backend->filter_pos_find(filter_type, &p_request->p_operand[1], false);
+            break;
+
+        case RACP_OPERATOR_RANGE:
+            *p_first_pos = p_backend->filter_pos_find(filter_type, &p_request->p_operand[1], false);
+            *p_end_pos   = p_backend->filter_pos_find(filter_type,
+                                                      &p_request->p_operand[1 + value_len],
+                                                      true);
+            break;
+
+        default:
+            // RACP_OPERATOR_ALL.
+            break;
+    }
+
+    if (*p_end_pos < *p_first_pos)
+    {
+        *p_end_pos = *p_first_pos;
+    }
+}
+
+
+/**@brief Function for reporting the next record matching the current request.
+ *
+ * @details Deleted records within the range of positions matching the request are skipped.
+ *
+ * @param[in] p_engine  Engine structure.
+ *
+ * @return NRF_SUCCESS on success, otherwise an error code.
+ */
+static uint32_t engine_report_records_next(ble_racp_engine_t * p_engine)
+{
+    while (p_engine->proc_pos < p_engine->proc_end_pos)
+    {
+        uint32_t err_code = p_engine->p_backend->record_send(p_engine->p_context, p_engine->proc_pos);
+
+        if (err_code == NRF_SUCCESS)
+        {
+            p_engine->proc_records_reported++;
+            p_engine->proc_records_reported_since_txcomplete++;
+            return NRF_SUCCESS;
+        }
+        if (err_code != NRF_ERROR_NOT_FOUND)
+        {
+            return err_code;
+        }
+        p_engine->proc_pos++;
+    }
+
+    p_engine->state = BLE_RACP_ENGINE_STATE_NO_COMM;
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for informing that the REPORT RECORDS procedure is completed.
+ *
+ * @param[in] p_engine  Engine structure.
+ */
+static void engine_report_records_completed(ble_racp_engine_t * p_engine)
+{
+    uint8_t resp_code_value;
+
+    if (p_engine->proc_records_reported > 0)
+    {
+        resp_code_value = RACP_RESPONSE_SUCCESS;
+    }
+    else
+    {
+        resp_code_value = RACP_RESPONSE_NO_RECORDS_FOUND;
+    }
+
+    engine_response_code_send(p_engine, RACP_OPCODE_REPORT_RECS, resp_code_value);
+}
+
+
+/**@brief Function for the RACP report records procedure.
+ *
+ * @details Records are reported until the SoftDevice runs out of buffers, and the procedure is
+ *          resumed on the next TX_COMPLETE event.
+ *
+ * @param[in] p_engine  Engine structure.
+ */
+static void engine_report_records_procedure(ble_racp_engine_t * p_engine)
+{
+    uint32_t err_code;
+
+    while (p_engine->state == BLE_RACP_ENGINE_STATE_PROC_ACTIVE)
+    {
+        // Execute requested procedure
+        err_code = engine_report_records_next(p_engine);
+
+        // Error handling
+        switch (err_code)
+        {
+            case NRF_SUCCESS:
+                if (p_engine->state == BLE_RACP_ENGINE_STATE_PROC_ACTIVE)
+                {
+                    p_engine->proc_pos++;
+                }
+                else
+                {
+                    engine_report_records_completed(p_engine);
+                }
+                break;
+
+            case BLE_ERROR_NO_TX_BUFFERS:
+                // Wait for TX_COMPLETE event to resume transmission
+                return;
+
+            case NRF_ERROR_INVALID_STATE:
+                // Notification is probably not enabled. Ignore request.
+                p_engine->state = BLE_RACP_ENGINE_STATE_NO_COMM;
+                return;
+
+            default:
+                engine_error_report(p_engine, err_code);
+
+                // Make sure state machine returns to the default state
+                p_engine->state = BLE_RACP_ENGINE_STATE_NO_COMM;
+                return;
+        }
+    }
+}
+
+
+/**@brief Function for processing a REPORT NUM RECORDS request.
+ *
+ * @param[in] p_engine   Engine structure.
+ * @param[in] p_request  Request to be executed.
+ */
+static void engine_report_num_records_execute(ble_racp_engine_t      * p_engine,
+                                              const ble_racp_value_t * p_request)
+{
+    uint16_t first_pos;
+    uint16_t end_pos;
+    uint16_t num_records;
+
+    engine_request_range_get(p_engine, p_request, &first_pos, &end_pos);
+    num_records = p_engine->p_backend->num_records_in_range_get(first_pos, end_pos);
+
+    p_engine->pending_response.opcode      = RACP_OPCODE_NUM_RECS_RESPONSE;
+    p_engine->pending_response.operator    = RACP_OPERATOR_NULL;
+    p_engine->pending_response.operand_len = sizeof(uint16_t);
+    p_engine->pending_response.p_operand   = p_engine->pending_response_operand;
+
+    p_engine->pending_response_operand[0] = num_records & 0xFF;
+    p_engine->pending_response_operand[1] = num_records >> 8;
+
+    engine_response_send(p_engine);
+}
+
+
+uint32_t ble_racp_engine_init(ble_racp_engine_t * p_engine, const ble_racp_engine_init_t * p_engine_init)
+{
+    ble_racp_backend_t const * p_backend = p_engine_init->p_backend;
+
+    if ((p_backend == NULL)                           ||
+        (p_backend->pos_count_get == NULL)            ||
+        (p_backend->record_send == NULL)              ||
+        (p_backend->num_records_in_range_get == NULL) ||
+        (p_backend->filter_value_len_get == NULL))
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    memset(p_engine, 0, sizeof(*p_engine));
+
+    p_engine->p_backend         = p_backend;
+    p_engine->p_context         = p_engine_init->p_context;
+    p_engine->error_handler     = p_engine_init->error_handler;
+    p_engine->racp_value_handle = p_engine_init->racp_value_handle;
+    p_engine->conn_handle       = BLE_CONN_HANDLE_INVALID;
+    p_engine->state             = BLE_RACP_ENGINE_STATE_NO_COMM;
+
+    return NRF_SUCCESS;
+}
+
+
+void ble_racp_engine_on_ble_evt(ble_racp_engine_t * p_engine, ble_evt_t * p_ble_evt)
+{
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GAP_EVT_CONNECTED:
+#ifdef S130
+            // Only the links where the device is a peripheral access the service.
+            if (p_ble_evt->evt.gap_evt.params.connected.role != BLE_GAP_ROLE_PERIPH)
+            {
+                break;
+            }
+#endif
+            p_engine->conn_handle                            = p_ble_evt->evt.gap_evt.conn_handle;
+            p_engine->state                                  = BLE_RACP_ENGINE_STATE_NO_COMM;
+            p_engine->proc_records_reported_since_txcomplete = 0;
+            break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            if (p_ble_evt->evt.gap_evt.conn_handle == p_engine->conn_handle)
+            {
+                p_engine->conn_handle = BLE_CONN_HANDLE_INVALID;
+                p_engine->state       = BLE_RACP_ENGINE_STATE_NO_COMM;
+            }
+            break;
+
+        case BLE_EVT_TX_COMPLETE:
+            if (p_ble_evt->evt.common_evt.conn_handle != p_engine->conn_handle)
+            {
+                break;
+            }
+            p_engine->proc_records_reported_since_txcomplete = 0;
+
+            if (p_engine->state == BLE_RACP_ENGINE_STATE_RESPONSE_PENDING)
+            {
+                engine_response_send(p_engine);
+            }
+            else if (p_engine->state == BLE_RACP_ENGINE_STATE_PROC_ACTIVE)
+            {
+                engine_report_records_procedure(p_engine);
+            }
+            break;
+
+        case BLE_GATTS_EVT_HVC:
+            if ((p_ble_evt->evt.gatts_evt.conn_handle == p_engine->conn_handle) &&
+                (p_ble_evt->evt.gatts_evt.params.hvc.handle == p_engine->racp_value_handle))
+            {
+                if (p_engine->state == BLE_RACP_ENGINE_STATE_RESPONSE_IND_VERIF)
+                {
+                    // Indication has been acknowledged. Return to default state.
+                    p_engine->state = BLE_RACP_ENGINE_STATE_NO_COMM;
+                }
+                else
+                {
+                    // We did not expect this event in this state. Report error to application.
+                    engine_error_report(p_engine, NRF_ERROR_INVALID_STATE);
+                }
+            }
+            break;
+
+        default:
+            // No implementation needed.
+            break;
+    }
+}
+
+
+bool ble_racp_engine_request_check(ble_racp_engine_t * p_engine, const ble_racp_value_t * p_request)
+{
+    uint8_t * p_response_code = &p_engine->response_code;
+
+    *p_response_code = RACP_RESPONSE_RESERVED;
+
+    if (p_request->opcode == RACP_OPCODE_ABORT_OPERATION)
+    {
+        if (p_engine->state == BLE_RACP_ENGINE_STATE_PROC_ACTIVE)
+        {
+            if (p_request->operator != RACP_OPERATOR_NULL)
+            {
+                *p_response_code = RACP_RESPONSE_INVALID_OPERATOR;
+            }
+            else if (p_request->operand_len != 0)
+            {
+                *p_response_code = RACP_RESPONSE_INVALID_OPERAND;
+            }
+            else
+            {
+                *p_response_code = RACP_RESPONSE_SUCCESS;
+            }
+        }
+        else
+        {
+            *p_response_code = RACP_RESPONSE_ABORT_FAILED;
+        }
+    }
+    else if (p_engine->state != BLE_RACP_ENGINE_STATE_NO_COMM)
+    {
+        return false;
+    }
+    // Supported opcodes.
+    else if ((p_request->opcode == RACP_OPCODE_REPORT_RECS) ||
+             (p_request->opcode == RACP_OPCODE_REPORT_NUM_RECS))
+    {
+        switch (p_request->operator)
+        {
+            // Operators WITHOUT a filter.
+            case RACP_OPERATOR_ALL:
+            case RACP_OPERATOR_FIRST:
+            case RACP_OPERATOR_LAST:
+                if (p_request->operand_len != 0)
+                {
+                    *p_response_code = RACP_RESPONSE_INVALID_OPERAND;
+                }
+                break;
+
+            // Operators WITH a filter.
+            case RACP_OPERATOR_LESS_OR_EQUAL:
+            case RACP_OPERATOR_GREATER_OR_EQUAL:
+            case RACP_OPERATOR_RANGE:
+                *p_response_code = engine_filter_check(p_engine, p_request);
+                break;
+
+            // Invalid operators.
+            case RACP_OPERATOR_NULL:
+            default:
+                if (p_request->operator >= RACP_OPERATOR_RFU_START)
+                {
+                    *p_response_code = RACP_RESPONSE_OPERATOR_UNSUPPORTED;
+                }
+                else
+                {
+                    *p_response_code = RACP_RESPONSE_INVALID_OPERATOR;
+                }
+                break;
+        }
+    }
+    // Unsupported and unknown opcodes.
+    else
+    {
+        *p_response_code = RACP_RESPONSE_OPCODE_UNSUPPORTED;
+    }
+
+    return true;
+}
+
+
+void ble_racp_engine_request_execute(ble_racp_engine_t * p_engine, const ble_racp_value_t * p_request)
+{
+    if (p_engine->response_code != RACP_RESPONSE_RESERVED)
+    {
+        // Abort any running procedure.
+        p_engine->state = BLE_RACP_ENGINE_STATE_NO_COMM;
+
+        // Respond with error code.
+        engine_response_code_send(p_engine, p_request->opcode, p_engine->response_code);
+    }
+    else if (p_request->opcode == RACP_OPCODE_REPORT_RECS)
+    {
+        p_engine->state = BLE_RACP_ENGINE_STATE_PROC_ACTIVE;
+
+        engine_request_range_get(p_engine, p_request, &p_engine->proc_pos, &p_engine->proc_end_pos);
+        p_engine->proc_records_reported = 0;
+
+        engine_report_records_procedure(p_engine);
+    }
+    else if (p_request->opcode == RACP_OPCODE_REPORT_NUM_RECS)
+    {
+        engine_report_num_records_execute(p_engine, p_request);
+    }
+}
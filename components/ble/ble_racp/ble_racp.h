@@ -15,6 +15,18 @@
  * @{
  * @ingroup ble_sdk_lib
  * @brief Record Access Control Point library.
+ *
+ * @details Besides encoding and decoding Record Access Control Point values, this library provides
+ *          a record access engine executing Record Access Control Point requests on behalf of a
+ *          service. The records are read through a @ref ble_racp_backend_t provided by the
+ *          service, and addressed by position, the oldest record being at position 0. The engine
+ *          finds the range of positions matching a request using the backend, reports the
+ *          records at full notification rate (resuming on TX_COMPLETE whenever the SoftDevice runs
+ *          out of buffers), handles the abort operation, and sends the Record Access Control Point
+ *          responses.
+ *
+ * @note The application must propagate BLE stack events to the engine by calling
+ *       ble_racp_engine_on_ble_evt() from the service event handler.
  */
 
 #ifndef BLE_RACP_H__
@@ -25,6 +37,7 @@
 #include "ble.h"
 #include "ble_types.h"
 #include "ble.h"
+#include "ble_srv_common.h"
 
 /**@brief Record Access Control Point opcodes. */
 #define RACP_OPCODE_RESERVED                0       /**< Record Access Control Point opcode - Reserved for future use. */
@@ -57,6 +70,11 @@
 #define RACP_RESPONSE_PROCEDURE_NOT_DONE    8       /**< Record Access Control Point response code - Procedure could not be completed. */
 #define RACP_RESPONSE_OPERAND_UNSUPPORTED   9       /**< Record Access Control Point response code - Unsupported operand. */
 
+/**@brief Record Access Control Point operand filter types. */
+#define RACP_FILTER_TYPE_SEQ_NUM            0x01    /**< Record Access Control Point filter type - Sequence number. */
+#define RACP_FILTER_TYPE_FACING_TIME        0x02    /**< Record Access Control Point filter type - User facing time. */
+#define RACP_FILTER_TYPE_RFU_START          0x07    /**< Record Access Control Point filter type - Start of Reserved for Future Use area. */
+
 /**@brief Record Access Control Point value structure. */
 typedef struct
 {
@@ -90,6 +108,104 @@ void ble_racp_decode(uint8_t data_len, uint8_t * p_data, ble_racp_value_t * p_ra
  */
 uint8_t ble_racp_encode(const ble_racp_value_t * p_racp_val, uint8_t * p_data);
 
+/**@brief Record store backend used by the record access engine.
+ *
+ * @details Records are addressed by position, the oldest record being at position 0. The records
+ *          must be stored in increasing order of every supported filter type, so that the first
+ *          position matching a filter value can be found by binary search.
+ */
+typedef struct
+{
+    uint16_t (*pos_count_get)(void);                                            /**< Function for getting the number of positions in the store. */
+    uint32_t (*record_send)(void * p_context, uint16_t pos);                    /**< Function for sending the record at a position. Returns NRF_ERROR_NOT_FOUND if the record has been deleted, BLE_ERROR_NO_TX_BUFFERS if it must be retried after TX_COMPLETE, otherwise the result of the send. */
+    uint16_t (*num_records_in_range_get)(uint16_t first_pos, uint16_t end_pos); /**< Function for getting the number of records (deleted records excluded) in a range of positions. */
+    uint8_t  (*filter_value_len_get)(uint8_t filter_type);                      /**< Function for getting the length of a filter value, 0 if the filter type is not supported. */
+    uint16_t (*filter_pos_find)(uint8_t         filter_type,
+                                uint8_t const * p_value,
+                                bool            upper);                         /**< Function for finding the first position with a value >= (or > if upper is TRUE) the filter value. Not called if filter_value_len_get always returns 0. */
+    bool     (*filter_range_is_valid)(uint8_t         filter_type,
+                                      uint8_t const * p_min,
+                                      uint8_t const * p_max);                   /**< Function for checking that the minimum of a RANGE filter is not greater than the maximum. May be NULL. */
+} ble_racp_backend_t;
+
+/**@brief Record access engine communication state. */
+typedef enum
+{
+    BLE_RACP_ENGINE_STATE_NO_COMM,                                              /**< The engine is not in a communicating state. */
+    BLE_RACP_ENGINE_STATE_PROC_ACTIVE,                                          /**< Reporting records. */
+    BLE_RACP_ENGINE_STATE_RESPONSE_PENDING,                                     /**< There is a RACP indication waiting to be sent. */
+    BLE_RACP_ENGINE_STATE_RESPONSE_IND_VERIF                                    /**< Waiting for a verification of a RACP indication. */
+} ble_racp_engine_state_t;
+
+/**@brief Record access engine init structure. */
+typedef struct
+{
+    ble_racp_backend_t const * p_backend;                                       /**< Record store backend. */
+    void                     * p_context;                                       /**< Context passed to the backend record_send function, typically the service instance. */
+    ble_srv_error_handler_t    error_handler;                                   /**< Function to be called in case of an error. */
+    uint16_t                   racp_value_handle;                               /**< Handle of the Record Access Control Point value. */
+} ble_racp_engine_init_t;
+
+/**@brief Record access engine structure. This contains the state of the procedure in progress. */
+typedef struct
+{
+    ble_racp_backend_t const * p_backend;                                       /**< Record store backend. */
+    void                     * p_context;                                       /**< Context passed to the backend record_send function. */
+    ble_srv_error_handler_t    error_handler;                                   /**< Function to be called in case of an error. */
+    uint16_t                   racp_value_handle;                               /**< Handle of the Record Access Control Point value. */
+    uint16_t                   conn_handle;                                     /**< Handle of the current connection (BLE_CONN_HANDLE_INVALID if not in a connection). */
+    ble_racp_engine_state_t    state;                                           /**< Current communication state. */
+    uint8_t                    response_code;                                   /**< Response code of the request being handled, RACP_RESPONSE_RESERVED if it is to be executed. */
+    uint16_t                   proc_pos;                                        /**< Current position of the procedure. */
+    uint16_t                   proc_end_pos;                                    /**< Position following the last one matching the request. */
+    uint16_t                   proc_records_reported;                           /**< Number of records reported. */
+    uint8_t                    proc_records_reported_since_txcomplete;          /**< Number of records reported since last TX_COMPLETE event. */
+    ble_racp_value_t           pending_response;                                /**< RACP response to be sent. */
+    uint8_t                    pending_response_operand[2];                     /**< Operand of RACP response to be sent. */
+} ble_racp_engine_t;
+
+/**@brief Function for initializing the record access engine.
+ *
+ * @param[out]  p_engine        Engine structure, supplied by the service.
+ * @param[in]   p_engine_init   Information needed to initialize the engine.
+ *
+ * @return      NRF_SUCCESS on success, NRF_ERROR_NULL if the backend is missing a function.
+ */
+uint32_t ble_racp_engine_init(ble_racp_engine_t * p_engine, const ble_racp_engine_init_t * p_engine_init);
+
+/**@brief Function for handling BLE stack events.
+ *
+ * @details Handles connection, TX_COMPLETE and HVC events.
+ *
+ * @param[in]   p_engine    Engine structure.
+ * @param[in]   p_ble_evt   Event received from the BLE stack.
+ */
+void ble_racp_engine_on_ble_evt(ble_racp_engine_t * p_engine, ble_evt_t * p_ble_evt);
+
+/**@brief Function for checking a request written to the Record Access Control Point.
+ *
+ * @details The service replies to the write authorization request with BLE_GATT_STATUS_SUCCESS if
+ *          this function returns TRUE, and then calls @ref ble_racp_engine_request_execute. If
+ *          this function returns FALSE, a procedure is already in progress and the service
+ *          replies with its Procedure Already In Progress error.
+ *
+ * @param[in]   p_engine    Engine structure.
+ * @param[in]   p_request   Decoded request.
+ *
+ * @return      TRUE if the request is accepted (either for execution or for an error response).
+ */
+bool ble_racp_engine_request_check(ble_racp_engine_t * p_engine, const ble_racp_value_t * p_request);
+
+/**@brief Function for executing a request accepted by @ref ble_racp_engine_request_check.
+ *
+ * @details Either starts reporting the matching records, sends the number of matching records, or
+ *          aborts the procedure in progress and sends the response code.
+ *
+ * @param[in]   p_engine    Engine structure.
+ * @param[in]   p_request   Decoded request.
+ */
+void ble_racp_engine_request_execute(ble_racp_engine_t * p_engine, const ble_racp_value_t * p_request);
+
 #endif // BLE_RACP_H__
 
 /** @} */
@@ -0,0 +1,532 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ */
+
+#include "ble_racp_db.h"
+#include <stddef.h>
+#include <string.h>
+#include "nrf_error.h"
+
+
+#define DB_SEQ_ERASED         0xFFFFFFFF                                 /**< Sequence counter of an erased slot. */
+#define DB_RECORD_LIVE        0xFFFFFFFF                                 /**< Deleted marker of a record that has not been deleted. */
+#define DB_RECORD_DELETED     0x00000000                                 /**< Deleted marker of a deleted record. */
+
+static uint32_t m_deleted_mark = DB_RECORD_DELETED;                      /**< Source of the deleted marker writes. */
+
+
+/**@brief Function for getting the slot of a position.
+ *
+ * @param[in]   p_db   Database structure.
+ * @param[in]   pos    Position, may exceed the number of positions by less than the slot count.
+ *
+ * @return      Slot of the position.
+ */
+static uint16_t pos_to_slot(ble_racp_db_t const * p_db, uint16_t pos)
+{
+    uint32_t slot = (uint32_t)p_db->tail + pos;
+
+    if (slot >= p_db->slot_count)
+    {
+        slot -= p_db->slot_count;
+    }
+
+    return (uint16_t)slot;
+}
+
+
+/**@brief Function for getting the flash copy of a slot.
+ *
+ * @param[in]   p_db   Database structure.
+ * @param[in]   slot   Slot number.
+ *
+ * @return      Pointer to the first word of the slot in flash.
+ */
+static uint32_t const * slot_get(ble_racp_db_t const * p_db, uint16_t slot)
+{
+    return (uint32_t const *)(p_db->storage_handle.block_id + (slot * p_db->block_size));
+}
+
+
+/**@brief Function for getting the sequence counter of a slot.
+ *
+ * @param[in]   p_db   Database structure.
+ * @param[in]   slot   Slot number.
+ *
+ * @return      Sequence counter, DB_SEQ_ERASED if the record has not been written.
+ */
+static uint32_t slot_seq_get(ble_racp_db_t const * p_db, uint16_t slot)
+{
+    return slot_get(p_db, slot)[p_db->seq_offset / sizeof(uint32_t)];
+}
+
+
+/**@brief Function for checking if a slot holds a record which has been written and not deleted.
+ *
+ * @param[in]   p_db   Database structure.
+ * @param[in]   slot   Slot number.
+ *
+ * @return      TRUE if the record is live, FALSE if it was deleted or its write failed.
+ */
+static bool slot_is_live(ble_racp_db_t const * p_db, uint16_t slot)
+{
+    uint32_t const * p_seq = &slot_get(p_db, slot)[p_db->seq_offset / sizeof(uint32_t)];
+
+    return (p_seq[0] != DB_SEQ_ERASED) && (p_seq[1] == DB_RECORD_LIVE);
+}
+
+
+/**@brief Function for checking if a slot is fully erased, and can be written.
+ *
+ * @param[in]   p_db   Database structure.
+ * @param[in]   slot   Slot number.
+ *
+ * @return      TRUE if every word of the slot is erased.
+ */
+static bool slot_is_erased(ble_racp_db_t const * p_db, uint16_t slot)
+{
+    uint32_t const * p_word = slot_get(p_db, slot);
+    uint32_t         i;
+
+    for (i = 0; i < (p_db->block_size / sizeof(uint32_t)); i++)
+    {
+        if (p_word[i] != DB_SEQ_ERASED)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/**@brief Function for dropping deleted records at the start of the database.
+ *
+ * @param[in]   p_db   Database structure.
+ */
+static void deleted_records_trim(ble_racp_db_t * p_db)
+{
+    while ((p_db->pos_count > 0) && !slot_is_live(p_db, p_db->tail))
+    {
+        p_db->tail = pos_to_slot(p_db, 1);
+        p_db->pos_count--;
+        p_db->num_deleted--;
+    }
+}
+
+
+/**@brief Function for erasing the flash page starting at a slot.
+ *
+ * @details The records stored in the page are the oldest ones, and are dropped.
+ *
+ * @param[in]   p_db         Database structure.
+ * @param[in]   first_slot   First slot of the page.
+ *
+ * @return      NRF_SUCCESS on success, otherwise an error code returned by pstorage_clear.
+ */
+static uint32_t page_erase(ble_racp_db_t * p_db, uint16_t first_slot)
+{
+    uint32_t          err_code;
+    pstorage_handle_t block_handle;
+
+    while ((p_db->pos_count > 0) &&
+           (p_db->tail >= first_slot) &&
+           (p_db->tail < (first_slot + p_db->slots_per_page)))
+    {
+        if (!slot_is_live(p_db, p_db->tail))
+        {
+            p_db->num_deleted--;
+        }
+        p_db->tail = pos_to_slot(p_db, 1);
+        p_db->pos_count--;
+    }
+    deleted_records_trim(p_db);
+
+    if ((p_db->newest_slot >= first_slot) &&
+        (p_db->newest_slot < (first_slot + p_db->slots_per_page)))
+    {
+        p_db->newest_slot = p_db->slot_count;
+    }
+
+    err_code = pstorage_block_identifier_get(&p_db->storage_handle, first_slot, &block_handle);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    return pstorage_clear(&block_handle, p_db->slots_per_page * p_db->block_size);
+}
+
+
+/**@brief Function for getting an entry of the store queue.
+ *
+ * @param[in]   p_db    Database structure.
+ * @param[in]   entry   Entry number, counted from the oldest record waiting to be written.
+ *
+ * @return      Pointer to the entry.
+ */
+static uint32_t * store_entry_get(ble_racp_db_t const * p_db, uint8_t entry)
+{
+    entry = (p_db->store_first + entry) % p_db->store_queue_size;
+
+    return &p_db->p_store_buf[entry * (BLE_RACP_DB_ENTRY_SIZE(p_db->record_size) / sizeof(uint32_t))];
+}
+
+
+uint32_t ble_racp_db_init(ble_racp_db_t * p_db, ble_racp_db_init_t const * p_init)
+{
+    uint16_t slot;
+    uint16_t head    = 0;
+    uint32_t min_seq = DB_SEQ_ERASED;
+    uint32_t max_seq = 0;
+
+    if ((p_db == NULL) || (p_init == NULL) ||
+        (p_init->p_storage_handle == NULL) || (p_init->p_store_buf == NULL))
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if ((BLE_RACP_DB_ENTRY_SIZE(p_init->record_size) > p_init->block_size) ||
+        ((PSTORAGE_FLASH_PAGE_SIZE % p_init->block_size) != 0)                ||
+        ((p_init->block_count % (PSTORAGE_FLASH_PAGE_SIZE / p_init->block_size)) != 0) ||
+        (p_init->store_queue_size == 0))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    memset(p_db, 0, sizeof(*p_db));
+
+    p_db->storage_handle   = *p_init->p_storage_handle;
+    p_db->block_size       = p_init->block_size;
+    p_db->record_size      = p_init->record_size;
+    p_db->seq_offset       = BLE_RACP_DB_ENTRY_SIZE(p_init->record_size) - (2 * sizeof(uint32_t));
+    p_db->slot_count       = p_init->block_count;
+    p_db->slots_per_page   = PSTORAGE_FLASH_PAGE_SIZE / p_init->block_size;
+    p_db->newest_slot      = p_db->slot_count;
+    p_db->p_store_buf      = p_init->p_store_buf;
+    p_db->store_queue_size = p_init->store_queue_size;
+
+    // Find the oldest and the newest record.
+    for (slot = 0; slot < p_db->slot_count; slot++)
+    {
+        uint32_t seq = slot_seq_get(p_db, slot);
+
+        if (seq == DB_SEQ_ERASED)
+        {
+            continue;
+        }
+        if (seq < min_seq)
+        {
+            min_seq    = seq;
+            p_db->tail = slot;
+        }
+        if (seq >= max_seq)
+        {
+            max_seq = seq;
+            head    = slot;
+        }
+    }
+
+    if (min_seq != DB_SEQ_ERASED)
+    {
+        p_db->pos_count   = (head >= p_db->tail) ? (head - p_db->tail + 1)
+                                                 : (head + p_db->slot_count - p_db->tail + 1);
+        p_db->newest_slot = head;
+        p_db->next_seq    = max_seq + 1;
+    }
+
+    // Slots whose write failed before a reset are not erased, they take a position so that
+    // they are not written again. Gaps between records are skipped the same way.
+    while ((p_db->pos_count < p_db->slot_count) &&
+           !slot_is_erased(p_db, pos_to_slot(p_db, p_db->pos_count)))
+    {
+        p_db->pos_count++;
+    }
+
+    for (slot = 0; slot < p_db->pos_count; slot++)
+    {
+        if (!slot_is_live(p_db, pos_to_slot(p_db, slot)))
+        {
+            p_db->num_deleted++;
+        }
+    }
+    deleted_records_trim(p_db);
+
+    return NRF_SUCCESS;
+}
+
+
+void ble_racp_db_on_pstorage_evt(ble_racp_db_t     * p_db,
+                                 pstorage_handle_t * p_handle,
+                                 uint8_t             op_code,
+                                 uint32_t            result,
+                                 uint8_t           * p_data)
+{
+    uint16_t slot;
+
+    // Added records are written in order, and take the next position once written.
+    if ((op_code != PSTORAGE_STORE_OP_CODE) ||
+        (p_db->num_pending == 0)            ||
+        (p_data != (uint8_t *)store_entry_get(p_db, 0)))
+    {
+        return;
+    }
+
+    p_db->store_first = (p_db->store_first + 1) % p_db->store_queue_size;
+    p_db->num_pending--;
+    p_db->pos_count++;
+
+    slot = pos_to_slot(p_db, p_db->pos_count - 1);
+
+    if (result == NRF_SUCCESS)
+    {
+        p_db->newest_slot = slot;
+    }
+    // A record whose write failed keeps its position so that the slot is not reused. A slot whose
+    // sequence counter was not written is already skipped. Otherwise it is marked deleted, unless
+    // the marker cannot be written, in which case the whole record was written.
+    else if (!slot_is_live(p_db, slot) ||
+             (pstorage_store(p_handle,
+                             (uint8_t *)&m_deleted_mark,
+                             sizeof(m_deleted_mark),
+                             p_db->seq_offset + sizeof(uint32_t)) == NRF_SUCCESS))
+    {
+        p_db->num_deleted++;
+        deleted_records_trim(p_db);
+    }
+}
+
+
+uint32_t ble_racp_db_record_add(ble_racp_db_t * p_db, void const * p_rec)
+{
+    uint32_t          err_code;
+    uint16_t          head;
+    uint32_t        * p_entry;
+    pstorage_handle_t block_handle;
+
+    if (p_db->num_pending == p_db->store_queue_size)
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    head = pos_to_slot(p_db, p_db->pos_count + p_db->num_pending);
+
+    // Entering a page written during the previous round, erase it first.
+    if (((head % p_db->slots_per_page) == 0) && !slot_is_erased(p_db, head))
+    {
+        err_code = page_erase(p_db, head);
+        if (err_code != NRF_SUCCESS)
+        {
+            return err_code;
+        }
+    }
+
+    err_code = pstorage_block_identifier_get(&p_db->storage_handle, head, &block_handle);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    p_entry = store_entry_get(p_db, p_db->num_pending);
+
+    memset(p_entry, 0xFF, BLE_RACP_DB_ENTRY_SIZE(p_db->record_size));
+    memcpy(p_entry, p_rec, p_db->record_size);
+    p_entry[p_db->seq_offset / sizeof(uint32_t)] = p_db->next_seq;
+
+    // The deleted marker is left erased.
+    err_code = pstorage_store(&block_handle,
+                              (uint8_t *)p_entry,
+                              p_db->seq_offset + sizeof(uint32_t),
+                              0);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    p_db->num_pending++;
+    p_db->next_seq++;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ble_racp_db_record_delete(ble_racp_db_t * p_db, uint16_t pos)
+{
+    uint32_t          err_code;
+    uint16_t          slot;
+    pstorage_handle_t block_handle;
+
+    if (pos >= p_db->pos_count)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    slot = pos_to_slot(p_db, pos);
+    if (!slot_is_live(p_db, slot))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    err_code = pstorage_block_identifier_get(&p_db->storage_handle, slot, &block_handle);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    err_code = pstorage_store(&block_handle,
+                              (uint8_t *)&m_deleted_mark,
+                              sizeof(m_deleted_mark),
+                              p_db->seq_offset + sizeof(uint32_t));
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    p_db->num_deleted++;
+    deleted_records_trim(p_db);
+
+    return NRF_SUCCESS;
+}
+
+
+uint16_t ble_racp_db_pos_count_get(ble_racp_db_t const * p_db)
+{
+    return p_db->pos_count;
+}
+
+
+uint16_t ble_racp_db_num_records_get(ble_racp_db_t const * p_db)
+{
+    return p_db->pos_count - p_db->num_deleted;
+}
+
+
+void const * ble_racp_db_pos_record_get(ble_racp_db_t const * p_db, uint16_t pos)
+{
+    uint16_t slot;
+
+    if (pos >= p_db->pos_count)
+    {
+        return NULL;
+    }
+
+    slot = pos_to_slot(p_db, pos);
+
+    return slot_is_live(p_db, slot) ? slot_get(p_db, slot) : NULL;
+}
+
+
+void const * ble_racp_db_newest_record_get(ble_racp_db_t const * p_db)
+{
+    return (p_db->newest_slot < p_db->slot_count) ? slot_get(p_db, p_db->newest_slot) : NULL;
+}
+
+
+uint16_t ble_racp_db_index_to_pos(ble_racp_db_t const * p_db, uint16_t rec_ndx)
+{
+    uint16_t pos;
+
+    if (p_db->num_deleted == 0)
+    {
+        return (rec_ndx < p_db->pos_count) ? rec_ndx : p_db->pos_count;
+    }
+
+    for (pos = 0; pos < p_db->pos_count; pos++)
+    {
+        if (slot_is_live(p_db, pos_to_slot(p_db, pos)))
+        {
+            if (rec_ndx == 0)
+            {
+                break;
+            }
+            rec_ndx--;
+        }
+    }
+
+    return pos;
+}
+
+
+uint16_t ble_racp_db_pos_find(ble_racp_db_t const * p_db,
+                              ble_racp_db_key_get_t key_get,
+                              void const          * p_context,
+                              int64_t               key,
+                              bool                  upper)
+{
+    uint16_t first = 0;
+    uint16_t count = p_db->pos_count;
+
+    while (count > 0)
+    {
+        uint16_t step  = count / 2;
+        uint16_t end   = first + count;
+        uint16_t probe = first + step;
+        int64_t  entry_key;
+
+        while ((probe < end) && !slot_is_live(p_db, pos_to_slot(p_db, probe)))
+        {
+            probe++;
+        }
+
+        if (probe == end)
+        {
+            // No live record from the middle on, look in the first half.
+            count = step;
+            continue;
+        }
+
+        entry_key = key_get(slot_get(p_db, pos_to_slot(p_db, probe)), p_context);
+
+        if ((entry_key < key) || (upper && (entry_key == key)))
+        {
+            first = probe + 1;
+            count = end - first;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+
+    return first;
+}
+
+
+uint16_t ble_racp_db_num_records_in_range_get(ble_racp_db_t const * p_db,
+                                              uint16_t              first_pos,
+                                              uint16_t              end_pos)
+{
+    uint16_t num_records;
+    uint16_t pos;
+
+    if (end_pos > p_db->pos_count)
+    {
+        end_pos = p_db->pos_count;
+    }
+    if (first_pos >= end_pos)
+    {
+        return 0;
+    }
+
+    num_records = end_pos - first_pos;
+
+    if (p_db->num_deleted != 0)
+    {
+        for (pos = first_pos; pos < end_pos; pos++)
+        {
+            if (!slot_is_live(p_db, pos_to_slot(p_db, pos)))
+            {
+                num_records--;
+            }
+        }
+    }
+
+    return num_records;
+}
@@ -0,0 +1,221 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ */
+
+/** @file
+ *
+ * @defgroup ble_sdk_lib_racp_db Record Access Database
+ * @{
+ * @ingroup ble_sdk_lib
+ * @brief Flash ring of fixed size records, used as record store by the services exposing a
+ *        Record Access Control Point.
+ *
+ * @details Records are kept in a ring of flash blocks managed through the persistent storage
+ *          module, so that they survive a reset. Each slot holds a record, followed by a
+ *          monotonically increasing 32-bit counter used to find the oldest and newest record on
+ *          initialization, and by a deleted marker. The counter is the last word written when
+ *          adding a record, so a slot is only in use once the whole record has been written.
+ *
+ *          Records are addressed by position, the oldest record being at position 0. An added
+ *          record takes its position once the persistent storage module reports that it has been
+ *          written. A record whose write failed keeps its position, so that the slot is not
+ *          reused, and is marked deleted. A deleted record keeps its position until it becomes the
+ *          oldest one. When the ring wraps around, the page holding the oldest records is erased
+ *          and those records are dropped. Records already stored are never cleared on
+ *          initialization.
+ *
+ *          The user registers the slots with the persistent storage module, and forwards the
+ *          events of that registration to @ref ble_racp_db_on_pstorage_evt.
+ *
+ * @note    @ref pstorage_init must have been called before @ref ble_racp_db_init, and the
+ *          application must propagate system events to @ref pstorage_sys_event_handler.
+ */
+
+#ifndef BLE_RACP_DB_H__
+#define BLE_RACP_DB_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pstorage.h"
+#include "app_util.h"
+
+/**@brief Size of a slot holding a record of a given size, sequence counter and deleted marker included. */
+#define BLE_RACP_DB_ENTRY_SIZE(RECORD_SIZE)                                       \
+    ((CEIL_DIV((RECORD_SIZE), sizeof(uint32_t)) + 2) * sizeof(uint32_t))
+
+/**@brief Number of words of the store queue buffer for a given record size and queue size. */
+#define BLE_RACP_DB_STORE_BUF_WORDS(RECORD_SIZE, QUEUE_SIZE)                      \
+    ((BLE_RACP_DB_ENTRY_SIZE(RECORD_SIZE) / sizeof(uint32_t)) * (QUEUE_SIZE))
+
+/**@brief Function for getting the search key of a record.
+ *
+ * @param[in]   p_rec       Record.
+ * @param[in]   p_context   Context given to @ref ble_racp_db_pos_find.
+ *
+ * @return      Key of the record. Records must be stored in increasing key order.
+ */
+typedef int64_t (*ble_racp_db_key_get_t)(void const * p_rec, void const * p_context);
+
+/**@brief Record access database init structure. */
+typedef struct
+{
+    pstorage_handle_t const * p_storage_handle;                                 /**< Base handle of the slots, as returned by pstorage_register. */
+    uint16_t                  block_size;                                       /**< Size of one slot, as registered. Must divide the flash page size and hold @ref BLE_RACP_DB_ENTRY_SIZE. */
+    uint16_t                  block_count;                                      /**< Number of slots, as registered. Must be a multiple of the number of slots in a flash page. */
+    uint16_t                  record_size;                                      /**< Size of a record. */
+    uint32_t                * p_store_buf;                                      /**< Buffer of @ref BLE_RACP_DB_STORE_BUF_WORDS words holding the records waiting to be written. */
+    uint8_t                   store_queue_size;                                 /**< Number of added records that can be waiting to be written to flash. */
+} ble_racp_db_init_t;
+
+/**@brief Record access database structure. This contains the state of the ring. */
+typedef struct
+{
+    pstorage_handle_t         storage_handle;                                   /**< Base handle of the slots. */
+    uint16_t                  block_size;                                       /**< Size of one slot. */
+    uint16_t                  record_size;                                      /**< Size of a record. */
+    uint16_t                  seq_offset;                                       /**< Offset of the sequence counter in a slot. */
+    uint16_t                  slot_count;                                       /**< Number of slots in the database. */
+    uint16_t                  slots_per_page;                                   /**< Number of slots in one flash page. */
+    uint16_t                  tail;                                             /**< Slot of the record at position 0. */
+    uint16_t                  pos_count;                                        /**< Number of positions, deleted records included. */
+    uint16_t                  num_deleted;                                      /**< Number of deleted records among the positions. */
+    uint16_t                  newest_slot;                                      /**< Slot of the newest record written, slot_count if there is none. */
+    uint32_t                  next_seq;                                         /**< Sequence counter of the next record written. */
+    uint32_t                * p_store_buf;                                      /**< Records waiting to be written, oldest first from store_first. */
+    uint8_t                   store_queue_size;                                 /**< Number of entries of the store queue. */
+    uint8_t                   store_first;                                      /**< Entry of the oldest record waiting to be written. */
+    uint8_t                   num_pending;                                      /**< Number of records waiting to be written, not counted in the positions yet. */
+} ble_racp_db_t;
+
+/**@brief Function for initializing a record access database.
+ *
+ * @details Restores the records found in flash.
+ *
+ * @param[out]  p_db      Database structure, supplied by the user.
+ * @param[in]   p_init    Information needed to initialize the database.
+ *
+ * @return      NRF_SUCCESS on success, NRF_ERROR_INVALID_PARAM if the layout does not fit the slots.
+ */
+uint32_t ble_racp_db_init(ble_racp_db_t * p_db, ble_racp_db_init_t const * p_init);
+
+/**@brief Function for handling the events of the persistent storage registration of the slots.
+ *
+ * @param[in]   p_db      Database structure.
+ * @param[in]   p_handle  Identifies the flash block the operation was on.
+ * @param[in]   op_code   Identifies the operation.
+ * @param[in]   result    Result of the operation.
+ * @param[in]   p_data    Data written.
+ */
+void ble_racp_db_on_pstorage_evt(ble_racp_db_t     * p_db,
+                                 pstorage_handle_t * p_handle,
+                                 uint8_t             op_code,
+                                 uint32_t            result,
+                                 uint8_t           * p_data);
+
+/**@brief Function for adding a record at the end of the database.
+ *
+ * @details If the database is full, the oldest records are dropped.
+ *
+ * @param[in]   p_db      Database structure.
+ * @param[in]   p_rec     Record to add, of the record size given at initialization.
+ *
+ * @return      NRF_SUCCESS on success, NRF_ERROR_BUSY if the store queue is full, otherwise an
+ *              error code returned by the persistent storage module.
+ */
+uint32_t ble_racp_db_record_add(ble_racp_db_t * p_db, void const * p_rec);
+
+/**@brief Function for deleting the record at a position.
+ *
+ * @param[in]   p_db      Database structure.
+ * @param[in]   pos       Position of a record which is not deleted.
+ *
+ * @return      NRF_SUCCESS on success, NRF_ERROR_NOT_FOUND if there is no such record, otherwise
+ *              an error code returned by the persistent storage module.
+ */
+uint32_t ble_racp_db_record_delete(ble_racp_db_t * p_db, uint16_t pos);
+
+/**@brief Function for getting the number of positions in the database.
+ *
+ * @param[in]   p_db      Database structure.
+ *
+ * @return      Number of positions, deleted records included.
+ */
+uint16_t ble_racp_db_pos_count_get(ble_racp_db_t const * p_db);
+
+/**@brief Function for getting the number of records in the database.
+ *
+ * @param[in]   p_db      Database structure.
+ *
+ * @return      Number of records, deleted records excluded.
+ */
+uint16_t ble_racp_db_num_records_get(ble_racp_db_t const * p_db);
+
+/**@brief Function for getting the record at a position.
+ *
+ * @param[in]   p_db      Database structure.
+ * @param[in]   pos       Position of the record, 0 being the oldest one.
+ *
+ * @return      Pointer to the record in flash, NULL if the position is out of range or the record
+ *              has been deleted.
+ */
+void const * ble_racp_db_pos_record_get(ble_racp_db_t const * p_db, uint16_t pos);
+
+/**@brief Function for getting the newest record ever written, even if deleted or dropped since.
+ *
+ * @param[in]   p_db      Database structure.
+ *
+ * @return      Pointer to the record in flash, NULL if the database has never held a record.
+ */
+void const * ble_racp_db_newest_record_get(ble_racp_db_t const * p_db);
+
+/**@brief Function for getting the position of a record from its index.
+ *
+ * @param[in]   p_db      Database structure.
+ * @param[in]   rec_ndx   Index of the record, deleted records excluded.
+ *
+ * @return      Position of the record, or @ref ble_racp_db_pos_count_get if there is none.
+ */
+uint16_t ble_racp_db_index_to_pos(ble_racp_db_t const * p_db, uint16_t rec_ndx);
+
+/**@brief Function for finding the first position with a key not less than (or greater than) a
+ *        given key, by binary search.
+ *
+ * @details Deleted records are skipped when probing.
+ *
+ * @param[in]   p_db        Database structure.
+ * @param[in]   key_get     Function for getting the key of a record.
+ * @param[in]   p_context   Context passed to key_get.
+ * @param[in]   key         Key to look for.
+ * @param[in]   upper       TRUE to find the first position with a key greater than the given key.
+ *
+ * @return      Position found, or @ref ble_racp_db_pos_count_get if there is none. Every record
+ *              before it has a key lower than (or not greater than) the given key.
+ */
+uint16_t ble_racp_db_pos_find(ble_racp_db_t const * p_db,
+                              ble_racp_db_key_get_t key_get,
+                              void const          * p_context,
+                              int64_t               key,
+                              bool                  upper);
+
+/**@brief Function for getting the number of records in a range of positions.
+ *
+ * @param[in]   p_db        Database structure.
+ * @param[in]   first_pos   First position of the range.
+ * @param[in]   end_pos     Position following the last position of the range.
+ *
+ * @return      Number of records, deleted records excluded.
+ */
+uint16_t ble_racp_db_num_records_in_range_get(ble_racp_db_t const * p_db,
+                                              uint16_t              first_pos,
+                                              uint16_t              end_pos);
+
+#endif // BLE_RACP_DB_H__
+
+/** @} */
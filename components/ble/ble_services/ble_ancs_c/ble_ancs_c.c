@@ -22,6 +22,7 @@
 #include "nrf_assert.h"
 #include "device_manager.h"
 #include "ble_db_discovery.h"
+#include "ble_gattc_queue.h"
 #include "app_error.h"
 #include "app_trace.h"
 
@@ -36,9 +37,7 @@
 
 #define START_HANDLE_DISCOVER            0x0001                   /**< Value of start handle during discovery. */
 
-#define TX_BUFFER_MASK                   0x07                     /**< TX buffer mask. Must be a mask of contiguous zeroes followed by a contiguous sequence of ones: 000...111. */
-#define TX_BUFFER_SIZE                   (TX_BUFFER_MASK + 1)     /**< Size of send buffer, which is 1 higher than the mask. */
-#define WRITE_MESSAGE_LENGTH             20                       /**< Length of the write message for CCCD/control point. */
+#define WRITE_MESSAGE_LENGTH             20                       /**< Length of the write message for the control point. */
 #define BLE_CCCD_NOTIFY_BIT_MASK         0x0001                   /**< Enable notification bit. */
 
 #define BLE_ANCS_MAX_DISCOVERED_CENTRALS DEVICE_MANAGER_MAX_BONDS /**< Maximum number of discovered services that can be stored in the flash. This number should be identical to maximum number of bonded peer devices. */
@@ -48,14 +47,7 @@
 #define DISCOVERED_SERVICE_DB_SIZE \
     CEIL_DIV(sizeof(ble_ancs_c_service_t) * BLE_ANCS_MAX_DISCOVERED_CENTRALS, sizeof(uint32_t)) /**< Size of bonded peer's database in word size (4 byte). */
 
-
-/**@brief ANCS request types.
- */
-typedef enum
-{
-    READ_REQ = 1,  /**< Type identifying that this tx_message is a read request. */
-    WRITE_REQ      /**< Type identifying that this tx_message is a write request. */
-} ancs_tx_request_t;
+STATIC_ASSERT(WRITE_MESSAGE_LENGTH <= BLE_GATTC_QUEUE_WRITE_MAX_LEN);
 
 
 /**@brief Structure used for holding the characteristic found during the discovery process.
@@ -82,29 +74,6 @@ typedef struct
 } ble_ancs_c_service_t;
 
 
-/**@brief Structure for writing a message to the central, i.e. Control Point or CCCD.
- */
-typedef struct
-{
-    uint8_t                  gattc_value[WRITE_MESSAGE_LENGTH]; /**< The message to write. */
-    ble_gattc_write_params_t gattc_params;                      /**< GATTC parameters for this message. */
-} write_params_t;
-
-
-/**@brief Structure for holding data to be transmitted to the connected master.
- */
-typedef struct
-{
-    uint16_t          conn_handle;  /**< Connection handle to be used when transmitting this message. */
-    ancs_tx_request_t type;         /**< Type of this message, i.e. read or write message. */
-    union
-    {
-        uint16_t       read_handle; /**< Read request message. */
-        write_params_t write_req;   /**< Write request message. */
-    } req;
-} tx_message_t;
-
-
 /**@brief Parsing states for received iOS notification attributes.
  */
 typedef enum
@@ -117,10 +86,6 @@ typedef enum
     DONE                       /**< Parsing is done. */
 } ble_ancs_c_parse_state_t;
 
-static tx_message_t m_tx_buffer[TX_BUFFER_SIZE];                           /**< Transmit buffer for messages to be transmitted to the Notification Provider. */
-static uint32_t     m_tx_insert_index = 0;                                 /**< Current index in the transmit buffer where the next message should be inserted. */
-static uint32_t     m_tx_index        = 0;                                 /**< Current index in the transmit buffer from where the next message to be transmitted resides. */
-
 static ble_ancs_c_service_t   m_service;                                   /**< Current service data. */
 static ble_ancs_c_t         * mp_ble_ancs;                                 /**< Pointer to the current instance of the ANCS client module. The memory for this is provided by the application.*/
 static ble_ancs_c_attr_list_t m_ancs_attr_list[BLE_ANCS_NB_OF_ATTRS];      /**< For all attributes; contains whether they should be requested upon attribute request and the length and buffer of where to store attribute data. */
@@ -249,34 +214,6 @@ static void db_discover_evt_handler(ble_db_discovery_evt_t * p_evt)
 }
 
 
-/**@brief Function for passing any pending request from the buffer to the stack.
- */
-static void tx_buffer_process(void)
-{
-    if (m_tx_index != m_tx_insert_index)
-    {
-        uint32_t err_code;
-
-        if (m_tx_buffer[m_tx_index].type == READ_REQ)
-        {
-            err_code = sd_ble_gattc_read(m_tx_buffer[m_tx_index].conn_handle,
-                                         m_tx_buffer[m_tx_index].req.read_handle,
-                                         0);
-        }
-        else
-        {
-            err_code = sd_ble_gattc_write(m_tx_buffer[m_tx_index].conn_handle,
-                                          &m_tx_buffer[m_tx_index].req.write_req.gattc_params);
-        }
-        if (err_code == NRF_SUCCESS)
-        {
-            ++m_tx_index;
-            m_tx_index &= TX_BUFFER_MASK;
-        }
-    }
-}
-
-
 /**@brief Function for parsing received notification attribute response data.
  *
  * @details The data that comes from the Notification Provider can be much longer than what
@@ -512,14 +449,6 @@ static void on_evt_gattc_notif(ble_ancs_c_t * p_ancs, const ble_evt_t * p_ble_ev
     }
 }
 
-/**@brief Function for handling write response events.
- */
-static void on_evt_write_rsp()
-{
-    tx_buffer_process();
-}
-
-
 void ble_ancs_c_on_device_manager_evt(ble_ancs_c_t      * p_ans,
                                       dm_handle_t const * p_handle,
                                       dm_event_t const  * p_dm_evt)
@@ -545,10 +474,6 @@ void ble_ancs_c_on_ble_evt(ble_ancs_c_t * p_ancs, const ble_evt_t * p_ble_evt)
 
     switch (evt)
     {
-        case BLE_GATTC_EVT_WRITE_RSP:
-            on_evt_write_rsp();
-            break;
-
         case BLE_GATTC_EVT_HVX:
             on_evt_gattc_notif(p_ancs, p_ble_evt);
             break;
@@ -575,7 +500,6 @@ uint32_t ble_ancs_c_init(ble_ancs_c_t * p_ancs, const ble_ancs_c_init_t * p_ancs
     mp_ble_ancs->conn_handle    = BLE_CONN_HANDLE_INVALID;
 
     memset(&m_service, 0, sizeof(ble_ancs_c_service_t));
-    memset(m_tx_buffer, 0, TX_BUFFER_SIZE);
 
     m_service.handle = BLE_GATT_HANDLE_INVALID;
 
@@ -587,35 +511,21 @@ uint32_t ble_ancs_c_init(ble_ancs_c_t * p_ancs, const ble_ancs_c_init_t * p_ancs
 }
 
 
-/**@brief Function for creating a TX message for writing a CCCD.
+/**@brief Function for queuing a write to a CCCD.
  *
  * @param[in] conn_handle  Connection handle on which to perform the configuration.
  * @param[in] handle_cccd  Handle of the CCCD.
  * @param[in] enable       Enable or disable GATTC notifications.
  *
- * @retval NRF_SUCCESS              If the message was created successfully.
- * @retval NRF_ERROR_INVALID_PARAM  If one of the input parameters was invalid.
+ * @retval NRF_SUCCESS              If the write was queued successfully.
+ * @retval NRF_ERROR_INVALID_STATE  If the connection handle is invalid.
+ * @retval NRF_ERROR_NO_MEM         If the request queue of the connection is full.
  */
 static uint32_t cccd_configure(const uint16_t conn_handle, const uint16_t handle_cccd, bool enable)
 {
-    tx_message_t * p_msg;
-    uint16_t       cccd_val = enable ? BLE_CCCD_NOTIFY_BIT_MASK : 0;
-
-    p_msg              = &m_tx_buffer[m_tx_insert_index++];
-    m_tx_insert_index &= TX_BUFFER_MASK;
-
-    p_msg->req.write_req.gattc_params.handle   = handle_cccd;
-    p_msg->req.write_req.gattc_params.len      = 2;
-    p_msg->req.write_req.gattc_params.p_value  = p_msg->req.write_req.gattc_value;
-    p_msg->req.write_req.gattc_params.offset   = 0;
-    p_msg->req.write_req.gattc_params.write_op = BLE_GATT_OP_WRITE_REQ;
-    p_msg->req.write_req.gattc_value[0]        = LSB(cccd_val);
-    p_msg->req.write_req.gattc_value[1]        = MSB(cccd_val);
-    p_msg->conn_handle                         = conn_handle;
-    p_msg->type                                = WRITE_REQ;
-
-    tx_buffer_process();
-    return NRF_SUCCESS;
+    return ble_gattc_queue_cccd_write(conn_handle,
+                                      handle_cccd,
+                                      enable ? BLE_CCCD_NOTIFY_BIT_MASK : 0);
 }
 
 
@@ -650,49 +560,39 @@ uint32_t ble_ancs_c_data_source_notif_disable(const ble_ancs_c_t * p_ancs)
 uint32_t ble_ancs_get_notif_attrs(const ble_ancs_c_t * p_ancs,
                                   const uint32_t       p_uid)
 {
-    tx_message_t * p_msg;
-    uint32_t       index                    = 0;
-    uint32_t       number_of_requested_attr = 0;
-
-    p_msg              = &m_tx_buffer[m_tx_insert_index++];
-    m_tx_insert_index &= TX_BUFFER_MASK;
-
-    p_msg->req.write_req.gattc_params.handle   = m_service.control_point.handle_value;
-    p_msg->req.write_req.gattc_params.p_value  = p_msg->req.write_req.gattc_value;
-    p_msg->req.write_req.gattc_params.offset   = 0;
-    p_msg->req.write_req.gattc_params.write_op = BLE_GATT_OP_WRITE_REQ;
+    uint8_t  value[WRITE_MESSAGE_LENGTH];
+    uint32_t index                    = 0;
+    uint32_t number_of_requested_attr = 0;
 
     //Encode Command ID.
-    p_msg->req.write_req.gattc_value[index++] = BLE_ANCS_COMMAND_ID_GET_NOTIF_ATTRIBUTES;
+    value[index++] = BLE_ANCS_COMMAND_ID_GET_NOTIF_ATTRIBUTES;
     
     //Encode Notification UID.
-    index += uint32_encode(p_uid, &p_msg->req.write_req.gattc_value[index]);
+    index += uint32_encode(p_uid, &value[index]);
 
     //Encode Attribute ID.
     for (uint32_t attr = 0; attr < BLE_ANCS_NB_OF_ATTRS; attr++)
     {
         if (m_ancs_attr_list[attr].get == true)
         {
-            p_msg->req.write_req.gattc_value[index++] = attr;
+            value[index++] = attr;
             if ((attr == BLE_ANCS_NOTIF_ATTR_ID_TITLE) ||
                 (attr == BLE_ANCS_NOTIF_ATTR_ID_SUBTITLE) ||
                 (attr == BLE_ANCS_NOTIF_ATTR_ID_MESSAGE))
             {
                 //Encode Length field, only applicable for Title, Subtitle and Message
-                index += uint16_encode(m_ancs_attr_list[attr].attr_len,
-                              &p_msg->req.write_req.gattc_value[index]);
+                index += uint16_encode(m_ancs_attr_list[attr].attr_len, &value[index]);
             }
             number_of_requested_attr++;
         }
     }
-    p_msg->req.write_req.gattc_params.len = index;
-    p_msg->conn_handle                    = p_ancs->conn_handle;
-    p_msg->type                           = WRITE_REQ;
-    m_expected_number_of_attrs            = number_of_requested_attr;
+    m_expected_number_of_attrs = number_of_requested_attr;
 
-    tx_buffer_process();
-
-    return NRF_SUCCESS;
+    return ble_gattc_queue_write(p_ancs->conn_handle,
+                                 BLE_GATTC_QUEUE_REQ_WRITE,
+                                 m_service.control_point.handle_value,
+                                 value,
+                                 index);
 }
 
 
@@ -23,27 +23,20 @@
 #include "nrf_assert.h"
 #include "device_manager.h"
 #include "pstorage.h"
+#include "ble_gattc_queue.h"
 
 #define START_HANDLE_DISCOVER           0x0001                                             /**< Value of start handle during discovery. */
 
 #define NOTIFICATION_DATA_LENGTH        2                                                  /**< The mandatory length of notification data. After the mandatory data, the optional message is located. */
 #define READ_DATA_LENGTH_MIN            1                                                  /**< Minimum data length in a valid Alert Notification Read Response message. */
 
-#define TX_BUFFER_MASK                  0x07                                               /**< TX Buffer mask, must be a mask of contiguous zeroes, followed by contiguous sequence of ones: 000...111. */
-#define TX_BUFFER_SIZE                  (TX_BUFFER_MASK + 1)                               /**< Size of send buffer, which is 1 higher than the mask. */
-#define WRITE_MESSAGE_LENGTH            2                                                  /**< Length of the write message for CCCD/control point. */
+#define WRITE_MESSAGE_LENGTH            2                                                  /**< Length of the write message for the control point. */
 
 #define BLE_ANS_MAX_DISCOVERED_CENTRALS  DEVICE_MANAGER_MAX_BONDS                          /**< Maximum number of discovered services that can be stored in the flash. This number should be identical to maximum number of bonded centrals. */
 
 #define DISCOVERED_SERVICE_DB_SIZE \
     CEIL_DIV(sizeof(alert_service_t) * BLE_ANS_MAX_DISCOVERED_CENTRALS, sizeof(uint32_t))  /**< Size of bonded centrals database in word size (4 byte). */
 
-typedef enum
-{
-    READ_REQ = 1,                                                                          /**< Type identifying that this tx_message is a read request. */
-    WRITE_REQ                                                                              /**< Type identifying that this tx_message is a write request. */
-} ans_tx_request_t;
-
 typedef enum
 {
     STATE_UNINITIALIZED,                                                                   /**< Uninitialized state of the internal state machine. */
@@ -80,30 +73,6 @@ typedef struct
     alert_characteristic_t   unread_alert_status;                                          /**< Characteristic for the Unread Alert Notification. */
 } alert_service_t;
 
-/**@brief Structure for writing a message to the central, i.e. Control Point or CCCD.
- */
-typedef struct
-{
-    uint8_t                  gattc_value[WRITE_MESSAGE_LENGTH];                            /**< The message to write. */
-    ble_gattc_write_params_t gattc_params;                                                 /**< GATTC parameters for this message. */
-} write_params_t;
-
-/**@brief Structure for holding data to be transmitted to the connected central.
- */
-typedef struct
-{
-    uint16_t                 conn_handle;                                                  /**< Connection handle to be used when transmitting this message. */
-    ans_tx_request_t         type;                                                         /**< Type of this message, i.e. read or write message. */
-    union
-    {
-        uint16_t             read_handle;                                                  /**< Read request message. */
-        write_params_t       write_req;                                                    /**< Write request message. */
-    } req;
-} tx_message_t;
-
-static tx_message_t          m_tx_buffer[TX_BUFFER_SIZE];                                  /**< Transmit buffer for messages to be transmitted to the central. */
-static uint32_t              m_tx_insert_index = 0;                                        /**< Current index in the transmit buffer where next message should be inserted. */
-static uint32_t              m_tx_index = 0;                                               /**< Current index in the transmit buffer from where the next message to be transmitted resides. */
 static pstorage_handle_t     m_flash_handle;                                               /**< Flash handle where discovered services for bonded masters should be stored. */
 
 static ans_state_t           m_client_state = STATE_UNINITIALIZED;                         /**< Current state of the Alert Notification State Machine. */
@@ -114,34 +83,6 @@ static alert_service_t       m_service;
 static ble_ans_c_t *         m_ans_c_obj;                                                  /**< Pointer to the instantiated object. */
 
 
-/**@brief Function for passing any pending request from the buffer to the stack.
- */
-static void tx_buffer_process(void)
-{
-    if (m_tx_index != m_tx_insert_index)
-    {
-        uint32_t err_code;
-
-        if (m_tx_buffer[m_tx_index].type == READ_REQ)
-        {
-            err_code = sd_ble_gattc_read(m_tx_buffer[m_tx_index].conn_handle,
-                                         m_tx_buffer[m_tx_index].req.read_handle,
-                                         0);
-        }
-        else
-        {
-            err_code = sd_ble_gattc_write(m_tx_buffer[m_tx_index].conn_handle,
-                                          &m_tx_buffer[m_tx_index].req.write_req.gattc_params);
-        }
-        if (err_code == NRF_SUCCESS)
-        {
-            ++m_tx_index;
-            m_tx_index &= TX_BUFFER_MASK;
-        }
-    }
-}
-
-
 /**@brief Function for updating the current state and sending an event on discovery failure.
  */
 static void handle_discovery_failure(const ble_ans_c_t * p_ans, uint32_t code)
@@ -586,14 +527,6 @@ static void event_notify(ble_ans_c_t * p_ans, const ble_evt_t * p_ble_evt)
 }
 
 
-/**@brief Function for handling write response events.
- */
-static void event_write_rsp(ble_ans_c_t * p_ans, const ble_evt_t * p_ble_evt)
-{
-    tx_buffer_process();
-}
-
-
 /**@brief Function for validating and passing the response to the application,
  *			when a read response is received.
  */
@@ -607,7 +540,6 @@ static void event_read_rsp(ble_ans_c_t * p_ans, const ble_evt_t * p_ble_evt)
 
     if (p_response->len < READ_DATA_LENGTH_MIN)
     {
-        tx_buffer_process();
         return;
     }
 
@@ -622,7 +554,6 @@ static void event_read_rsp(ble_ans_c_t * p_ans, const ble_evt_t * p_ble_evt)
     else
     {
         // Bad response, ignore.
-        tx_buffer_process();
         return;
     }
 
@@ -636,8 +567,6 @@ static void event_read_rsp(ble_ans_c_t * p_ans, const ble_evt_t * p_ble_evt)
     }
 
     p_ans->evt_handler(&event);
-
-    tx_buffer_process();
 }
 
 
@@ -771,10 +700,6 @@ void ble_ans_c_on_ble_evt(ble_ans_c_t * p_ans, const ble_evt_t * p_ble_evt)
             {
                 event_read_rsp(p_ans, p_ble_evt);
             }
-            else if (event == BLE_GATTC_EVT_WRITE_RSP)
-            {
-                event_write_rsp(p_ans, p_ble_evt);
-            }
             else if (event == BLE_GAP_EVT_DISCONNECTED)
             {
                 event_disconnect(p_ans);
@@ -834,7 +759,6 @@ uint32_t ble_ans_c_init(ble_ans_c_t * p_ans, const ble_ans_c_init_t * p_ans_init
     m_ans_c_obj = p_ans;
 
     memset(&m_service, 0, sizeof(alert_service_t));
-    memset(m_tx_buffer, 0, TX_BUFFER_SIZE);
 
     m_service.handle = INVALID_SERVICE_HANDLE;
     m_client_state   = STATE_IDLE;
@@ -852,33 +776,18 @@ uint32_t ble_ans_c_init(ble_ans_c_t * p_ans, const ble_ans_c_init_t * p_ans_init
 }
 
 
-/**@brief Function for creating a TX message for writing a CCCD.
+/**@brief Function for queuing a write to a CCCD.
  */
 static uint32_t cccd_configure(uint16_t conn_handle, uint16_t handle_cccd, bool enable)
 {
-    tx_message_t * p_msg;
-    uint16_t       cccd_val = enable ? BLE_GATT_HVX_NOTIFICATION : 0;
-
     if (m_client_state != STATE_RUNNING)
     {
         return NRF_ERROR_INVALID_STATE;
     }
 
-    p_msg              = &m_tx_buffer[m_tx_insert_index++];
-    m_tx_insert_index &= TX_BUFFER_MASK;
-
-    p_msg->req.write_req.gattc_params.handle   = handle_cccd;
-    p_msg->req.write_req.gattc_params.len      = WRITE_MESSAGE_LENGTH;
-    p_msg->req.write_req.gattc_params.p_value  = p_msg->req.write_req.gattc_value;
-    p_msg->req.write_req.gattc_params.offset   = 0;
-    p_msg->req.write_req.gattc_params.write_op = BLE_GATT_OP_WRITE_REQ;
-    p_msg->req.write_req.gattc_value[0]        = LSB(cccd_val);
-    p_msg->req.write_req.gattc_value[1]        = MSB(cccd_val);
-    p_msg->conn_handle                         = conn_handle;
-    p_msg->type                                = WRITE_REQ;
-
-    tx_buffer_process();
-    return NRF_SUCCESS;
+    return ble_gattc_queue_cccd_write(conn_handle,
+                                      handle_cccd,
+                                      enable ? BLE_GATT_HVX_NOTIFICATION : 0);
 }
 
 
@@ -917,60 +826,34 @@ uint32_t ble_ans_c_disable_notif_unread_alert(const ble_ans_c_t * p_ans)
 uint32_t ble_ans_c_control_point_write(const ble_ans_c_t             * p_ans,
                                        const ble_ans_control_point_t * p_control_point)
 {
-    tx_message_t * p_msg;
+    uint8_t value[WRITE_MESSAGE_LENGTH];
 
     if (m_client_state != STATE_RUNNING)
     {
         return NRF_ERROR_INVALID_STATE;
     }
 
-    p_msg              = &m_tx_buffer[m_tx_insert_index++];
-    m_tx_insert_index &= TX_BUFFER_MASK;
-
-    p_msg->req.write_req.gattc_params.handle   = m_service.alert_notif_ctrl_point.handle_value;
-    p_msg->req.write_req.gattc_params.len      = WRITE_MESSAGE_LENGTH;
-    p_msg->req.write_req.gattc_params.p_value  = p_msg->req.write_req.gattc_value;
-    p_msg->req.write_req.gattc_params.offset   = 0;
-    p_msg->req.write_req.gattc_params.write_op = BLE_GATT_OP_WRITE_REQ;
-    p_msg->req.write_req.gattc_value[0]        = p_control_point->command;
-    p_msg->req.write_req.gattc_value[1]        = p_control_point->category;
-    p_msg->conn_handle                         = p_ans->conn_handle;
-    p_msg->type                                = WRITE_REQ;
-
-    tx_buffer_process();
-    return NRF_SUCCESS;
+    value[0] = p_control_point->command;
+    value[1] = p_control_point->category;
+
+    return ble_gattc_queue_write(p_ans->conn_handle,
+                                 BLE_GATTC_QUEUE_REQ_WRITE,
+                                 m_service.alert_notif_ctrl_point.handle_value,
+                                 value,
+                                 WRITE_MESSAGE_LENGTH);
 }
 
 
 uint32_t ble_ans_c_new_alert_read(const ble_ans_c_t * p_ans)
 {
-    tx_message_t * msg;
-
-    msg                = &m_tx_buffer[m_tx_insert_index++];
-    m_tx_insert_index &= TX_BUFFER_MASK;
-
-    msg->req.read_handle = m_service.suported_new_alert_cat.handle_value;
-    msg->conn_handle     = p_ans->conn_handle;
-    msg->type            = READ_REQ;
-
-    tx_buffer_process();
-    return NRF_SUCCESS;
+    return ble_gattc_queue_read(p_ans->conn_handle, m_service.suported_new_alert_cat.handle_value);
 }
 
 
 uint32_t ble_ans_c_unread_alert_read(const ble_ans_c_t * p_ans)
 {
-    tx_message_t * msg;
-
-    msg                = &m_tx_buffer[m_tx_insert_index++];
-    m_tx_insert_index &= TX_BUFFER_MASK;
-
-    msg->req.read_handle = m_service.suported_unread_alert_cat.handle_value;
-    msg->conn_handle     = p_ans->conn_handle;
-    msg->type            = READ_REQ;
-
-    tx_buffer_process();
-    return NRF_SUCCESS;
+    return ble_gattc_queue_read(p_ans->conn_handle,
+                                m_service.suported_unread_alert_cat.handle_value);
 }
 
 
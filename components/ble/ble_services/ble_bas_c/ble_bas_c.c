@@ -14,92 +14,15 @@
 #include "ble_srv_common.h"
 #include "nrf_error.h"
 #include "ble_gattc.h"
+#include "ble_gattc_queue.h"
 #include "app_util.h"
 #include "nordic_common.h"
 #include "app_trace.h"
 
 #define LOG                  app_trace_log         /**< Debug logger macro that will be used in this file to do logging of important information over UART. */
-#define TX_BUFFER_MASK       0x07                  /**< TX Buffer mask, must be a mask of contiguous zeroes, followed by contiguous sequence of ones: 000...111. */
-#define TX_BUFFER_SIZE       (TX_BUFFER_MASK + 1)  /**< Size of the send buffer, which is 1 higher than the mask. */
-#define WRITE_MESSAGE_LENGTH BLE_CCCD_VALUE_LEN    /**< Length of the write message for CCCD. */
-
-typedef enum
-{
-    READ_REQ,      /**< Type identifying that this tx_message is a read request. */
-    WRITE_REQ      /**< Type identifying that this tx_message is a write request. */
-} tx_request_t;
-
-/**@brief Structure for writing a message to the peer, i.e. CCCD.
- */
-typedef struct
-{
-    uint8_t                  gattc_value[WRITE_MESSAGE_LENGTH];  /**< The message to write. */
-    ble_gattc_write_params_t gattc_params;                       /**< The GATTC parameters for this message. */
-} write_params_t;
-
-/**@brief Structure for holding the data that will be transmitted to the connected central.
- */
-typedef struct
-{
-    uint16_t     conn_handle;  /**< Connection handle to be used when transmitting this message. */
-    tx_request_t type;         /**< Type of message. (read or write). */
-    union
-    {
-        uint16_t       read_handle;  /**< Read request handle. */
-        write_params_t write_req;    /**< Write request message. */
-    } req;
-} tx_message_t;
 
 
 static ble_bas_c_t * mp_ble_bas_c;                 /**< Pointer to the current instance of the BAS Client module. The memory for this is provided by the application.*/
-static tx_message_t  m_tx_buffer[TX_BUFFER_SIZE];  /**< Transmit buffer for the messages that will be transmitted to the central. */
-static uint32_t      m_tx_insert_index = 0;        /**< Current index in the transmit buffer where the next message should be inserted. */
-static uint32_t      m_tx_index        = 0;        /**< Current index in the transmit buffer containing the next message to be transmitted. */
-
-/**@brief Function for passing any pending request from the buffer to the stack.
- */
-static void tx_buffer_process(void)
-{
-    if (m_tx_index != m_tx_insert_index)
-    {
-        uint32_t err_code;
-
-        if (m_tx_buffer[m_tx_index].type == READ_REQ)
-        {
-            err_code = sd_ble_gattc_read(m_tx_buffer[m_tx_index].conn_handle,
-                                         m_tx_buffer[m_tx_index].req.read_handle,
-                                         0);
-        }
-        else
-        {
-            err_code = sd_ble_gattc_write(m_tx_buffer[m_tx_index].conn_handle,
-                                          &m_tx_buffer[m_tx_index].req.write_req.gattc_params);
-        }
-        if (err_code == NRF_SUCCESS)
-        {
-            LOG("[BAS_C]: SD Read/Write API returns Success..\r\n");
-            m_tx_index++;
-            m_tx_index &= TX_BUFFER_MASK;
-        }
-        else
-        {
-            LOG("[BAS_C]: SD Read/Write API returns error. This message sending will be "
-                "attempted again..\r\n");
-        }
-    }
-}
-
-
-/**@brief Function for handling write response events.
- *
- * @param[in] p_bas_c   Pointer to the Battery Service Client Structure.
- * @param[in] p_ble_evt Pointer to the SoftDevice event.
- */
-static void on_write_rsp(ble_bas_c_t * p_bas_c, const ble_evt_t * p_ble_evt)
-{
-    // Check if there is any message to be sent across to the peer and send it.
-    tx_buffer_process();
-}
 
 
 /**@brief     Function for handling read response events.
@@ -126,8 +49,6 @@ static void on_read_rsp(ble_bas_c_t * p_bas_c, const ble_evt_t * p_ble_evt)
 
         p_bas_c->evt_handler(p_bas_c, &evt);
     }
-    // Check if there is any buffered transmissions and send them.
-    tx_buffer_process();
 }
 
 
@@ -211,31 +132,16 @@ static void db_discovery_evt_handler(ble_db_discovery_evt_t * p_evt)
 }
 
 
-/**@brief Function for creating a message for writing to the CCCD.
+/**@brief Function for queuing a write to the CCCD.
  */
 static uint32_t cccd_configure(uint16_t conn_handle, uint16_t handle_cccd, bool notification_enable)
 {
     LOG("[BAS_C]: Configuring CCCD. CCCD Handle = %d, Connection Handle = %d\r\n",
                                                             handle_cccd,conn_handle);
 
-    tx_message_t * p_msg;
-    uint16_t       cccd_val = notification_enable ? BLE_GATT_HVX_NOTIFICATION : 0;
-
-    p_msg              = &m_tx_buffer[m_tx_insert_index++];
-    m_tx_insert_index &= TX_BUFFER_MASK;
-
-    p_msg->req.write_req.gattc_params.handle   = handle_cccd;
-    p_msg->req.write_req.gattc_params.len      = WRITE_MESSAGE_LENGTH;
-    p_msg->req.write_req.gattc_params.p_value  = p_msg->req.write_req.gattc_value;
-    p_msg->req.write_req.gattc_params.offset   = 0;
-    p_msg->req.write_req.gattc_params.write_op = BLE_GATT_OP_WRITE_REQ;
-    p_msg->req.write_req.gattc_value[0]        = LSB(cccd_val);
-    p_msg->req.write_req.gattc_value[1]        = MSB(cccd_val);
-    p_msg->conn_handle                         = conn_handle;
-    p_msg->type                                = WRITE_REQ;
-
-    tx_buffer_process();
-    return NRF_SUCCESS;
+    return ble_gattc_queue_cccd_write(conn_handle,
+                                      handle_cccd,
+                                      notification_enable ? BLE_GATT_HVX_NOTIFICATION : 0);
 }
 
 
@@ -280,10 +186,6 @@ void ble_bas_c_on_ble_evt(ble_bas_c_t * p_ble_bas_c, const ble_evt_t * p_ble_evt
             on_hvx(p_ble_bas_c, p_ble_evt);
             break;
 
-        case BLE_GATTC_EVT_WRITE_RSP:
-            on_write_rsp(p_ble_bas_c, p_ble_evt);
-            break;
-
         case BLE_GATTC_EVT_READ_RSP:
             on_read_rsp(p_ble_bas_c, p_ble_evt);
             break;
@@ -307,15 +209,10 @@ uint32_t ble_bas_c_bl_notif_enable(ble_bas_c_t * p_ble_bas_c)
 
 uint32_t ble_bas_c_bl_read(ble_bas_c_t * p_ble_bas_c)
 {
-    tx_message_t * msg;
-
-    msg                  = &m_tx_buffer[m_tx_insert_index++];
-    m_tx_insert_index   &= TX_BUFFER_MASK;
-
-    msg->req.read_handle = p_ble_bas_c->bl_handle;
-    msg->conn_handle     = p_ble_bas_c->conn_handle;
-    msg->type            = READ_REQ;
+    if (p_ble_bas_c == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
 
-    tx_buffer_process();
-    return NRF_SUCCESS;
+    return ble_gattc_queue_read(p_ble_bas_c->conn_handle, p_ble_bas_c->bl_handle);
 }
@@ -0,0 +1,508 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ */
+
+/* The Blood Pressure Record Service is a vendor specific service. Its CCCDs and Record Access
+ * Control Point are writable without encryption, like the other services of the relay example.
+ */
+
+#include "ble_bprs.h"
+#include <string.h>
+#include "nordic_common.h"
+#include "ble_l2cap.h"
+#include "app_util.h"
+
+
+#define BPRS_BASE_UUID                       {{0x3C, 0x1A, 0x7B, 0x52, 0x8E, 0x04, 0x6D, 0x9F, 0x41, 0x4B, 0x5E, 0x27, 0x00, 0x00, 0xB2, 0x1D}} /**< Used vendor specific UUID. */
+
+#define OPERAND_FILTER_SEQ_NUM_LEN           2                           /**< Length of a sequence number filter value. */
+
+#define BPRS_NACK_PROC_ALREADY_IN_PROGRESS   BLE_GATT_STATUS_ATTERR_APP_BEGIN + 0 /**< Reply when a requested procedure is already in progress. */
+#define BPRS_NACK_CCCD_IMPROPERLY_CONFIGURED BLE_GATT_STATUS_ATTERR_APP_BEGIN + 1 /**< Reply when a CCCD is improperly configured. */
+
+
+/**@brief Function for adding the Stored Blood Pressure Measurement characteristic.
+ *
+ * @param[in] p_bprs  Service instance.
+ *
+ * @return NRF_SUCCESS if characteristic was successfully added, otherwise an error code.
+ */
+static uint32_t stored_bpm_char_add(ble_bprs_t * p_bprs)
+{
+    ble_gatts_char_md_t char_md;
+    ble_gatts_attr_md_t cccd_md;
+    ble_gatts_attr_t    attr_char_value;
+    ble_uuid_t          ble_uuid;
+    ble_gatts_attr_md_t attr_md;
+
+    memset(&cccd_md, 0, sizeof(cccd_md));
+
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&cccd_md.read_perm);
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&cccd_md.write_perm);
+    cccd_md.vloc = BLE_GATTS_VLOC_STACK;
+
+    memset(&char_md, 0, sizeof(char_md));
+
+    char_md.char_props.notify = 1;
+    char_md.p_char_user_desc  = NULL;
+    char_md.p_char_pf         = NULL;
+    char_md.p_user_desc_md    = NULL;
+    char_md.p_cccd_md         = &cccd_md;
+    char_md.p_sccd_md         = NULL;
+
+    ble_uuid.type = p_bprs->uuid_type;
+    ble_uuid.uuid = BLE_UUID_BPRS_STORED_BPM_CHAR;
+
+    memset(&attr_md, 0, sizeof(attr_md));
+
+    BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(&attr_md.read_perm);
+    BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(&attr_md.write_perm);
+
+    attr_md.vloc    = BLE_GATTS_VLOC_STACK;
+    attr_md.rd_auth = 0;
+    attr_md.wr_auth = 0;
+    attr_md.vlen    = 1;
+
+    memset(&attr_char_value, 0, sizeof(attr_char_value));
+
+    attr_char_value.p_uuid    = &ble_uuid;
+    attr_char_value.p_attr_md = &attr_md;
+    attr_char_value.init_len  = 0;
+    attr_char_value.init_offs = 0;
+    attr_char_value.max_len   = BLE_BPRS_STORED_BPM_MAX_LEN;
+    attr_char_value.p_value   = NULL;
+
+    return sd_ble_gatts_characteristic_add(p_bprs->service_handle,
+                                           &char_md,
+                                           &attr_char_value,
+                                           &p_bprs->bpm_handles);
+}
+
+
+/**@brief Function for adding the characteristic for a record access control point.
+ *
+ * @param[in] p_bprs  Service instance.
+ *
+ * @return NRF_SUCCESS if characteristic was successfully added, otherwise an error code.
+ */
+static uint32_t record_access_control_point_char_add(ble_bprs_t * p_bprs)
+{
+    ble_gatts_char_md_t char_md;
+    ble_gatts_attr_md_t cccd_md;
+    ble_gatts_attr_t    attr_char_value;
+    ble_uuid_t          ble_uuid;
+    ble_gatts_attr_md_t attr_md;
+
+    memset(&cccd_md, 0, sizeof(cccd_md));
+
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&cccd_md.read_perm);
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&cccd_md.write_perm);
+    cccd_md.vloc = BLE_GATTS_VLOC_STACK;
+
+    memset(&char_md, 0, sizeof(char_md));
+
+    char_md.char_props.indicate = 1;
+    char_md.char_props.write    = 1;
+    char_md.p_char_user_desc    = NULL;
+    char_md.p_char_pf           = NULL;
+    char_md.p_user_desc_md      = NULL;
+    char_md.p_cccd_md           = &cccd_md;
+    char_md.p_sccd_md           = NULL;
+
+    BLE_UUID_BLE_ASSIGN(ble_uuid, BLE_UUID_RECORD_ACCESS_CONTROL_POINT_CHAR);
+
+    memset(&attr_md, 0, sizeof(attr_md));
+
+    BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(&attr_md.read_perm);
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&attr_md.write_perm);
+
+    attr_md.vloc    = BLE_GATTS_VLOC_STACK;
+    attr_md.rd_auth = 0;
+    attr_md.wr_auth = 1;
+    attr_md.vlen    = 1;
+
+    memset(&attr_char_value, 0, sizeof(attr_char_value));
+
+    attr_char_value.p_uuid    = &ble_uuid;
+    attr_char_value.p_attr_md = &attr_md;
+    attr_char_value.init_len  = 0;
+    attr_char_value.init_offs = 0;
+    attr_char_value.max_len   = BLE_L2CAP_MTU_DEF;
+    attr_char_value.p_value   = 0;
+
+    return sd_ble_gatts_characteristic_add(p_bprs->service_handle,
+                                           &char_md,
+                                           &attr_char_value,
+                                           &p_bprs->racp_handles);
+}
+
+
+/**@brief Function for sending the blood pressure record at a database position.
+ *
+ * @details Record access engine backend function.
+ *
+ * @param[in] p_context  Service instance.
+ * @param[in] pos        Database position.
+ *
+ * @return NRF_SUCCESS on success, otherwise an error code.
+ */
+static uint32_t racp_record_send(void * p_context, uint16_t pos)
+{
+    ble_bprs_t           * p_bprs = (ble_bprs_t *)p_context;
+    uint32_t               err_code;
+    ble_bprs_rec_t         rec;
+    uint8_t                encoded_bpm[BLE_BPRS_STORED_BPM_MAX_LEN];
+    uint16_t               len;
+    uint16_t               hvx_len;
+    ble_gatts_hvx_params_t hvx_params;
+
+    err_code = ble_bprs_db_pos_record_get(pos, &rec);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    len = uint16_encode(rec.sequence_number, encoded_bpm);
+    memcpy(&encoded_bpm[len], rec.data, rec.len);
+    len    += rec.len;
+    hvx_len = len;
+
+    memset(&hvx_params, 0, sizeof(hvx_params));
+
+    hvx_params.handle = p_bprs->bpm_handles.value_handle;
+    hvx_params.type   = BLE_GATT_HVX_NOTIFICATION;
+    hvx_params.offset = 0;
+    hvx_params.p_len  = &hvx_len;
+    hvx_params.p_data = encoded_bpm;
+
+    err_code = sd_ble_gatts_hvx(p_bprs->conn_handle, &hvx_params);
+    if ((err_code == NRF_SUCCESS) && (hvx_len != len))
+    {
+        err_code = NRF_ERROR_DATA_SIZE;
+    }
+
+    return err_code;
+}
+
+
+/**@brief Function for getting the length of a filter value.
+ *
+ * @details Record access engine backend function. Only the sequence number filter is supported.
+ *
+ * @param[in] filter_type  Filter type.
+ *
+ * @return Length of the filter value, 0 if the filter type is not supported.
+ */
+static uint8_t racp_filter_value_len_get(uint8_t filter_type)
+{
+    return (filter_type == RACP_FILTER_TYPE_SEQ_NUM) ? OPERAND_FILTER_SEQ_NUM_LEN : 0;
+}
+
+
+/**@brief Function for finding the first database position matching a sequence number.
+ *
+ * @details Record access engine backend function.
+ *
+ * @param[in] filter_type  RACP_FILTER_TYPE_SEQ_NUM.
+ * @param[in] p_value      Encoded sequence number.
+ * @param[in] upper        TRUE to find the first position following the record with the sequence
+ *                         number.
+ *
+ * @return Position found.
+ */
+static uint16_t racp_filter_pos_find(uint8_t filter_type, uint8_t const * p_value, bool upper)
+{
+    UNUSED_PARAMETER(filter_type);
+
+    return ble_bprs_db_seq_num_pos_find(uint16_decode(p_value), upper);
+}
+
+
+/**@brief Function for checking the values of a RANGE filter.
+ *
+ * @details Record access engine backend function. Sequence numbers wrap around, so the maximum
+ *          must be within the half range following the minimum.
+ *
+ * @param[in] filter_type  RACP_FILTER_TYPE_SEQ_NUM.
+ * @param[in] p_min        Encoded minimum sequence number.
+ * @param[in] p_max        Encoded maximum sequence number.
+ *
+ * @return FALSE if the minimum sequence number is greater than the maximum one.
+ */
+static bool racp_filter_range_is_valid(uint8_t filter_type, uint8_t const * p_min, uint8_t const * p_max)
+{
+    UNUSED_PARAMETER(filter_type);
+
+    return (int16_t)(uint16_decode(p_max) - uint16_decode(p_min)) >= 0;
+}
+
+
+static const ble_racp_backend_t m_racp_backend =
+{
+    .pos_count_get            = ble_bprs_db_pos_count_get,
+    .record_send              = racp_record_send,
+    .num_records_in_range_get = ble_bprs_db_num_records_in_range_get,
+    .filter_value_len_get     = racp_filter_value_len_get,
+    .filter_pos_find          = racp_filter_pos_find,
+    .filter_range_is_valid    = racp_filter_range_is_valid
+};                                                                      /**< Blood pressure record database backend of the record access engine. */
+
+
+/**@brief Function for checking if the CCCDs are configured.
+ *
+ * @param[in]  p_bprs                 Service instance.
+ * @param[out] p_are_cccd_configured  TRUE if both CCCDs are configured.
+ *
+ * @return NRF_SUCCESS on success, otherwise an error code.
+ */
+static uint32_t cccd_configured_check(ble_bprs_t * p_bprs, bool * p_are_cccd_configured)
+{
+    uint32_t          err_code;
+    uint8_t           cccd_value_buf[BLE_CCCD_VALUE_LEN];
+    bool              is_bpm_notif_enabled;
+    ble_gatts_value_t gatts_value;
+
+    memset(&gatts_value, 0, sizeof(gatts_value));
+
+    gatts_value.len     = BLE_CCCD_VALUE_LEN;
+    gatts_value.offset  = 0;
+    gatts_value.p_value = cccd_value_buf;
+
+    err_code = sd_ble_gatts_value_get(p_bprs->conn_handle,
+                                      p_bprs->bpm_handles.cccd_handle,
+                                      &gatts_value);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+    is_bpm_notif_enabled = ble_srv_is_notification_enabled(cccd_value_buf);
+
+    err_code = sd_ble_gatts_value_get(p_bprs->conn_handle,
+                                      p_bprs->racp_handles.cccd_handle,
+                                      &gatts_value);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    *p_are_cccd_configured = is_bpm_notif_enabled &&
+                             ble_srv_is_indication_enabled(cccd_value_buf);
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for replying to a write authorization request.
+ *
+ * @param[in] p_bprs       Service instance.
+ * @param[in] gatt_status  GATT status of the reply.
+ *
+ * @return NRF_SUCCESS on success, otherwise an error code.
+ */
+static uint32_t write_authorize_reply(ble_bprs_t * p_bprs, uint16_t gatt_status)
+{
+    ble_gatts_rw_authorize_reply_params_t auth_reply;
+
+    memset(&auth_reply, 0, sizeof(auth_reply));
+
+    auth_reply.type                     = BLE_GATTS_AUTHORIZE_TYPE_WRITE;
+    auth_reply.params.write.gatt_status = gatt_status;
+
+    return sd_ble_gatts_rw_authorize_reply(p_bprs->conn_handle, &auth_reply);
+}
+
+
+/**@brief Function for handling a write event to the Record Access Control Point.
+ *
+ * @param[in] p_bprs       Service instance.
+ * @param[in] p_evt_write  WRITE event to be handled.
+ */
+static void on_racp_value_write(ble_bprs_t * p_bprs, ble_gatts_evt_write_t * p_evt_write)
+{
+    ble_racp_value_t racp_request;
+    bool             are_cccd_configured;
+    bool             is_accepted = false;
+    uint16_t         gatt_status;
+    uint32_t         err_code;
+
+    err_code = cccd_configured_check(p_bprs, &are_cccd_configured);
+    if (err_code == NRF_SUCCESS)
+    {
+        if (!are_cccd_configured)
+        {
+            gatt_status = BPRS_NACK_CCCD_IMPROPERLY_CONFIGURED;
+        }
+        else
+        {
+            ble_racp_decode(p_evt_write->len, p_evt_write->data, &racp_request);
+
+            is_accepted = ble_racp_engine_request_check(&p_bprs->racp_engine, &racp_request);
+            gatt_status = is_accepted ? BLE_GATT_STATUS_SUCCESS : BPRS_NACK_PROC_ALREADY_IN_PROGRESS;
+        }
+
+        err_code = write_authorize_reply(p_bprs, gatt_status);
+    }
+
+    if (err_code != NRF_SUCCESS)
+    {
+        if (p_bprs->error_handler != NULL)
+        {
+            p_bprs->error_handler(err_code);
+        }
+        return;
+    }
+
+    if (is_accepted)
+    {
+        // Execute request, or respond with error code.
+        ble_racp_engine_request_execute(&p_bprs->racp_engine, &racp_request);
+    }
+}
+
+
+/**@brief Function for handling the Read/Write Authorization Request event.
+ *
+ * @param[in] p_bprs       Service instance.
+ * @param[in] p_gatts_evt  GATTS event to be handled.
+ */
+static void on_rw_authorize_request(ble_bprs_t * p_bprs, ble_gatts_evt_t * p_gatts_evt)
+{
+    ble_gatts_evt_rw_authorize_request_t * p_auth_req = &p_gatts_evt->params.authorize_request;
+
+    if (   (p_auth_req->type == BLE_GATTS_AUTHORIZE_TYPE_WRITE)
+        && (p_auth_req->request.write.op != BLE_GATTS_OP_PREP_WRITE_REQ)
+        && (p_auth_req->request.write.op != BLE_GATTS_OP_EXEC_WRITE_REQ_NOW)
+        && (p_auth_req->request.write.op != BLE_GATTS_OP_EXEC_WRITE_REQ_CANCEL)
+        && (p_auth_req->request.write.handle == p_bprs->racp_handles.value_handle)
+       )
+    {
+        on_racp_value_write(p_bprs, &p_auth_req->request.write);
+    }
+}
+
+
+uint32_t ble_bprs_init(ble_bprs_t * p_bprs, const ble_bprs_init_t * p_bprs_init)
+{
+    uint32_t               err_code;
+    ble_uuid_t             ble_uuid;
+    ble_uuid128_t          bprs_base_uuid = BPRS_BASE_UUID;
+    ble_racp_engine_init_t engine_init;
+
+    if ((p_bprs == NULL) || (p_bprs_init == NULL))
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    // Initialize data base
+    err_code = ble_bprs_db_init();
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    // Initialize service structure
+    p_bprs->error_handler = p_bprs_init->error_handler;
+    p_bprs->conn_handle   = BLE_CONN_HANDLE_INVALID;
+
+    // Add service
+    err_code = sd_ble_uuid_vs_add(&bprs_base_uuid, &p_bprs->uuid_type);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    ble_uuid.type = p_bprs->uuid_type;
+    ble_uuid.uuid = BLE_UUID_BPRS_SERVICE;
+
+    err_code = sd_ble_gatts_service_add(BLE_GATTS_SRVC_TYPE_PRIMARY, &ble_uuid, &p_bprs->service_handle);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    // Add stored blood pressure measurement characteristic
+    err_code = stored_bpm_char_add(p_bprs);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    // Add record control access point characteristic
+    err_code = record_access_control_point_char_add(p_bprs);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    // Initialize record access engine
+    engine_init.p_backend         = &m_racp_backend;
+    engine_init.p_context         = p_bprs;
+    engine_init.error_handler     = p_bprs->error_handler;
+    engine_init.racp_value_handle = p_bprs->racp_handles.value_handle;
+
+    return ble_racp_engine_init(&p_bprs->racp_engine, &engine_init);
+}
+
+
+void ble_bprs_on_ble_evt(ble_bprs_t * p_bprs, ble_evt_t * p_ble_evt)
+{
+    // Connection, TX_COMPLETE and HVC events drive the RACP procedures.
+    ble_racp_engine_on_ble_evt(&p_bprs->racp_engine, p_ble_evt);
+
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GAP_EVT_CONNECTED:
+#ifdef S130
+            if (p_ble_evt->evt.gap_evt.params.connected.role == BLE_GAP_ROLE_PERIPH)
+            {
+                p_bprs->conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
+            }
+#else
+            p_bprs->conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
+#endif
+            break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            if (p_ble_evt->evt.gap_evt.conn_handle == p_bprs->conn_handle)
+            {
+                p_bprs->conn_handle = BLE_CONN_HANDLE_INVALID;
+            }
+            break;
+
+        case BLE_GATTS_EVT_RW_AUTHORIZE_REQUEST:
+            on_rw_authorize_request(p_bprs, &p_ble_evt->evt.gatts_evt);
+            break;
+
+        default:
+            // No implementation needed.
+            break;
+    }
+}
+
+
+uint32_t ble_bprs_meas_store(ble_bprs_t * p_bprs, uint8_t const * p_meas, uint8_t len)
+{
+    ble_bprs_rec_t rec;
+
+    UNUSED_PARAMETER(p_bprs);
+
+    if (len > BLE_BPRS_MEAS_MAX_LEN)
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    memset(&rec, 0, sizeof(rec));
+
+    rec.sequence_number = ble_bprs_db_next_seq_num_get();
+    rec.len             = len;
+    memcpy(rec.data, p_meas, len);
+
+    return ble_bprs_db_record_add(&rec);
+}
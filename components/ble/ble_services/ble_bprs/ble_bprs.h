@@ -0,0 +1,112 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ */
+
+/** @file
+ *
+ * @defgroup ble_sdk_srv_bprs Blood Pressure Record Service
+ * @{
+ * @ingroup ble_sdk_srv
+ * @brief Blood Pressure Record Service module.
+ *
+ * @details This module implements a vendor specific service which stores Blood Pressure
+ *          Measurements in flash, and lets the peer retrieve them through a Record Access Control
+ *          Point. It is meant for a device relaying measurements from a blood pressure sensor,
+ *          so that measurements received while no peer is connected are not lost.
+ *
+ *          Stored records are sent as notifications of the Stored Blood Pressure Measurement
+ *          characteristic. Each notification holds the sequence number of the record (2 bytes,
+ *          little endian) followed by the measurement as received from the sensor.
+ *
+ *          The Record Access Control Point supports the Report Stored Records, Report Number of
+ *          Stored Records and Abort Operation op codes, with the sequence number filter.
+ *
+ * @note    The application must propagate BLE stack events to the Blood Pressure Record Service
+ *          module by calling ble_bprs_on_ble_evt() from the @ref softdevice_handler callback, and
+ *          system events to @ref pstorage_sys_event_handler.
+ */
+
+#ifndef BLE_BPRS_H__
+#define BLE_BPRS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble.h"
+#include "ble_srv_common.h"
+#include "ble_racp.h"
+#include "ble_bprs_db.h"
+
+#define BLE_UUID_BPRS_SERVICE             0x0001                        /**< The UUID of the Blood Pressure Record Service. */
+#define BLE_UUID_BPRS_STORED_BPM_CHAR     0x0002                        /**< The UUID of the Stored Blood Pressure Measurement characteristic. */
+
+#define BLE_BPRS_STORED_BPM_MAX_LEN       (sizeof(uint16_t) + BLE_BPRS_MEAS_MAX_LEN) /**< Maximum length of a Stored Blood Pressure Measurement. */
+
+/**@brief Blood Pressure Record Service init structure. This contains all options and data needed
+ *        for initialization of the service. */
+typedef struct
+{
+    ble_srv_error_handler_t error_handler;                              /**< Function to be called in case of an error. */
+} ble_bprs_init_t;
+
+/**@brief Blood Pressure Record Service structure. This contains various status information for
+ *        the service. */
+typedef struct
+{
+    ble_srv_error_handler_t  error_handler;                             /**< Function to be called in case of an error. */
+    uint8_t                  uuid_type;                                 /**< UUID type of the Blood Pressure Record Service base UUID. */
+    uint16_t                 service_handle;                            /**< Handle of Blood Pressure Record Service (as provided by the BLE stack). */
+    ble_gatts_char_handles_t bpm_handles;                               /**< Handles related to the Stored Blood Pressure Measurement characteristic. */
+    ble_gatts_char_handles_t racp_handles;                              /**< Handles related to the Record Access Control Point characteristic. */
+    uint16_t                 conn_handle;                               /**< Handle of the current connection (as provided by the BLE stack, is BLE_CONN_HANDLE_INVALID if not in a connection). */
+    ble_racp_engine_t        racp_engine;                               /**< Record access engine executing the RACP requests. */
+} ble_bprs_t;
+
+/**@brief Function for initializing the Blood Pressure Record Service.
+ *
+ * @details This call initializes the record database, and allocates the service and its
+ *          characteristics in the BLE stack.
+ *
+ * @param[out]  p_bprs       Blood Pressure Record Service structure. This structure will have to
+ *                           be supplied by the application. It will be initialized by this
+ *                           function, and will later be used to identify this particular service
+ *                           instance.
+ * @param[in]   p_bprs_init  Information needed to initialize the service.
+ *
+ * @return      NRF_SUCCESS on successful initialization of service, otherwise an error code.
+ */
+uint32_t ble_bprs_init(ble_bprs_t * p_bprs, const ble_bprs_init_t * p_bprs_init);
+
+/**@brief Function for handling the Application's BLE Stack events.
+ *
+ * @details Handles all events from the BLE stack of interest to the Blood Pressure Record Service.
+ *
+ * @param[in]   p_bprs      Blood Pressure Record Service structure.
+ * @param[in]   p_ble_evt   Event received from the BLE stack.
+ */
+void ble_bprs_on_ble_evt(ble_bprs_t * p_bprs, ble_evt_t * p_ble_evt);
+
+/**@brief Function for storing a new Blood Pressure Measurement.
+ *
+ * @details The measurement is given the next sequence number and added to the record database.
+ *          It is not sent to the peer, which retrieves it through the Record Access Control Point.
+ *
+ * @param[in]   p_bprs   Blood Pressure Record Service structure.
+ * @param[in]   p_meas   Encoded Blood Pressure Measurement.
+ * @param[in]   len      Length of the encoded measurement.
+ *
+ * @return      NRF_SUCCESS on success, NRF_ERROR_INVALID_LENGTH if the measurement is longer than
+ *              @ref BLE_BPRS_MEAS_MAX_LEN, otherwise an error code returned by
+ *              @ref ble_bprs_db_record_add.
+ */
+uint32_t ble_bprs_meas_store(ble_bprs_t * p_bprs, uint8_t const * p_meas, uint8_t len);
+
+#endif // BLE_BPRS_H__
+
+/** @} */
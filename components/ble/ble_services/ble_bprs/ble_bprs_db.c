@@ -0,0 +1,178 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ */
+
+#include "ble_bprs_db.h"
+#include <stddef.h>
+#include "nrf_error.h"
+#include "app_util.h"
+#include "nordic_common.h"
+#include "ble_racp_db.h"
+
+
+STATIC_ASSERT(BLE_RACP_DB_ENTRY_SIZE(sizeof(ble_bprs_rec_t)) <= BLE_BPRS_DB_BLOCK_SIZE);
+
+static pstorage_handle_t m_storage_handle;                               /**< Base handle of the database slots. */
+static ble_racp_db_t     m_db;                                           /**< Flash ring holding the records. */
+static uint16_t          m_next_seq_num;                                 /**< Sequence number of the next blood pressure record. */
+static uint32_t          m_store_buf[BLE_RACP_DB_STORE_BUF_WORDS(sizeof(ble_bprs_rec_t),
+                                                                 BLE_BPRS_DB_STORE_QUEUE_SIZE)]; /**< Records waiting to be written to flash. */
+
+
+/**@brief Function for getting the sequence number of a record, relative to the oldest record.
+ *
+ * @details Sequence numbers wrap around, so they are compared relative to the oldest record.
+ *
+ * @param[in]   p_rec       Record.
+ * @param[in]   p_context   Sequence number of the oldest record.
+ *
+ * @return      Distance from the oldest record.
+ */
+static int64_t rec_seq_num_key_get(void const * p_rec, void const * p_context)
+{
+    uint16_t oldest_seq_num = *(uint16_t const *)p_context;
+
+    return (uint16_t)(((ble_bprs_rec_t const *)p_rec)->sequence_number - oldest_seq_num);
+}
+
+
+/**@brief Function for handling persistent storage events.
+ *
+ * @param[in] p_handle  Identifies the flash block the operation was on.
+ * @param[in] op_code   Identifies the operation.
+ * @param[in] result    Result of the operation.
+ * @param[in] p_data    Data written.
+ * @param[in] data_len  Length of the data written.
+ */
+static void db_pstorage_cb_handler(pstorage_handle_t * p_handle,
+                                   uint8_t             op_code,
+                                   uint32_t            result,
+                                   uint8_t           * p_data,
+                                   uint32_t            data_len)
+{
+    UNUSED_PARAMETER(data_len);
+
+    ble_racp_db_on_pstorage_evt(&m_db, p_handle, op_code, result, p_data);
+}
+
+
+uint32_t ble_bprs_db_init(void)
+{
+    uint32_t                err_code;
+    pstorage_module_param_t param;
+    ble_racp_db_init_t      db_init;
+    ble_bprs_rec_t const  * p_newest;
+
+    param.block_size  = BLE_BPRS_DB_BLOCK_SIZE;
+    param.block_count = BLE_BPRS_DB_MAX_RECORDS;
+    param.cb          = db_pstorage_cb_handler;
+
+    err_code = pstorage_register(&param, &m_storage_handle);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    db_init.p_storage_handle = &m_storage_handle;
+    db_init.block_size       = BLE_BPRS_DB_BLOCK_SIZE;
+    db_init.block_count      = BLE_BPRS_DB_MAX_RECORDS;
+    db_init.record_size      = sizeof(ble_bprs_rec_t);
+    db_init.p_store_buf      = m_store_buf;
+    db_init.store_queue_size = BLE_BPRS_DB_STORE_QUEUE_SIZE;
+
+    err_code = ble_racp_db_init(&m_db, &db_init);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    p_newest       = ble_racp_db_newest_record_get(&m_db);
+    m_next_seq_num = (p_newest != NULL) ? (p_newest->sequence_number + 1) : 0;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ble_bprs_db_record_add(ble_bprs_rec_t const * p_rec)
+{
+    uint32_t err_code = ble_racp_db_record_add(&m_db, p_rec);
+
+    if (err_code == NRF_SUCCESS)
+    {
+        m_next_seq_num = p_rec->sequence_number + 1;
+    }
+
+    return err_code;
+}
+
+
+uint16_t ble_bprs_db_next_seq_num_get(void)
+{
+    return m_next_seq_num;
+}
+
+
+uint16_t ble_bprs_db_pos_count_get(void)
+{
+    return ble_racp_db_pos_count_get(&m_db);
+}
+
+
+uint32_t ble_bprs_db_pos_record_get(uint16_t pos, ble_bprs_rec_t * p_rec)
+{
+    ble_bprs_rec_t const * p_stored;
+
+    if (pos >= ble_racp_db_pos_count_get(&m_db))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    p_stored = ble_racp_db_pos_record_get(&m_db, pos);
+    if (p_stored == NULL)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    *p_rec = *p_stored;
+
+    return NRF_SUCCESS;
+}
+
+
+uint16_t ble_bprs_db_seq_num_pos_find(uint16_t seq_num, bool upper)
+{
+    ble_bprs_rec_t const * p_oldest;
+    uint16_t               oldest_seq_num;
+
+    p_oldest = ble_racp_db_pos_record_get(&m_db, ble_racp_db_index_to_pos(&m_db, 0));
+    if (p_oldest == NULL)
+    {
+        return ble_racp_db_pos_count_get(&m_db);
+    }
+
+    // A value in the half range preceding the oldest record is older than every record.
+    oldest_seq_num = p_oldest->sequence_number;
+    if ((int16_t)(seq_num - oldest_seq_num) < 0)
+    {
+        return 0;
+    }
+
+    return ble_racp_db_pos_find(&m_db,
+                                rec_seq_num_key_get,
+                                &oldest_seq_num,
+                                (uint16_t)(seq_num - oldest_seq_num),
+                                upper);
+}
+
+
+uint16_t ble_bprs_db_num_records_in_range_get(uint16_t first_pos, uint16_t end_pos)
+{
+    return ble_racp_db_num_records_in_range_get(&m_db, first_pos, end_pos);
+}
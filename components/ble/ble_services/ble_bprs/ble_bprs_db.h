@@ -0,0 +1,122 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ */
+
+/** @file
+ *
+ * @defgroup ble_sdk_srv_bprs_db Blood Pressure Record Database
+ * @{
+ * @ingroup ble_sdk_srv
+ * @brief Blood Pressure Record Database module.
+ *
+ * @details This module implements a database of stored blood pressure measurements.
+ *
+ *          Records are kept in flash by the @ref ble_sdk_lib_racp_db module, so that they
+ *          survive a reset. Records are addressed by position, the oldest record being at
+ *          position 0. An added record takes its position once it has been written. A record
+ *          whose write failed keeps its position but is skipped. Records cannot be deleted
+ *          individually, and records already stored are never cleared on initialization.
+ *
+ * @note    @ref pstorage_init must have been called before @ref ble_bprs_db_init, and the
+ *          application must propagate system events to @ref pstorage_sys_event_handler.
+ */
+
+#ifndef BLE_BPRS_DB_H__
+#define BLE_BPRS_DB_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pstorage.h"
+
+#ifndef BLE_BPRS_DB_FLASH_PAGES
+#define BLE_BPRS_DB_FLASH_PAGES       4                                                       /**< Number of flash pages holding the database. Must be taken into account in PSTORAGE_NUM_OF_PAGES. */
+#endif
+
+#define BLE_BPRS_DB_BLOCK_SIZE        32                                                      /**< Size of one record in flash. Must divide the flash page size. */
+#define BLE_BPRS_DB_RECORDS_PER_PAGE  (1024 / BLE_BPRS_DB_BLOCK_SIZE)                         /**< Number of records in one nRF51 flash page. */
+#define BLE_BPRS_DB_MAX_RECORDS       (BLE_BPRS_DB_FLASH_PAGES * BLE_BPRS_DB_RECORDS_PER_PAGE) /**< Number of record slots in the database. */
+#define BLE_BPRS_DB_STORE_QUEUE_SIZE  4                                                       /**< Number of added records that can be waiting to be written to flash. */
+
+#define BLE_BPRS_MEAS_MAX_LEN         19                                                      /**< Maximum length of an encoded Blood Pressure Measurement. */
+
+/**@brief Blood Pressure record. */
+typedef struct
+{
+    uint16_t sequence_number;                                                                 /**< Sequence number of the record. */
+    uint8_t  len;                                                                             /**< Length of the encoded measurement. */
+    uint8_t  data[BLE_BPRS_MEAS_MAX_LEN];                                                     /**< Blood Pressure Measurement, as received from the sensor. */
+} ble_bprs_rec_t;
+
+/**@brief Function for initializing the blood pressure record database.
+ *
+ * @details This call initializes the database holding blood pressure records, and restores the
+ *          records found in flash.
+ *
+ * @return      NRF_SUCCESS on success, otherwise an error code returned by the persistent storage module.
+ */
+uint32_t ble_bprs_db_init(void);
+
+/**@brief Function for adding a record at the end of the database.
+ *
+ * @details This call adds a record as the last record in the database. If the database is full,
+ *          the oldest records are dropped.
+ *
+ * @param[in]   p_rec   Pointer to record to add to database.
+ *
+ * @return      NRF_SUCCESS on success, NRF_ERROR_BUSY if @ref BLE_BPRS_DB_STORE_QUEUE_SIZE records
+ *              are already waiting to be written to flash.
+ */
+uint32_t ble_bprs_db_record_add(ble_bprs_rec_t const * p_rec);
+
+/**@brief Function for getting the sequence number to be given to the next record.
+ *
+ * @return      Sequence number of the next record.
+ */
+uint16_t ble_bprs_db_next_seq_num_get(void);
+
+/**@brief Function for getting the number of positions in the database.
+ *
+ * @return      Number of positions in the database.
+ */
+uint16_t ble_bprs_db_pos_count_get(void);
+
+/**@brief Function for getting the record at a position.
+ *
+ * @param[in]   pos     Position of the record, 0 being the oldest one.
+ * @param[out]  p_rec   Pointer to record structure where retrieved record is copied to.
+ *
+ * @return      NRF_SUCCESS on success, NRF_ERROR_INVALID_PARAM if the position is out of range,
+ *              NRF_ERROR_NOT_FOUND if the record at the position could not be written.
+ */
+uint32_t ble_bprs_db_pos_record_get(uint16_t pos, ble_bprs_rec_t * p_rec);
+
+/**@brief Function for finding the first position with a sequence number not less than (or
+ *        greater than) a given value.
+ *
+ * @param[in]   seq_num   Sequence number to look for.
+ * @param[in]   upper     FALSE to find the first position with a sequence number >= seq_num,
+ *                        TRUE to find the first position with a sequence number > seq_num.
+ *
+ * @return      Position found, or @ref ble_bprs_db_pos_count_get if there is none.
+ */
+uint16_t ble_bprs_db_seq_num_pos_find(uint16_t seq_num, bool upper);
+
+/**@brief Function for getting the number of records in a range of positions.
+ *
+ * @param[in]   first_pos   First position of the range.
+ * @param[in]   end_pos     Position following the last position of the range.
+ *
+ * @return      Number of records.
+ */
+uint16_t ble_bprs_db_num_records_in_range_get(uint16_t first_pos, uint16_t end_pos);
+
+#endif // BLE_BPRS_DB_H__
+
+/** @} */
@@ -66,14 +66,6 @@ typedef struct ble_bps_s ble_bps_t;
 /**@brief Blood Pressure Service event handler type. */
 typedef void (*ble_bps_evt_handler_t) (ble_bps_t * p_bps, ble_bps_evt_t * p_evt);
 
-/**@brief SFLOAT format (IEEE-11073 16-bit FLOAT, defined as a 16-bit vlue with 12-bit mantissa and
- *        4-bit exponent. */
-typedef struct
-{
-  int8_t  exponent;                                                         /**< Base 10 exponent, only 4 bits */
-  int16_t mantissa;                                                         /**< Mantissa, only 12 bits */
-} ieee_float16_t;
-
 /**@brief Blood Pressure Service init structure. This contains all options and data
  *        needed for initialization of the service. */
 typedef struct
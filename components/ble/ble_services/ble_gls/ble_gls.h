@@ -34,6 +34,7 @@
 #include "ble.h"
 #include "ble_srv_common.h"
 #include "ble_date_time.h"
+#include "ble_racp.h"
 
 /**@brief Glucose feature */
 #define BLE_GLS_FEATURE_LOW_BATT                       0x0001  /**< Low Battery Detection During Measurement Supported */
@@ -222,6 +223,7 @@ struct ble_gls_s
     uint16_t                  conn_handle;                     /**< Handle of the current connection (as provided by the BLE stack, is BLE_CONN_HANDLE_INVALID if not in a connection). */
     uint16_t                  feature;
     bool                      is_context_supported;
+    ble_racp_engine_t         racp_engine;                     /**< Record access engine executing the RACP requests. */
 };
 
 /**@brief Function for initializing the Glucose Service.
@@ -10,30 +10,155 @@
  */
 
 #include "ble_gls_db.h"
+#include <stddef.h>
+#include "pstorage.h"
+#include "app_util.h"
+#include "nordic_common.h"
+#include "ble_racp_db.h"
 
 
-typedef struct
+#define DB_SECONDS_PER_DAY    86400                                      /**< Number of seconds in a day. */
+
+STATIC_ASSERT(BLE_RACP_DB_ENTRY_SIZE(sizeof(ble_gls_rec_t)) <= BLE_GLS_DB_BLOCK_SIZE);
+
+static pstorage_handle_t m_storage_handle;                               /**< Base handle of the database slots. */
+static ble_racp_db_t     m_db;                                           /**< Flash ring holding the records. */
+static uint16_t          m_next_seq_num;                                 /**< Sequence number of the next glucose record. */
+static uint32_t          m_store_buf[BLE_RACP_DB_STORE_BUF_WORDS(sizeof(ble_gls_rec_t),
+                                                                 BLE_GLS_DB_STORE_QUEUE_SIZE)]; /**< Records waiting to be written to flash. */
+
+
+/**@brief Function for getting the number of days between 1970-01-01 and a date.
+ *
+ * @param[in]   year    Year.
+ * @param[in]   month   Month, 1 to 12.
+ * @param[in]   day     Day of month, 1 to 31.
+ *
+ * @return      Number of days.
+ */
+static int32_t days_from_civil(int32_t year, uint32_t month, uint32_t day)
+{
+    int32_t  era;
+    uint32_t year_of_era;
+    uint32_t day_of_year;
+    uint32_t day_of_era;
+
+    year -= (month <= 2) ? 1 : 0;
+    era   = ((year >= 0) ? year : (year - 399)) / 400;
+
+    year_of_era = (uint32_t)(year - (era * 400));
+    day_of_year = ((153 * ((month > 2) ? (month - 3) : (month + 9))) + 2) / 5 + day - 1;
+    day_of_era  = (year_of_era * 365) + (year_of_era / 4) - (year_of_era / 100) + day_of_year;
+
+    return (era * 146097) + (int32_t)day_of_era - 719468;
+}
+
+
+/**@brief Function for converting a date and time to seconds since 1970-01-01.
+ *
+ * @param[in]   p_time   Date and time.
+ *
+ * @return      Number of seconds.
+ */
+static int64_t time_to_seconds(ble_date_time_t const * p_time)
+{
+    int64_t days = days_from_civil(p_time->year, p_time->month, p_time->day);
+
+    return (days * DB_SECONDS_PER_DAY) +
+           (((p_time->hours * 60) + p_time->minutes) * 60) + p_time->seconds;
+}
+
+
+/**@brief Function for getting the user facing time of a record.
+ *
+ * @param[in]   p_rec       Record.
+ * @param[in]   p_context   Unused.
+ *
+ * @return      Base time plus time offset, in seconds since 1970-01-01.
+ */
+static int64_t rec_time_key_get(void const * p_rec, void const * p_context)
+{
+    ble_gls_meas_t const * p_meas = &((ble_gls_rec_t const *)p_rec)->meas;
+    int64_t                time   = time_to_seconds(&p_meas->base_time);
+
+    UNUSED_PARAMETER(p_context);
+
+    if ((p_meas->flags & BLE_GLS_MEAS_FLAG_TIME_OFFSET) != 0)
+    {
+        time += (int64_t)p_meas->time_offset * 60;
+    }
+
+    return time;
+}
+
+
+/**@brief Function for getting the sequence number of a record.
+ *
+ * @param[in]   p_rec       Record.
+ * @param[in]   p_context   Unused.
+ *
+ * @return      Sequence number.
+ */
+static int64_t rec_seq_num_key_get(void const * p_rec, void const * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    return ((ble_gls_rec_t const *)p_rec)->meas.sequence_number;
+}
+
+
+/**@brief Function for handling persistent storage events.
+ *
+ * @param[in] p_handle  Identifies the flash block the operation was on.
+ * @param[in] op_code   Identifies the operation.
+ * @param[in] result    Result of the operation.
+ * @param[in] p_data    Data written.
+ * @param[in] data_len  Length of the data written.
+ */
+static void db_pstorage_cb_handler(pstorage_handle_t * p_handle,
+                                   uint8_t             op_code,
+                                   uint32_t            result,
+                                   uint8_t           * p_data,
+                                   uint32_t            data_len)
 {
-    bool          in_use_flag;
-    ble_gls_rec_t record;
-} database_entry_t;
+    UNUSED_PARAMETER(data_len);
 
-static database_entry_t m_database[BLE_GLS_DB_MAX_RECORDS];
-static uint8_t          m_database_crossref[BLE_GLS_DB_MAX_RECORDS];
-static uint16_t         m_num_records;
+    ble_racp_db_on_pstorage_evt(&m_db, p_handle, op_code, result, p_data);
+}
 
 
 uint32_t ble_gls_db_init(void)
 {
-    int i;
+    uint32_t                err_code;
+    pstorage_module_param_t param;
+    ble_racp_db_init_t      db_init;
+    ble_gls_rec_t const   * p_newest;
+
+    param.block_size  = BLE_GLS_DB_BLOCK_SIZE;
+    param.block_count = BLE_GLS_DB_MAX_RECORDS;
+    param.cb          = db_pstorage_cb_handler;
 
-    for (i = 0; i < BLE_GLS_DB_MAX_RECORDS; i++)
+    err_code = pstorage_register(&param, &m_storage_handle);
+    if (err_code != NRF_SUCCESS)
     {
-        m_database[i].in_use_flag = false;
-        m_database_crossref[i]    = 0xFF;
+        return err_code;
     }
 
-    m_num_records = 0;
+    db_init.p_storage_handle = &m_storage_handle;
+    db_init.block_size       = BLE_GLS_DB_BLOCK_SIZE;
+    db_init.block_count      = BLE_GLS_DB_MAX_RECORDS;
+    db_init.record_size      = sizeof(ble_gls_rec_t);
+    db_init.p_store_buf      = m_store_buf;
+    db_init.store_queue_size = BLE_GLS_DB_STORE_QUEUE_SIZE;
+
+    err_code = ble_racp_db_init(&m_db, &db_init);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    p_newest       = ble_racp_db_newest_record_get(&m_db);
+    m_next_seq_num = (p_newest != NULL) ? (p_newest->meas.sequence_number + 1) : 0;
 
     return NRF_SUCCESS;
 }
@@ -41,19 +166,22 @@ uint32_t ble_gls_db_init(void)
 
 uint16_t ble_gls_db_num_records_get(void)
 {
-    return m_num_records;
+    return ble_racp_db_num_records_get(&m_db);
 }
 
 
 uint32_t ble_gls_db_record_get(uint8_t rec_ndx, ble_gls_rec_t * p_rec)
 {
-    if (rec_ndx >= m_num_records)
+    ble_gls_rec_t const * p_stored;
+
+    p_stored = ble_racp_db_pos_record_get(&m_db, ble_racp_db_index_to_pos(&m_db, rec_ndx));
+    if (p_stored == NULL)
     {
         return NRF_ERROR_INVALID_PARAM;
     }
 
     // copy record to the specified memory
-    *p_rec = m_database[m_database_crossref[rec_ndx]].record;
+    *p_rec = *p_stored;
 
     return NRF_SUCCESS;
 }
@@ -61,52 +189,69 @@ uint32_t ble_gls_db_record_get(uint8_t rec_ndx, ble_gls_rec_t * p_rec)
 
 uint32_t ble_gls_db_record_add(ble_gls_rec_t * p_rec)
 {
-    int i;
+    uint32_t err_code = ble_racp_db_record_add(&m_db, p_rec);
 
-    if (m_num_records == BLE_GLS_DB_MAX_RECORDS)
+    if (err_code == NRF_SUCCESS)
     {
-        return NRF_ERROR_NO_MEM;
+        m_next_seq_num = p_rec->meas.sequence_number + 1;
     }
 
-    // find next available database entry
-    for (i = 0; i < BLE_GLS_DB_MAX_RECORDS; i++)
-    {
-        if (!m_database[i].in_use_flag)
-        {
-            m_database[i].in_use_flag = true;
-            m_database[i].record      = *p_rec;
+    return err_code;
+}
 
-            m_database_crossref[m_num_records] = i;
-            m_num_records++;
 
-            return NRF_SUCCESS;
-        }
-    }
+uint32_t ble_gls_db_record_delete(uint8_t rec_ndx)
+{
+    return ble_racp_db_record_delete(&m_db, ble_racp_db_index_to_pos(&m_db, rec_ndx));
+}
 
-    return NRF_ERROR_NO_MEM;
+
+uint16_t ble_gls_db_next_seq_num_get(void)
+{
+    return m_next_seq_num;
 }
 
 
-uint32_t ble_gls_db_record_delete(uint8_t rec_ndx)
+uint16_t ble_gls_db_pos_count_get(void)
 {
-    int i;
+    return ble_racp_db_pos_count_get(&m_db);
+}
 
-    if (rec_ndx >= m_num_records)
-    {
-        return NRF_ERROR_NOT_FOUND;
-    }
 
-    // free entry
-    m_database[m_database_crossref[rec_ndx]].in_use_flag = false;
+uint32_t ble_gls_db_pos_record_get(uint16_t pos, ble_gls_rec_t * p_rec)
+{
+    ble_gls_rec_t const * p_stored;
 
-    // decrease number of records
-    m_num_records--;
+    if (pos >= ble_racp_db_pos_count_get(&m_db))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
 
-    // remove cross reference index
-    for (i = rec_ndx; i < m_num_records; i++)
+    p_stored = ble_racp_db_pos_record_get(&m_db, pos);
+    if (p_stored == NULL)
     {
-        m_database_crossref[i] = m_database_crossref[i + 1];
+        return NRF_ERROR_NOT_FOUND;
     }
 
+    *p_rec = *p_stored;
+
     return NRF_SUCCESS;
 }
+
+
+uint16_t ble_gls_db_seq_num_pos_find(uint16_t seq_num, bool upper)
+{
+    return ble_racp_db_pos_find(&m_db, rec_seq_num_key_get, NULL, seq_num, upper);
+}
+
+
+uint16_t ble_gls_db_time_pos_find(ble_date_time_t const * p_time, bool upper)
+{
+    return ble_racp_db_pos_find(&m_db, rec_time_key_get, NULL, time_to_seconds(p_time), upper);
+}
+
+
+uint16_t ble_gls_db_num_records_in_range_get(uint16_t first_pos, uint16_t end_pos)
+{
+    return ble_racp_db_num_records_in_range_get(&m_db, first_pos, end_pos);
+}
@@ -18,6 +18,18 @@
  *
  * @details This module implements at database of stored glucose measurement values.
  *
+ *          Records are kept in flash by the @ref ble_sdk_lib_racp_db module, so that they
+ *          survive a reset. Records are addressed by position, the oldest record being at
+ *          position 0. An added record takes its position once it has been written, a deleted
+ *          record keeps its position until it becomes the oldest one. Records already stored are
+ *          never cleared on initialization.
+ *
+ *          Records are expected to be added in increasing sequence number and user facing time
+ *          order, which allows finding them by binary search.
+ *
+ * @note    @ref pstorage_init must have been called before @ref ble_gls_db_init, and the
+ *          application must propagate system events to @ref pstorage_sys_event_handler.
+ *
  * @note Attention! 
  *  To maintain compliance with Nordic Semiconductor ASA Bluetooth profile 
  *  qualification listings, These APIs must not be modified. However, the corresponding
@@ -29,14 +41,23 @@
 
 #include <stdint.h>
 #include "ble_gls.h"
+#include "ble_date_time.h"
+
+#ifndef BLE_GLS_DB_FLASH_PAGES
+#define BLE_GLS_DB_FLASH_PAGES      2                                                   /**< Number of flash pages holding the database. Must be taken into account in PSTORAGE_NUM_OF_PAGES. */
+#endif
 
-#define BLE_GLS_DB_MAX_RECORDS      20
+#define BLE_GLS_DB_BLOCK_SIZE       64                                                  /**< Size of one record in flash. Must divide the flash page size. */
+#define BLE_GLS_DB_RECORDS_PER_PAGE (1024 / BLE_GLS_DB_BLOCK_SIZE)                      /**< Number of records in one nRF51 flash page. */
+#define BLE_GLS_DB_MAX_RECORDS      (BLE_GLS_DB_FLASH_PAGES * BLE_GLS_DB_RECORDS_PER_PAGE) /**< Number of record slots in the database. */
+#define BLE_GLS_DB_STORE_QUEUE_SIZE 4                                                   /**< Number of added records that can be waiting to be written to flash. */
 
 /**@brief Function for initializing the glucose record database.
  *
- * @details This call initializes the database holding glucose records.
+ * @details This call initializes the database holding glucose records, and restores the records
+ *          found in flash.
  *
- * @return      NRF_SUCCESS on success. 
+ * @return      NRF_SUCCESS on success, otherwise an error code returned by the persistent storage module.
  */
 uint32_t ble_gls_db_init(void);
 
@@ -61,11 +82,14 @@ uint32_t ble_gls_db_record_get(uint8_t record_num, ble_gls_rec_t * p_rec);
 
 /**@brief Function for adding a record at the end of the database.
  *
- * @details This call adds a record as the last record in the database.
+ * @details This call adds a record as the last record in the database. If the database is full,
+ *          the oldest records are dropped. The record takes its position once it has been written
+ *          to flash. If the write fails, the position is kept as a deleted record.
  *
  * @param[in]   p_rec   Pointer to record to add to database.
  * 
- * @return      NRF_SUCCESS on success.
+ * @return      NRF_SUCCESS on success, NRF_ERROR_BUSY if @ref BLE_GLS_DB_STORE_QUEUE_SIZE records
+ *              are already waiting to be written to flash.
  */
 uint32_t ble_gls_db_record_add(ble_gls_rec_t * p_rec);
 
@@ -79,6 +103,66 @@ uint32_t ble_gls_db_record_add(ble_gls_rec_t * p_rec);
  */
 uint32_t ble_gls_db_record_delete(uint8_t record_num);
 
+/**@brief Function for getting the sequence number to be given to the next record.
+ *
+ * @details The sequence number follows the one of the newest record ever written, so that it
+ *          keeps increasing across resets and deletions.
+ *
+ * @return      Sequence number of the next record.
+ */
+uint16_t ble_gls_db_next_seq_num_get(void);
+
+/**@brief Function for getting the number of positions in the database.
+ *
+ * @details Deleted records which are not the oldest records still take a position.
+ *
+ * @return      Number of positions in the database.
+ */
+uint16_t ble_gls_db_pos_count_get(void);
+
+/**@brief Function for getting the record at a position.
+ *
+ * @param[in]   pos     Position of the record, 0 being the oldest one.
+ * @param[out]  p_rec   Pointer to record structure where retrieved record is copied to.
+ *
+ * @return      NRF_SUCCESS on success, NRF_ERROR_NOT_FOUND if the record has been deleted,
+ *              NRF_ERROR_INVALID_PARAM if the position is out of range.
+ */
+uint32_t ble_gls_db_pos_record_get(uint16_t pos, ble_gls_rec_t * p_rec);
+
+/**@brief Function for finding the first position with a sequence number not less than (or
+ *        greater than) a given value.
+ *
+ * @param[in]   seq_num   Sequence number to look for.
+ * @param[in]   upper     FALSE to find the first position with a sequence number >= seq_num,
+ *                        TRUE to find the first position with a sequence number > seq_num.
+ *
+ * @return      Position found, or @ref ble_gls_db_pos_count_get if there is none.
+ */
+uint16_t ble_gls_db_seq_num_pos_find(uint16_t seq_num, bool upper);
+
+/**@brief Function for finding the first position with a user facing time not less than (or
+ *        greater than) a given time.
+ *
+ * @details The user facing time of a record is its base time plus its time offset.
+ *
+ * @param[in]   p_time    User facing time to look for.
+ * @param[in]   upper     FALSE to find the first position with a user facing time >= p_time,
+ *                        TRUE to find the first position with a user facing time > p_time.
+ *
+ * @return      Position found, or @ref ble_gls_db_pos_count_get if there is none.
+ */
+uint16_t ble_gls_db_time_pos_find(ble_date_time_t const * p_time, bool upper);
+
+/**@brief Function for getting the number of records in a range of positions.
+ *
+ * @param[in]   first_pos   First position of the range.
+ * @param[in]   end_pos     Position following the last position of the range.
+ *
+ * @return      Number of records, deleted records excluded.
+ */
+uint16_t ble_gls_db_num_records_in_range_get(uint16_t first_pos, uint16_t end_pos);
+
 #endif // BLE_GLS_DB_H__
 
 /** @} */
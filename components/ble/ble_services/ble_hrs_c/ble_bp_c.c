@@ -1,249 +1,373 @@
+/**@cond To Make Doxygen skip documentation generation for this file.
+ * @{
+ */
+
 #include "ble_bp_c.h"
 
 #include <stdint.h>
-#include "ble_hrs_c.h"
+#include <string.h>
 #include "ble_db_discovery.h"
 #include "ble_types.h"
 #include "ble_srv_common.h"
 #include "nordic_common.h"
 #include "nrf_error.h"
 #include "ble_gattc.h"
+#include "ble_gattc_queue.h"
 #include "app_util.h"
 #include "app_trace.h"
 
-static ble_bp_c_t * mp_ble_bp_c;
+#define LOG                                 app_trace_log  /**< Debug logger macro that will be used in this file to do logging of important information over UART. */
 
-//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-#define BLE_CCCD_VALUE_LEN                                       2          /**< The length of a CCCD value. */
-#define WRITE_MESSAGE_LENGTH   BLE_CCCD_VALUE_LEN 
-typedef enum
-{
-    READ_REQ,  /**< Type identifying that this tx_message is a read request. */
-    WRITE_REQ  /**< Type identifying that this tx_message is a write request. */
-} tx_request_t;
+#define BPM_FLAG_UNITS_KPA                  (0x01 << 0)    /**< Blood Pressure Units Flag bit. */
+#define BPM_FLAG_TIME_STAMP                 (0x01 << 1)    /**< Time Stamp Flag bit. */
+#define BPM_FLAG_PULSE_RATE                 (0x01 << 2)    /**< Pulse Rate Flag bit. */
+#define BPM_FLAG_USER_ID                    (0x01 << 3)    /**< User ID Flag bit. */
+#define BPM_FLAG_MEASUREMENT_STATUS         (0x01 << 4)    /**< Measurement Status Flag bit. */
+
+#define SFLOAT_LEN                          2              /**< Length of an encoded SFLOAT. */
+#define TIME_STAMP_LEN                      7              /**< Length of an encoded time stamp. */
+
+STATIC_ASSERT(BLE_BP_C_MEAS_MAX_LEN == 1 + 3 * SFLOAT_LEN + TIME_STAMP_LEN + SFLOAT_LEN + 1 + 2);
+
+static ble_bp_c_t * mp_ble_bp_c[BLE_BP_C_MAX_INSTANCES];  /**< Instances of the BPS Client module. The memory for these is provided by the application. */
+static uint8_t      m_instance_count;                     /**< Number of instances initialized. */
 
-/**@brief Structure for writing a message to the peer, i.e. CCCD.
+
+/**@brief Function for decoding an SFLOAT.
+ *
+ * @param[in]   p_data   Encoded SFLOAT, little endian.
+ *
+ * @return Decoded SFLOAT, with the exponent and the mantissa sign extended.
  */
-typedef struct
-{
-    uint8_t                  gattc_value[WRITE_MESSAGE_LENGTH];  /**< The message to write. */
-    ble_gattc_write_params_t gattc_params;                       /**< GATTC parameters for this message. */
-} write_params_t;
-typedef struct
+static ieee_float16_t sfloat_decode(uint8_t const * p_data)
 {
-    uint16_t     conn_handle;  /**< Connection handle to be used when transmitting this message. */
-    tx_request_t type;         /**< Type of this message, i.e. read or write message. */
-    union
-    {
-        uint16_t       read_handle;  /**< Read request message. */
-        write_params_t write_req;    /**< Write request message. */
-    } req;
-} tx_message_t;
-//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-
-#define TX_BUFFER_MASK         0x07                  /**< TX Buffer mask, must be a mask of continuous zeroes, followed by continuous sequence of ones: 000...111. */
-#define TX_BUFFER_SIZE         (TX_BUFFER_MASK + 1)
-static tx_message_t  m_tx_buffer[TX_BUFFER_SIZE];  /**< Transmit buffer for messages to be transmitted to the central. */
-static uint32_t      m_tx_insert_index = 0; 
-static uint32_t      m_tx_index = 0;
-
-static void tx_buffer_process(void)
+    ieee_float16_t sfloat;
+    uint16_t       raw = uint16_decode(p_data);
+
+    sfloat.exponent = (int8_t)(raw >> 12);
+    if (sfloat.exponent >= 8)
+    {
+        sfloat.exponent -= 16;
+    }
+
+    sfloat.mantissa = (int16_t)(raw & 0x0FFF);
+    if (sfloat.mantissa >= 0x0800)
+    {
+        sfloat.mantissa -= 0x1000;
+    }
+
+    return sfloat;
+}
+
+
+uint32_t ble_bp_c_meas_decode(uint8_t const * p_data, uint16_t len, ble_bp_c_meas_t * p_meas)
 {
-	//printf(">>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>\r\n");
-	//printf("m_tx_index=%d,m_tx_insert_index=%d\r\n",m_tx_index,m_tx_insert_index);
-	//printf("m_tx_buffer[m_tx_index].type=%d\r\n",m_tx_buffer[m_tx_index].type);
-    if (m_tx_index != m_tx_insert_index)
+    uint16_t index = 0;
+    uint16_t needed;
+    uint8_t  flags;
+
+    if ((p_data == NULL) || (p_meas == NULL))
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (len < 1 + 3 * SFLOAT_LEN)
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    flags  = p_data[index++];
+    needed = 1 + 3 * SFLOAT_LEN;
+    needed += (flags & BPM_FLAG_TIME_STAMP)         ? TIME_STAMP_LEN   : 0;
+    needed += (flags & BPM_FLAG_PULSE_RATE)         ? SFLOAT_LEN       : 0;
+    needed += (flags & BPM_FLAG_USER_ID)            ? sizeof(uint8_t)  : 0;
+    needed += (flags & BPM_FLAG_MEASUREMENT_STATUS) ? sizeof(uint16_t) : 0;
+    if (len < needed)
     {
-        uint32_t err_code;
+        return NRF_ERROR_INVALID_LENGTH;
+    }
 
-        if (m_tx_buffer[m_tx_index].type == READ_REQ)
-        {
-            err_code = sd_ble_gattc_read(m_tx_buffer[m_tx_index].conn_handle,
-                                         m_tx_buffer[m_tx_index].req.read_handle,
-                                         0);
-        }
-        else
-        {
-            err_code = sd_ble_gattc_write(m_tx_buffer[m_tx_index].conn_handle,
-                                          &m_tx_buffer[m_tx_index].req.write_req.gattc_params);
-        }
-        if (err_code == NRF_SUCCESS)
-        {
-            //printf("[BP_C]: SD Read/Write API returns Success..\r\n");
-            m_tx_index++;
-            m_tx_index &= TX_BUFFER_MASK;
-        }
-        else
-        {
-            //printf("[BP_C]: SD Read/Write API returns error. This message sending will be "
-            //    "attempted again..\r\n");
-        }
+    p_meas->units_in_kpa               = ((flags & BPM_FLAG_UNITS_KPA) != 0);
+    p_meas->time_stamp_present         = ((flags & BPM_FLAG_TIME_STAMP) != 0);
+    p_meas->pulse_rate_present         = ((flags & BPM_FLAG_PULSE_RATE) != 0);
+    p_meas->user_id_present            = ((flags & BPM_FLAG_USER_ID) != 0);
+    p_meas->measurement_status_present = ((flags & BPM_FLAG_MEASUREMENT_STATUS) != 0);
+
+    p_meas->systolic               = sfloat_decode(&p_data[index]);
+    index                         += SFLOAT_LEN;
+    p_meas->diastolic              = sfloat_decode(&p_data[index]);
+    index                         += SFLOAT_LEN;
+    p_meas->mean_arterial_pressure = sfloat_decode(&p_data[index]);
+    index                         += SFLOAT_LEN;
+
+    if (p_meas->time_stamp_present)
+    {
+        index += ble_date_time_decode(&p_meas->time_stamp, &p_data[index]);
+    }
+    if (p_meas->pulse_rate_present)
+    {
+        p_meas->pulse_rate = sfloat_decode(&p_data[index]);
+        index             += SFLOAT_LEN;
+    }
+    if (p_meas->user_id_present)
+    {
+        p_meas->user_id = p_data[index++];
     }
+    if (p_meas->measurement_status_present)
+    {
+        p_meas->measurement_status = uint16_decode(&p_data[index]);
+    }
+
+    return NRF_SUCCESS;
 }
 
-extern void bp_c_evt_handler(ble_bp_c_t * p_bp_c, ble_bp_c_evt_t * p_bp_c_evt);
-static void on_hvx(ble_bp_c_t * p_ble_bp_c, const ble_evt_t * p_ble_evt)
+
+uint32_t ble_bp_c_sfloat_to_int(ieee_float16_t sfloat, int32_t * p_value)
 {
-		bp_log("p_ble_evt->evt.gattc_evt.params.hvx.handle=0x%x\r\n",p_ble_evt->evt.gattc_evt.params.hvx.handle);
-	  bp_log("p_ble_hrs_c->bp_CUFF_handle=0x%x\r\n",p_ble_bp_c->bp_CUFF_handle);
-	  bp_log("p_ble_hrs_c->bp_MEA_handle=0x%x\r\n",p_ble_bp_c->bp_MEA_handle);
-	
-    p_ble_bp_c->bp_CUFF_handle = BLE_CUFF_HANDLE;
-		p_ble_bp_c->bp_MEA_handle = BLE_BP_MEASUREMENT_HANDLE;
-    // Check if this is a heart rate notification.
-    //if (p_ble_evt->evt.gattc_evt.params.hvx.handle == p_ble_bp_c->bp_CUFF_handle)
-		if (p_ble_evt->evt.gattc_evt.params.hvx.handle == p_ble_bp_c->bp_MEA_handle)
-    {
-        ble_bp_c_evt_t ble_bp_c_evt;
-        uint32_t        index = 0;
-
-        ble_bp_c_evt.evt_type = BLE_BP_C_EVT_GOT_VAL;
-			
-			bp_log("hvx:len=0x%x\r\n",(p_ble_evt->evt.gattc_evt.params.hvx.len));
-			int ii;
-			for (ii=0;ii<p_ble_evt->evt.gattc_evt.params.hvx.len;ii++){
-				//for (ii=0;ii<4;ii++){
-					ble_bp_c_evt.params.bp.bp_value[ii] = p_ble_evt->evt.gattc_evt.params.hvx.data[index];
-				  index++;
-			    //bp_log("hvx:index=%d, val=%d\r\n",index+ii,p_ble_evt->evt.gattc_evt.params.hvx.data[index+ii]);
-			}
-			 //bp_log("hvx:index=%d, val=0x%x\r\n",index+len,p_ble_evt->evt.gattc_evt.params.hvx.data[index+len]);
-			bp_log("Finish\r\n");
-			
-			bp_c_evt_handler(p_ble_bp_c, &ble_bp_c_evt);
-			
-			
-/*
-        if (!(p_ble_evt->evt.gattc_evt.params.hvx.data[index++] & HRM_FLAG_MASK_HR_16BIT))
-        {
-            // 8 Bit heart rate value received.
-            ble_bp_c_evt.params.hrm.hr_value = p_ble_evt->evt.gattc_evt.params.hvx.data[index++];  //lint !e415 suppress Lint Warning 415: Likely access out of bond
-        }
-        else
+    int32_t value = sfloat.mantissa;
+    int8_t  exponent;
+
+    if (p_value == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if ((sfloat.exponent == 0) &&
+        ((sfloat.mantissa == BLE_BP_C_SFLOAT_NAN)            ||
+         (sfloat.mantissa == BLE_BP_C_SFLOAT_NRES)           ||
+         (sfloat.mantissa == BLE_BP_C_SFLOAT_PLUS_INFINITY)  ||
+         (sfloat.mantissa == BLE_BP_C_SFLOAT_MINUS_INFINITY) ||
+         (sfloat.mantissa == BLE_BP_C_SFLOAT_RESERVED)))
+    {
+        return NRF_ERROR_INVALID_DATA;
+    }
+
+    for (exponent = sfloat.exponent; exponent > 0; exponent--)
+    {
+        if ((value > INT32_MAX / 10) || (value < -(INT32_MAX / 10)))
         {
-            // 16 bit heart rate value received.
-            ble_bp_c_evt.params.hrm.hr_value =
-                uint16_decode(&(p_ble_evt->evt.gattc_evt.params.hvx.data[index]));
+            return NRF_ERROR_INVALID_DATA;
         }
+        value *= 10;
+    }
+    for (exponent = sfloat.exponent; exponent < 0; exponent++)
+    {
+        value /= 10;
+    }
+
+    *p_value = value;
 
-        p_ble_hrs_c->evt_handler(p_ble_hrs_c, &ble_hrs_c_evt);
-*/ 
-   }
+    return NRF_SUCCESS;
 }
 
 
-static uint32_t NOTIFICATION_cccd_configure(uint16_t conn_handle, uint16_t handle_cccd, bool enable)
+/**@brief Function for freeing an instance, e.g. when its connection is disconnected. */
+static void instance_reset(ble_bp_c_t * p_ble_bp_c)
 {
-   //printf("[BP]: Configuring CCCD. CCCD Handle = %d, Connection Handle = %d\r\n", handle_cccd,conn_handle);
-	
-	  tx_message_t * p_msg;
-    uint16_t       cccd_val = enable ? BLE_GATT_HVX_NOTIFICATION : 0;
-    //printf("cccd_val=0x%x\\r\n",cccd_val);
-    p_msg              = &m_tx_buffer[m_tx_insert_index++];
-    m_tx_insert_index &= TX_BUFFER_MASK;
-
-    p_msg->req.write_req.gattc_params.handle   = handle_cccd;
-    p_msg->req.write_req.gattc_params.len      = WRITE_MESSAGE_LENGTH;
-    p_msg->req.write_req.gattc_params.p_value  = p_msg->req.write_req.gattc_value;
-    p_msg->req.write_req.gattc_params.offset   = 0;
-    p_msg->req.write_req.gattc_params.write_op = BLE_GATT_OP_WRITE_REQ;
-    p_msg->req.write_req.gattc_value[0]        = LSB(cccd_val);
-    p_msg->req.write_req.gattc_value[1]        = MSB(cccd_val);
-    p_msg->conn_handle                         = conn_handle;
-    p_msg->type                                = WRITE_REQ;
-
-    tx_buffer_process();
-    
-	  return NRF_SUCCESS;
+    p_ble_bp_c->conn_handle      = BLE_CONN_HANDLE_INVALID;
+    p_ble_bp_c->meas_handle      = BLE_GATT_HANDLE_INVALID;
+    p_ble_bp_c->meas_cccd_handle = BLE_GATT_HANDLE_INVALID;
+    p_ble_bp_c->icp_handle       = BLE_GATT_HANDLE_INVALID;
+    p_ble_bp_c->icp_cccd_handle  = BLE_GATT_HANDLE_INVALID;
+    p_ble_bp_c->feature_handle   = BLE_GATT_HANDLE_INVALID;
 }
 
-static uint32_t INDICATION_cccd_configure(uint16_t conn_handle, uint16_t handle_cccd, bool enable)
-{
-   //printf("[BP]: Configuring CCCD. CCCD Handle = %d, Connection Handle = %d\r\n", handle_cccd,conn_handle);
-	
-	  tx_message_t * p_msg;
-    uint16_t       cccd_val = enable ? BLE_GATT_HVX_INDICATION : 0;
-    //printf("cccd_val=0x%x\\r\n",cccd_val);
-    p_msg              = &m_tx_buffer[m_tx_insert_index++];
-    m_tx_insert_index &= TX_BUFFER_MASK;
-
-    p_msg->req.write_req.gattc_params.handle   = handle_cccd;
-    p_msg->req.write_req.gattc_params.len      = WRITE_MESSAGE_LENGTH;
-    p_msg->req.write_req.gattc_params.p_value  = p_msg->req.write_req.gattc_value;
-    p_msg->req.write_req.gattc_params.offset   = 0;
-    p_msg->req.write_req.gattc_params.write_op = BLE_GATT_OP_WRITE_REQ;
-    p_msg->req.write_req.gattc_value[0]        = LSB(cccd_val);
-    p_msg->req.write_req.gattc_value[1]        = MSB(cccd_val);
-    p_msg->conn_handle                         = conn_handle;
-    p_msg->type                                = WRITE_REQ;
-
-    tx_buffer_process();
-    
-	  return NRF_SUCCESS;
-}
 
-uint32_t ble_bp_c_cuff_notif_enable(ble_bp_c_t * p_ble_bp_c)
+/**@brief Function for finding the instance to give a connection on which the service was
+ *        discovered.
+ *
+ * @return Instance already serving the connection, else the first free instance, else NULL.
+ */
+static ble_bp_c_t * instance_get(uint16_t conn_handle)
 {
-	//bp_log(">>>>ble_bp_c_cuff_notif_enable>>>\r\n");
-	 return NOTIFICATION_cccd_configure(p_ble_bp_c->conn_handle, p_ble_bp_c->bp_CUFF_cccd_handle, true);
+    ble_bp_c_t * p_free = NULL;
+    uint8_t      i;
+
+    for (i = 0; i < m_instance_count; i++)
+    {
+        if (mp_ble_bp_c[i]->conn_handle == conn_handle)
+        {
+            return mp_ble_bp_c[i];
+        }
+        if ((p_free == NULL) && (mp_ble_bp_c[i]->conn_handle == BLE_CONN_HANDLE_INVALID))
+        {
+            p_free = mp_ble_bp_c[i];
+        }
+    }
+    return p_free;
 }
 
-uint32_t ble_bp_c_mea_notif_enable(ble_bp_c_t * p_ble_bp_c)
+
+/**@brief     Function for handling Handle Value Notifications and Indications received from the
+ *            SoftDevice.
+ *
+ * @details   Decodes the Blood Pressure Measurements and Intermediate Cuff Pressures of the
+ *            connection of the instance, and passes them to the application.
+ *
+ * @param[in] p_ble_bp_c Instance.
+ * @param[in] p_ble_evt  Pointer to the BLE event received.
+ */
+static void on_hvx(ble_bp_c_t * p_ble_bp_c, const ble_evt_t * p_ble_evt)
 {
-	bp_log(">>>>ble_bp_c_mea_notif_enable>>>\r\n");
-	 return INDICATION_cccd_configure(p_ble_bp_c->conn_handle, p_ble_bp_c->bp_MEA_cccd_handle, true);
+    const ble_gattc_evt_hvx_t * p_hvx = &p_ble_evt->evt.gattc_evt.params.hvx;
+    ble_bp_c_evt_t              ble_bp_c_evt;
+
+    if (p_hvx->handle == p_ble_bp_c->meas_handle)
+    {
+        ble_bp_c_evt.evt_type = BLE_BP_C_EVT_MEA_NOTIFICATION;
+    }
+    else if (p_hvx->handle == p_ble_bp_c->icp_handle)
+    {
+        ble_bp_c_evt.evt_type = BLE_BP_C_EVT_CUFF_NOTIFICATION;
+    }
+    else
+    {
+        return;
+    }
+
+    if (p_hvx->type == BLE_GATT_HVX_INDICATION)
+    {
+        // The peer does not send the next indication until this one is confirmed.
+        UNUSED_VARIABLE(sd_ble_gattc_hv_confirm(p_ble_bp_c->conn_handle, p_hvx->handle));
+    }
+
+    memset(&ble_bp_c_evt.params.bp.meas, 0, sizeof(ble_bp_c_evt.params.bp.meas));
+    if (ble_bp_c_meas_decode(p_hvx->data, p_hvx->len, &ble_bp_c_evt.params.bp.meas) != NRF_SUCCESS)
+    {
+        LOG("[BP_C]: Malformed value dropped, length %d\r\n", p_hvx->len);
+        return;
+    }
+    ble_bp_c_evt.params.bp.p_data = p_hvx->data;
+    ble_bp_c_evt.params.bp.len    = (uint8_t)MIN(p_hvx->len, BLE_BP_C_MEAS_MAX_LEN);
+
+    p_ble_bp_c->evt_handler(p_ble_bp_c, &ble_bp_c_evt);
 }
-uint32_t ble_bp_c_test_notif_enable(ble_bp_c_t * p_ble_bp_c)
+
+
+/**@brief     Function for handling events from the database discovery module.
+ *
+ * @details   When the Blood Pressure Service is discovered on a connection, gives the connection to
+ *            an instance, stores the handles of the characteristics in it, and calls the
+ *            application's event handler of the instance.
+ *
+ * @param[in] p_evt Pointer to the event received from the database discovery module.
+ */
+static void db_discover_evt_handler(ble_db_discovery_evt_t * p_evt)
 {
-	//printf(">>>>>>>>>>>>>>>>.do ble_bp_c_test_notif_enable>>>>>>>>>>\r\n");
-	/*
+    ble_bp_c_t   * p_ble_bp_c;
+    ble_bp_c_evt_t evt;
+    uint32_t       i;
+
+    if ((p_evt->evt_type != BLE_DB_DISCOVERY_COMPLETE) ||
+        (p_evt->params.discovered_db.srv_uuid.uuid != BLE_UUID_BLOOD_PRESSURE_SERVICE) ||
+        (p_evt->params.discovered_db.srv_uuid.type != BLE_UUID_TYPE_BLE))
+    {
+        return;
+    }
+
+    p_ble_bp_c = instance_get(p_evt->conn_handle);
     if (p_ble_bp_c == NULL)
     {
-			printf("ble_bp_c_test_notif_enable: p_ble_bp_c=NULL\r\n");
-        return NRF_ERROR_NULL;
+        LOG("[BP_C]: No free instance for connection %d\r\n", p_evt->conn_handle);
+        return;
     }
-    printf("call ble_bp_c_test_notif_enable now\r\n");
-    return cccd_configure(p_ble_bp_c->conn_handle, p_ble_bp_c->bp_test_cccd_handle, true);
-	
-*/
-	return 0;
+
+    instance_reset(p_ble_bp_c);
+    p_ble_bp_c->conn_handle = p_evt->conn_handle;
+
+    for (i = 0; i < p_evt->params.discovered_db.char_count; i++)
+    {
+        const ble_db_discovery_char_t * p_char = &p_evt->params.discovered_db.charateristics[i];
+
+        switch (p_char->characteristic.uuid.uuid)
+        {
+            case BLE_UUID_BLOOD_PRESSURE_MEASUREMENT_CHAR:
+                p_ble_bp_c->meas_handle      = p_char->characteristic.handle_value;
+                p_ble_bp_c->meas_cccd_handle = p_char->cccd_handle;
+                break;
+
+            case BLE_UUID_INTERMEDIATE_CUFF_PRESSURE_CHAR:
+                p_ble_bp_c->icp_handle       = p_char->characteristic.handle_value;
+                p_ble_bp_c->icp_cccd_handle  = p_char->cccd_handle;
+                break;
+
+            case BLE_UUID_BLOOD_PRESSURE_FEATURE_CHAR:
+                p_ble_bp_c->feature_handle   = p_char->characteristic.handle_value;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    LOG("[BP_C]: Blood Pressure Service discovered at peer.\r\n");
+
+    evt.evt_type = BLE_BP_C_EVT_DISCOVERY_COMPLETE;
+
+    p_ble_bp_c->evt_handler(p_ble_bp_c, &evt);
 }
 
 
-static void on_write_rsp(ble_bp_c_t * p_bas_c, const ble_evt_t * p_ble_evt)
+uint32_t ble_bp_c_init(ble_bp_c_t * p_ble_bp_c, ble_bp_c_evt_handler_t bp_callback)
 {
-    // Check if there is any message to be sent across to the peer and send it.
-    tx_buffer_process();
+    ble_uuid_t bp_uuid;
+
+    if ((p_ble_bp_c == NULL) || (bp_callback == NULL))
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (m_instance_count >= BLE_BP_C_MAX_INSTANCES)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    p_ble_bp_c->evt_handler = bp_callback;
+    instance_reset(p_ble_bp_c);
+
+    mp_ble_bp_c[m_instance_count++] = p_ble_bp_c;
+
+    if (m_instance_count > 1)
+    {
+        // The module is already registered with the database discovery module.
+        return NRF_SUCCESS;
+    }
+
+    bp_uuid.type = BLE_UUID_TYPE_BLE;
+    bp_uuid.uuid = BLE_UUID_BLOOD_PRESSURE_SERVICE;
+
+    return ble_db_discovery_evt_register(&bp_uuid,
+                                         db_discover_evt_handler);
 }
 
 
 void ble_bp_c_on_ble_evt(ble_bp_c_t * p_ble_bp_c, ble_evt_t * p_ble_evt)
-//void ble_bp_on_ble_evt(ble_bp_t * p_bp, ble_evt_t * p_ble_evt)
 {
-    switch (p_ble_evt->header.evt_id)
+    if ((p_ble_bp_c == NULL) || (p_ble_evt == NULL))
     {
-        case BLE_GAP_EVT_CONNECTED:
-					bp_log("ble_bp_on_ble_evt: BLE_GAP_EVT_CONNECTED\r\n");
-				  p_ble_bp_c->conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
-            break;
+        return;
+    }
 
+    if ((p_ble_bp_c->conn_handle == BLE_CONN_HANDLE_INVALID) ||
+        (p_ble_evt->evt.gap_evt.conn_handle != p_ble_bp_c->conn_handle))
+    {
+        // The event is not for the connection of this instance.
+        return;
+    }
+
+    switch (p_ble_evt->header.evt_id)
+    {
         case BLE_GAP_EVT_DISCONNECTED:
-				{
-           bp_log("ble_bp_on_ble_evt: BLE_GAP_EVT_DISCONNECTED\r\n");
-					 ble_bp_c_evt_t ble_bp_c_evt;
-           ble_bp_c_evt.evt_type = BLE_BP_C_EVT_DISCONNECTED;
-			    bp_c_evt_handler(p_ble_bp_c, &ble_bp_c_evt);
-				}
-            break;
+        {
+            ble_bp_c_evt_t ble_bp_c_evt;
 
-        case BLE_GATTC_EVT_HVX:
-           bp_log("ble_bp_on_ble_evt: BLE_GATTC_EVT_HVX\r\n");
-				   on_hvx(p_ble_bp_c, p_ble_evt);
+            // The handler still sees the connection handle of the instance.
+            ble_bp_c_evt.evt_type = BLE_BP_C_EVT_DISCONNECTED;
+            p_ble_bp_c->evt_handler(p_ble_bp_c, &ble_bp_c_evt);
+
+            instance_reset(p_ble_bp_c);
             break;
+        }
 
-        case BLE_GATTC_EVT_WRITE_RSP:
-             bp_log("ble_bp_on_ble_evt: BLE_GATTC_EVT_WRITE_RSP\r\n");
-				     on_write_rsp(p_ble_bp_c, p_ble_evt);
+        case BLE_GATTC_EVT_HVX:
+            on_hvx(p_ble_bp_c, p_ble_evt);
             break;
 
         default:
@@ -253,98 +377,51 @@ void ble_bp_c_on_ble_evt(ble_bp_c_t * p_ble_bp_c, ble_evt_t * p_ble_evt)
 }
 
 
-static void db_discover_evt_handler(ble_db_discovery_evt_t * p_evt)
+/**@brief Function for queuing a write to a CCCD.
+ */
+static uint32_t cccd_configure(uint16_t conn_handle, uint16_t handle_cccd, uint16_t value)
 {
-	//printf("%d\r\n",__LINE__);
-  //printf("bp: db_discover_evt_handler\r\n");
-	 // Check if the Heart Rate Service was discovered.
-    if (p_evt->evt_type == BLE_DB_DISCOVERY_COMPLETE &&
-        p_evt->params.discovered_db.srv_uuid.uuid == /*BLE_UUID_HEART_RATE_SERVICE*/BLE_UUID_BLOOD_PRESSURE_SERVICE &&
-        p_evt->params.discovered_db.srv_uuid.type == BLE_UUID_TYPE_BLE)
-    {
-			//printf("BP: Got db_discover_evt_handler for BP\r\n");
-        //mp_ble_hrs_c->conn_handle = p_evt->conn_handle;
-
-        // Find the CCCD Handle of the Heart Rate Measurement characteristic.
-        uint32_t i;
-			 for (i = 0; i < p_evt->params.discovered_db.char_count; i++)
-        {
-					//BLE_UUID_INTERMEDIATE_CUFF_PRESSURE_CHAR 0x2a36
-					//BLE_UUID_BLOOD_PRESSURE_MEASUREMENT_CHAR 0x2a35
-					//BLE_UUID_BLOOD_PRESSURE_FEATURE_CHAR 0x2a49
-            if (p_evt->params.discovered_db.charateristics[i].characteristic.uuid.uuid ==
-                BLE_UUID_INTERMEDIATE_CUFF_PRESSURE_CHAR)
-            {
-							//printf("BP: Found BLE_UUID_INTERMEDIATE_CUFF_PRESSURE_CHAR characteristic\r\n");
-                // Found Heart Rate characteristic. Store CCCD handle and break.
-                mp_ble_bp_c->bp_CUFF_cccd_handle =     p_evt->params.discovered_db.charateristics[i].cccd_handle;
-                mp_ble_bp_c->bp_CUFF_handle      =    p_evt->params.discovered_db.charateristics[i].characteristic.handle_value;
-                break;
-            }
-						if (p_evt->params.discovered_db.charateristics[i].characteristic.uuid.uuid ==
-                BLE_UUID_BLOOD_PRESSURE_MEASUREMENT_CHAR)
-            {
-							//printf("BP: Found BLE_UUID_BLOOD_PRESSURE_MEASUREMENT_CHAR characteristic\r\n");
-                // Found Heart Rate characteristic. Store CCCD handle and break.
-                mp_ble_bp_c->bp_MEA_cccd_handle =     p_evt->params.discovered_db.charateristics[i].cccd_handle;
-                mp_ble_bp_c->bp_MEA_handle      =    p_evt->params.discovered_db.charateristics[i].characteristic.handle_value;
-                break;
-            }
-						if (p_evt->params.discovered_db.charateristics[i].characteristic.uuid.uuid ==
-                BLE_UUID_BLOOD_PRESSURE_FEATURE_CHAR)
-            {
-							//printf("BP: Found BLE_UUID_BLOOD_PRESSURE_FEATURE_CHAR characteristic\r\n");
-                // Found Heart Rate characteristic. Store CCCD handle and break.
-                //mp_ble_bp_c->bp_MEA_cccd_handle =     p_evt->params.discovered_db.charateristics[i].cccd_handle;
-                mp_ble_bp_c->bp_FEA_handle      =    p_evt->params.discovered_db.charateristics[i].characteristic.handle_value;
-                break;
-            }
-						
-							if (p_evt->params.discovered_db.charateristics[i].characteristic.uuid.uuid ==
-                BLE_UUID_HEART_RATE_MEASUREMENT_CHAR)
-            {
-							//printf("BP: Found BLE_UUID_HEART_RATE_MEASUREMENT_CHAR characteristic\r\n");
-                // Found Heart Rate characteristic. Store CCCD handle and break.
-                mp_ble_bp_c->bp_test_cccd_handle =     p_evt->params.discovered_db.charateristics[i].cccd_handle;
-                mp_ble_bp_c->bp_test_handle      =    p_evt->params.discovered_db.charateristics[i].characteristic.handle_value;
-                break;
-            }
-						
-        }
-				
-				ble_bp_c_evt_t evt;
-        evt.evt_type = BLE_BP_C_EVT_DISCOVERY_COMPLETE;
-				//printf("BP:set BLE_BP_C_EVT_DISCOVERY_COMPLETE\r\n");
-				if (mp_ble_bp_c->evt_handler)
-          mp_ble_bp_c->evt_handler(mp_ble_bp_c, &evt);
-		}
+    LOG("[BP_C]: Configuring CCCD. CCCD Handle = %d, Connection Handle = %d\r\n",
+        handle_cccd,conn_handle);
 
+    return ble_gattc_queue_cccd_write(conn_handle, handle_cccd, value);
 }
 
 
+uint32_t ble_bp_c_mea_notif_enable(ble_bp_c_t * p_ble_bp_c)
+{
+    if (p_ble_bp_c == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if ((p_ble_bp_c->conn_handle == BLE_CONN_HANDLE_INVALID) ||
+        (p_ble_bp_c->meas_cccd_handle == BLE_GATT_HANDLE_INVALID))
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
 
+    return cccd_configure(p_ble_bp_c->conn_handle, p_ble_bp_c->meas_cccd_handle, BLE_GATT_HVX_INDICATION);
+}
 
-//static ble_bp_c_t               m_ble_bp_c; 
-uint32_t ble_bp_c_init(ble_bp_c_t * p_ble_bp_c, ble_bp_c_evt_handler_t bp_callback)
-//uint32_t ble_bp_c_init(ble_bp_c_evt_handler_t bp_callback)
+
+uint32_t ble_bp_c_cuff_notif_enable(ble_bp_c_t * p_ble_bp_c)
 {
-	  //printf("ble_bp_init\r\n");
-    ble_uuid_t bp_uuid;
-    bp_uuid.type = BLE_UUID_TYPE_BLE;
-    bp_uuid.uuid = BLE_UUID_BLOOD_PRESSURE_SERVICE/*BLE_UUID_HEART_RATE_SERVICE*/;
-
-	  mp_ble_bp_c = p_ble_bp_c;
-    mp_ble_bp_c->evt_handler     = bp_callback;
-    mp_ble_bp_c->conn_handle     = BLE_CONN_HANDLE_INVALID;
-    mp_ble_bp_c->bp_test_cccd_handle = BLE_GATT_HANDLE_INVALID;
-	 mp_ble_bp_c->bp_CUFF_cccd_handle = BLE_GATT_HANDLE_INVALID;
-	 mp_ble_bp_c->bp_CUFF_handle = BLE_GATT_HANDLE_INVALID;
-	 mp_ble_bp_c->bp_FEA_handle = BLE_GATT_HANDLE_INVALID;
-	 mp_ble_bp_c->bp_MEA_cccd_handle = BLE_GATT_HANDLE_INVALID;
-	mp_ble_bp_c->bp_MEA_handle = BLE_GATT_HANDLE_INVALID;
-	mp_ble_bp_c->bp_test_handle = BLE_GATT_HANDLE_INVALID;
-
-	
-    return ble_db_discovery_evt_register(&bp_uuid,
-                                         db_discover_evt_handler);
+    if (p_ble_bp_c == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (p_ble_bp_c->conn_handle == BLE_CONN_HANDLE_INVALID)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    if (p_ble_bp_c->icp_cccd_handle == BLE_GATT_HANDLE_INVALID)
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+
+    return cccd_configure(p_ble_bp_c->conn_handle, p_ble_bp_c->icp_cccd_handle, BLE_GATT_HVX_NOTIFICATION);
 }
+
+/** @}
+ *  @endcond
+ */
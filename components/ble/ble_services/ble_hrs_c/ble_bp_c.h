@@ -1,3 +1,22 @@
+/**@file
+ *
+ * @defgroup ble_sdk_srv_bp_c   Blood Pressure Service Client
+ * @{
+ * @ingroup  ble_sdk_srv
+ * @brief    Blood Pressure Service Client module.
+ *
+ * @details  This module discovers the Blood Pressure Service at the peer, enables the Blood
+ *           Pressure Measurement indication and the Intermediate Cuff Pressure notification, and
+ *           decodes the values received (see @ref ble_bp_c_meas_decode).
+ *
+ *           Several instances can be used, one per connection to a blood pressure sensor. Each
+ *           instance is initialized with @ref ble_bp_c_init. When the service is discovered on a
+ *           connection, the module gives the connection to the first free instance, or to the
+ *           instance already serving it, and the instance is freed on disconnection.
+ *
+ * @note     The application must propagate BLE stack events to each instance by calling
+ *           ble_bp_c_on_ble_evt().
+ */
 
 #ifndef BLE_BP_C_H__
 #define BLE_BP_C_H__
@@ -6,75 +25,167 @@
 #include <stdbool.h>
 #include "ble.h"
 #include "ble_srv_common.h"
+#include "ble_date_time.h"
 
+#ifndef BLE_BP_C_MAX_INSTANCES
+#define BLE_BP_C_MAX_INSTANCES          1   /**< Maximum number of instances, i.e. of blood pressure sensors served concurrently. */
+#endif
 
-#define BLE_UUID_BP_SERVICE 0x1810
-#define BLE_BP_CONN_HANDLE 0x0
+#define BLE_BP_C_MEAS_MAX_LEN           19  /**< Maximum length of a Blood Pressure Measurement or Intermediate Cuff Pressure value. */
 
-/* 
-//For LIght BLUE
-#define BLE_BP_MEASUREMENT_HANDLE 0x27//0x4d
-#define BLE_BP_MEASUREMENT_CCCD_HANDLE 0x28//0x4e
-#define BLE_CUFF_HANDLE 0x24//0x52
-#define BLE_CUFF_CCCD_HANDLE 0x25//0x53
-*/
+/**@defgroup BLE_BP_C_SFLOAT_SPECIAL Special values of an SFLOAT mantissa, with an exponent of 0
+ * @{ */
+#define BLE_BP_C_SFLOAT_NAN             2047    /**< Not a Number, e.g. the diastolic and mean arterial pressure of an Intermediate Cuff Pressure. */
+#define BLE_BP_C_SFLOAT_NRES            (-2048) /**< Not at this Resolution. */
+#define BLE_BP_C_SFLOAT_PLUS_INFINITY   2046    /**< + Infinity. */
+#define BLE_BP_C_SFLOAT_MINUS_INFINITY  (-2046) /**< - Infinity. */
+#define BLE_BP_C_SFLOAT_RESERVED        (-2047) /**< Reserved for future use. */
+/** @} */
 
-
-#define BLE_BP_MEASUREMENT_HANDLE 0xD 
-#define BLE_BP_MEASUREMENT_CCCD_HANDLE 0xE
-#define BLE_CUFF_HANDLE 0x10
-#define BLE_CUFF_CCCD_HANDLE 0x11
-
-
-#define bp_log //printf
+/**@brief BPS Client event type. */
 typedef enum
 {
-    BLE_BP_C_EVT_DISCOVERY_COMPLETE = 1,  /**< Event indicating that the Heart Rate Service has been discovered at the peer. */
-    BLE_BP_C_EVT_MEA_NOTIFICATION,         /**< Event indicating that a notification of the Heart Rate Measurement characteristic has been received from the peer. */
-    BLE_BP_C_EVT_CUFF_NOTIFICATION,
-	  BLE_BP_C_EVT_GOT_VAL,
-	 BLE_BP_C_EVT_DISCONNECTED
+    BLE_BP_C_EVT_DISCOVERY_COMPLETE = 1,  /**< Event indicating that the Blood Pressure Service has been discovered at the peer. */
+    BLE_BP_C_EVT_MEA_NOTIFICATION,        /**< Event indicating that a Blood Pressure Measurement has been indicated by the peer. */
+    BLE_BP_C_EVT_CUFF_NOTIFICATION,       /**< Event indicating that an Intermediate Cuff Pressure has been notified by the peer. */
+    BLE_BP_C_EVT_DISCONNECTED             /**< Event indicating that the connection of the instance is disconnected. The instance still holds the connection handle in the event handler, and is free again once the handler returns. */
 } ble_bp_c_evt_type_t;
 
-typedef struct ble_bp_c_s ble_bp_c_t;
-
+/**@brief Decoded Blood Pressure Measurement or Intermediate Cuff Pressure.
+ *
+ * @details For an Intermediate Cuff Pressure, the cuff pressure is in the systolic field, and the
+ *          diastolic and mean arterial pressure fields are @ref BLE_BP_C_SFLOAT_NAN.
+ */
+typedef struct
+{
+    bool            units_in_kpa;                /**< Blood Pressure Units Flag, false=mmHg, true=kPa. */
+    bool            time_stamp_present;          /**< True if time_stamp is present. */
+    bool            pulse_rate_present;          /**< True if pulse_rate is present. */
+    bool            user_id_present;             /**< True if user_id is present. */
+    bool            measurement_status_present;  /**< True if measurement_status is present. */
+    ieee_float16_t  systolic;                    /**< Systolic pressure, or current cuff pressure. */
+    ieee_float16_t  diastolic;                   /**< Diastolic pressure. */
+    ieee_float16_t  mean_arterial_pressure;      /**< Mean arterial pressure. */
+    ble_date_time_t time_stamp;                  /**< Time stamp. */
+    ieee_float16_t  pulse_rate;                  /**< Pulse rate, in beats per minute. */
+    uint8_t         user_id;                     /**< User ID, 0xFF if unknown. */
+    uint16_t        measurement_status;          /**< Measurement status bits. */
+} ble_bp_c_meas_t;
+
+/**@brief Value received from the peer. */
 typedef struct
 {
-    uint16_t bp_value[19];  /**< Heart Rate Value. */
+    ble_bp_c_meas_t meas;    /**< Decoded value. */
+    uint8_t const * p_data;  /**< Value as received, valid during the event only. */
+    uint8_t         len;     /**< Length of the value as received. */
 } ble_bp_t;
 
+/**@brief BPS Client event. */
 typedef struct
 {
     ble_bp_c_evt_type_t evt_type;  /**< Type of the event. */
     union
     {
-        ble_bp_t bp;  /**< Heart rate measurement received. This will be filled if the evt_type is @ref BLE_HRS_C_EVT_HRM_NOTIFICATION. */
+        ble_bp_t bp;               /**< Value received. Filled if the evt_type is @ref BLE_BP_C_EVT_MEA_NOTIFICATION or @ref BLE_BP_C_EVT_CUFF_NOTIFICATION. */
     } params;
 } ble_bp_c_evt_t;
 
-//typedef void (* ble_bp_c_evt_handler_t) (ble_bp_c_t * p_ble_bp_c, ble_bp_c_evt_t * p_evt);
+// Forward declaration of the ble_bp_c_t type.
+typedef struct ble_bp_c_s ble_bp_c_t;
+
+/**@brief BPS Client event handler type. */
 typedef void (* ble_bp_c_evt_handler_t) (ble_bp_c_t * p_ble_bp_c, ble_bp_c_evt_t * p_evt);
 
+/**@brief BPS Client instance. */
 struct ble_bp_c_s
 {
-    uint16_t                conn_handle;      /**< Connection handle as provided by the SoftDevice. */
-    uint16_t                bp_CUFF_cccd_handle;  /**< Handle of the CCCD of the Heart Rate Measurement characteristic. */
-    uint16_t                bp_MEA_cccd_handle;  /**< Handle of the CCCD of the Heart Rate Measurement characteristic. */
- // 	uint16_t                bp_handle;       /**< Handle of the Heart Rate Measurement characteristic as provided by the SoftDevice. */
-	uint16_t                bp_CUFF_handle;
-	uint16_t                bp_MEA_handle;
-		uint16_t                bp_FEA_handle;
-	  uint16_t                bp_test_handle;
-	 uint16_t                bp_test_cccd_handle;
-    ble_bp_c_evt_handler_t evt_handler;      /**< Application event handler to be called when there is an event related to the heart rate service. */
+    uint16_t               conn_handle;       /**< Connection handle of the instance, BLE_CONN_HANDLE_INVALID if the instance is free. */
+    uint16_t               meas_handle;       /**< Handle of the Blood Pressure Measurement characteristic. */
+    uint16_t               meas_cccd_handle;  /**< Handle of the CCCD of the Blood Pressure Measurement characteristic. */
+    uint16_t               icp_handle;        /**< Handle of the Intermediate Cuff Pressure characteristic, BLE_GATT_HANDLE_INVALID if the peer has none. */
+    uint16_t               icp_cccd_handle;   /**< Handle of the CCCD of the Intermediate Cuff Pressure characteristic. */
+    uint16_t               feature_handle;    /**< Handle of the Blood Pressure Feature characteristic. */
+    ble_bp_c_evt_handler_t evt_handler;       /**< Application event handler. */
 };
 
 
+/**@brief Function for initializing an instance of the Blood Pressure Service Client module.
+ *
+ * @details The first call registers the module with the database discovery module.
+ *
+ * @param[in]   p_ble_bp_c    Instance, kept by the module.
+ * @param[in]   bp_callback   Event handler.
+ *
+ * @retval NRF_SUCCESS      The instance is initialized.
+ * @retval NRF_ERROR_NULL   A parameter is NULL.
+ * @retval NRF_ERROR_NO_MEM @ref BLE_BP_C_MAX_INSTANCES instances are initialized.
+ * @return Otherwise, an error code returned by @ref ble_db_discovery_evt_register.
+ */
 uint32_t ble_bp_c_init(ble_bp_c_t * p_ble_bp_c, ble_bp_c_evt_handler_t bp_callback);
-uint32_t ble_bp_c_test_notif_enable(ble_bp_c_t * p_ble_bp_c);
-void ble_bp_c_on_ble_evt(ble_bp_c_t * p_bp, ble_evt_t * p_ble_evt);
+
+
+/**@brief Function for handling the Application's BLE Stack events for an instance.
+ *
+ * @details Handles the events of the connection of the instance: disconnection, and indications
+ *          and notifications, which are decoded and passed to the event handler. Indications are
+ *          confirmed.
+ *
+ * @param[in]   p_ble_bp_c   Instance.
+ * @param[in]   p_ble_evt    Event received from the BLE stack.
+ */
+void ble_bp_c_on_ble_evt(ble_bp_c_t * p_ble_bp_c, ble_evt_t * p_ble_evt);
+
+
+/**@brief Function for enabling the Blood Pressure Measurement indication at the peer.
+ *
+ * @param[in]   p_ble_bp_c   Instance.
+ *
+ * @retval NRF_SUCCESS             The CCCD write is queued.
+ * @retval NRF_ERROR_NULL          p_ble_bp_c is NULL.
+ * @retval NRF_ERROR_INVALID_STATE The service has not been discovered on the connection.
+ * @return Otherwise, an error code returned by @ref ble_gattc_queue_cccd_write.
+ */
 uint32_t ble_bp_c_mea_notif_enable(ble_bp_c_t * p_ble_bp_c);
+
+
+/**@brief Function for enabling the Intermediate Cuff Pressure notification at the peer.
+ *
+ * @param[in]   p_ble_bp_c   Instance.
+ *
+ * @retval NRF_SUCCESS             The CCCD write is queued.
+ * @retval NRF_ERROR_NULL          p_ble_bp_c is NULL.
+ * @retval NRF_ERROR_NOT_SUPPORTED The peer has no Intermediate Cuff Pressure characteristic.
+ * @retval NRF_ERROR_INVALID_STATE The service has not been discovered on the connection.
+ * @return Otherwise, an error code returned by @ref ble_gattc_queue_cccd_write.
+ */
 uint32_t ble_bp_c_cuff_notif_enable(ble_bp_c_t * p_ble_bp_c);
 
 
-#endif
\ No newline at end of file
+/**@brief Function for decoding a Blood Pressure Measurement or Intermediate Cuff Pressure value.
+ *
+ * @param[in]   p_data   Value.
+ * @param[in]   len      Length of the value.
+ * @param[out]  p_meas   Decoded value. Fields whose flag is not set are left unchanged.
+ *
+ * @retval NRF_SUCCESS              The value is decoded.
+ * @retval NRF_ERROR_NULL           p_data or p_meas is NULL.
+ * @retval NRF_ERROR_INVALID_LENGTH The value is shorter than its flags require.
+ */
+uint32_t ble_bp_c_meas_decode(uint8_t const * p_data, uint16_t len, ble_bp_c_meas_t * p_meas);
+
+
+/**@brief Function for converting an SFLOAT to an integer.
+ *
+ * @param[in]   sfloat    SFLOAT value.
+ * @param[out]  p_value   Value rounded toward zero.
+ *
+ * @retval NRF_SUCCESS            The value is converted.
+ * @retval NRF_ERROR_NULL         p_value is NULL.
+ * @retval NRF_ERROR_INVALID_DATA The SFLOAT is a special value (see @ref BLE_BP_C_SFLOAT_SPECIAL),
+ *                                or the value does not fit in an int32_t.
+ */
+uint32_t ble_bp_c_sfloat_to_int(ieee_float16_t sfloat, int32_t * p_value);
+
+#endif // BLE_BP_C_H__
+
+/** @} */
@@ -23,6 +23,138 @@
 
 #define NUS_BASE_UUID                  {{0x9E, 0xCA, 0xDC, 0x24, 0x0E, 0xE5, 0xA9, 0xE0, 0x93, 0xF3, 0xA3, 0xB5, 0x00, 0x00, 0x40, 0x6E}} /**< Used vendor specific UUID. */
 
+/**@brief Function for sending a stream event to the application.
+ *
+ * @param[in] p_nus     Nordic UART Service structure.
+ * @param[in] evt_type  Event type.
+ */
+static void stream_evt_send(ble_nus_t * p_nus, ble_nus_evt_type_t evt_type)
+{
+    if (p_nus->evt_handler != NULL)
+    {
+        p_nus->evt_handler(p_nus, evt_type);
+    }
+}
+
+
+/**@brief Function for sending the TX ring.
+ *
+ * @details Takes notifications of up to @ref BLE_NUS_MAX_DATA_LEN bytes from the TX ring and sends
+ *          them until the SoftDevice has no free TX buffer. A notification not accepted is kept in
+ *          tx_chunk and sent first next time, so bytes are never reordered.
+ *
+ * @param[in] p_nus     Nordic UART Service structure.
+ *
+ * @return NRF_SUCCESS if the ring is sent or the SoftDevice TX buffers are full, otherwise an error
+ *         code returned by sd_ble_gatts_hvx.
+ */
+static uint32_t stream_pump(ble_nus_t * p_nus)
+{
+    uint32_t               err_code;
+    uint16_t               len;
+    ble_gatts_hvx_params_t hvx_params;
+
+    if ((p_nus->conn_handle == BLE_CONN_HANDLE_INVALID) || (!p_nus->is_notification_enabled))
+    {
+        return NRF_SUCCESS;
+    }
+
+    memset(&hvx_params, 0, sizeof(hvx_params));
+
+    hvx_params.handle = p_nus->rx_handles.value_handle;
+    hvx_params.p_data = p_nus->tx_chunk;
+    hvx_params.p_len  = &len;
+    hvx_params.type   = BLE_GATT_HVX_NOTIFICATION;
+
+    for (;;)
+    {
+        if (p_nus->tx_chunk_len == 0)
+        {
+            uint32_t size = BLE_NUS_MAX_DATA_LEN;
+
+            if (app_fifo_read(&p_nus->tx_fifo, p_nus->tx_chunk, &size) != NRF_SUCCESS)
+            {
+                break;
+            }
+            p_nus->tx_chunk_len = (uint16_t)size;
+        }
+
+        len      = p_nus->tx_chunk_len;
+        err_code = sd_ble_gatts_hvx(p_nus->conn_handle, &hvx_params);
+        if (err_code == BLE_ERROR_NO_TX_BUFFERS)
+        {
+            break;
+        }
+        if (err_code != NRF_SUCCESS)
+        {
+            return err_code;
+        }
+        p_nus->tx_chunk_len = 0;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for sending the TX ring from an event handler.
+ *
+ * @details Sends @ref BLE_NUS_EVT_TX_RDY if the ring has room again. This is only done here, so the
+ *          application is not called back from within @ref ble_nus_stream_write.
+ *
+ * @param[in] p_nus     Nordic UART Service structure.
+ */
+static void stream_pump_on_evt(ble_nus_t * p_nus)
+{
+    uint32_t err_code;
+
+    if (!p_nus->tx_enabled)
+    {
+        return;
+    }
+
+    err_code = stream_pump(p_nus);
+    if ((err_code != NRF_SUCCESS) && (p_nus->error_handler != NULL))
+    {
+        p_nus->error_handler(err_code);
+    }
+
+    if (p_nus->tx_blocked && (app_fifo_length(&p_nus->tx_fifo) <= p_nus->tx_fifo.buf_size_mask))
+    {
+        p_nus->tx_blocked = false;
+        stream_evt_send(p_nus, BLE_NUS_EVT_TX_RDY);
+    }
+}
+
+
+/**@brief Function for putting bytes received from the peer in the RX ring.
+ *
+ * @param[in] p_nus     Nordic UART Service structure.
+ * @param[in] p_data    Bytes received.
+ * @param[in] length    Number of bytes received.
+ */
+static void stream_rx(ble_nus_t * p_nus, uint8_t const * p_data, uint16_t length)
+{
+    uint32_t size = length;
+    uint32_t free_space;
+
+    (void)app_fifo_write(&p_nus->rx_fifo, p_data, &size);
+    p_nus->rx_drop_count += length - size;
+
+    if (size != 0)
+    {
+        stream_evt_send(p_nus, BLE_NUS_EVT_RX_DATA);
+    }
+
+    // The application may have read the ring in the event handler.
+    free_space = (uint32_t)p_nus->rx_fifo.buf_size_mask + 1 - app_fifo_length(&p_nus->rx_fifo);
+    if (!p_nus->rx_paused && (free_space < p_nus->rx_low_water))
+    {
+        p_nus->rx_paused = true;
+        stream_evt_send(p_nus, BLE_NUS_EVT_RX_FULL);
+    }
+}
+
+
 /**@brief Function for handling the @ref BLE_GAP_EVT_CONNECTED event from the S110 SoftDevice.
  *
  * @param[in] p_nus     Nordic UART Service structure.
@@ -43,6 +175,13 @@ static void on_disconnect(ble_nus_t * p_nus, ble_evt_t * p_ble_evt)
 {
     UNUSED_PARAMETER(p_ble_evt);
     p_nus->conn_handle = BLE_CONN_HANDLE_INVALID;
+
+    // Bytes of the stream are not kept for the next peer.
+    p_nus->tx_chunk_len = 0;
+    p_nus->tx_blocked   = false;
+    p_nus->rx_paused    = false;
+    (void)app_fifo_flush(&p_nus->tx_fifo);
+    (void)app_fifo_flush(&p_nus->rx_fifo);
 }
 
 
@@ -64,12 +203,17 @@ static void on_write(ble_nus_t * p_nus, ble_evt_t * p_ble_evt)
         if (ble_srv_is_notification_enabled(p_evt_write->data))
         {
             p_nus->is_notification_enabled = true;
+            stream_pump_on_evt(p_nus);
         }
         else
         {
             p_nus->is_notification_enabled = false;
         }
     }
+    else if ((p_evt_write->handle == p_nus->tx_handles.value_handle) && p_nus->rx_enabled)
+    {
+        stream_rx(p_nus, p_evt_write->data, p_evt_write->len);
+    }
     else if (
              (p_evt_write->handle == p_nus->tx_handles.value_handle)
              &&
@@ -219,6 +363,10 @@ void ble_nus_on_ble_evt(ble_nus_t * p_nus, ble_evt_t * p_ble_evt)
             on_write(p_nus, p_ble_evt);
             break;
 
+        case BLE_EVT_TX_COMPLETE:
+            stream_pump_on_evt(p_nus);
+            break;
+
         default:
             // No implementation needed.
             break;
@@ -237,10 +385,38 @@ uint32_t ble_nus_init(ble_nus_t * p_nus, const ble_nus_init_t * p_nus_init)
         return NRF_ERROR_NULL;
     }
 
+    if (p_nus_init->rx_low_water > p_nus_init->rx_buf_size / 2)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
     // Initialize the service structure.
     p_nus->conn_handle             = BLE_CONN_HANDLE_INVALID;
     p_nus->data_handler            = p_nus_init->data_handler;
     p_nus->is_notification_enabled = false;
+    p_nus->evt_handler             = p_nus_init->evt_handler;
+    p_nus->error_handler           = p_nus_init->error_handler;
+    p_nus->tx_enabled              = (p_nus_init->p_tx_buf != NULL);
+    p_nus->rx_enabled              = (p_nus_init->p_rx_buf != NULL);
+    p_nus->tx_chunk_len            = 0;
+    p_nus->tx_blocked              = false;
+    p_nus->rx_paused               = false;
+    p_nus->rx_low_water            = p_nus_init->rx_low_water;
+    p_nus->rx_drop_count           = 0;
+
+    // Set up the rings of the stream.
+    memset(&p_nus->tx_fifo, 0, sizeof(p_nus->tx_fifo));
+    memset(&p_nus->rx_fifo, 0, sizeof(p_nus->rx_fifo));
+    if (p_nus->tx_enabled &&
+        (app_fifo_init(&p_nus->tx_fifo, p_nus_init->p_tx_buf, p_nus_init->tx_buf_size) != NRF_SUCCESS))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (p_nus->rx_enabled &&
+        (app_fifo_init(&p_nus->rx_fifo, p_nus_init->p_rx_buf, p_nus_init->rx_buf_size) != NRF_SUCCESS))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
 
     /**@snippet [Adding proprietary Service to S110 SoftDevice] */
     // Add a custom base UUID.
@@ -311,3 +487,56 @@ uint32_t ble_nus_string_send(ble_nus_t * p_nus, uint8_t * p_string, uint16_t len
 }
 
 
+uint32_t ble_nus_stream_write(ble_nus_t * p_nus, uint8_t const * p_data, uint16_t * p_length)
+{
+    uint32_t size;
+
+    if ((p_nus == NULL) || (p_data == NULL) || (p_length == NULL))
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if (!p_nus->tx_enabled)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    size = *p_length;
+    if (app_fifo_write(&p_nus->tx_fifo, p_data, &size) != NRF_SUCCESS)
+    {
+        p_nus->tx_blocked = true;
+    }
+    *p_length = (uint16_t)size;
+
+    return stream_pump(p_nus);
+}
+
+
+uint32_t ble_nus_stream_read(ble_nus_t * p_nus, uint8_t * p_data, uint16_t * p_length)
+{
+    uint32_t err_code;
+    uint32_t size;
+
+    if ((p_nus == NULL) || (p_data == NULL) || (p_length == NULL))
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if (!p_nus->rx_enabled)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    size      = *p_length;
+    err_code  = app_fifo_read(&p_nus->rx_fifo, p_data, &size);
+    *p_length = (uint16_t)size;
+
+    if (p_nus->rx_paused &&
+        (app_fifo_length(&p_nus->rx_fifo) <= ((uint32_t)p_nus->rx_fifo.buf_size_mask + 1) / 2))
+    {
+        p_nus->rx_paused = false;
+        stream_evt_send(p_nus, BLE_NUS_EVT_RX_RESUME);
+    }
+
+    return err_code;
+}
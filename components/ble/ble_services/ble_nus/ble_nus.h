@@ -25,6 +25,14 @@
  *          is used by the application to send and receive ASCII text strings to and from the
  *          peer.
  *
+ *          For bulk data, the service can also be used as a byte stream. Bytes written with
+ *          @ref ble_nus_stream_write are put in a TX ring and sent in notifications of
+ *          @ref BLE_NUS_MAX_DATA_LEN bytes. Every free SoftDevice TX buffer is filled, and filled
+ *          again on each @ref BLE_EVT_TX_COMPLETE, so several notifications are sent in each
+ *          connection event. Bytes received from the peer are put in an RX ring and read with
+ *          @ref ble_nus_stream_read. Both rings are given by the application in
+ *          @ref ble_nus_init_t.
+ *
  * @note The application must propagate S110 SoftDevice events to the Nordic UART Service module
  *       by calling the ble_nus_on_ble_evt() function from the ble_stack_handler callback.
  */
@@ -34,6 +42,7 @@
 
 #include "ble.h"
 #include "ble_srv_common.h"
+#include "app_fifo.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -46,6 +55,18 @@ typedef struct ble_nus_s ble_nus_t;
 /**@brief Nordic UART Service event handler type. */
 typedef void (*ble_nus_data_handler_t) (ble_nus_t * p_nus, uint8_t * p_data, uint16_t length);
 
+/**@brief Nordic UART Service stream event type. */
+typedef enum
+{
+    BLE_NUS_EVT_RX_DATA,   /**< Bytes received from the peer have been put in the RX ring. */
+    BLE_NUS_EVT_RX_FULL,   /**< The free space in the RX ring is below ble_nus_init_t::rx_low_water. Bytes that do not fit are dropped, the application should read the ring faster or ask the peer to pause. */
+    BLE_NUS_EVT_RX_RESUME, /**< The RX ring is half empty again after @ref BLE_NUS_EVT_RX_FULL. */
+    BLE_NUS_EVT_TX_RDY     /**< There is free space in the TX ring again after @ref ble_nus_stream_write could not take all bytes. */
+} ble_nus_evt_type_t;
+
+/**@brief Nordic UART Service stream event handler type. */
+typedef void (*ble_nus_evt_handler_t) (ble_nus_t * p_nus, ble_nus_evt_type_t evt_type);
+
 /**@brief Nordic UART Service initialization structure.
  *
  * @details This structure contains the initialization information for the service. The application
@@ -54,7 +75,14 @@ typedef void (*ble_nus_data_handler_t) (ble_nus_t * p_nus, uint8_t * p_data, uin
  */
 typedef struct
 {
-    ble_nus_data_handler_t data_handler; /**< Event handler to be called for handling received data. */
+    ble_nus_data_handler_t  data_handler;  /**< Event handler to be called for handling received data. Not used if p_rx_buf is set. */
+    ble_nus_evt_handler_t   evt_handler;   /**< Handler of the stream events, may be NULL. */
+    ble_srv_error_handler_t error_handler; /**< Handler of the errors when sending the TX ring on @ref BLE_EVT_TX_COMPLETE, may be NULL. */
+    uint8_t *               p_tx_buf;      /**< TX ring of the stream, NULL if @ref ble_nus_stream_write is not used. */
+    uint16_t                tx_buf_size;   /**< Size of the TX ring, a power of two. */
+    uint8_t *               p_rx_buf;      /**< RX ring of the stream, NULL to pass received data to data_handler instead. */
+    uint16_t                rx_buf_size;   /**< Size of the RX ring, a power of two. */
+    uint16_t                rx_low_water;  /**< Free space of the RX ring below which @ref BLE_NUS_EVT_RX_FULL is sent. At most half the RX ring. */
 } ble_nus_init_t;
 
 /**@brief Nordic UART Service structure.
@@ -70,6 +98,18 @@ struct ble_nus_s
     uint16_t                 conn_handle;             /**< Handle of the current connection (as provided by the S110 SoftDevice). BLE_CONN_HANDLE_INVALID if not in a connection. */
     bool                     is_notification_enabled; /**< Variable to indicate if the peer has enabled notification of the RX characteristic.*/
     ble_nus_data_handler_t   data_handler;            /**< Event handler to be called for handling received data. */
+    ble_nus_evt_handler_t    evt_handler;             /**< Handler of the stream events. */
+    ble_srv_error_handler_t  error_handler;           /**< Handler of the errors when sending the TX ring. */
+    bool                     tx_enabled;              /**< Variable to indicate if the TX ring is used. */
+    bool                     rx_enabled;              /**< Variable to indicate if the RX ring is used. */
+    app_fifo_t               tx_fifo;                 /**< TX ring. */
+    app_fifo_t               rx_fifo;                 /**< RX ring. */
+    uint8_t                  tx_chunk[BLE_NUS_MAX_DATA_LEN]; /**< Notification taken from the TX ring and not yet accepted by the SoftDevice. */
+    uint16_t                 tx_chunk_len;            /**< Length of tx_chunk, 0 if none. */
+    bool                     tx_blocked;              /**< Variable to indicate if @ref BLE_NUS_EVT_TX_RDY is to be sent. */
+    bool                     rx_paused;               /**< Variable to indicate if @ref BLE_NUS_EVT_RX_FULL was sent and not yet followed by @ref BLE_NUS_EVT_RX_RESUME. */
+    uint16_t                 rx_low_water;            /**< Free space of the RX ring below which @ref BLE_NUS_EVT_RX_FULL is sent. */
+    uint32_t                 rx_drop_count;           /**< Number of received bytes dropped because the RX ring was full. */
 };
 
 /**@brief Function for initializing the Nordic UART Service.
@@ -81,6 +121,8 @@ struct ble_nus_s
  *
  * @retval NRF_SUCCESS If the service was successfully initialized. Otherwise, an error code is returned.
  * @retval NRF_ERROR_NULL If either of the pointers p_nus or p_nus_init is NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If a ring size is not a power of two, or rx_low_water is larger
+ *                                 than half the RX ring.
  */
 uint32_t ble_nus_init(ble_nus_t * p_nus, const ble_nus_init_t * p_nus_init);
 
@@ -109,6 +151,46 @@ void ble_nus_on_ble_evt(ble_nus_t * p_nus, ble_evt_t * p_ble_evt);
  */
 uint32_t ble_nus_string_send(ble_nus_t * p_nus, uint8_t * p_string, uint16_t length);
 
+/**@brief Function for writing bytes to the stream.
+ *
+ * @details The bytes are put in the TX ring, then as much of the ring as the SoftDevice TX buffers
+ *          can take is sent. The rest is sent on @ref BLE_EVT_TX_COMPLETE. Bytes written while
+ *          notifications are disabled are kept until they are enabled, and dropped on
+ *          disconnection. Must not be mixed with @ref ble_nus_string_send.
+ *
+ * @note    The TX ring and the notification being built are also changed when the ring is sent on
+ *          @ref BLE_EVT_TX_COMPLETE, without a critical region. This function must therefore
+ *          neither preempt nor be preempted by the handling of SoftDevice events: call it at the
+ *          same interrupt priority, e.g. from a UART event handler with both interrupts at
+ *          APP_IRQ_PRIORITY_LOW, or from the context events are handled in when they go through
+ *          the scheduler.
+ *
+ * @param[in]    p_nus      Pointer to the Nordic UART Service structure.
+ * @param[in]    p_data     Bytes to write.
+ * @param[inout] p_length   Number of bytes to write. Number of bytes written on return, less if
+ *                          the TX ring is full. @ref BLE_NUS_EVT_TX_RDY is then sent when there is
+ *                          room again.
+ *
+ * @retval NRF_SUCCESS             If the bytes were written, maybe not all of them.
+ * @retval NRF_ERROR_NULL          If a pointer is NULL.
+ * @retval NRF_ERROR_INVALID_STATE If the service has no TX ring.
+ * @return Otherwise, an error code returned by sd_ble_gatts_hvx.
+ */
+uint32_t ble_nus_stream_write(ble_nus_t * p_nus, uint8_t const * p_data, uint16_t * p_length);
+
+/**@brief Function for reading bytes from the stream.
+ *
+ * @param[in]    p_nus      Pointer to the Nordic UART Service structure.
+ * @param[out]   p_data     Memory to read the bytes into.
+ * @param[inout] p_length   Number of bytes to read. Number of bytes read on return.
+ *
+ * @retval NRF_SUCCESS             If at least one byte was read.
+ * @retval NRF_ERROR_NOT_FOUND     If the RX ring is empty.
+ * @retval NRF_ERROR_NULL          If a pointer is NULL.
+ * @retval NRF_ERROR_INVALID_STATE If the service has no RX ring.
+ */
+uint32_t ble_nus_stream_read(ble_nus_t * p_nus, uint8_t * p_data, uint16_t * p_length);
+
 #endif // BLE_NUS_H__
 
 /** @} */
@@ -1,4 +1,25 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
 #include "ble_advdata_parser.h"
+#include <string.h>
+#include "nrf_error.h"
+#include "app_util.h"
+
+#define FIELD_HEADER_SIZE   2   /**< Size of the length and AD type bytes preceding the field data. */
+#define UUID16_SIZE         2   /**< Size of a 16-bit UUID. */
+#define UUID128_SIZE        16  /**< Size of a 128-bit UUID. */
+#define COMPANY_ID_SIZE     2   /**< Size of the company identifier of manufacturer specific data. */
+
 
 uint32_t ble_advdata_parser_field_find(uint8_t    type,
                                        uint8_t  * p_advdata,
@@ -10,11 +31,18 @@ uint32_t ble_advdata_parser_field_find(uint8_t    type,
     while (index < *len)
     {
         uint8_t field_length = p_advdata[index];
-        uint8_t field_type   = p_advdata[index + 1];
 
-        if (field_type == type)
+        if (field_length == 0)
+        {
+            break;
+        }
+        if (index + 1 + field_length > *len)
+        {
+            return NRF_ERROR_INVALID_LENGTH;
+        }
+        if (p_advdata[index + 1] == type)
         {
-            *pp_field_data = &p_advdata[index + 2];
+            *pp_field_data = &p_advdata[index + FIELD_HEADER_SIZE];
             *len           = field_length - 1;
             return NRF_SUCCESS;
         }
@@ -22,3 +50,212 @@ uint32_t ble_advdata_parser_field_find(uint8_t    type,
     }
     return NRF_ERROR_NOT_FOUND;
 }
+
+
+uint32_t ble_advdata_index_build(uint8_t const * p_data, uint8_t len, ble_advdata_index_t * p_index)
+{
+    uint32_t offset = 0;
+
+    if ((p_data == NULL) || (p_index == NULL))
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    p_index->p_data = p_data;
+    p_index->count  = 0;
+
+    while (offset < len)
+    {
+        uint8_t field_length = p_data[offset];
+
+        if (field_length == 0)
+        {
+            // Zero padding ends the significant part of the data.
+            break;
+        }
+        if (offset + 1 + field_length > len)
+        {
+            return NRF_ERROR_INVALID_LENGTH;
+        }
+        if (p_index->count == BLE_ADVDATA_INDEX_MAX_FIELDS)
+        {
+            return NRF_ERROR_NO_MEM;
+        }
+
+        p_index->fields[p_index->count].type   = p_data[offset + 1];
+        p_index->fields[p_index->count].offset = (uint8_t)(offset + FIELD_HEADER_SIZE);
+        p_index->fields[p_index->count].len    = field_length - 1;
+        p_index->count++;
+
+        offset += field_length + 1;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ble_advdata_field_get(ble_advdata_index_t const * p_index,
+                               uint8_t                     type,
+                               uint8_t const            ** pp_data,
+                               uint8_t                   * p_len)
+{
+    uint32_t i;
+
+    for (i = 0; i < p_index->count; i++)
+    {
+        if (p_index->fields[i].type == type)
+        {
+            *pp_data = &p_index->p_data[p_index->fields[i].offset];
+            *p_len   = p_index->fields[i].len;
+            return NRF_SUCCESS;
+        }
+    }
+    return NRF_ERROR_NOT_FOUND;
+}
+
+
+/**@brief Function for checking if a UUID is listed in the UUID list fields of the given types.
+ *
+ * @param[in]  p_index     Index of the advertising data.
+ * @param[in]  type_more   AD type of the incomplete list.
+ * @param[in]  type_cmpl   AD type of the complete list.
+ * @param[in]  p_uuid      UUID, little endian.
+ * @param[in]  uuid_size   Size of the UUID.
+ *
+ * @return True if the UUID is listed.
+ */
+static bool uuid_find(ble_advdata_index_t const * p_index,
+                      uint8_t                     type_more,
+                      uint8_t                     type_cmpl,
+                      uint8_t const             * p_uuid,
+                      uint8_t                     uuid_size)
+{
+    uint32_t i;
+
+    for (i = 0; i < p_index->count; i++)
+    {
+        ble_advdata_field_t const * p_field = &p_index->fields[i];
+        uint8_t const             * p_list;
+        uint32_t                    pos;
+
+        if ((p_field->type != type_more) && (p_field->type != type_cmpl))
+        {
+            continue;
+        }
+
+        p_list = &p_index->p_data[p_field->offset];
+        for (pos = 0; pos + uuid_size <= p_field->len; pos += uuid_size)
+        {
+            if (memcmp(&p_list[pos], p_uuid, uuid_size) == 0)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+
+bool ble_advdata_uuid16_find(ble_advdata_index_t const * p_index, uint16_t uuid)
+{
+    uint8_t encoded_uuid[UUID16_SIZE];
+
+    (void)uint16_encode(uuid, encoded_uuid);
+
+    return uuid_find(p_index,
+                     BLE_GAP_AD_TYPE_16BIT_SERVICE_UUID_MORE_AVAILABLE,
+                     BLE_GAP_AD_TYPE_16BIT_SERVICE_UUID_COMPLETE,
+                     encoded_uuid,
+                     UUID16_SIZE);
+}
+
+
+bool ble_advdata_uuid128_find(ble_advdata_index_t const * p_index, uint8_t const * p_uuid128)
+{
+    return uuid_find(p_index,
+                     BLE_GAP_AD_TYPE_128BIT_SERVICE_UUID_MORE_AVAILABLE,
+                     BLE_GAP_AD_TYPE_128BIT_SERVICE_UUID_COMPLETE,
+                     p_uuid128,
+                     UUID128_SIZE);
+}
+
+
+uint32_t ble_advdata_name_get(ble_advdata_index_t const * p_index,
+                              uint8_t const            ** pp_name,
+                              uint8_t                   * p_len,
+                              bool                      * p_complete)
+{
+    bool complete = true;
+
+    if (ble_advdata_field_get(p_index, BLE_GAP_AD_TYPE_COMPLETE_LOCAL_NAME, pp_name, p_len)
+        != NRF_SUCCESS)
+    {
+        if (ble_advdata_field_get(p_index, BLE_GAP_AD_TYPE_SHORT_LOCAL_NAME, pp_name, p_len)
+            != NRF_SUCCESS)
+        {
+            return NRF_ERROR_NOT_FOUND;
+        }
+        complete = false;
+    }
+
+    if (p_complete != NULL)
+    {
+        *p_complete = complete;
+    }
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ble_advdata_manuf_data_get(ble_advdata_index_t const * p_index,
+                                    uint16_t                  * p_company_id,
+                                    uint8_t const            ** pp_data,
+                                    uint8_t                   * p_len)
+{
+    uint8_t const * p_field;
+    uint8_t         field_len;
+    uint32_t        err_code;
+
+    err_code = ble_advdata_field_get(p_index,
+                                     BLE_GAP_AD_TYPE_MANUFACTURER_SPECIFIC_DATA,
+                                     &p_field,
+                                     &field_len);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+    if (field_len < COMPANY_ID_SIZE)
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    *p_company_id = uint16_decode(p_field);
+    *pp_data      = &p_field[COMPANY_ID_SIZE];
+    *p_len        = field_len - COMPANY_ID_SIZE;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ble_advdata_service_data_get(ble_advdata_index_t const * p_index,
+                                      uint16_t                    uuid,
+                                      uint8_t const            ** pp_data,
+                                      uint8_t                   * p_len)
+{
+    uint32_t i;
+
+    // A report may carry service data for several services, so every field is checked.
+    for (i = 0; i < p_index->count; i++)
+    {
+        ble_advdata_field_t const * p_field = &p_index->fields[i];
+        uint8_t const             * p_value = &p_index->p_data[p_field->offset];
+
+        if ((p_field->type == BLE_GAP_AD_TYPE_SERVICE_DATA) &&
+            (p_field->len >= UUID16_SIZE)                   &&
+            (uint16_decode(p_value) == uuid))
+        {
+            *pp_data = &p_value[UUID16_SIZE];
+            *p_len   = p_field->len - UUID16_SIZE;
+            return NRF_SUCCESS;
+        }
+    }
+    return NRF_ERROR_NOT_FOUND;
+}
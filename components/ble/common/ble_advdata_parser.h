@@ -1,9 +1,186 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ble_sdk_lib_advdata_parser Advertising Data Parser
+ * @{
+ * @ingroup ble_sdk_lib
+ * @brief Functions for finding fields in received advertising data and scan response data.
+ *
+ * @details @ref ble_advdata_index_build walks the data once, validates the length of every field,
+ *          and records the type, offset and length of each field in an index. The lookup functions
+ *          then search the index instead of the data, so looking up several fields of a report
+ *          costs a single pass over it.
+ */
+
 #ifndef BLE_ADVDATA_PARSER_H_
 #define BLE_ADVDATA_PARSER_H_
 
+#include <stdint.h>
+#include <stdbool.h>
 #include "ble_advdata.h"
 
+#define BLE_ADVDATA_INDEX_MAX_FIELDS (BLE_GAP_ADV_MAX_SIZE / 2)  /**< Maximum number of fields in advertising data, each field has at least a length and a type byte. */
+
+/**@brief Location of a field in advertising data. */
+typedef struct
+{
+    uint8_t type;    /**< AD type of the field, see @ref BLE_GAP_AD_TYPE_DEFINITIONS. */
+    uint8_t offset;  /**< Offset of the field data, following the AD type, in the advertising data. */
+    uint8_t len;     /**< Length of the field data. */
+} ble_advdata_field_t;
+
+/**@brief Index of the fields of advertising data. */
+typedef struct
+{
+    uint8_t const *     p_data;                                  /**< Advertising data the index refers to. */
+    uint8_t             count;                                   /**< Number of fields in the index. */
+    ble_advdata_field_t fields[BLE_ADVDATA_INDEX_MAX_FIELDS];    /**< Fields, in the order they are found in the data. */
+} ble_advdata_index_t;
+
+
 uint32_t ble_advdata_parse(uint8_t * p_data, uint8_t len, ble_advdata_t * advdata);
+
+
+/**@brief Function for finding a field in advertising data.
+ *
+ * @details Walks the data up to the field. To look up several fields of the same data, use
+ *          @ref ble_advdata_index_build and the lookup functions instead.
+ *
+ * @param[in]     type            AD type of the field.
+ * @param[in]     p_advdata       Advertising data.
+ * @param[in,out] len             In: length of the advertising data. Out: length of the field
+ *                                data.
+ * @param[out]    pp_field_data   Field data.
+ *
+ * @retval NRF_SUCCESS              The field is found.
+ * @retval NRF_ERROR_NOT_FOUND      The data has no field of this type.
+ * @retval NRF_ERROR_INVALID_LENGTH A field preceding or matching the type runs past the end of the
+ *                                  data.
+ */
 uint32_t ble_advdata_parser_field_find(uint8_t type, uint8_t * p_advdata, uint8_t * len, uint8_t ** pp_field_data);
 
+
+/**@brief Function for indexing the fields of advertising data.
+ *
+ * @details A field with a length of 0 ends the significant part of the data, the rest is ignored.
+ *
+ * @param[in]  p_data    Advertising data. It must be kept unchanged while the index is used.
+ * @param[in]  len       Length of the advertising data.
+ * @param[out] p_index   Index of the fields.
+ *
+ * @retval NRF_SUCCESS              The data is indexed.
+ * @retval NRF_ERROR_NULL           A parameter is NULL.
+ * @retval NRF_ERROR_INVALID_LENGTH A field runs past the end of the data. The index holds the
+ *                                  fields preceding it.
+ * @retval NRF_ERROR_NO_MEM         The data has more than @ref BLE_ADVDATA_INDEX_MAX_FIELDS fields.
+ *                                  The index holds the first ones.
+ */
+uint32_t ble_advdata_index_build(uint8_t const * p_data, uint8_t len, ble_advdata_index_t * p_index);
+
+
+/**@brief Function for getting a field of indexed advertising data.
+ *
+ * @param[in]  p_index     Index of the advertising data.
+ * @param[in]  type        AD type of the field.
+ * @param[out] pp_data     Field data.
+ * @param[out] p_len       Length of the field data.
+ *
+ * @retval NRF_SUCCESS         The first field of this type is returned.
+ * @retval NRF_ERROR_NOT_FOUND The data has no field of this type.
+ */
+uint32_t ble_advdata_field_get(ble_advdata_index_t const * p_index,
+                               uint8_t                     type,
+                               uint8_t const            ** pp_data,
+                               uint8_t                   * p_len);
+
+
+/**@brief Function for checking if a 16-bit service UUID is listed in indexed advertising data.
+ *
+ * @details Both the complete and the incomplete lists of 16-bit service UUIDs are searched.
+ *
+ * @param[in]  p_index     Index of the advertising data.
+ * @param[in]  uuid        16-bit UUID of the service.
+ *
+ * @return True if the UUID is listed.
+ */
+bool ble_advdata_uuid16_find(ble_advdata_index_t const * p_index, uint16_t uuid);
+
+
+/**@brief Function for checking if a 128-bit service UUID is listed in indexed advertising data.
+ *
+ * @details Both the complete and the incomplete lists of 128-bit service UUIDs are searched.
+ *
+ * @param[in]  p_index     Index of the advertising data.
+ * @param[in]  p_uuid128   128-bit UUID of the service, little endian as transmitted over the air.
+ *
+ * @return True if the UUID is listed.
+ */
+bool ble_advdata_uuid128_find(ble_advdata_index_t const * p_index, uint8_t const * p_uuid128);
+
+
+/**@brief Function for getting the device name in indexed advertising data.
+ *
+ * @details The complete local name is returned if present, the shortened local name otherwise.
+ *          The name is not zero terminated.
+ *
+ * @param[in]  p_index     Index of the advertising data.
+ * @param[out] pp_name     Name.
+ * @param[out] p_len       Length of the name.
+ * @param[out] p_complete  True if the name is the complete local name. May be NULL.
+ *
+ * @retval NRF_SUCCESS         The name is found.
+ * @retval NRF_ERROR_NOT_FOUND The data has no name.
+ */
+uint32_t ble_advdata_name_get(ble_advdata_index_t const * p_index,
+                              uint8_t const            ** pp_name,
+                              uint8_t                   * p_len,
+                              bool                      * p_complete);
+
+
+/**@brief Function for getting the manufacturer specific data in indexed advertising data.
+ *
+ * @param[in]  p_index        Index of the advertising data.
+ * @param[out] p_company_id   Company identifier.
+ * @param[out] pp_data        Data following the company identifier.
+ * @param[out] p_len          Length of the data following the company identifier.
+ *
+ * @retval NRF_SUCCESS              The manufacturer specific data is found.
+ * @retval NRF_ERROR_NOT_FOUND      The data has no manufacturer specific data.
+ * @retval NRF_ERROR_INVALID_LENGTH The field is too short to hold a company identifier.
+ */
+uint32_t ble_advdata_manuf_data_get(ble_advdata_index_t const * p_index,
+                                    uint16_t                  * p_company_id,
+                                    uint8_t const            ** pp_data,
+                                    uint8_t                   * p_len);
+
+
+/**@brief Function for getting the service data of a 16-bit service UUID in indexed advertising
+ *        data.
+ *
+ * @param[in]  p_index     Index of the advertising data.
+ * @param[in]  uuid        16-bit UUID of the service.
+ * @param[out] pp_data     Service data following the UUID.
+ * @param[out] p_len       Length of the service data following the UUID.
+ *
+ * @retval NRF_SUCCESS         The service data is found.
+ * @retval NRF_ERROR_NOT_FOUND The data has no service data for this UUID.
+ */
+uint32_t ble_advdata_service_data_get(ble_advdata_index_t const * p_index,
+                                      uint16_t                    uuid,
+                                      uint8_t const            ** pp_data,
+                                      uint8_t                   * p_len);
+
 #endif
+
+/** @} */
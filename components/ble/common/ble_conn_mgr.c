@@ -0,0 +1,534 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "ble_conn_mgr.h"
+#include <string.h>
+#include "nordic_common.h"
+#include "nrf_error.h"
+#include "ble_hci.h"
+#include "app_timer.h"
+#include "app_util.h"
+
+STATIC_ASSERT(BLE_CONN_MGR_MAX_TARGETS <= BLE_GAP_WHITELIST_ADDR_MAX_COUNT);
+STATIC_ASSERT(BLE_CONN_MGR_MAX_TARGETS < BLE_CONN_MGR_TARGET_ID_INVALID);
+
+static ble_conn_mgr_link_t           m_links[BLE_CONN_MGR_MAX_TARGETS];                 /**< Targets and their links, indexed by target identifier. A free entry has an invalid target identifier. */
+static uint8_t                       m_link_by_handle[BLE_CONN_MGR_CONN_HANDLE_MAX];    /**< Target identifier of each connection handle. */
+
+static ble_conn_mgr_evt_handler_t    m_evt_handler;                                     /**< Event handler. */
+static ble_srv_error_handler_t       m_error_handler;                                   /**< Error handler. */
+static ble_gap_conn_params_t const * mp_conn_params;                                    /**< Connection parameters. */
+static ble_gap_scan_params_t         m_scan_params;                                     /**< Scan parameters of the connection procedure. */
+static ble_gap_whitelist_t           m_whitelist;                                       /**< Whitelist of the connection procedure. */
+static ble_gap_addr_t              * mp_whitelist_addr[BLE_CONN_MGR_MAX_TARGETS];       /**< Addresses in the whitelist. */
+
+static app_timer_id_t                m_backoff_timer_id;                                /**< Timer delaying the next connection procedure. */
+static uint32_t                      m_backoff_min;                                     /**< Delay after the first failed connection procedure. */
+static uint32_t                      m_backoff_max;                                     /**< Largest delay between connection procedures. */
+static uint32_t                      m_backoff;                                         /**< Delay after the next failed connection procedure. */
+static bool                          m_backoff_running;                                 /**< True if the back-off timer is running. */
+static bool                          m_connecting;                                      /**< True if a connection procedure is ongoing. */
+
+
+/**@brief Function for checking if two addresses are equal. */
+static bool addr_equal(ble_gap_addr_t const * p_addr1, ble_gap_addr_t const * p_addr2)
+{
+    return (p_addr1->addr_type == p_addr2->addr_type) &&
+           (memcmp(p_addr1->addr, p_addr2->addr, BLE_GAP_ADDR_LEN) == 0);
+}
+
+
+/**@brief Function for finding a target by its address.
+ *
+ * @param[in]   p_addr   Address of the target.
+ *
+ * @return Target, or NULL if there is no target with this address.
+ */
+static ble_conn_mgr_link_t * target_find(ble_gap_addr_t const * p_addr)
+{
+    uint8_t i;
+
+    for (i = 0; i < BLE_CONN_MGR_MAX_TARGETS; i++)
+    {
+        if ((m_links[i].target_id != BLE_CONN_MGR_TARGET_ID_INVALID) &&
+            addr_equal(&m_links[i].addr, p_addr))
+        {
+            return &m_links[i];
+        }
+    }
+    return NULL;
+}
+
+
+/**@brief Function for finding the link of a connection handle.
+ *
+ * @param[in]   conn_handle   Connection handle.
+ *
+ * @return Link, or NULL if the connection is not to a target.
+ */
+static ble_conn_mgr_link_t * link_find(uint16_t conn_handle)
+{
+    uint8_t i;
+
+    if (conn_handle == BLE_CONN_HANDLE_INVALID)
+    {
+        return NULL;
+    }
+
+    if (conn_handle < BLE_CONN_MGR_CONN_HANDLE_MAX)
+    {
+        uint8_t target_id = m_link_by_handle[conn_handle];
+
+        return (target_id == BLE_CONN_MGR_TARGET_ID_INVALID) ? NULL : &m_links[target_id];
+    }
+
+    for (i = 0; i < BLE_CONN_MGR_MAX_TARGETS; i++)
+    {
+        if ((m_links[i].target_id != BLE_CONN_MGR_TARGET_ID_INVALID) &&
+            (m_links[i].conn_handle == conn_handle))
+        {
+            return &m_links[i];
+        }
+    }
+    return NULL;
+}
+
+
+/**@brief Function for ending the connection procedure, its targets are put back in the idle state.
+ */
+static void connecting_end(void)
+{
+    uint8_t i;
+
+    m_connecting = false;
+
+    for (i = 0; i < BLE_CONN_MGR_MAX_TARGETS; i++)
+    {
+        if ((m_links[i].target_id != BLE_CONN_MGR_TARGET_ID_INVALID) &&
+            (m_links[i].state == BLE_CONN_MGR_STATE_CONNECTING))
+        {
+            m_links[i].state = BLE_CONN_MGR_STATE_IDLE;
+        }
+    }
+}
+
+
+/**@brief Function for cancelling the connection procedure, e.g. to include another target.
+ */
+static void connecting_cancel(void)
+{
+    if (m_connecting && (sd_ble_gap_connect_cancel() == NRF_SUCCESS))
+    {
+        connecting_end();
+    }
+}
+
+
+/**@brief Function for starting the back-off timer after a failed connection procedure.
+ */
+static void backoff_start(void)
+{
+    uint32_t err_code;
+
+    if (m_backoff_running)
+    {
+        return;
+    }
+
+    err_code = app_timer_start(m_backoff_timer_id, m_backoff, NULL);
+    if (err_code == NRF_SUCCESS)
+    {
+        m_backoff_running = true;
+    }
+    else if (m_error_handler != NULL)
+    {
+        m_error_handler(err_code);
+    }
+
+    m_backoff = MIN(m_backoff * 2, m_backoff_max);
+}
+
+
+/**@brief Function for stopping the back-off timer, so that the next connection procedure starts
+ *        at once.
+ */
+static void backoff_reset(void)
+{
+    if (m_backoff_running)
+    {
+        UNUSED_VARIABLE(app_timer_stop(m_backoff_timer_id));
+        m_backoff_running = false;
+    }
+    m_backoff = m_backoff_min;
+}
+
+
+/**@brief Function for starting a connection procedure to all idle targets.
+ *
+ * @details Does nothing if a connection procedure is ongoing, or if the back-off timer is running.
+ */
+static void connect_start(void)
+{
+    uint32_t err_code;
+    uint8_t  i;
+
+    if (m_connecting || m_backoff_running)
+    {
+        return;
+    }
+
+    m_whitelist.addr_count = 0;
+    for (i = 0; i < BLE_CONN_MGR_MAX_TARGETS; i++)
+    {
+        if ((m_links[i].target_id != BLE_CONN_MGR_TARGET_ID_INVALID) &&
+            (m_links[i].state == BLE_CONN_MGR_STATE_IDLE))
+        {
+            mp_whitelist_addr[m_whitelist.addr_count++] = &m_links[i].addr;
+        }
+    }
+
+    if (m_whitelist.addr_count == 0)
+    {
+        return;
+    }
+
+    // The SoftDevice cannot scan and initiate at the same time.
+    UNUSED_VARIABLE(sd_ble_gap_scan_stop());
+
+    err_code = sd_ble_gap_connect(NULL, &m_scan_params, mp_conn_params);
+    if (err_code == NRF_SUCCESS)
+    {
+        m_connecting = true;
+
+        for (i = 0; i < BLE_CONN_MGR_MAX_TARGETS; i++)
+        {
+            if ((m_links[i].target_id != BLE_CONN_MGR_TARGET_ID_INVALID) &&
+                (m_links[i].state == BLE_CONN_MGR_STATE_IDLE))
+            {
+                m_links[i].state = BLE_CONN_MGR_STATE_CONNECTING;
+            }
+        }
+        return;
+    }
+
+    // Busy, or connection limit reached: retry later.
+    if ((err_code != NRF_ERROR_BUSY)          &&
+        (err_code != NRF_ERROR_NO_MEM)        &&
+        (err_code != NRF_ERROR_INVALID_STATE) &&
+        (m_error_handler != NULL))
+    {
+        m_error_handler(err_code);
+    }
+    backoff_start();
+}
+
+
+/**@brief Function for handling the back-off timer timeout.
+ *
+ * @param[in]   p_context   Unused.
+ */
+static void backoff_timeout_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    m_backoff_running = false;
+    connect_start();
+}
+
+
+/**@brief Function for sending an event to the application.
+ */
+static void evt_send(ble_conn_mgr_evt_type_t evt_type, ble_conn_mgr_link_t const * p_link, uint8_t reason)
+{
+    ble_conn_mgr_evt_t evt;
+
+    if (m_evt_handler == NULL)
+    {
+        return;
+    }
+
+    evt.evt_type = evt_type;
+    evt.p_link   = p_link;
+    evt.reason   = reason;
+
+    m_evt_handler(&evt);
+}
+
+
+/**@brief Function for handling the Connected event.
+ *
+ * @param[in]   p_gap_evt   GAP event received from the BLE stack.
+ */
+static void on_connected(ble_gap_evt_t const * p_gap_evt)
+{
+    ble_conn_mgr_link_t * p_link;
+
+    if (p_gap_evt->params.connected.role != BLE_GAP_ROLE_CENTRAL)
+    {
+        return;
+    }
+
+    // Only one connection procedure runs at a time, so this one is complete.
+    connecting_end();
+
+    p_link = target_find(&p_gap_evt->params.connected.peer_addr);
+    if ((p_link != NULL) && (p_link->conn_handle == BLE_CONN_HANDLE_INVALID))
+    {
+        p_link->conn_handle = p_gap_evt->conn_handle;
+        p_link->state       = BLE_CONN_MGR_STATE_DISCOVERING;
+        if (p_link->connect_count++ != 0)
+        {
+            uint32_t ticks;
+
+            UNUSED_VARIABLE(app_timer_cnt_get(&ticks));
+            UNUSED_VARIABLE(app_timer_cnt_diff_compute(ticks,
+                                                       p_link->disconnect_ticks,
+                                                       &p_link->recover_ticks));
+        }
+        if (p_gap_evt->conn_handle < BLE_CONN_MGR_CONN_HANDLE_MAX)
+        {
+            m_link_by_handle[p_gap_evt->conn_handle] = p_link->target_id;
+        }
+
+        evt_send(BLE_CONN_MGR_EVT_CONNECTED, p_link, 0);
+    }
+
+    // Set up the links of the other targets while this one is being discovered.
+    backoff_reset();
+    connect_start();
+}
+
+
+/**@brief Function for handling the Disconnected event.
+ *
+ * @param[in]   p_gap_evt   GAP event received from the BLE stack.
+ */
+static void on_disconnected(ble_gap_evt_t const * p_gap_evt)
+{
+    ble_conn_mgr_link_t * p_link = link_find(p_gap_evt->conn_handle);
+    uint8_t               reason = p_gap_evt->params.disconnected.reason;
+
+    if (p_link == NULL)
+    {
+        return;
+    }
+
+    if (p_gap_evt->conn_handle < BLE_CONN_MGR_CONN_HANDLE_MAX)
+    {
+        m_link_by_handle[p_gap_evt->conn_handle] = BLE_CONN_MGR_TARGET_ID_INVALID;
+    }
+    p_link->conn_handle = BLE_CONN_HANDLE_INVALID;
+    p_link->state       = BLE_CONN_MGR_STATE_IDLE;
+    UNUSED_VARIABLE(app_timer_cnt_get(&p_link->disconnect_ticks));
+
+    evt_send(BLE_CONN_MGR_EVT_DISCONNECTED, p_link, reason);
+
+    if (reason == BLE_HCI_CONN_FAILED_TO_BE_ESTABLISHED)
+    {
+        // The connection procedure succeeded but the link did not come up, as for a timeout.
+        backoff_start();
+        return;
+    }
+
+    // Reconnect at once, restarting an ongoing connection procedure to include the target.
+    connecting_cancel();
+    backoff_reset();
+    connect_start();
+}
+
+
+/**@brief Function for handling the Timeout event.
+ *
+ * @param[in]   p_gap_evt   GAP event received from the BLE stack.
+ */
+static void on_timeout(ble_gap_evt_t const * p_gap_evt)
+{
+    if ((p_gap_evt->params.timeout.src == BLE_GAP_TIMEOUT_SRC_CONN) && m_connecting)
+    {
+        connecting_end();
+        backoff_start();
+    }
+}
+
+
+uint32_t ble_conn_mgr_init(ble_conn_mgr_init_t const * p_init)
+{
+    uint8_t i;
+
+    if ((p_init == NULL) || (p_init->p_scan_params == NULL) || (p_init->p_conn_params == NULL))
+    {
+        return NRF_ERROR_NULL;
+    }
+    if ((p_init->backoff_min == 0) || (p_init->backoff_min > p_init->backoff_max))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    m_evt_handler   = p_init->evt_handler;
+    m_error_handler = p_init->error_handler;
+    mp_conn_params  = p_init->p_conn_params;
+    m_backoff_min   = MAX(p_init->backoff_min, APP_TIMER_MIN_TIMEOUT_TICKS);
+    m_backoff_max   = MAX(p_init->backoff_max, m_backoff_min);
+    m_backoff       = m_backoff_min;
+
+    m_backoff_running = false;
+    m_connecting      = false;
+
+    memset(&m_scan_params, 0, sizeof(m_scan_params));
+    m_scan_params.selective   = 1;
+    m_scan_params.p_whitelist = &m_whitelist;
+    m_scan_params.interval    = p_init->p_scan_params->interval;
+    m_scan_params.window      = p_init->p_scan_params->window;
+    m_scan_params.timeout     = p_init->p_scan_params->timeout;
+
+    memset(&m_whitelist, 0, sizeof(m_whitelist));
+    m_whitelist.pp_addrs = mp_whitelist_addr;
+
+    for (i = 0; i < BLE_CONN_MGR_MAX_TARGETS; i++)
+    {
+        m_links[i].target_id = BLE_CONN_MGR_TARGET_ID_INVALID;
+    }
+    memset(m_link_by_handle, BLE_CONN_MGR_TARGET_ID_INVALID, sizeof(m_link_by_handle));
+
+    return app_timer_create(&m_backoff_timer_id,
+                            APP_TIMER_MODE_SINGLE_SHOT,
+                            backoff_timeout_handler);
+}
+
+
+void ble_conn_mgr_on_ble_evt(ble_evt_t const * p_ble_evt)
+{
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GAP_EVT_CONNECTED:
+            on_connected(&p_ble_evt->evt.gap_evt);
+            break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            on_disconnected(&p_ble_evt->evt.gap_evt);
+            break;
+
+        case BLE_GAP_EVT_TIMEOUT:
+            on_timeout(&p_ble_evt->evt.gap_evt);
+            break;
+
+        default:
+            // No implementation needed.
+            break;
+    }
+}
+
+
+uint32_t ble_conn_mgr_target_add(ble_gap_addr_t const * p_addr, void * p_context, uint8_t * p_target_id)
+{
+    ble_conn_mgr_link_t * p_link;
+    uint8_t               i;
+
+    if (p_addr == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    p_link = target_find(p_addr);
+    if (p_link == NULL)
+    {
+        for (i = 0; i < BLE_CONN_MGR_MAX_TARGETS; i++)
+        {
+            if (m_links[i].target_id == BLE_CONN_MGR_TARGET_ID_INVALID)
+            {
+                break;
+            }
+        }
+        if (i == BLE_CONN_MGR_MAX_TARGETS)
+        {
+            return NRF_ERROR_NO_MEM;
+        }
+
+        p_link = &m_links[i];
+        memset(p_link, 0, sizeof(*p_link));
+        p_link->addr        = *p_addr;
+        p_link->p_context   = p_context;
+        p_link->state       = BLE_CONN_MGR_STATE_IDLE;
+        p_link->conn_handle = BLE_CONN_HANDLE_INVALID;
+        p_link->target_id   = i;
+
+        // Restart an ongoing connection procedure to include the new target.
+        connecting_cancel();
+        connect_start();
+    }
+
+    if (p_target_id != NULL)
+    {
+        *p_target_id = p_link->target_id;
+    }
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ble_conn_mgr_target_remove(uint8_t target_id)
+{
+    ble_conn_mgr_link_t * p_link;
+
+    if ((target_id >= BLE_CONN_MGR_MAX_TARGETS) ||
+        (m_links[target_id].target_id == BLE_CONN_MGR_TARGET_ID_INVALID))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    p_link = &m_links[target_id];
+    if (p_link->conn_handle != BLE_CONN_HANDLE_INVALID)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if (p_link->state == BLE_CONN_MGR_STATE_CONNECTING)
+    {
+        // Restart the connection procedure without the target.
+        connecting_cancel();
+        if (p_link->state == BLE_CONN_MGR_STATE_CONNECTING)
+        {
+            return NRF_ERROR_INVALID_STATE;
+        }
+        p_link->target_id = BLE_CONN_MGR_TARGET_ID_INVALID;
+        connect_start();
+        return NRF_SUCCESS;
+    }
+
+    p_link->target_id = BLE_CONN_MGR_TARGET_ID_INVALID;
+    return NRF_SUCCESS;
+}
+
+
+ble_conn_mgr_link_t const * ble_conn_mgr_link_get(uint16_t conn_handle)
+{
+    return link_find(conn_handle);
+}
+
+
+uint32_t ble_conn_mgr_state_set(uint16_t conn_handle, ble_conn_mgr_state_t state)
+{
+    ble_conn_mgr_link_t * p_link = link_find(conn_handle);
+
+    if (p_link == NULL)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    if ((state != BLE_CONN_MGR_STATE_DISCOVERING) &&
+        (state != BLE_CONN_MGR_STATE_SECURING)    &&
+        (state != BLE_CONN_MGR_STATE_STREAMING))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    p_link->state = state;
+    return NRF_SUCCESS;
+}
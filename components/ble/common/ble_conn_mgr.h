@@ -0,0 +1,192 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ble_sdk_lib_conn_mgr Central Connection Manager
+ * @{
+ * @ingroup ble_sdk_lib
+ * @brief Module for keeping a central connected to a list of peripherals.
+ *
+ * @details The application adds the peripherals it wants to be connected to, the targets, with
+ *          @ref ble_conn_mgr_target_add. The module then connects to every target that is not
+ *          connected:
+ *          - All such targets are put in a whitelist, and a single connection procedure connects
+ *            to whichever advertises first. No advertising report is needed, so a target is
+ *            reconnected as soon as it advertises again.
+ *          - A new connection procedure is started as soon as the previous one completes, so
+ *            links are set up while the links already connected are being discovered or secured.
+ *          - When a connection procedure times out or fails, the next one is started after a
+ *            delay that doubles on each failure, from
+ *            @ref ble_conn_mgr_init_t::backoff_min to @ref ble_conn_mgr_init_t::backoff_max.
+ *            The application can scan in between.
+ *          - When a link is disconnected, its target is reconnected at once.
+ *
+ *          Each target has a link state (@ref ble_conn_mgr_state_t). The module moves a link to
+ *          @ref BLE_CONN_MGR_STATE_DISCOVERING when it is connected, the application moves it on
+ *          with @ref ble_conn_mgr_state_set. @ref ble_conn_mgr_link_get finds the link of a
+ *          connection handle in constant time.
+ *
+ * @note The module stops scanning before starting a connection procedure, as the SoftDevice
+ *       cannot scan and initiate at the same time.
+ *
+ * @note The application must propagate BLE stack events to this module by calling
+ *       @ref ble_conn_mgr_on_ble_evt.
+ */
+
+#ifndef BLE_CONN_MGR_H__
+#define BLE_CONN_MGR_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble.h"
+#include "ble_gap.h"
+#include "ble_srv_common.h"
+
+#ifndef BLE_CONN_MGR_MAX_TARGETS
+#define BLE_CONN_MGR_MAX_TARGETS        4   /**< Maximum number of targets. Must not exceed BLE_GAP_WHITELIST_ADDR_MAX_COUNT. */
+#endif
+
+#ifndef BLE_CONN_MGR_CONN_HANDLE_MAX
+#define BLE_CONN_MGR_CONN_HANDLE_MAX    8   /**< Connection handles below this value are looked up in a table, others by a search of the targets. */
+#endif
+
+#define BLE_CONN_MGR_TARGET_ID_INVALID  0xFF  /**< Invalid target identifier. */
+
+/**@brief Link state of a target. */
+typedef enum
+{
+    BLE_CONN_MGR_STATE_IDLE,         /**< Not connected, waiting for the next connection procedure. */
+    BLE_CONN_MGR_STATE_CONNECTING,   /**< In the whitelist of the ongoing connection procedure. */
+    BLE_CONN_MGR_STATE_DISCOVERING,  /**< Connected, the services of the peer are being discovered. */
+    BLE_CONN_MGR_STATE_SECURING,     /**< Connected, the link is being secured. */
+    BLE_CONN_MGR_STATE_STREAMING     /**< Connected and set up, data is exchanged. */
+} ble_conn_mgr_state_t;
+
+/**@brief Target and its link. */
+typedef struct
+{
+    ble_gap_addr_t       addr;             /**< Address of the target. */
+    void               * p_context;        /**< Application context of the target, given to @ref ble_conn_mgr_target_add. */
+    ble_conn_mgr_state_t state;            /**< Link state. */
+    uint16_t             conn_handle;      /**< Connection handle, BLE_CONN_HANDLE_INVALID if not connected. */
+    uint8_t              target_id;        /**< Identifier of the target. */
+    uint16_t             connect_count;    /**< Number of times the target was connected. */
+    uint32_t             disconnect_ticks; /**< Time of the last disconnection, in RTC1 ticks. */
+    uint32_t             recover_ticks;    /**< Time from the last disconnection to the next connection, in RTC1 ticks. 0 if the target was not reconnected yet. */
+} ble_conn_mgr_link_t;
+
+/**@brief Central Connection Manager event type. */
+typedef enum
+{
+    BLE_CONN_MGR_EVT_CONNECTED,     /**< A target is connected. */
+    BLE_CONN_MGR_EVT_DISCONNECTED   /**< A target is disconnected, it will be reconnected. */
+} ble_conn_mgr_evt_type_t;
+
+/**@brief Central Connection Manager event. */
+typedef struct
+{
+    ble_conn_mgr_evt_type_t     evt_type;  /**< Type of event. */
+    ble_conn_mgr_link_t const * p_link;    /**< Target and link. */
+    uint8_t                     reason;    /**< HCI reason of a disconnection. */
+} ble_conn_mgr_evt_t;
+
+/**@brief Central Connection Manager event handler type. */
+typedef void (*ble_conn_mgr_evt_handler_t) (ble_conn_mgr_evt_t const * p_evt);
+
+/**@brief Central Connection Manager init structure. */
+typedef struct
+{
+    ble_conn_mgr_evt_handler_t    evt_handler;    /**< Event handler, may be NULL. */
+    ble_srv_error_handler_t       error_handler;  /**< Handler for errors returned by the SoftDevice when starting a connection procedure, may be NULL. */
+    ble_gap_scan_params_t const * p_scan_params;  /**< Scan interval, window and timeout of the connection procedure, copied by @ref ble_conn_mgr_init. The other fields are ignored. */
+    ble_gap_conn_params_t const * p_conn_params;  /**< Connection parameters. */
+    uint32_t                      backoff_min;    /**< Delay after the first failed connection procedure, in RTC1 ticks (see @ref APP_TIMER_TICKS). */
+    uint32_t                      backoff_max;    /**< Largest delay between connection procedures, in RTC1 ticks. */
+} ble_conn_mgr_init_t;
+
+
+/**@brief Function for initializing the Central Connection Manager module.
+ *
+ * @details Creates an application timer, the application must be initialized with
+ *          APP_TIMER_INIT and account for it in the maximum number of timers.
+ *
+ * @param[in]   p_init   Init structure. The connection parameters must be kept by the application.
+ *
+ * @retval NRF_SUCCESS             The module is initialized.
+ * @retval NRF_ERROR_NULL          A parameter is NULL.
+ * @retval NRF_ERROR_INVALID_PARAM backoff_min is 0 or larger than backoff_max.
+ * @return Otherwise, an error code returned by app_timer_create.
+ */
+uint32_t ble_conn_mgr_init(ble_conn_mgr_init_t const * p_init);
+
+
+/**@brief Function for handling the Application's BLE Stack events.
+ *
+ * @details Handles the connection, disconnection and connection timeout events. Events of links
+ *          not set up by the module are ignored.
+ *
+ * @param[in]   p_ble_evt   Event received from the BLE stack.
+ */
+void ble_conn_mgr_on_ble_evt(ble_evt_t const * p_ble_evt);
+
+
+/**@brief Function for adding a target.
+ *
+ * @details The module starts connecting to the target.
+ *
+ * @param[in]   p_addr        Address of the target.
+ * @param[in]   p_context     Application context of the target, may be NULL.
+ * @param[out]  p_target_id   Identifier of the target, may be NULL.
+ *
+ * @retval NRF_SUCCESS     The target is added, or was already in the list.
+ * @retval NRF_ERROR_NULL  p_addr is NULL.
+ * @retval NRF_ERROR_NO_MEM The list of targets is full.
+ */
+uint32_t ble_conn_mgr_target_add(ble_gap_addr_t const * p_addr, void * p_context, uint8_t * p_target_id);
+
+
+/**@brief Function for removing a target.
+ *
+ * @param[in]   target_id   Identifier of the target.
+ *
+ * @retval NRF_SUCCESS             The target is removed.
+ * @retval NRF_ERROR_NOT_FOUND     There is no target with this identifier.
+ * @retval NRF_ERROR_INVALID_STATE The target is connected, it must be disconnected first.
+ */
+uint32_t ble_conn_mgr_target_remove(uint8_t target_id);
+
+
+/**@brief Function for getting the link of a connection handle.
+ *
+ * @param[in]   conn_handle   Connection handle.
+ *
+ * @return Link of the connection, or NULL if the connection is not to a target.
+ */
+ble_conn_mgr_link_t const * ble_conn_mgr_link_get(uint16_t conn_handle);
+
+
+/**@brief Function for setting the link state of a connection.
+ *
+ * @param[in]   conn_handle   Connection handle.
+ * @param[in]   state         @ref BLE_CONN_MGR_STATE_DISCOVERING, @ref BLE_CONN_MGR_STATE_SECURING
+ *                            or @ref BLE_CONN_MGR_STATE_STREAMING.
+ *
+ * @retval NRF_SUCCESS             The state is set.
+ * @retval NRF_ERROR_NOT_FOUND     The connection is not to a target.
+ * @retval NRF_ERROR_INVALID_PARAM The state is not a connected state.
+ */
+uint32_t ble_conn_mgr_state_set(uint16_t conn_handle, ble_conn_mgr_state_t state);
+
+#endif // BLE_CONN_MGR_H__
+
+/** @} */
@@ -12,22 +12,35 @@
 
 #include "ble_conn_params.h"
 #include <stdlib.h>
+#include <string.h>
 #include "nordic_common.h"
 #include "ble_hci.h"
 #include "app_timer.h"
 #include "ble_srv_common.h"
 #include "app_util.h"
 
+#define ADAPT_BACKOFF_SHIFT_MAX  4  /**< Maximum number of times the minimum interval between requests is doubled while the central does not grant a set. */
+
 
 static ble_conn_params_init_t m_conn_params_config;     /**< Configuration as specified by the application. */
 static ble_gap_conn_params_t  m_preferred_conn_params;  /**< Connection parameters preferred by the application. */
 static uint8_t                m_update_count;           /**< Number of Connection Parameter Update messages that has currently been sent. */
 static uint16_t               m_conn_handle;            /**< Current connection handle. */
 static ble_gap_conn_params_t  m_current_conn_params;    /**< Connection parameters received in the most recent Connect event. */
-static app_timer_id_t         m_conn_params_timer_id;   /**< Connection parameters timer. */
+static app_timer_id_t         m_conn_params_timer_id;   /**< Connection parameters timer. In adaptive mode, the sampling timer. */
 
 static bool m_change_param = false;
 
+static bool                          m_adapt_enabled = false; /**< Adaptive mode is used. */
+static ble_conn_params_adapt_init_t  m_adapt_config;          /**< Adaptive mode configuration as specified by the application. */
+static ble_conn_params_adapt_stats_t m_adapt_stats;           /**< Time spent in each parameter set. */
+static uint8_t                       m_adapt_target;          /**< Parameter set to be requested. */
+static uint8_t                       m_adapt_relax_count;     /**< Number of samples in a row the policy has asked for a set slower than m_adapt_target. */
+static uint16_t                      m_adapt_tx_packets;      /**< Packets sent since the last sample. */
+static uint32_t                      m_adapt_request_wait;    /**< Time left before a request may be sent (in number of timer ticks). */
+static uint8_t                       m_adapt_attempts;        /**< Number of requests sent for m_adapt_target without the central granting it. */
+static uint32_t                      m_adapt_last_ticks;      /**< Time up to which m_adapt_stats is counted. */
+
 static bool is_conn_params_ok(ble_gap_conn_params_t * p_conn_params)
 {
     // Check if interval is within the acceptable range.
@@ -96,12 +109,246 @@ static void update_timeout_handler(void * p_context)
 }
 
 
+/**@brief Function for finding the parameter set matching connection parameters.
+ *
+ * @param[in]   p_conn_params   Connection parameters of the connection.
+ *
+ * @return      Index of the first set whose interval range holds the connection interval and whose
+ *              slave latency is the connection's, or the number of sets if there is none.
+ */
+static uint8_t adapt_set_find(ble_gap_conn_params_t const * p_conn_params)
+{
+    uint8_t i;
+
+    for (i = 0; i < m_adapt_config.param_set_count; i++)
+    {
+        ble_gap_conn_params_t const * p_set = &m_adapt_config.p_param_sets[i];
+
+        // As in is_conn_params_ok, max_conn_interval holds the connection interval.
+        if ((p_conn_params->max_conn_interval >= p_set->min_conn_interval) &&
+            (p_conn_params->max_conn_interval <= p_set->max_conn_interval) &&
+            (p_conn_params->slave_latency == p_set->slave_latency))
+        {
+            break;
+        }
+    }
+    return i;
+}
+
+
+/**@brief Function for adding the time since the last call to the current parameter set. */
+static void adapt_time_account(void)
+{
+    uint32_t now;
+    uint32_t ticks;
+
+    (void)app_timer_cnt_get(&now);
+    (void)app_timer_cnt_diff_compute(now, m_adapt_last_ticks, &ticks);
+
+    m_adapt_stats.set_ticks[m_adapt_stats.current_set] += ticks;
+    m_adapt_last_ticks                                  = now;
+}
+
+
+/**@brief Default adaptive policy, see @ref ble_conn_params_adapt_init_t::policy. */
+static uint8_t adapt_policy_default(ble_conn_params_traffic_t const * p_traffic)
+{
+    if ((p_traffic->tx_queued > 0) || (p_traffic->tx_packets >= m_adapt_config.burst_packets))
+    {
+        return 0;
+    }
+    return p_traffic->set_count - 1;
+}
+
+
+/**@brief Function for sampling the traffic and requesting the parameter set chosen by the policy.
+ *
+ * @param[in]   p_context   Not used.
+ */
+static void adapt_timeout_handler(void * p_context)
+{
+    ble_conn_params_traffic_t traffic;
+    uint8_t                   wanted;
+    uint8_t                   prev_target;
+    uint32_t                  err_code;
+
+    UNUSED_PARAMETER(p_context);
+
+    if (m_conn_handle == BLE_CONN_HANDLE_INVALID)
+    {
+        return;
+    }
+
+    adapt_time_account();
+
+    // Count the rate limit in samples, the RTC1 counter wraps during long connections.
+    m_adapt_request_wait -= MIN(m_adapt_request_wait, m_adapt_config.sample_period);
+
+    traffic.tx_queued   = (m_adapt_config.tx_queued_get != NULL) ? m_adapt_config.tx_queued_get() : 0;
+    traffic.tx_packets  = m_adapt_tx_packets;
+    traffic.current_set = m_adapt_stats.current_set;
+    traffic.set_count   = m_adapt_config.param_set_count;
+    m_adapt_tx_packets  = 0;
+
+    wanted = m_adapt_config.policy(&traffic);
+    if (wanted >= m_adapt_config.param_set_count)
+    {
+        wanted = m_adapt_config.param_set_count - 1;
+    }
+
+    prev_target = m_adapt_target;
+
+    // Speed up at once, slow down only after relax_samples samples in a row asking for it.
+    if (wanted < m_adapt_target)
+    {
+        m_adapt_target      = wanted;
+        m_adapt_relax_count = 0;
+    }
+    else if (wanted > m_adapt_target)
+    {
+        m_adapt_relax_count++;
+        if (m_adapt_relax_count >= m_adapt_config.relax_samples)
+        {
+            m_adapt_target      = wanted;
+            m_adapt_relax_count = 0;
+        }
+    }
+    else
+    {
+        m_adapt_relax_count = 0;
+    }
+
+    if (m_adapt_target != prev_target)
+    {
+        // The back-off was for the previous set.
+        m_adapt_attempts     = 0;
+        m_adapt_request_wait = MIN(m_adapt_request_wait, m_adapt_config.min_update_interval);
+    }
+    else if (m_adapt_target == m_adapt_stats.current_set)
+    {
+        m_adapt_attempts = 0;
+    }
+
+    if ((m_adapt_target == m_adapt_stats.current_set) || (m_adapt_request_wait != 0))
+    {
+        return;
+    }
+
+    if ((m_adapt_config.max_attempts != 0) && (m_adapt_attempts >= m_adapt_config.max_attempts))
+    {
+        // The central keeps granting other parameters, keep them until the policy changes its mind.
+        return;
+    }
+
+    err_code = sd_ble_gap_conn_param_update(m_conn_handle,
+                                            &m_adapt_config.p_param_sets[m_adapt_target]);
+    if (err_code == NRF_SUCCESS)
+    {
+        // Each request for the same set waits twice as long as the previous one.
+        m_adapt_stats.update_count++;
+        m_adapt_request_wait = m_adapt_config.min_update_interval <<
+                               MIN(m_adapt_attempts, ADAPT_BACKOFF_SHIFT_MAX);
+        m_adapt_attempts++;
+    }
+    else if ((err_code != NRF_ERROR_BUSY) && (m_conn_params_config.error_handler != NULL))
+    {
+        // NRF_ERROR_BUSY: a procedure is in progress, the request is retried on the next sample.
+        m_conn_params_config.error_handler(err_code);
+    }
+}
+
+
+/**@brief Function for handling the BLE stack events in adaptive mode.
+ *
+ * @param[in]   p_ble_evt   The event received from the BLE stack.
+ */
+static void adapt_on_ble_evt(ble_evt_t * p_ble_evt)
+{
+    uint32_t err_code;
+
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GAP_EVT_CONNECTED:
+            m_conn_handle         = p_ble_evt->evt.gap_evt.conn_handle;
+            m_current_conn_params = p_ble_evt->evt.gap_evt.params.connected.conn_params;
+
+            (void)app_timer_cnt_get(&m_adapt_last_ticks);
+            m_adapt_stats.current_set = adapt_set_find(&m_current_conn_params);
+            m_adapt_target            = MIN(m_adapt_stats.current_set,
+                                            m_adapt_config.param_set_count - 1);
+            m_adapt_relax_count       = 0;
+            m_adapt_tx_packets        = 0;
+            m_adapt_request_wait      = m_conn_params_config.first_conn_params_update_delay;
+            m_adapt_attempts          = 0;
+
+            err_code = app_timer_start(m_conn_params_timer_id, m_adapt_config.sample_period, NULL);
+            if ((err_code != NRF_SUCCESS) && (m_conn_params_config.error_handler != NULL))
+            {
+                m_conn_params_config.error_handler(err_code);
+            }
+            break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            if (m_conn_handle == BLE_CONN_HANDLE_INVALID)
+            {
+                break;
+            }
+            adapt_time_account();
+            m_adapt_stats.current_set = m_adapt_config.param_set_count;
+            m_conn_handle             = BLE_CONN_HANDLE_INVALID;
+
+            err_code = app_timer_stop(m_conn_params_timer_id);
+            if ((err_code != NRF_SUCCESS) && (m_conn_params_config.error_handler != NULL))
+            {
+                m_conn_params_config.error_handler(err_code);
+            }
+            break;
+
+        case BLE_GAP_EVT_CONN_PARAM_UPDATE:
+            adapt_time_account();
+            m_current_conn_params     = p_ble_evt->evt.gap_evt.params.conn_param_update.conn_params;
+            m_adapt_stats.current_set = adapt_set_find(&m_current_conn_params);
+            break;
+
+        case BLE_EVT_TX_COMPLETE:
+            m_adapt_tx_packets += MIN(p_ble_evt->evt.common_evt.params.tx_complete.count,
+                                      UINT16_MAX - m_adapt_tx_packets);
+            break;
+
+        default:
+            // No implementation needed.
+            break;
+    }
+}
+
+
 uint32_t ble_conn_params_init(const ble_conn_params_init_t * p_init)
 {
     uint32_t err_code;
 
     m_conn_params_config = *p_init;
     m_change_param = false;
+    m_adapt_enabled = false;
+
+    if (p_init->p_adapt != NULL)
+    {
+        if ((p_init->p_adapt->p_param_sets == NULL)                                ||
+            (p_init->p_adapt->param_set_count == 0)                                ||
+            (p_init->p_adapt->param_set_count > BLE_CONN_PARAMS_ADAPT_MAX_SETS)    ||
+            (p_init->p_adapt->sample_period == 0))
+        {
+            return NRF_ERROR_INVALID_PARAM;
+        }
+
+        m_adapt_config = *p_init->p_adapt;
+        if (m_adapt_config.policy == NULL)
+        {
+            m_adapt_config.policy = adapt_policy_default;
+        }
+        memset(&m_adapt_stats, 0, sizeof(m_adapt_stats));
+        m_adapt_stats.current_set = m_adapt_config.param_set_count;
+        m_adapt_enabled           = true;
+    }
     if (p_init->p_conn_params != NULL)
     {
         m_preferred_conn_params = *p_init->p_conn_params;
@@ -126,6 +373,13 @@ uint32_t ble_conn_params_init(const ble_conn_params_init_t * p_init)
     m_conn_handle  = BLE_CONN_HANDLE_INVALID;
     m_update_count = 0;
 
+    if (m_adapt_enabled)
+    {
+        return app_timer_create(&m_conn_params_timer_id,
+                                APP_TIMER_MODE_REPEATED,
+                                adapt_timeout_handler);
+    }
+
     return app_timer_create(&m_conn_params_timer_id,
                             APP_TIMER_MODE_SINGLE_SHOT,
                             update_timeout_handler);
@@ -266,6 +520,12 @@ static void on_conn_params_update(ble_evt_t * p_ble_evt)
 
 void ble_conn_params_on_ble_evt(ble_evt_t * p_ble_evt)
 {
+    if (m_adapt_enabled)
+    {
+        adapt_on_ble_evt(p_ble_evt);
+        return;
+    }
+
     switch (p_ble_evt->header.evt_id)
     {
         case BLE_GAP_EVT_CONNECTED:
@@ -295,6 +555,11 @@ uint32_t ble_conn_params_change_conn_params(ble_gap_conn_params_t * new_params)
 {
     uint32_t err_code;
 
+    if (m_adapt_enabled)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
     m_preferred_conn_params = *new_params;
     // Set the connection params in stack
     err_code = sd_ble_gap_ppcp_set(&m_preferred_conn_params);
@@ -321,3 +586,25 @@ uint32_t ble_conn_params_change_conn_params(ble_gap_conn_params_t * new_params)
     }
     return err_code;
 }
+
+
+uint32_t ble_conn_params_adapt_stats_get(ble_conn_params_adapt_stats_t * p_stats)
+{
+    if (p_stats == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if (!m_adapt_enabled)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if (m_conn_handle != BLE_CONN_HANDLE_INVALID)
+    {
+        adapt_time_account();
+    }
+
+    *p_stats = m_adapt_stats;
+    return NRF_SUCCESS;
+}
@@ -16,6 +16,17 @@
  * @{
  * @ingroup ble_sdk_lib
  * @brief Module for initiating and executing a connection parameters negotiation procedure.
+ *
+ * @details In adaptive mode (see @ref ble_conn_params_adapt_init_t), the module instead follows
+ *          the traffic of the connection. The application gives a few parameter sets, from the
+ *          fastest to the slowest. The traffic is sampled periodically: the packets sent, counted
+ *          from @ref BLE_EVT_TX_COMPLETE, and the bytes the application has queued. A policy
+ *          chooses the set for the traffic. A faster set is requested at once, a slower set only
+ *          after the policy has asked for it for several samples in a row, and no two requests are
+ *          closer than a minimum interval. While the central grants other parameters than the set
+ *          requested, the interval doubles with each request, and the parameters granted are kept
+ *          after a maximum number of requests. The time spent in each set is counted
+ *          (see @ref ble_conn_params_adapt_stats_get).
  */
 
 #ifndef BLE_CONN_PARAMS_H__
@@ -25,6 +36,10 @@
 #include "ble.h"
 #include "ble_srv_common.h"
 
+#ifndef BLE_CONN_PARAMS_ADAPT_MAX_SETS
+#define BLE_CONN_PARAMS_ADAPT_MAX_SETS  4   /**< Maximum number of parameter sets in adaptive mode. */
+#endif
+
 /**@brief Connection Parameters Module event type. */
 typedef enum
 {
@@ -41,6 +56,49 @@ typedef struct
 /**@brief Connection Parameters Module event handler type. */
 typedef void (*ble_conn_params_evt_handler_t) (ble_conn_params_evt_t * p_evt);
 
+/**@brief Traffic of the connection over a sampling period, given to the adaptive policy. */
+typedef struct
+{
+    uint32_t tx_queued;        /**< Bytes queued by the application, as returned by ble_conn_params_adapt_init_t::tx_queued_get, 0 if it is NULL. */
+    uint16_t tx_packets;       /**< Packets sent during the period. */
+    uint8_t  current_set;      /**< Index of the parameter set in use, the number of sets if the connection parameters match none. */
+    uint8_t  set_count;        /**< Number of parameter sets. */
+} ble_conn_params_traffic_t;
+
+/**@brief Adaptive policy type.
+ *
+ * @param[in]   p_traffic   Traffic over the last sampling period.
+ *
+ * @return Index of the parameter set wanted for this traffic.
+ */
+typedef uint8_t (*ble_conn_params_policy_t) (ble_conn_params_traffic_t const * p_traffic);
+
+/**@brief Adaptive mode init structure. */
+typedef struct
+{
+    ble_gap_conn_params_t const * p_param_sets;         /**< Parameter sets, from the fastest to the slowest. Must be kept by the application. */
+    uint8_t                       param_set_count;      /**< Number of parameter sets, at most @ref BLE_CONN_PARAMS_ADAPT_MAX_SETS. */
+    ble_conn_params_policy_t      policy;               /**< Policy choosing the parameter set. If NULL, the fastest set is chosen while bytes are queued or at least burst_packets packets were sent in the period, the slowest set otherwise. */
+    uint32_t                   (* tx_queued_get)(void); /**< Function returning the number of bytes queued for sending, may be NULL. */
+    uint16_t                      burst_packets;        /**< Packets per sampling period from which the default policy chooses the fastest set. */
+    uint32_t                      sample_period;        /**< Sampling period (in number of timer ticks). Must be shorter than the period of the RTC1 counter, 512 seconds with a prescaler of 0. */
+    uint8_t                       relax_samples;        /**< Number of samples in a row the policy must ask for a slower set before it is requested. */
+    uint32_t                      min_update_interval;  /**< Minimum time between two requests (in number of timer ticks). Doubled with each request for a set the central does not grant, up to 16 times this value. */
+    uint8_t                       max_attempts;         /**< Number of requests for a set the central does not grant, after which the parameters granted are kept until the policy asks for another set. 0 for no limit. */
+} ble_conn_params_adapt_init_t;
+
+/**@brief Time spent in each parameter set in adaptive mode.
+ *
+ * @note The times are counted from initialization, over all connections. An entry wraps around
+ *       after 2^32 timer ticks, about 36 hours connected with a prescaler of 0.
+ */
+typedef struct
+{
+    uint32_t set_ticks[BLE_CONN_PARAMS_ADAPT_MAX_SETS + 1]; /**< Time connected with each set (in number of timer ticks). The entry following the last set is the time with parameters matching no set. */
+    uint16_t update_count;                                  /**< Number of update requests sent. */
+    uint8_t  current_set;                                   /**< Index of the parameter set in use, the number of sets if none. */
+} ble_conn_params_adapt_stats_t;
+
 /**@brief Connection Parameters Module init structure. This contains all options and data needed for
  *        initialization of the connection parameters negotiation module. */
 typedef struct
@@ -53,6 +111,7 @@ typedef struct
     bool                          disconnect_on_fail;               /**< Set to TRUE if a failed connection parameters update shall cause an automatic disconnection, set to FALSE otherwise. */
     ble_conn_params_evt_handler_t evt_handler;                      /**< Event handler to be called for handling events in the Connection Parameters. */
     ble_srv_error_handler_t       error_handler;                    /**< Function to be called in case of an error. */
+    ble_conn_params_adapt_init_t const * p_adapt;                   /**< Adaptive mode, copied by ble_conn_params_init. NULL to negotiate p_conn_params. In adaptive mode, first_conn_params_update_delay is the delay from the connect event to the first request, and next_conn_params_update_delay, max_conn_params_update_count, start_on_notify_cccd_handle and disconnect_on_fail are not used. */
 } ble_conn_params_init_t;
 
 
@@ -62,9 +121,13 @@ typedef struct
  *       any characteristic is enabled by the peer, then this function must be called after
  *       having initialized the services.
  *
+ * @note In adaptive mode, the timer of the module is a repeated timer running while connected.
+ *
  * @param[in]   p_init  This contains information needed to initialize this module.
  *
- * @return      NRF_SUCCESS on successful initialization, otherwise an error code.
+ * @return      NRF_SUCCESS on successful initialization, NRF_ERROR_INVALID_PARAM if the adaptive
+ *              mode has no parameter set, too many, or a sampling period of 0, otherwise an error
+ *              code.
  */
 uint32_t ble_conn_params_init(const ble_conn_params_init_t * p_init);
 
@@ -94,10 +157,21 @@ uint32_t ble_conn_params_stop(void);
  *
  * @param[in]   new_params  This contains the new connections parameters to setup.
  *
- * @return      NRF_SUCCESS on successful initialization, otherwise an error code.
+ * @return      NRF_SUCCESS on successful initialization, NRF_ERROR_INVALID_STATE in adaptive mode,
+ *              otherwise an error code.
  */
 uint32_t ble_conn_params_change_conn_params(ble_gap_conn_params_t *new_params);
 
+/**@brief Function for getting the time spent in each parameter set in adaptive mode.
+ *
+ * @param[out]  p_stats  Time spent in each set, counted since initialization.
+ *
+ * @retval      NRF_SUCCESS              The statistics are copied.
+ * @retval      NRF_ERROR_NULL           p_stats is NULL.
+ * @retval      NRF_ERROR_INVALID_STATE  The module is not in adaptive mode.
+ */
+uint32_t ble_conn_params_adapt_stats_get(ble_conn_params_adapt_stats_t * p_stats);
+
 /**@brief Function for handling the Application's BLE Stack events.
  *
  * @details Handles all events from the BLE stack that are of interest to this module.
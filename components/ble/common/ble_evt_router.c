@@ -0,0 +1,346 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "ble_evt_router.h"
+#include <stdbool.h>
+#include <string.h>
+#include "nordic_common.h"
+#include "nrf_error.h"
+#include "ble_ranges.h"
+#include "app_timer.h"
+#include "app_util.h"
+
+#define GROUP_SIZE   (BLE_GAP_EVT_LAST - BLE_GAP_EVT_BASE + 1)  /**< Number of event IDs of the GAP, GATTC, GATTS and L2CAP groups. */
+#define GROUP_COUNT  5                                          /**< Number of event groups: common, GAP, GATTC, GATTS and L2CAP. */
+#define ROLE_COUNT   (BLE_GAP_ROLE_CENTRAL + 1)                 /**< Number of event roles, including no role. */
+
+STATIC_ASSERT(BLE_EVT_ROUTER_MAX_HANDLERS <= 32);
+STATIC_ASSERT(BLE_GATTC_EVT_BASE == BLE_GAP_EVT_BASE + GROUP_SIZE);
+STATIC_ASSERT(BLE_GATTS_EVT_BASE == BLE_GATTC_EVT_BASE + GROUP_SIZE);
+STATIC_ASSERT(BLE_L2CAP_EVT_BASE == BLE_GATTS_EVT_BASE + GROUP_SIZE);
+STATIC_ASSERT(BLE_L2CAP_EVT_LAST == BLE_L2CAP_EVT_BASE + GROUP_SIZE - 1);
+
+static ble_evt_router_reg_t   m_regs[BLE_EVT_ROUTER_MAX_HANDLERS];          /**< Registrations, in the order they were made. */
+static ble_evt_router_stats_t m_stats[BLE_EVT_ROUTER_MAX_HANDLERS];         /**< Profiling counters of each registration. */
+static uint8_t                m_reg_count;                                  /**< Number of registrations. */
+
+static uint32_t               m_group_mask[GROUP_COUNT];                    /**< Registrations with event IDs in each event group. */
+static uint32_t               m_role_mask[ROLE_COUNT];                      /**< Registrations handling each role, indexed by BLE_GAP_ROLE_*. */
+static uint32_t               m_conn_all_mask;                              /**< Registrations handling the events of all connections. */
+static uint32_t               m_conn_none_mask;                             /**< Registrations handling the events without a connection. */
+static uint32_t               m_conn_mask[BLE_EVT_ROUTER_CONN_HANDLE_MAX];  /**< Registrations handling the events of each connection. */
+static uint8_t                m_conn_role[BLE_EVT_ROUTER_CONN_HANDLE_MAX];  /**< Role of each connection, BLE_GAP_ROLE_INVALID if not connected. */
+
+
+/**@brief Function for getting the group of an event ID.
+ *
+ * @return Group, GROUP_COUNT if the event ID is not in any group.
+ */
+static uint8_t evt_group_get(uint16_t evt_id)
+{
+    if (evt_id < BLE_EVT_BASE)
+    {
+        return GROUP_COUNT;
+    }
+    if (evt_id < BLE_GAP_EVT_BASE)
+    {
+        return 0;
+    }
+    return (uint8_t)MIN(((evt_id - BLE_GAP_EVT_BASE) / GROUP_SIZE) + 1, GROUP_COUNT);
+}
+
+
+/**@brief Function for getting the mask of the registrations handling the events of a connection.
+ *
+ * @param[in]   conn_handle   Connection handle, BLE_CONN_HANDLE_INVALID for no connection.
+ */
+static uint32_t conn_mask_get(uint16_t conn_handle)
+{
+    if (conn_handle == BLE_CONN_HANDLE_INVALID)
+    {
+        return m_conn_all_mask | m_conn_none_mask;
+    }
+    if (conn_handle < BLE_EVT_ROUTER_CONN_HANDLE_MAX)
+    {
+        return m_conn_all_mask | m_conn_mask[conn_handle];
+    }
+    return m_conn_all_mask;
+}
+
+
+/**@brief Function for adding or removing a registration to the mask of a connection handle.
+ *
+ * @param[in]   bit           Bit of the registration.
+ * @param[in]   conn_handle   Connection handle of the registration.
+ * @param[in]   set           True to add the registration, false to remove it.
+ */
+static void conn_mask_update(uint32_t bit, uint16_t conn_handle, bool set)
+{
+    uint32_t * p_mask;
+
+    if (conn_handle == BLE_CONN_HANDLE_ALL)
+    {
+        p_mask = &m_conn_all_mask;
+    }
+    else if (conn_handle == BLE_CONN_HANDLE_INVALID)
+    {
+        p_mask = &m_conn_none_mask;
+    }
+    else
+    {
+        p_mask = &m_conn_mask[conn_handle];
+    }
+
+    if (set)
+    {
+        *p_mask |= bit;
+    }
+    else
+    {
+        *p_mask &= ~bit;
+    }
+}
+
+
+/**@brief Function for checking if a connection handle can be given to a registration. */
+static bool conn_handle_valid(uint16_t conn_handle)
+{
+    return (conn_handle == BLE_CONN_HANDLE_ALL)     ||
+           (conn_handle == BLE_CONN_HANDLE_INVALID) ||
+           (conn_handle < BLE_EVT_ROUTER_CONN_HANDLE_MAX);
+}
+
+
+/**@brief Function for getting the role of a new connection.
+ *
+ * @param[in]   p_gap_evt   @ref BLE_GAP_EVT_CONNECTED event.
+ */
+static uint8_t connected_role_get(ble_gap_evt_t const * p_gap_evt)
+{
+#if defined(S130)
+    return p_gap_evt->params.connected.role;
+#elif defined(S120)
+    UNUSED_PARAMETER(p_gap_evt);
+    return BLE_GAP_ROLE_CENTRAL;
+#else
+    UNUSED_PARAMETER(p_gap_evt);
+    return BLE_GAP_ROLE_PERIPH;
+#endif
+}
+
+
+/**@brief Function for getting the role of an event.
+ *
+ * @param[in]   p_ble_evt     Event.
+ * @param[in]   conn_handle   Connection handle of the event.
+ *
+ * @return BLE_GAP_ROLE_* value, BLE_GAP_ROLE_INVALID if the event has no role.
+ */
+static uint8_t evt_role_get(ble_evt_t const * p_ble_evt, uint16_t conn_handle)
+{
+    if (conn_handle < BLE_EVT_ROUTER_CONN_HANDLE_MAX)
+    {
+        return m_conn_role[conn_handle];
+    }
+
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GAP_EVT_ADV_REPORT:
+            return BLE_GAP_ROLE_CENTRAL;
+
+        case BLE_GAP_EVT_SCAN_REQ_REPORT:
+            return BLE_GAP_ROLE_PERIPH;
+
+        case BLE_GAP_EVT_TIMEOUT:
+            switch (p_ble_evt->evt.gap_evt.params.timeout.src)
+            {
+                case BLE_GAP_TIMEOUT_SRC_ADVERTISING:
+                    return BLE_GAP_ROLE_PERIPH;
+
+                case BLE_GAP_TIMEOUT_SRC_SCAN:
+                case BLE_GAP_TIMEOUT_SRC_CONN:
+                    return BLE_GAP_ROLE_CENTRAL;
+
+                default:
+                    break;
+            }
+            break;
+
+        default:
+            break;
+    }
+    return BLE_GAP_ROLE_INVALID;
+}
+
+
+/**@brief Function for passing an event to a handler, and counting the time spent in it.
+ *
+ * @param[in]   reg_id      Identifier of the registration.
+ * @param[in]   p_ble_evt   Event.
+ */
+static void handler_call(uint8_t reg_id, ble_evt_t * p_ble_evt)
+{
+    uint32_t start;
+    uint32_t end;
+    uint32_t ticks;
+
+    UNUSED_VARIABLE(app_timer_cnt_get(&start));
+    m_regs[reg_id].handler(p_ble_evt, m_regs[reg_id].p_context);
+    UNUSED_VARIABLE(app_timer_cnt_get(&end));
+    UNUSED_VARIABLE(app_timer_cnt_diff_compute(end, start, &ticks));
+
+    m_stats[reg_id].evt_count++;
+    m_stats[reg_id].ticks += ticks;
+}
+
+
+uint32_t ble_evt_router_register(ble_evt_router_reg_t const * p_reg, uint8_t * p_reg_id)
+{
+    uint32_t bit;
+    uint8_t  group;
+    uint8_t  role;
+
+    if ((p_reg == NULL) || (p_reg->handler == NULL))
+    {
+        return NRF_ERROR_NULL;
+    }
+    if ((p_reg->evt_id_first > p_reg->evt_id_last) ||
+        (evt_group_get(p_reg->evt_id_first) >= GROUP_COUNT) ||
+        !conn_handle_valid(p_reg->conn_handle))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (m_reg_count >= BLE_EVT_ROUTER_MAX_HANDLERS)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    m_regs[m_reg_count] = *p_reg;
+    memset(&m_stats[m_reg_count], 0, sizeof(m_stats[m_reg_count]));
+
+    bit = 1UL << m_reg_count;
+
+    for (group = evt_group_get(p_reg->evt_id_first);
+         group <= MIN(evt_group_get(p_reg->evt_id_last), GROUP_COUNT - 1);
+         group++)
+    {
+        m_group_mask[group] |= bit;
+    }
+
+    for (role = 0; role < ROLE_COUNT; role++)
+    {
+        if ((p_reg->role_mask & (1 << role)) != 0)
+        {
+            m_role_mask[role] |= bit;
+        }
+    }
+
+    conn_mask_update(bit, p_reg->conn_handle, true);
+
+    if (p_reg_id != NULL)
+    {
+        *p_reg_id = m_reg_count;
+    }
+    m_reg_count++;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ble_evt_router_conn_handle_set(uint8_t reg_id, uint16_t conn_handle)
+{
+    uint32_t bit;
+
+    if (reg_id >= m_reg_count)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    if (!conn_handle_valid(conn_handle))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    bit = 1UL << reg_id;
+
+    conn_mask_update(bit, m_regs[reg_id].conn_handle, false);
+    conn_mask_update(bit, conn_handle, true);
+    m_regs[reg_id].conn_handle = conn_handle;
+
+    return NRF_SUCCESS;
+}
+
+
+void ble_evt_router_on_ble_evt(ble_evt_t * p_ble_evt)
+{
+    uint16_t evt_id = p_ble_evt->header.evt_id;
+    uint16_t conn_handle;
+    uint8_t  group;
+    uint32_t mask;
+    uint8_t  reg_id;
+
+    group = evt_group_get(evt_id);
+    if (group >= GROUP_COUNT)
+    {
+        return;
+    }
+
+    // The connection handle is the first field of the events of every group.
+    conn_handle = p_ble_evt->evt.common_evt.conn_handle;
+
+    if ((evt_id == BLE_GAP_EVT_CONNECTED) && (conn_handle < BLE_EVT_ROUTER_CONN_HANDLE_MAX))
+    {
+        m_conn_role[conn_handle] = connected_role_get(&p_ble_evt->evt.gap_evt);
+    }
+
+    mask = m_group_mask[group] &
+           m_role_mask[evt_role_get(p_ble_evt, conn_handle)] &
+           conn_mask_get(conn_handle);
+
+    // Cortex-M0 has no instruction to find the lowest bit set, the mask is shifted until empty.
+    for (reg_id = 0; mask != 0; reg_id++, mask >>= 1)
+    {
+        if (((mask & 1) != 0) &&
+            (evt_id >= m_regs[reg_id].evt_id_first) &&
+            (evt_id <= m_regs[reg_id].evt_id_last))
+        {
+            handler_call(reg_id, p_ble_evt);
+        }
+    }
+
+    if ((evt_id == BLE_GAP_EVT_DISCONNECTED) && (conn_handle < BLE_EVT_ROUTER_CONN_HANDLE_MAX))
+    {
+        m_conn_role[conn_handle] = BLE_GAP_ROLE_INVALID;
+    }
+}
+
+
+uint32_t ble_evt_router_stats_get(uint8_t reg_id, ble_evt_router_stats_t * p_stats)
+{
+    if (p_stats == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (reg_id >= m_reg_count)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    *p_stats = m_stats[reg_id];
+
+    return NRF_SUCCESS;
+}
+
+
+void ble_evt_router_stats_clear(void)
+{
+    memset(m_stats, 0, sizeof(m_stats));
+}
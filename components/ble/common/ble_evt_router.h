@@ -0,0 +1,145 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ble_sdk_lib_evt_router BLE Event Router
+ * @{
+ * @ingroup ble_sdk_lib
+ * @brief Module for dispatching BLE stack events only to the modules interested in them.
+ *
+ * @details Each module registers a handler with @ref ble_evt_router_register, giving the range of
+ *          event IDs, the roles and the connection handle of the events it handles. The
+ *          application then passes every BLE stack event to @ref ble_evt_router_on_ble_evt, e.g.
+ *          by registering it with @ref softdevice_ble_evt_handler_set.
+ *
+ *          The registrations are compiled into bit masks indexed by event group (common, GAP,
+ *          GATTC, GATTS, L2CAP), role and connection handle. An event is passed to the handlers in
+ *          the intersection of its three masks, in the order they were registered, so the cost of
+ *          an event does not grow with the number of modules not interested in it.
+ *
+ *          The role of an event is the role of its connection, recorded on
+ *          @ref BLE_GAP_EVT_CONNECTED. Advertising reports, and scan and connection timeouts, are
+ *          central role events, advertising timeouts and scan request reports are peripheral role
+ *          events. Other events without a connection have no role.
+ *
+ *          The number of events passed to each handler, and the time spent in it, are counted for
+ *          profiling (see @ref ble_evt_router_stats_get).
+ *
+ * @note Registrations changed by a handler take effect from the next event.
+ */
+
+#ifndef BLE_EVT_ROUTER_H__
+#define BLE_EVT_ROUTER_H__
+
+#include <stdint.h>
+#include "ble.h"
+#include "ble_gap.h"
+
+#ifndef BLE_EVT_ROUTER_MAX_HANDLERS
+#define BLE_EVT_ROUTER_MAX_HANDLERS     16  /**< Maximum number of registered handlers. At most 32. */
+#endif
+
+#ifndef BLE_EVT_ROUTER_CONN_HANDLE_MAX
+#define BLE_EVT_ROUTER_CONN_HANDLE_MAX  8   /**< Connection handles below this value have their role recorded, and can be given to a registration. */
+#endif
+
+/**@defgroup BLE_EVT_ROUTER_ROLES Roles of a registration
+ * @{ */
+#define BLE_EVT_ROUTER_ROLE_NONE     (1 << BLE_GAP_ROLE_INVALID)  /**< Events without a role. */
+#define BLE_EVT_ROUTER_ROLE_PERIPH   (1 << BLE_GAP_ROLE_PERIPH)   /**< Peripheral role events. */
+#define BLE_EVT_ROUTER_ROLE_CENTRAL  (1 << BLE_GAP_ROLE_CENTRAL)  /**< Central role events. */
+#define BLE_EVT_ROUTER_ROLE_ALL      (BLE_EVT_ROUTER_ROLE_NONE   | \
+                                      BLE_EVT_ROUTER_ROLE_PERIPH | \
+                                      BLE_EVT_ROUTER_ROLE_CENTRAL) /**< All events. */
+/** @} */
+
+/**@brief Handler of the events of a registration.
+ *
+ * @param[in]   p_ble_evt   Event received from the BLE stack.
+ * @param[in]   p_context   Context given in the registration.
+ */
+typedef void (*ble_evt_router_handler_t) (ble_evt_t * p_ble_evt, void * p_context);
+
+/**@brief Registration of a handler. */
+typedef struct
+{
+    ble_evt_router_handler_t handler;       /**< Event handler. */
+    void *                   p_context;     /**< Context passed to the handler, may be NULL. */
+    uint16_t                 evt_id_first;  /**< First event ID of the range handled, e.g. BLE_GAP_EVT_BASE. */
+    uint16_t                 evt_id_last;   /**< Last event ID of the range handled, e.g. BLE_GATTS_EVT_LAST. */
+    uint8_t                  role_mask;     /**< Roles of the events handled, see @ref BLE_EVT_ROUTER_ROLES. */
+    uint16_t                 conn_handle;   /**< Connection handle of the events handled. BLE_CONN_HANDLE_ALL for all events, BLE_CONN_HANDLE_INVALID for the events without a connection only. */
+} ble_evt_router_reg_t;
+
+/**@brief Profiling counters of a handler. */
+typedef struct
+{
+    uint32_t evt_count;  /**< Number of events passed to the handler. */
+    uint32_t ticks;      /**< Time spent in the handler, in RTC1 ticks (see @ref app_timer_cnt_get). Handlers shorter than a tick are counted in a tick with a probability proportional to their duration, so the sum is meaningful over many events. */
+} ble_evt_router_stats_t;
+
+
+/**@brief Function for registering a handler.
+ *
+ * @param[in]   p_reg      Registration, copied by the function.
+ * @param[out]  p_reg_id   Identifier of the registration, may be NULL.
+ *
+ * @retval NRF_SUCCESS             The handler is registered.
+ * @retval NRF_ERROR_NULL          p_reg or its handler is NULL.
+ * @retval NRF_ERROR_INVALID_PARAM The range of event IDs is empty, or the connection handle is
+ *                                 not below @ref BLE_EVT_ROUTER_CONN_HANDLE_MAX.
+ * @retval NRF_ERROR_NO_MEM        @ref BLE_EVT_ROUTER_MAX_HANDLERS handlers are registered.
+ */
+uint32_t ble_evt_router_register(ble_evt_router_reg_t const * p_reg, uint8_t * p_reg_id);
+
+
+/**@brief Function for changing the connection handle of a registration.
+ *
+ * @details Used by modules with an instance per link, when the instance is given a link.
+ *
+ * @param[in]   reg_id        Identifier of the registration.
+ * @param[in]   conn_handle   Connection handle, see @ref ble_evt_router_reg_t::conn_handle.
+ *
+ * @retval NRF_SUCCESS             The connection handle is changed.
+ * @retval NRF_ERROR_NOT_FOUND     There is no registration with this identifier.
+ * @retval NRF_ERROR_INVALID_PARAM The connection handle is not below
+ *                                 @ref BLE_EVT_ROUTER_CONN_HANDLE_MAX.
+ */
+uint32_t ble_evt_router_conn_handle_set(uint8_t reg_id, uint16_t conn_handle);
+
+
+/**@brief Function for dispatching a BLE stack event to the registered handlers.
+ *
+ * @param[in]   p_ble_evt   Event received from the BLE stack.
+ */
+void ble_evt_router_on_ble_evt(ble_evt_t * p_ble_evt);
+
+
+/**@brief Function for getting the profiling counters of a handler.
+ *
+ * @param[in]   reg_id    Identifier of the registration.
+ * @param[out]  p_stats   Counters.
+ *
+ * @retval NRF_SUCCESS          The counters are copied.
+ * @retval NRF_ERROR_NULL       p_stats is NULL.
+ * @retval NRF_ERROR_NOT_FOUND  There is no registration with this identifier.
+ */
+uint32_t ble_evt_router_stats_get(uint8_t reg_id, ble_evt_router_stats_t * p_stats);
+
+
+/**@brief Function for clearing the profiling counters of all handlers. */
+void ble_evt_router_stats_clear(void);
+
+#endif // BLE_EVT_ROUTER_H__
+
+/** @} */
@@ -0,0 +1,577 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "ble_gattc_queue.h"
+#include <string.h>
+#include "nordic_common.h"
+#include "nrf_error.h"
+#include "ble_gattc.h"
+#include "app_timer.h"
+#include "app_util.h"
+#include "ble_srv_common.h"
+
+#define ENTRY_COUNT  ((BLE_GATTC_QUEUE_MAX_CONN * BLE_GATTC_QUEUE_SIZE) + BLE_GATTC_QUEUE_POOL_SIZE)  /**< Number of requests of all connections. */
+#define ENTRY_NONE   0xFF                                                                           /**< Index marking the end of a list of requests. */
+
+STATIC_ASSERT((ENTRY_COUNT > 0) && (ENTRY_COUNT < ENTRY_NONE));
+
+/**@brief Queued request. */
+typedef struct
+{
+    uint8_t  type;                                  /**< Type of the request, see @ref ble_gattc_queue_req_type_t. */
+    uint8_t  next;                                  /**< Index of the next request in the list, or ENTRY_NONE. */
+    uint16_t handle;                                /**< Handle of the attribute. */
+    uint16_t len;                                   /**< Length of the value to write. */
+    uint32_t queued_ticks;                          /**< RTC1 counter when the request was queued. */
+    uint8_t  value[BLE_GATTC_QUEUE_WRITE_MAX_LEN];  /**< Value to write. */
+} req_entry_t;
+
+/**@brief Queue of a connection. */
+typedef struct
+{
+    uint16_t                conn_handle;  /**< Handle of the connection, or BLE_CONN_HANDLE_INVALID if the queue is free. */
+    uint8_t                 head;         /**< Index of the oldest request, or ENTRY_NONE. */
+    uint8_t                 tail;         /**< Index of the newest request, or ENTRY_NONE. */
+    bool                    rsp_pending;  /**< True if the oldest request is sent, and waits for its response. */
+    ble_gattc_queue_stats_t stats;        /**< Statistics of the connection. */
+} conn_queue_t;
+
+static req_entry_t  m_entries[ENTRY_COUNT];              /**< Requests of all connections. */
+static uint8_t      m_free_head;                         /**< Index of the first free request, or ENTRY_NONE. */
+static uint16_t     m_pool_used;                         /**< Number of requests taken from the shared pool. */
+static conn_queue_t m_queues[BLE_GATTC_QUEUE_MAX_CONN];  /**< Queues of the connections. */
+static uint8_t      m_next_queue;                        /**< Queue served first when transmit buffers are freed. */
+static uint8_t      m_tx_buf_count;                      /**< Number of application transmit buffers of the SoftDevice. */
+static uint8_t      m_tx_buf_free;                       /**< Number of transmit buffers the module can use for write commands. */
+
+
+/**@brief Function for finding the queue of a connection.
+ *
+ * @param[in]   conn_handle   Handle of the connection.
+ *
+ * @return Pointer to the queue, or NULL if the connection has none.
+ */
+static conn_queue_t * queue_find(uint16_t conn_handle)
+{
+    uint32_t i;
+
+    for (i = 0; i < BLE_GATTC_QUEUE_MAX_CONN; i++)
+    {
+        if (m_queues[i].conn_handle == conn_handle)
+        {
+            return &m_queues[i];
+        }
+    }
+
+    return NULL;
+}
+
+
+/**@brief Function for getting the queue of a connection, assigning a free one if needed.
+ *
+ * @param[in]   conn_handle   Handle of the connection.
+ *
+ * @return Pointer to the queue, or NULL if there is no free queue.
+ */
+static conn_queue_t * queue_get(uint16_t conn_handle)
+{
+    conn_queue_t * p_queue = queue_find(conn_handle);
+
+    if (p_queue == NULL)
+    {
+        p_queue = queue_find(BLE_CONN_HANDLE_INVALID);
+
+        if (p_queue != NULL)
+        {
+            memset(&p_queue->stats, 0, sizeof(p_queue->stats));
+
+            p_queue->conn_handle = conn_handle;
+            p_queue->head        = ENTRY_NONE;
+            p_queue->tail        = ENTRY_NONE;
+            p_queue->rsp_pending = false;
+        }
+    }
+
+    return p_queue;
+}
+
+
+/**@brief Function for taking a free request for a queue.
+ *
+ * @details A queue takes a request from the shared pool when it holds BLE_GATTC_QUEUE_SIZE
+ *          requests or more.
+ *
+ * @param[in]   p_queue   Queue of the connection.
+ *
+ * @return Index of the request, or ENTRY_NONE if the queue is full.
+ */
+static uint8_t entry_alloc(conn_queue_t * p_queue)
+{
+    uint8_t index = m_free_head;
+
+    if (index == ENTRY_NONE)
+    {
+        return ENTRY_NONE;
+    }
+
+    if (p_queue->stats.depth >= BLE_GATTC_QUEUE_SIZE)
+    {
+        if (m_pool_used >= BLE_GATTC_QUEUE_POOL_SIZE)
+        {
+            return ENTRY_NONE;
+        }
+        m_pool_used++;
+    }
+
+    m_free_head = m_entries[index].next;
+
+    return index;
+}
+
+
+/**@brief Function for removing the oldest request of a queue, and freeing it.
+ *
+ * @param[in]   p_queue   Queue of the connection.
+ */
+static void entry_release(conn_queue_t * p_queue)
+{
+    uint8_t index = p_queue->head;
+
+    p_queue->head = m_entries[index].next;
+    if (p_queue->head == ENTRY_NONE)
+    {
+        p_queue->tail = ENTRY_NONE;
+    }
+
+    m_entries[index].next = m_free_head;
+    m_free_head           = index;
+
+    if (p_queue->stats.depth > BLE_GATTC_QUEUE_SIZE)
+    {
+        m_pool_used--;
+    }
+    p_queue->stats.depth--;
+}
+
+
+/**@brief Function for completing the oldest request of a queue.
+ *
+ * @param[in]   p_queue   Queue of the connection.
+ */
+static void entry_complete(conn_queue_t * p_queue)
+{
+    uint32_t ticks;
+    uint32_t latency;
+
+    UNUSED_VARIABLE(app_timer_cnt_get(&ticks));
+    UNUSED_VARIABLE(app_timer_cnt_diff_compute(ticks, m_entries[p_queue->head].queued_ticks, &latency));
+
+    p_queue->stats.done_count++;
+    p_queue->stats.latency_last  = latency;
+    p_queue->stats.latency_sum  += latency;
+    if (latency > p_queue->stats.latency_max)
+    {
+        p_queue->stats.latency_max = latency;
+    }
+
+    entry_release(p_queue);
+}
+
+
+/**@brief Function for passing a request to the SoftDevice.
+ *
+ * @param[in]   conn_handle   Handle of the connection.
+ * @param[in]   p_entry       Request.
+ *
+ * @return Error code returned by the SoftDevice.
+ */
+static uint32_t entry_send(uint16_t conn_handle, req_entry_t * p_entry)
+{
+    ble_gattc_write_params_t write_params;
+
+    if (p_entry->type == BLE_GATTC_QUEUE_REQ_READ)
+    {
+        return sd_ble_gattc_read(conn_handle, p_entry->handle, 0);
+    }
+
+    write_params.write_op = (p_entry->type == BLE_GATTC_QUEUE_REQ_WRITE) ? BLE_GATT_OP_WRITE_REQ
+                                                                         : BLE_GATT_OP_WRITE_CMD;
+    write_params.flags    = 0;
+    write_params.handle   = p_entry->handle;
+    write_params.offset   = 0;
+    write_params.len      = p_entry->len;
+    write_params.p_value  = p_entry->value;
+
+    return sd_ble_gattc_write(conn_handle, &write_params);
+}
+
+
+/**@brief Function for passing the requests of a queue to the SoftDevice, as long as it accepts
+ *        them.
+ *
+ * @details Stops at a request waiting for its response, and at a write command when no transmit
+ *          buffer is free. A request the SoftDevice is busy with is retried on the next GATT
+ *          Client event of the connection.
+ *
+ * @param[in]   p_queue   Queue of the connection.
+ */
+static void queue_process(conn_queue_t * p_queue)
+{
+    while ((p_queue->head != ENTRY_NONE) && !p_queue->rsp_pending)
+    {
+        req_entry_t * p_entry = &m_entries[p_queue->head];
+        uint32_t      err_code;
+
+        if ((p_entry->type == BLE_GATTC_QUEUE_REQ_WRITE_CMD) && (m_tx_buf_free == 0))
+        {
+            return;
+        }
+
+        err_code = entry_send(p_queue->conn_handle, p_entry);
+
+        switch (err_code)
+        {
+            case NRF_SUCCESS:
+                p_queue->stats.sent_count++;
+                if (p_entry->type == BLE_GATTC_QUEUE_REQ_WRITE_CMD)
+                {
+                    m_tx_buf_free--;
+                    entry_complete(p_queue);
+                }
+                else
+                {
+                    p_queue->rsp_pending = true;
+                }
+                break;
+
+            case NRF_ERROR_BUSY:
+                return;
+
+            case BLE_ERROR_NO_TX_BUFFERS:
+                // Buffers are used by other modules as well, wait until some are freed.
+                m_tx_buf_free = 0;
+                return;
+
+            default:
+                p_queue->stats.dropped_count++;
+                entry_release(p_queue);
+                break;
+        }
+    }
+}
+
+
+/**@brief Function for flushing the queue of a connection, and making it free.
+ *
+ * @param[in]   p_queue   Queue of the connection.
+ */
+static void queue_flush(conn_queue_t * p_queue)
+{
+    while (p_queue->head != ENTRY_NONE)
+    {
+        entry_release(p_queue);
+    }
+
+    p_queue->rsp_pending = false;
+    p_queue->conn_handle = BLE_CONN_HANDLE_INVALID;
+}
+
+
+/**@brief Function for checking if a Read Response or Write Response event answers the request
+ *        waiting for its response.
+ *
+ * @details Responses to requests sent by other modules on the same connection are not for the
+ *          queue.
+ *
+ * @param[in]   p_entry     Request waiting for its response.
+ * @param[in]   p_ble_evt   Event received from the BLE stack.
+ *
+ * @return TRUE if the event is the response to the request.
+ */
+static bool rsp_is_for_entry(const req_entry_t * p_entry, const ble_evt_t * p_ble_evt)
+{
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GATTC_EVT_READ_RSP:
+            return (p_entry->type == BLE_GATTC_QUEUE_REQ_READ) &&
+                   (p_entry->handle == p_ble_evt->evt.gattc_evt.params.read_rsp.handle);
+
+        case BLE_GATTC_EVT_WRITE_RSP:
+            return (p_entry->type == BLE_GATTC_QUEUE_REQ_WRITE) &&
+                   (p_entry->handle == p_ble_evt->evt.gattc_evt.params.write_rsp.handle);
+
+        default:
+            return false;
+    }
+}
+
+
+/**@brief Function for handling a Read Response, Write Response or Timeout event.
+ *
+ * @details The procedure which ended may have kept the SoftDevice busy, so the queue is processed
+ *          whether the event is for the queue or not.
+ *
+ * @param[in]   p_ble_evt   Event received from the BLE stack.
+ */
+static void on_rsp(const ble_evt_t * p_ble_evt)
+{
+    conn_queue_t * p_queue = queue_find(p_ble_evt->evt.gattc_evt.conn_handle);
+
+    if (p_queue == NULL)
+    {
+        return;
+    }
+
+    if (p_queue->rsp_pending)
+    {
+        if (p_ble_evt->header.evt_id == BLE_GATTC_EVT_TIMEOUT)
+        {
+            // Timeout, the request will not get a response.
+            p_queue->stats.dropped_count++;
+            entry_release(p_queue);
+            p_queue->rsp_pending = false;
+        }
+        else if (rsp_is_for_entry(&m_entries[p_queue->head], p_ble_evt))
+        {
+            entry_complete(p_queue);
+            p_queue->rsp_pending = false;
+        }
+    }
+
+    queue_process(p_queue);
+}
+
+
+/**@brief Function for handling the Transmission Complete event.
+ *
+ * @details The freed buffers are used by the queues in turn, starting with the queue after the one
+ *          served first last time.
+ *
+ * @param[in]   p_ble_evt   Event received from the BLE stack.
+ */
+static void on_tx_complete(const ble_evt_t * p_ble_evt)
+{
+    uint32_t free_count = m_tx_buf_free + p_ble_evt->evt.common_evt.params.tx_complete.count;
+    uint32_t i;
+
+    m_tx_buf_free = (free_count > m_tx_buf_count) ? m_tx_buf_count : free_count;
+
+    for (i = 0; i < BLE_GATTC_QUEUE_MAX_CONN; i++)
+    {
+        conn_queue_t * p_queue = &m_queues[(m_next_queue + i) % BLE_GATTC_QUEUE_MAX_CONN];
+
+        if (p_queue->conn_handle != BLE_CONN_HANDLE_INVALID)
+        {
+            queue_process(p_queue);
+        }
+    }
+
+    m_next_queue = (m_next_queue + 1) % BLE_GATTC_QUEUE_MAX_CONN;
+}
+
+
+/**@brief Function for queuing a request, and sending it if the SoftDevice can accept it.
+ *
+ * @param[in]   conn_handle   Handle of the connection.
+ * @param[in]   type          Type of the request.
+ * @param[in]   handle        Handle of the attribute.
+ * @param[in]   p_value       Value to write.
+ * @param[in]   len           Length of the value.
+ *
+ * @return NRF_SUCCESS if the request is queued, otherwise an error code.
+ */
+static uint32_t req_queue(uint16_t                   conn_handle,
+                          ble_gattc_queue_req_type_t type,
+                          uint16_t                   handle,
+                          const uint8_t            * p_value,
+                          uint16_t                   len)
+{
+    conn_queue_t * p_queue;
+    req_entry_t  * p_entry;
+    uint8_t        index;
+
+    if ((conn_handle == BLE_CONN_HANDLE_INVALID) || (handle == BLE_GATT_HANDLE_INVALID))
+    {
+        // Checked before a queue is assigned to the connection.
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    p_queue = queue_get(conn_handle);
+    if (p_queue == NULL)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    index = entry_alloc(p_queue);
+    if (index == ENTRY_NONE)
+    {
+        p_queue->stats.dropped_count++;
+        return NRF_ERROR_NO_MEM;
+    }
+
+    p_entry         = &m_entries[index];
+    p_entry->type   = type;
+    p_entry->next   = ENTRY_NONE;
+    p_entry->handle = handle;
+    p_entry->len    = len;
+    if (len != 0)
+    {
+        memcpy(p_entry->value, p_value, len);
+    }
+    UNUSED_VARIABLE(app_timer_cnt_get(&p_entry->queued_ticks));
+
+    if (p_queue->tail == ENTRY_NONE)
+    {
+        p_queue->head = index;
+    }
+    else
+    {
+        m_entries[p_queue->tail].next = index;
+    }
+    p_queue->tail = index;
+
+    p_queue->stats.depth++;
+    if (p_queue->stats.depth > p_queue->stats.max_depth)
+    {
+        p_queue->stats.max_depth = p_queue->stats.depth;
+    }
+
+    queue_process(p_queue);
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ble_gattc_queue_init(void)
+{
+    uint32_t err_code;
+    uint32_t i;
+
+    for (i = 0; i < ENTRY_COUNT; i++)
+    {
+        m_entries[i].next = (i + 1 < ENTRY_COUNT) ? (i + 1) : ENTRY_NONE;
+    }
+    m_free_head = 0;
+    m_pool_used = 0;
+
+    for (i = 0; i < BLE_GATTC_QUEUE_MAX_CONN; i++)
+    {
+        m_queues[i].conn_handle = BLE_CONN_HANDLE_INVALID;
+        m_queues[i].head        = ENTRY_NONE;
+        m_queues[i].tail        = ENTRY_NONE;
+        m_queues[i].rsp_pending = false;
+    }
+    m_next_queue = 0;
+
+    m_tx_buf_count = 0;
+    err_code       = sd_ble_tx_buffer_count_get(&m_tx_buf_count);
+    m_tx_buf_free  = m_tx_buf_count;
+
+    return err_code;
+}
+
+
+void ble_gattc_queue_on_ble_evt(const ble_evt_t * p_ble_evt)
+{
+    conn_queue_t * p_queue;
+
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GAP_EVT_DISCONNECTED:
+            p_queue = queue_find(p_ble_evt->evt.gap_evt.conn_handle);
+            if (p_queue != NULL)
+            {
+                queue_flush(p_queue);
+            }
+            break;
+
+        case BLE_EVT_TX_COMPLETE:
+            on_tx_complete(p_ble_evt);
+            break;
+
+        case BLE_GATTC_EVT_READ_RSP:
+        case BLE_GATTC_EVT_WRITE_RSP:
+        case BLE_GATTC_EVT_TIMEOUT:
+            on_rsp(p_ble_evt);
+            break;
+
+        default:
+            if ((p_ble_evt->header.evt_id >= BLE_GATTC_EVT_BASE) &&
+                (p_ble_evt->header.evt_id <= BLE_GATTC_EVT_LAST))
+            {
+                // The procedure which kept the SoftDevice busy may be complete.
+                p_queue = queue_find(p_ble_evt->evt.gattc_evt.conn_handle);
+                if (p_queue != NULL)
+                {
+                    queue_process(p_queue);
+                }
+            }
+            break;
+    }
+}
+
+
+uint32_t ble_gattc_queue_read(uint16_t conn_handle, uint16_t handle)
+{
+    return req_queue(conn_handle, BLE_GATTC_QUEUE_REQ_READ, handle, NULL, 0);
+}
+
+
+uint32_t ble_gattc_queue_write(uint16_t                   conn_handle,
+                               ble_gattc_queue_req_type_t type,
+                               uint16_t                   handle,
+                               const uint8_t            * p_value,
+                               uint16_t                   len)
+{
+    if ((type != BLE_GATTC_QUEUE_REQ_WRITE) && (type != BLE_GATTC_QUEUE_REQ_WRITE_CMD))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (len > BLE_GATTC_QUEUE_WRITE_MAX_LEN)
+    {
+        return NRF_ERROR_DATA_SIZE;
+    }
+
+    return req_queue(conn_handle, type, handle, p_value, len);
+}
+
+
+uint32_t ble_gattc_queue_cccd_write(uint16_t conn_handle, uint16_t cccd_handle, uint16_t cccd_value)
+{
+    uint8_t value[BLE_CCCD_VALUE_LEN];
+
+    value[0] = LSB(cccd_value);
+    value[1] = MSB(cccd_value);
+
+    return req_queue(conn_handle, BLE_GATTC_QUEUE_REQ_WRITE, cccd_handle, value, sizeof(value));
+}
+
+
+uint32_t ble_gattc_queue_stats_get(uint16_t conn_handle, ble_gattc_queue_stats_t * p_stats)
+{
+    conn_queue_t * p_queue;
+
+    if (p_stats == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    p_queue = queue_find(conn_handle);
+    if ((p_queue == NULL) || (conn_handle == BLE_CONN_HANDLE_INVALID))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    *p_stats = p_queue->stats;
+
+    return NRF_SUCCESS;
+}
@@ -0,0 +1,171 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ble_sdk_lib_gattc_queue GATT Client Request Queue
+ * @{
+ * @ingroup ble_sdk_lib
+ * @brief Module for queuing GATT Client read and write requests of the client service modules.
+ *
+ * @details The SoftDevice runs one GATT Client read or write procedure at a time on each
+ *          connection, and accepts write commands only while it has free application transmit
+ *          buffers. This module keeps a FIFO of requests for each connection, and passes them to
+ *          the SoftDevice as soon as it can accept them:
+ *          - A read or write request is sent when the response to the previous one is received
+ *            (@ref BLE_GATTC_EVT_READ_RSP, @ref BLE_GATTC_EVT_WRITE_RSP).
+ *          - Write commands are sent in batches, as long as transmit buffers are available. The
+ *            number of available buffers starts at the value given by
+ *            @ref sd_ble_tx_buffer_count_get, and is given back by @ref BLE_EVT_TX_COMPLETE.
+ *          Requests of a connection are sent in the order they were queued.
+ *
+ *          Each connection owns @ref BLE_GATTC_QUEUE_SIZE requests. When these are used up, the
+ *          connection can take requests from a pool of @ref BLE_GATTC_QUEUE_POOL_SIZE requests
+ *          shared by all connections.
+ *
+ * @note The application must propagate BLE stack events to this module by calling
+ *       @ref ble_gattc_queue_on_ble_evt once per event, after the client service modules.
+ */
+
+#ifndef BLE_GATTC_QUEUE_H__
+#define BLE_GATTC_QUEUE_H__
+
+#include <stdint.h>
+#include "ble.h"
+
+#ifndef BLE_GATTC_QUEUE_MAX_CONN
+#define BLE_GATTC_QUEUE_MAX_CONN      1   /**< Maximum number of connections with queued requests. */
+#endif
+
+#ifndef BLE_GATTC_QUEUE_SIZE
+#define BLE_GATTC_QUEUE_SIZE          8   /**< Number of requests owned by each connection. */
+#endif
+
+#ifndef BLE_GATTC_QUEUE_POOL_SIZE
+#define BLE_GATTC_QUEUE_POOL_SIZE     0   /**< Number of requests shared by all connections. */
+#endif
+
+#ifndef BLE_GATTC_QUEUE_WRITE_MAX_LEN
+#define BLE_GATTC_QUEUE_WRITE_MAX_LEN 20  /**< Maximum length of the value of a write. */
+#endif
+
+/**@brief Type of a queued request. */
+typedef enum
+{
+    BLE_GATTC_QUEUE_REQ_READ,       /**< Read request. */
+    BLE_GATTC_QUEUE_REQ_WRITE,      /**< Write request, acknowledged by a write response. */
+    BLE_GATTC_QUEUE_REQ_WRITE_CMD   /**< Write command (Write Without Response). */
+} ble_gattc_queue_req_type_t;
+
+/**@brief Statistics of the requests of a connection.
+ *
+ * @details Latencies are in RTC1 ticks (see @ref app_timer_cnt_get), from the time a request is
+ *          queued to the time it is complete: for a request, when its response is received, for a
+ *          write command, when the SoftDevice accepts it.
+ */
+typedef struct
+{
+    uint16_t depth;           /**< Number of requests queued, including a request waiting for its response. */
+    uint16_t max_depth;       /**< Largest depth reached. */
+    uint32_t sent_count;      /**< Number of requests accepted by the SoftDevice. */
+    uint32_t done_count;      /**< Number of requests completed. */
+    uint32_t dropped_count;   /**< Number of requests rejected because the queue was full, or dropped because the SoftDevice returned an error. */
+    uint32_t latency_last;    /**< Latency of the last request completed. */
+    uint32_t latency_max;     /**< Largest latency. */
+    uint32_t latency_sum;     /**< Sum of the latencies of the requests completed, the mean is latency_sum / done_count. */
+} ble_gattc_queue_stats_t;
+
+
+/**@brief Function for initializing the GATT Client Request Queue module.
+ *
+ * @details Must be called after the SoftDevice is enabled, and before any request is queued.
+ *
+ * @return NRF_SUCCESS on successful initialization, otherwise an error code.
+ */
+uint32_t ble_gattc_queue_init(void);
+
+
+/**@brief Function for handling the Application's BLE Stack events.
+ *
+ * @details Sends the queued requests the SoftDevice can accept, and flushes the queue of a
+ *          connection when it is disconnected.
+ *
+ * @param[in]   p_ble_evt   Event received from the BLE stack.
+ */
+void ble_gattc_queue_on_ble_evt(const ble_evt_t * p_ble_evt);
+
+
+/**@brief Function for queuing a read request.
+ *
+ * @param[in]   conn_handle   Handle of the connection.
+ * @param[in]   handle        Handle of the attribute to read.
+ *
+ * @retval NRF_SUCCESS             The request is queued, or sent.
+ * @retval NRF_ERROR_INVALID_PARAM conn_handle is BLE_CONN_HANDLE_INVALID, or the handle is
+ *                                 BLE_GATT_HANDLE_INVALID.
+ * @retval NRF_ERROR_NO_MEM        The queue of the connection is full.
+ */
+uint32_t ble_gattc_queue_read(uint16_t conn_handle, uint16_t handle);
+
+
+/**@brief Function for queuing a write request or a write command.
+ *
+ * @param[in]   conn_handle   Handle of the connection.
+ * @param[in]   type          @ref BLE_GATTC_QUEUE_REQ_WRITE or @ref BLE_GATTC_QUEUE_REQ_WRITE_CMD.
+ * @param[in]   handle        Handle of the attribute to write.
+ * @param[in]   p_value       Value to write. It is copied to the queue.
+ * @param[in]   len           Length of the value.
+ *
+ * @retval NRF_SUCCESS             The request is queued, or sent.
+ * @retval NRF_ERROR_INVALID_PARAM The type is not a write, conn_handle is BLE_CONN_HANDLE_INVALID,
+ *                                 or the handle is BLE_GATT_HANDLE_INVALID.
+ * @retval NRF_ERROR_DATA_SIZE     The value is longer than @ref BLE_GATTC_QUEUE_WRITE_MAX_LEN.
+ * @retval NRF_ERROR_NO_MEM        The queue of the connection is full.
+ */
+uint32_t ble_gattc_queue_write(uint16_t                   conn_handle,
+                               ble_gattc_queue_req_type_t type,
+                               uint16_t                   handle,
+                               const uint8_t            * p_value,
+                               uint16_t                   len);
+
+
+/**@brief Function for queuing a write request to a Client Characteristic Configuration Descriptor.
+ *
+ * @param[in]   conn_handle   Handle of the connection.
+ * @param[in]   cccd_handle   Handle of the CCCD.
+ * @param[in]   cccd_value    Value to write, i.e. BLE_GATT_HVX_NOTIFICATION, BLE_GATT_HVX_INDICATION
+ *                            or 0.
+ *
+ * @retval NRF_SUCCESS             The request is queued, or sent.
+ * @retval NRF_ERROR_INVALID_PARAM conn_handle is BLE_CONN_HANDLE_INVALID, or the handle is
+ *                                 BLE_GATT_HANDLE_INVALID.
+ * @retval NRF_ERROR_NO_MEM        The queue of the connection is full.
+ */
+uint32_t ble_gattc_queue_cccd_write(uint16_t conn_handle, uint16_t cccd_handle, uint16_t cccd_value);
+
+
+/**@brief Function for getting the statistics of a connection.
+ *
+ * @details The statistics are cleared when the connection is disconnected.
+ *
+ * @param[in]   conn_handle   Handle of the connection.
+ * @param[out]  p_stats       Statistics of the connection.
+ *
+ * @retval NRF_SUCCESS         The statistics are copied to p_stats.
+ * @retval NRF_ERROR_NULL      p_stats is NULL.
+ * @retval NRF_ERROR_NOT_FOUND No request was queued on the connection.
+ */
+uint32_t ble_gattc_queue_stats_get(uint16_t conn_handle, ble_gattc_queue_stats_t * p_stats);
+
+#endif // BLE_GATTC_QUEUE_H__
+
+/** @} */
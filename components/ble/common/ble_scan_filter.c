@@ -0,0 +1,531 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "ble_scan_filter.h"
+#include <string.h>
+#include "nordic_common.h"
+#include "nrf_error.h"
+#include "app_util.h"
+#include "app_timer.h"
+#include "ble_advdata_parser.h"
+
+#define FILTER_ADDR     0x01  /**< Peer address filters are used. */
+#define FILTER_UUID16   0x02  /**< 16-bit service UUID filters are used. */
+#define FILTER_UUID128  0x04  /**< 128-bit service UUID filters are used. */
+#define FILTER_NAME     0x08  /**< Device name prefix filters are used. */
+#define FILTER_MANUF    0x10  /**< Manufacturer specific data filters are used. */
+
+#define UUID16_SIZE     2     /**< Size of a 16-bit UUID. */
+
+/**@brief Device name prefix filter, as compiled by @ref ble_scan_filter_init. */
+typedef struct
+{
+    uint8_t len;                                   /**< Length of the prefix. */
+    uint8_t prefix[BLE_SCAN_FILTER_NAME_MAX_LEN];  /**< Prefix, not zero terminated. */
+} name_filter_t;
+
+/**@brief Manufacturer specific data filter, as compiled by @ref ble_scan_filter_init. */
+typedef struct
+{
+    uint16_t company_id;                                  /**< Company identifier. */
+    uint8_t  len;                                         /**< Length of the pattern. */
+    uint8_t  pattern[BLE_SCAN_FILTER_MANUF_DATA_MAX_LEN]; /**< Pattern, already ANDed with the mask. */
+    uint8_t  mask[BLE_SCAN_FILTER_MANUF_DATA_MAX_LEN];    /**< Mask. */
+} manuf_filter_t;
+
+/**@brief Report in the duplicate cache. */
+typedef struct
+{
+    uint32_t hash;    /**< Hash of the peer address and data of the report. */
+    uint32_t ticks;   /**< Time the report was let through, in RTC1 ticks. */
+    bool     in_use;  /**< True if the entry holds a report. */
+} dup_entry_t;
+
+static uint8_t                 m_enabled;                                    /**< Kinds of filters used, FILTER_* bits. */
+static bool                    m_match_all;                                  /**< See @ref ble_scan_filter_set_t::match_all. */
+static int8_t                  m_rssi_min = BLE_SCAN_FILTER_RSSI_NONE;       /**< RSSI floor. */
+static uint32_t                m_dup_timeout;                                /**< Duplicate timeout in RTC1 ticks, 0 if the cache is disabled. */
+
+static uint16_t                m_uuid16[BLE_SCAN_FILTER_UUID16_MAX];         /**< 16-bit service UUID filters. */
+static uint8_t                 m_uuid16_count;                               /**< Number of 16-bit service UUID filters. */
+static ble_uuid128_t           m_uuid128[BLE_SCAN_FILTER_UUID128_MAX];       /**< 128-bit service UUID filters. */
+static uint8_t                 m_uuid128_count;                              /**< Number of 128-bit service UUID filters. */
+static name_filter_t           m_names[BLE_SCAN_FILTER_NAME_MAX];            /**< Device name prefix filters. */
+static uint8_t                 m_name_count;                                 /**< Number of device name prefix filters. */
+static manuf_filter_t          m_manuf[BLE_SCAN_FILTER_MANUF_MAX];           /**< Manufacturer specific data filters. */
+static uint8_t                 m_manuf_count;                                /**< Number of manufacturer specific data filters. */
+static ble_gap_addr_t          m_addr[BLE_SCAN_FILTER_ADDR_MAX];             /**< Peer address filters. */
+static uint8_t                 m_addr_count;                                 /**< Number of peer address filters. */
+
+static dup_entry_t             m_dup_cache[BLE_SCAN_FILTER_DUP_CACHE_SIZE];  /**< Duplicate cache. */
+static uint8_t                 m_dup_next;                                   /**< Entry replaced by the next new report. */
+
+static ble_scan_filter_stats_t m_stats;                                      /**< Counters of the reports checked. */
+
+STATIC_ASSERT(BLE_SCAN_FILTER_DUP_CACHE_SIZE <= 0xFF);
+
+
+/**@brief Function for computing the FNV-1a hash of the peer address and data of a report.
+ *
+ * @param[in]   p_report   Advertising report.
+ *
+ * @return Hash of the report.
+ */
+static uint32_t report_hash(ble_gap_evt_adv_report_t const * p_report)
+{
+    uint32_t hash = 2166136261uL;
+    uint8_t  i;
+
+    hash = (hash ^ p_report->peer_addr.addr_type) * 16777619uL;
+    for (i = 0; i < BLE_GAP_ADDR_LEN; i++)
+    {
+        hash = (hash ^ p_report->peer_addr.addr[i]) * 16777619uL;
+    }
+
+    // Advertising data and scan response data of a device are different reports.
+    hash = (hash ^ p_report->scan_rsp) * 16777619uL;
+    for (i = 0; i < p_report->dlen; i++)
+    {
+        hash = (hash ^ p_report->data[i]) * 16777619uL;
+    }
+
+    return hash;
+}
+
+
+/**@brief Function for checking a report against the duplicate cache, and adding it to the cache.
+ *
+ * @param[in]   p_report   Advertising report.
+ *
+ * @return True if the report is a duplicate of a report let through less than the duplicate
+ *         timeout ago.
+ */
+static bool dup_check(ble_gap_evt_adv_report_t const * p_report)
+{
+    uint32_t hash = report_hash(p_report);
+    uint32_t ticks;
+    uint32_t age;
+    uint8_t  i;
+
+    UNUSED_VARIABLE(app_timer_cnt_get(&ticks));
+
+    for (i = 0; i < BLE_SCAN_FILTER_DUP_CACHE_SIZE; i++)
+    {
+        if (m_dup_cache[i].in_use && (m_dup_cache[i].hash == hash))
+        {
+            UNUSED_VARIABLE(app_timer_cnt_diff_compute(ticks, m_dup_cache[i].ticks, &age));
+            if (age < m_dup_timeout)
+            {
+                return true;
+            }
+
+            // Expired, the report is let through and its time restarts.
+            m_dup_cache[i].ticks = ticks;
+            return false;
+        }
+    }
+
+    m_dup_cache[m_dup_next].hash   = hash;
+    m_dup_cache[m_dup_next].ticks  = ticks;
+    m_dup_cache[m_dup_next].in_use = true;
+    m_dup_next = (m_dup_next + 1) % BLE_SCAN_FILTER_DUP_CACHE_SIZE;
+
+    return false;
+}
+
+
+/**@brief Function for checking if the outcome of the filters is known.
+ *
+ * @param[in]   matched   Kinds of filters matched so far, FILTER_* bits.
+ * @param[in]   checked   Kinds of filters checked so far, FILTER_* bits.
+ *
+ * @return True if the kinds of filters not checked yet cannot change the outcome.
+ */
+static bool outcome_known(uint8_t matched, uint8_t checked)
+{
+    if (checked == m_enabled)
+    {
+        return true;
+    }
+    if (m_match_all)
+    {
+        return (checked & ~matched) != 0;
+    }
+    return matched != 0;
+}
+
+
+/**@brief Function for getting the outcome of the filters.
+ *
+ * @param[in]   matched   Kinds of filters matched, FILTER_* bits.
+ *
+ * @return True if the report matches.
+ */
+static bool outcome_get(uint8_t matched)
+{
+    if (m_match_all || (m_enabled == 0))
+    {
+        return matched == m_enabled;
+    }
+    return matched != 0;
+}
+
+
+/**@brief Function for checking the peer address filters.
+ *
+ * @param[in]   p_addr   Peer address of the report.
+ *
+ * @return True if the address matches a filter.
+ */
+static bool addr_match(ble_gap_addr_t const * p_addr)
+{
+    uint8_t i;
+
+    for (i = 0; i < m_addr_count; i++)
+    {
+        if ((m_addr[i].addr_type == p_addr->addr_type) &&
+            (memcmp(m_addr[i].addr, p_addr->addr, BLE_GAP_ADDR_LEN) == 0))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**@brief Function for checking the 16-bit service UUID filters.
+ *
+ * @details Each UUID listed in the report is looked up in the filter table, so the lists are
+ *          walked once whatever the number of filters.
+ *
+ * @param[in]   p_index   Index of the report data.
+ *
+ * @return True if a listed UUID matches a filter.
+ */
+static bool uuid16_match(ble_advdata_index_t const * p_index)
+{
+    uint8_t i;
+
+    for (i = 0; i < p_index->count; i++)
+    {
+        ble_advdata_field_t const * p_field = &p_index->fields[i];
+        uint8_t                     pos;
+
+        if ((p_field->type != BLE_GAP_AD_TYPE_16BIT_SERVICE_UUID_MORE_AVAILABLE) &&
+            (p_field->type != BLE_GAP_AD_TYPE_16BIT_SERVICE_UUID_COMPLETE))
+        {
+            continue;
+        }
+
+        for (pos = 0; pos + UUID16_SIZE <= p_field->len; pos += UUID16_SIZE)
+        {
+            uint16_t uuid = uint16_decode(&p_index->p_data[p_field->offset + pos]);
+            uint8_t  j;
+
+            for (j = 0; j < m_uuid16_count; j++)
+            {
+                if (m_uuid16[j] == uuid)
+                {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+
+/**@brief Function for checking the 128-bit service UUID filters.
+ *
+ * @param[in]   p_index   Index of the report data.
+ *
+ * @return True if a listed UUID matches a filter.
+ */
+static bool uuid128_match(ble_advdata_index_t const * p_index)
+{
+    uint8_t i;
+
+    for (i = 0; i < m_uuid128_count; i++)
+    {
+        if (ble_advdata_uuid128_find(p_index, m_uuid128[i].uuid128))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**@brief Function for checking the device name prefix filters.
+ *
+ * @param[in]   p_index   Index of the report data.
+ *
+ * @return True if the name starts with a prefix of the filters.
+ */
+static bool name_match(ble_advdata_index_t const * p_index)
+{
+    uint8_t const * p_name;
+    uint8_t         len;
+    uint8_t         i;
+
+    if (ble_advdata_name_get(p_index, &p_name, &len, NULL) != NRF_SUCCESS)
+    {
+        return false;
+    }
+
+    for (i = 0; i < m_name_count; i++)
+    {
+        if ((len >= m_names[i].len) && (memcmp(p_name, m_names[i].prefix, m_names[i].len) == 0))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**@brief Function for checking the manufacturer specific data filters.
+ *
+ * @param[in]   p_index   Index of the report data.
+ *
+ * @return True if the manufacturer specific data matches a filter.
+ */
+static bool manuf_match(ble_advdata_index_t const * p_index)
+{
+    uint8_t const * p_data;
+    uint8_t         len;
+    uint16_t        company_id;
+    uint8_t         i;
+
+    if (ble_advdata_manuf_data_get(p_index, &company_id, &p_data, &len) != NRF_SUCCESS)
+    {
+        return false;
+    }
+
+    for (i = 0; i < m_manuf_count; i++)
+    {
+        manuf_filter_t const * p_filter = &m_manuf[i];
+        uint8_t                j;
+
+        if ((p_filter->company_id != company_id) || (len < p_filter->len))
+        {
+            continue;
+        }
+        for (j = 0; j < p_filter->len; j++)
+        {
+            if ((p_data[j] & p_filter->mask[j]) != p_filter->pattern[j])
+            {
+                break;
+            }
+        }
+        if (j == p_filter->len)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+uint32_t ble_scan_filter_init(ble_scan_filter_set_t const * p_filters)
+{
+    uint8_t i;
+
+    if (p_filters == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (((p_filters->uuid16_count != 0)      && (p_filters->p_uuid16 == NULL))       ||
+        ((p_filters->uuid128_count != 0)     && (p_filters->p_uuid128 == NULL))      ||
+        ((p_filters->name_prefix_count != 0) && (p_filters->pp_name_prefix == NULL)) ||
+        ((p_filters->manuf_count != 0)       && (p_filters->p_manuf == NULL))        ||
+        ((p_filters->addr_count != 0)        && (p_filters->p_addr == NULL)))
+    {
+        return NRF_ERROR_NULL;
+    }
+    if ((p_filters->uuid16_count > BLE_SCAN_FILTER_UUID16_MAX)     ||
+        (p_filters->uuid128_count > BLE_SCAN_FILTER_UUID128_MAX)   ||
+        (p_filters->name_prefix_count > BLE_SCAN_FILTER_NAME_MAX)  ||
+        (p_filters->manuf_count > BLE_SCAN_FILTER_MANUF_MAX)       ||
+        (p_filters->addr_count > BLE_SCAN_FILTER_ADDR_MAX))
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+    for (i = 0; i < p_filters->name_prefix_count; i++)
+    {
+        if (p_filters->pp_name_prefix[i] == NULL)
+        {
+            return NRF_ERROR_NULL;
+        }
+        if (strlen(p_filters->pp_name_prefix[i]) > BLE_SCAN_FILTER_NAME_MAX_LEN)
+        {
+            return NRF_ERROR_DATA_SIZE;
+        }
+    }
+    for (i = 0; i < p_filters->manuf_count; i++)
+    {
+        if ((p_filters->p_manuf[i].len != 0) && (p_filters->p_manuf[i].p_pattern == NULL))
+        {
+            return NRF_ERROR_NULL;
+        }
+        if (p_filters->p_manuf[i].len > BLE_SCAN_FILTER_MANUF_DATA_MAX_LEN)
+        {
+            return NRF_ERROR_DATA_SIZE;
+        }
+    }
+
+    // Compile the filters into the tables.
+    m_enabled = 0;
+
+    m_uuid16_count = p_filters->uuid16_count;
+    if (m_uuid16_count != 0)
+    {
+        memcpy(m_uuid16, p_filters->p_uuid16, m_uuid16_count * sizeof(m_uuid16[0]));
+        m_enabled |= FILTER_UUID16;
+    }
+
+    m_uuid128_count = p_filters->uuid128_count;
+    if (m_uuid128_count != 0)
+    {
+        memcpy(m_uuid128, p_filters->p_uuid128, m_uuid128_count * sizeof(m_uuid128[0]));
+        m_enabled |= FILTER_UUID128;
+    }
+
+    m_name_count = p_filters->name_prefix_count;
+    for (i = 0; i < m_name_count; i++)
+    {
+        m_names[i].len = (uint8_t)strlen(p_filters->pp_name_prefix[i]);
+        memcpy(m_names[i].prefix, p_filters->pp_name_prefix[i], m_names[i].len);
+    }
+    if (m_name_count != 0)
+    {
+        m_enabled |= FILTER_NAME;
+    }
+
+    m_manuf_count = p_filters->manuf_count;
+    for (i = 0; i < m_manuf_count; i++)
+    {
+        ble_scan_filter_manuf_t const * p_manuf = &p_filters->p_manuf[i];
+        uint8_t                         j;
+
+        m_manuf[i].company_id = p_manuf->company_id;
+        m_manuf[i].len        = p_manuf->len;
+        for (j = 0; j < p_manuf->len; j++)
+        {
+            m_manuf[i].mask[j]    = (p_manuf->p_mask != NULL) ? p_manuf->p_mask[j] : 0xFF;
+            m_manuf[i].pattern[j] = p_manuf->p_pattern[j] & m_manuf[i].mask[j];
+        }
+    }
+    if (m_manuf_count != 0)
+    {
+        m_enabled |= FILTER_MANUF;
+    }
+
+    m_addr_count = p_filters->addr_count;
+    if (m_addr_count != 0)
+    {
+        memcpy(m_addr, p_filters->p_addr, m_addr_count * sizeof(m_addr[0]));
+        m_enabled |= FILTER_ADDR;
+    }
+
+    m_match_all   = p_filters->match_all;
+    m_rssi_min    = p_filters->rssi_min;
+    m_dup_timeout = p_filters->dup_timeout;
+
+    ble_scan_filter_dup_cache_clear();
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    return NRF_SUCCESS;
+}
+
+
+bool ble_scan_filter_match(ble_gap_evt_adv_report_t const * p_report)
+{
+    ble_advdata_index_t index;
+    uint8_t             matched = 0;
+    uint8_t             checked = 0;
+
+    m_stats.report_count++;
+
+    // Cheapest checks first, the data is only parsed for reports that get past them.
+    if (p_report->rssi < m_rssi_min)
+    {
+        m_stats.rssi_drop_count++;
+        return false;
+    }
+    if ((m_dup_timeout != 0) && dup_check(p_report))
+    {
+        m_stats.dup_drop_count++;
+        return false;
+    }
+
+    if ((m_enabled & FILTER_ADDR) != 0)
+    {
+        if (addr_match(&p_report->peer_addr))
+        {
+            matched |= FILTER_ADDR;
+        }
+        checked |= FILTER_ADDR;
+    }
+
+    if (!outcome_known(matched, checked))
+    {
+        if (ble_advdata_index_build(p_report->data, p_report->dlen, &index) != NRF_SUCCESS)
+        {
+            m_stats.bad_drop_count++;
+            return false;
+        }
+
+        if (((m_enabled & FILTER_UUID16) != 0) && !outcome_known(matched, checked))
+        {
+            matched |= uuid16_match(&index) ? FILTER_UUID16 : 0;
+            checked |= FILTER_UUID16;
+        }
+        if (((m_enabled & FILTER_UUID128) != 0) && !outcome_known(matched, checked))
+        {
+            matched |= uuid128_match(&index) ? FILTER_UUID128 : 0;
+            checked |= FILTER_UUID128;
+        }
+        if (((m_enabled & FILTER_NAME) != 0) && !outcome_known(matched, checked))
+        {
+            matched |= name_match(&index) ? FILTER_NAME : 0;
+            checked |= FILTER_NAME;
+        }
+        if (((m_enabled & FILTER_MANUF) != 0) && !outcome_known(matched, checked))
+        {
+            matched |= manuf_match(&index) ? FILTER_MANUF : 0;
+            checked |= FILTER_MANUF;
+        }
+    }
+
+    if (!outcome_get(matched))
+    {
+        m_stats.miss_drop_count++;
+        return false;
+    }
+
+    m_stats.match_count++;
+    return true;
+}
+
+
+void ble_scan_filter_dup_cache_clear(void)
+{
+    memset(m_dup_cache, 0, sizeof(m_dup_cache));
+    m_dup_next = 0;
+}
+
+
+void ble_scan_filter_stats_get(ble_scan_filter_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}
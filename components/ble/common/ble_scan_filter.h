@@ -0,0 +1,173 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ble_sdk_lib_scan_filter Scan Filter
+ * @{
+ * @ingroup ble_sdk_lib
+ * @brief Module for filtering advertising reports received while scanning.
+ *
+ * @details The application describes the devices it is interested in with a
+ *          @ref ble_scan_filter_set_t. @ref ble_scan_filter_init copies the filters to internal
+ *          tables, and @ref ble_scan_filter_match then checks each advertising report in this
+ *          order, stopping as soon as the outcome is known:
+ *          -# RSSI floor.
+ *          -# Duplicate cache: a report whose peer address and data are the same as those of a
+ *             report seen less than @ref ble_scan_filter_set_t::dup_timeout ago is dropped,
+ *             without parsing its data.
+ *          -# Peer address filters.
+ *          -# Service UUID, device name prefix and manufacturer specific data filters, checked on
+ *             a single @ref ble_advdata_index_build pass over the data.
+ *
+ *          A report matches when it matches any filter, or, if
+ *          @ref ble_scan_filter_set_t::match_all is set, at least one filter of each kind that is
+ *          used. A report matches if no filter is used.
+ *
+ * @note The duplicate cache stores a hash of the peer address and data, two different reports
+ *       with the same hash are taken as duplicates.
+ */
+
+#ifndef BLE_SCAN_FILTER_H__
+#define BLE_SCAN_FILTER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_gap.h"
+#include "ble_types.h"
+
+#ifndef BLE_SCAN_FILTER_UUID16_MAX
+#define BLE_SCAN_FILTER_UUID16_MAX          4   /**< Maximum number of 16-bit service UUID filters. */
+#endif
+
+#ifndef BLE_SCAN_FILTER_UUID128_MAX
+#define BLE_SCAN_FILTER_UUID128_MAX         1   /**< Maximum number of 128-bit service UUID filters. */
+#endif
+
+#ifndef BLE_SCAN_FILTER_NAME_MAX
+#define BLE_SCAN_FILTER_NAME_MAX            2   /**< Maximum number of device name prefix filters. */
+#endif
+
+#ifndef BLE_SCAN_FILTER_NAME_MAX_LEN
+#define BLE_SCAN_FILTER_NAME_MAX_LEN        12  /**< Maximum length of a device name prefix. */
+#endif
+
+#ifndef BLE_SCAN_FILTER_MANUF_MAX
+#define BLE_SCAN_FILTER_MANUF_MAX           2   /**< Maximum number of manufacturer specific data filters. */
+#endif
+
+#ifndef BLE_SCAN_FILTER_MANUF_DATA_MAX_LEN
+#define BLE_SCAN_FILTER_MANUF_DATA_MAX_LEN  8   /**< Maximum length of the data pattern of a manufacturer specific data filter. */
+#endif
+
+#ifndef BLE_SCAN_FILTER_ADDR_MAX
+#define BLE_SCAN_FILTER_ADDR_MAX            2   /**< Maximum number of peer address filters. */
+#endif
+
+#ifndef BLE_SCAN_FILTER_DUP_CACHE_SIZE
+#define BLE_SCAN_FILTER_DUP_CACHE_SIZE      16  /**< Number of reports kept in the duplicate cache. */
+#endif
+
+#define BLE_SCAN_FILTER_RSSI_NONE           (-128) /**< RSSI floor letting every report through. */
+
+/**@brief Manufacturer specific data filter.
+ *
+ * @details The data of a report matches if it has the company identifier, and if each of the
+ *          first len bytes following the company identifier, ANDed with p_mask, equals p_pattern
+ *          ANDed with p_mask.
+ */
+typedef struct
+{
+    uint16_t        company_id;  /**< Company identifier. */
+    uint8_t const * p_pattern;   /**< Data pattern following the company identifier. May be NULL if len is 0. */
+    uint8_t const * p_mask;      /**< Mask of the data pattern. If NULL, every bit of the pattern is compared. */
+    uint8_t         len;         /**< Length of the data pattern and of the mask. */
+} ble_scan_filter_manuf_t;
+
+/**@brief Filter set.
+ *
+ * @details A kind of filter is unused if its count is 0. The arrays are copied by
+ *          @ref ble_scan_filter_init and need not be kept.
+ */
+typedef struct
+{
+    uint16_t const *                p_uuid16;          /**< 16-bit service UUIDs. */
+    uint8_t                         uuid16_count;      /**< Number of 16-bit service UUIDs. */
+    ble_uuid128_t const *           p_uuid128;         /**< 128-bit service UUIDs, little endian. */
+    uint8_t                         uuid128_count;     /**< Number of 128-bit service UUIDs. */
+    char const * const *            pp_name_prefix;    /**< Zero terminated device name prefixes, matched against the complete or shortened local name. */
+    uint8_t                         name_prefix_count; /**< Number of device name prefixes. */
+    ble_scan_filter_manuf_t const * p_manuf;           /**< Manufacturer specific data filters. */
+    uint8_t                         manuf_count;       /**< Number of manufacturer specific data filters. */
+    ble_gap_addr_t const *          p_addr;            /**< Peer addresses. */
+    uint8_t                         addr_count;        /**< Number of peer addresses. */
+    int8_t                          rssi_min;          /**< Reports with a lower RSSI are dropped, @ref BLE_SCAN_FILTER_RSSI_NONE to let every report through. */
+    bool                            match_all;         /**< True if a report must match a filter of each kind used, false if it must match any filter. */
+    uint32_t                        dup_timeout;       /**< Time during which a repeated report is dropped, in RTC1 ticks (see @ref APP_TIMER_TICKS). 0 disables the duplicate cache. */
+} ble_scan_filter_set_t;
+
+/**@brief Counters of the reports checked. Each report is counted once, in report_count, and in
+ *        one of the other counters. */
+typedef struct
+{
+    uint32_t report_count;      /**< Number of reports checked. */
+    uint32_t match_count;       /**< Number of reports matching. */
+    uint32_t rssi_drop_count;   /**< Number of reports dropped because of their RSSI. */
+    uint32_t dup_drop_count;    /**< Number of reports dropped by the duplicate cache. */
+    uint32_t bad_drop_count;    /**< Number of reports dropped because their data is malformed. */
+    uint32_t miss_drop_count;   /**< Number of reports dropped because they do not match the filters. */
+} ble_scan_filter_stats_t;
+
+
+/**@brief Function for initializing the Scan Filter module with a filter set.
+ *
+ * @details Can be called again to replace the filters. Clears the duplicate cache and the
+ *          counters.
+ *
+ * @param[in]   p_filters   Filter set.
+ *
+ * @retval NRF_SUCCESS             The filters are in use.
+ * @retval NRF_ERROR_NULL          p_filters, or an array whose count is not 0, is NULL.
+ * @retval NRF_ERROR_NO_MEM        There are more filters of a kind than the module can hold.
+ * @retval NRF_ERROR_DATA_SIZE     A name prefix or a manufacturer data pattern is too long.
+ */
+uint32_t ble_scan_filter_init(ble_scan_filter_set_t const * p_filters);
+
+
+/**@brief Function for checking an advertising report against the filters.
+ *
+ * @details Call on every @ref BLE_GAP_EVT_ADV_REPORT event.
+ *
+ * @param[in]   p_report   Advertising report.
+ *
+ * @return True if the report matches the filters, and is not a duplicate.
+ */
+bool ble_scan_filter_match(ble_gap_evt_adv_report_t const * p_report);
+
+
+/**@brief Function for clearing the duplicate cache.
+ *
+ * @details Reports already in the cache are let through the next time they are received, e.g.
+ *          after scanning is restarted.
+ */
+void ble_scan_filter_dup_cache_clear(void);
+
+
+/**@brief Function for getting the counters of the reports checked.
+ *
+ * @param[out]  p_stats   Counters.
+ */
+void ble_scan_filter_stats_get(ble_scan_filter_stats_t * p_stats);
+
+#endif // BLE_SCAN_FILTER_H__
+
+/** @} */
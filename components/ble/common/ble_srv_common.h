@@ -163,6 +163,14 @@ typedef struct
     uint8_t * p_str;                                    /**< String data. */
 } ble_srv_utf8_str_t;
 
+/**@brief SFLOAT format (IEEE-11073 16-bit FLOAT, defined as a 16-bit vlue with 12-bit mantissa and
+ *        4-bit exponent. */
+typedef struct
+{
+  int8_t  exponent;                                                         /**< Base 10 exponent, only 4 bits */
+  int16_t mantissa;                                                         /**< Mantissa, only 12 bits */
+} ieee_float16_t;
+
 
 /**@brief Security settings structure.
  * @details This structure contains the security options needed during initialization of the
@@ -410,6 +410,15 @@ typedef enum
     ENCRYPTION_IN_PROGRESS, /**< Link security is being established.*/
     ENCRYPTED               /**< The link is secure.*/
 } dm_security_status_t;
+
+/**
+ * @brief Persistent storage statistics of an active connection.
+ */
+typedef struct
+{
+    uint16_t requested; /**< Number of storage operations the immediate store path would have issued. */
+    uint16_t issued;    /**< Number of storage operations actually issued. */
+} dm_store_stats_t;
 /** @} */
 
 /**
@@ -639,6 +648,8 @@ ret_code_t dm_device_delete_all(dm_application_instance_t const * p_handle);
  *          (or when service context is exchanged in an out of band way.)
  *          This API could also be used to trigger a storing of service context into persistent
  *          memory. If this is desired, a NULL pointer could be passed to the p_context.
+ *          GATT Client context (DM_PROTOCOL_CNTXT_GATT_CLI_ID), for example the handles found by
+ *          service discovery, is only managed if DEVICE_MANAGER_GATTC_CONTEXT_SIZE is non-zero.
  *
  * @param[in] p_handle  Identifies peer device for which the procedure is requested.
  * @param[in] p_context Service context being set. The context information includes length of
@@ -654,6 +665,8 @@ ret_code_t dm_device_delete_all(dm_application_instance_t const * p_handle);
  *                                 application registration.
  * @retval NRF_ERROR_NULL          If p_handle is NULL.
  * @retval NRF_ERROR_INVALID_ADDR  If the peer is not identified by the handle provided by the application.
+ * @retval NRF_ERROR_INVALID_PARAM If GATT Client context data is larger than
+ *                                 DEVICE_MANAGER_GATTC_CONTEXT_SIZE.
  */
 ret_code_t dm_service_context_set(dm_handle_t const          * p_handle,
                                   dm_service_context_t const * p_context);
@@ -665,6 +678,8 @@ ret_code_t dm_service_context_set(dm_handle_t const          * p_handle,
  *          this API returns NRF_SUCCESS, DM_EVT_SERVICE_CONTEXT_LOADED event is notified to the
  *          application. The event result is notified along with the event indicates success or failure
  *          of this procedure.
+ *          GATT Client context is loaded when a bonded peer connects, and is returned without an
+ *          event. Its length is zero if nothing was stored for the peer.
  *
  * @param[in] p_handle  Identifies peer device for which procedure is requested.
  * @param[in] p_context Application context being requested. The context information includes length
@@ -881,6 +896,28 @@ ret_code_t dm_distributed_keys_get(dm_handle_t const * p_handle,
  */
 ret_code_t dm_handle_get(uint16_t conn_handle, dm_handle_t * p_handle);
 
+/**
+ * @brief Function for getting persistent storage statistics of an active connection.
+ *
+ * @details When DM_DEFERRED_STORE_ENABLED is set, contexts are marked dirty instead of being
+ *          written on each security or GATT event, and are flushed in one coalesced write on
+ *          disconnection or after DM_DEFERRED_STORE_IDLE_TIMEOUT. The statistics compare the number
+ *          of storage operations the immediate store path would have issued for the connection
+ *          with the number actually issued. The number of operations saved is the difference.
+ *
+ * @param[in]  p_handle Identifies the active connection.
+ * @param[out] p_stats  Statistics of the connection.
+ *
+ * @retval NRF_SUCCESS             On success, else an error code indicating reason for failure.
+ * @retval NRF_ERROR_NULL          If p_handle and/or p_stats is NULL.
+ * @retval NRF_ERROR_INVALID_ADDR  If the connection is not identified by the handle.
+ * @retval FEATURE_NOT_ENABLED     If DM_DEFERRED_STORE_ENABLED is not set.
+ *
+ * @note The connection instance is freed after DM_EVT_DISCONNECTION is notified. Statistics for
+ *       the complete connection should therefore be read while handling that event.
+ */
+ret_code_t dm_store_stats_get(dm_handle_t const * p_handle, dm_store_stats_t * p_stats);
+
 /** @} */
 /** @} */
 /** @} */
@@ -14,6 +14,23 @@
 #include "pstorage.h"
 #include "ble_hci.h"
 #include "app_error.h"
+#include <stddef.h>
+
+#ifndef DM_DEFERRED_STORE_ENABLED
+#define DM_DEFERRED_STORE_ENABLED      0 /**< Contexts are stored immediately unless enabled in device_manager_cnfg.h. */
+#endif // DM_DEFERRED_STORE_ENABLED
+
+#ifndef DM_DEFERRED_STORE_IDLE_TIMEOUT
+#define DM_DEFERRED_STORE_IDLE_TIMEOUT 0 /**< Dirty contexts are only flushed on disconnection unless set in device_manager_cnfg.h. */
+#endif // DM_DEFERRED_STORE_IDLE_TIMEOUT
+
+#ifndef DEVICE_MANAGER_GATTC_CONTEXT_SIZE
+#define DEVICE_MANAGER_GATTC_CONTEXT_SIZE 0 /**< GATT Client context is not managed unless set in device_manager_cnfg.h. */
+#endif // DEVICE_MANAGER_GATTC_CONTEXT_SIZE
+
+#if (DM_DEFERRED_STORE_ENABLED != 0) && (DM_DEFERRED_STORE_IDLE_TIMEOUT != 0)
+#include "app_timer.h"
+#endif // DM_DEFERRED_STORE_IDLE_TIMEOUT
 
 #if defined ( __CC_ARM )
     #ifndef __ALIGN
@@ -106,6 +123,7 @@ typedef enum
 #define PEER_ID_STORAGE_OFFSET     0                                               /**< Offset at which peer id is stored in the block. */
 #define BOND_STORAGE_OFFSET        PEER_ID_SIZE                                    /**< Offset at which bond information is stored in the block. */
 #define SERVICE_STORAGE_OFFSET     (BOND_STORAGE_OFFSET + BOND_SIZE)               /**< Offset at which service context is stored in the block. */
+#define GATTC_STORAGE_OFFSET       (SERVICE_STORAGE_OFFSET + GATTS_SERVICE_CONTEXT_SIZE) /**< Offset at which GATT Client context is stored in the block. */
 #define APP_CONTEXT_STORAGE_OFFSET (SERVICE_STORAGE_OFFSET + SERVICE_CONTEXT_SIZE) /**< Offset at which application context is stored in the block. */
 /** @} */
 
@@ -385,12 +403,24 @@ typedef struct
 
 STATIC_ASSERT(sizeof(dm_gatts_context_t) % 4 == 0); /**< Check to ensure GATT Server Attributes size and data information is a multiple of 4. */
 
-/**@brief GATT Client context information. Placeholder for now.
+#if (DEVICE_MANAGER_GATTC_CONTEXT_SIZE != 0)
+/**@brief GATT Client context size and data.
+ */
+typedef struct
+{
+    uint32_t size;                                    /**< Size of the context data. */
+    uint8_t  data[DEVICE_MANAGER_GATTC_CONTEXT_SIZE]; /**< Context data, as set by the application. */
+} dm_gatt_client_context_t;
+
+STATIC_ASSERT((DEVICE_MANAGER_GATTC_CONTEXT_SIZE % 4) == 0); /**< Check to ensure GATT Client context size is a multiple of 4. */
+#else
+/**@brief GATT Client context information. Placeholder when GATT Client context is not managed.
  */
 typedef struct
 {
     void * p_dummy; /**< Placeholder, currently unused. */
 } dm_gatt_client_context_t;
+#endif // DEVICE_MANAGER_GATTC_CONTEXT_SIZE
 
 STATIC_ASSERT(sizeof(dm_gatt_client_context_t) % 4 == 0);  /**< Check to ensure GATT Client context information is a multiple of 4. */
 STATIC_ASSERT((DEVICE_MANAGER_APP_CONTEXT_SIZE % 4) == 0); /**< Check to ensure device manager application context information is a multiple of 4. */
@@ -416,6 +446,22 @@ typedef struct
     uint8_t              service;   /**< Service registered by the application. */
 } application_instance_t;
 
+#if (DM_DEFERRED_STORE_ENABLED != 0)
+/**@brief Staging copy of a device block used by the deferred store. The layout matches the layout
+ *        of the block in persistent memory, so that all dirty contexts of a device can be written
+ *        with a single storage operation.
+ */
+typedef struct
+{
+    peer_id_t          peer_id; /**< Peer identification information. */
+    bond_context_t     bond;    /**< Bond information. */
+    dm_gatts_context_t gatts;   /**< GATT Server context. */
+} flush_buffer_t;
+
+STATIC_ASSERT(offsetof(flush_buffer_t, bond) == BOND_STORAGE_OFFSET);     /**< Check to ensure staging layout matches the bond information offset. */
+STATIC_ASSERT(offsetof(flush_buffer_t, gatts) == SERVICE_STORAGE_OFFSET); /**< Check to ensure staging layout matches the service context offset. */
+#endif // DM_DEFERRED_STORE_ENABLED
+
 /**@brief Function for performing necessary action of storing each of the service context as
  *        registered by the application.
  *
@@ -465,6 +511,9 @@ static peer_id_t              m_peer_table[DEVICE_MANAGER_MAX_BONDS] ;
 __ALIGN(sizeof(uint32_t))
 static bond_context_t         m_bond_table[DEVICE_MANAGER_MAX_CONNECTIONS];         /**< Table to maintain bond information for active peers. */
 static dm_gatts_context_t     m_gatts_table[DEVICE_MANAGER_MAX_CONNECTIONS];        /**< Table for service information for active connection instances. */
+#if (DEVICE_MANAGER_GATTC_CONTEXT_SIZE != 0)
+static dm_gatt_client_context_t m_gattc_table[DEVICE_MANAGER_MAX_CONNECTIONS]; /**< Table for GATT Client context of active connection instances. */
+#endif // DEVICE_MANAGER_GATTC_CONTEXT_SIZE
 static connection_instance_t  m_connection_table[DEVICE_MANAGER_MAX_CONNECTIONS];   /**< Table to maintain active peer information. An instance is allocated in the table when a new connection is established and freed on disconnection. */
 static application_instance_t m_application_table[DEVICE_MANAGER_MAX_APPLICATIONS]; /**< Table to maintain application instances. */
 static pstorage_handle_t      m_storage_handle;                                     /**< Persistent storage handle for blocks requested by the module. */
@@ -472,6 +521,17 @@ static uint32_t               m_peer_addr_update;
 static ble_gap_id_key_t       m_local_id_info;                                      /**< ID information of central in case resolvable address is used. */
 static bool                   m_module_initialized = false;                         /**< State indicating if module is initialized or not. */
 static uint8_t                m_irk_index_table[DEVICE_MANAGER_MAX_BONDS];          /**< List maintaining IRK index list. */
+#if (DM_DEFERRED_STORE_ENABLED != 0)
+static flush_buffer_t         m_flush_buffer;                                       /**< Staging buffer of the deferred store in progress. */
+static uint8_t                m_flush_device_id;                                    /**< Device being flushed, DM_INVALID_ID when the staging buffer is free. */
+static uint8_t                m_flush_connection_id;                                /**< Connection instance the flushed contexts were taken from. */
+static uint8_t                m_flush_op_count;                                     /**< Number of storage operations still referring to the staging buffer. */
+static uint32_t               m_flush_result;                                       /**< Result of the flush in progress, first failure is retained. */
+static dm_store_stats_t       m_store_stats[DEVICE_MANAGER_MAX_CONNECTIONS];        /**< Storage statistics of active connections. */
+#if (DM_DEFERRED_STORE_IDLE_TIMEOUT != 0)
+static app_timer_id_t         m_flush_timer_id;                                     /**< Timer flushing dirty contexts of idle connections. */
+#endif // DM_DEFERRED_STORE_IDLE_TIMEOUT
+#endif // DM_DEFERRED_STORE_ENABLED
 
 SDK_MUTEX_DEFINE(m_dm_mutex) /**< Mutex variable. Currently unused, this declaration does not occupy any space in RAM. */
 /** @} */
@@ -598,6 +658,14 @@ static __INLINE void connection_instance_init(uint32_t index)
     m_connection_table[index].state         = STATE_IDLE;
     m_connection_table[index].conn_handle   = BLE_CONN_HANDLE_INVALID;
     m_connection_table[index].bonded_dev_id = DM_INVALID_ID;
+
+#if (DM_DEFERRED_STORE_ENABLED != 0)
+    memset(&m_store_stats[index], 0, sizeof(dm_store_stats_t));
+#endif // DM_DEFERRED_STORE_ENABLED
+
+#if (DEVICE_MANAGER_GATTC_CONTEXT_SIZE != 0)
+    m_gattc_table[index].size = 0;
+#endif // DEVICE_MANAGER_GATTC_CONTEXT_SIZE
     
     memset(&m_connection_table[index].peer_addr, 0, sizeof (ble_gap_addr_t));
 }
@@ -1008,6 +1076,381 @@ static __INLINE void device_context_store(dm_handle_t const * p_handle, device_s
 }
 
 
+#if (DM_DEFERRED_STORE_ENABLED != 0)
+/**@brief Function for checking if the GATT Server context of a connection has changed since it was
+ *        last stored.
+ *
+ * @param[in]  connection_id Connection instance identifier.
+ * @param[out] p_context     Receives the changed context if not NULL. Left untouched otherwise.
+ *
+ * @retval true  If the application registered GATT Server context and the context has changed.
+ * @retval false Otherwise.
+ */
+static bool gatts_context_is_dirty(uint32_t connection_id, dm_gatts_context_t * p_context)
+{
+    uint16_t attr_len = DM_GATT_SERVER_ATTR_MAX_SIZE;
+    uint8_t  sys_data[DM_GATT_SERVER_ATTR_MAX_SIZE];
+
+    if ((m_application_table[0].service & DM_PROTOCOL_CNTXT_GATT_SRVR_ID) == 0)
+    {
+        return false;
+    }
+
+    uint32_t err_code = sd_ble_gatts_sys_attr_get(
+        m_connection_table[connection_id].conn_handle,
+        sys_data,
+        &attr_len,
+        BLE_GATTS_SYS_ATTR_FLAG_SYS_SRVCS | BLE_GATTS_SYS_ATTR_FLAG_USR_SRVCS);
+
+    if ((err_code != NRF_SUCCESS) ||
+        ((m_gatts_table[connection_id].size == attr_len) &&
+         (memcmp(m_gatts_table[connection_id].attributes, sys_data, attr_len) == 0)))
+    {
+        return false;
+    }
+
+    if (p_context != NULL)
+    {
+        p_context->flags = BLE_GATTS_SYS_ATTR_FLAG_SYS_SRVCS | BLE_GATTS_SYS_ATTR_FLAG_USR_SRVCS;
+        p_context->size  = attr_len;
+        memcpy(p_context->attributes, sys_data, attr_len);
+    }
+
+    return true;
+}
+
+
+/**@brief Function for restarting the idle flush timer after a context was marked dirty.
+ */
+static __INLINE void deferred_store_timer_restart(void)
+{
+#if (DM_DEFERRED_STORE_IDLE_TIMEOUT != 0)
+    uint32_t err_code;
+
+    err_code = app_timer_stop(m_flush_timer_id);
+
+    if (err_code == NRF_SUCCESS)
+    {
+        err_code = app_timer_start(m_flush_timer_id, DM_DEFERRED_STORE_IDLE_TIMEOUT, NULL);
+    }
+
+    if (err_code != NRF_SUCCESS)
+    {
+        DM_ERR("[DM]: Failed to start idle flush timer, reason 0x%08X\r\n", err_code);
+    }
+#endif // DM_DEFERRED_STORE_IDLE_TIMEOUT
+}
+
+
+/**@brief Function for marking the contexts of a connection dirty instead of storing them.
+ *
+ * @details The number of storage operations the immediate store path would issue for the same
+ *          request is accounted in the statistics of the connection. A first bond stores the peer
+ *          identification and the bond information, and the service context if it changed.
+ *
+ * @param[in] connection_id Connection instance identifier.
+ * @param[in] state         Device store state the immediate store path would have used.
+ */
+static void deferred_store_mark(uint32_t connection_id, device_store_state_t state)
+{
+    if (state == FIRST_BOND_STORE)
+    {
+        m_connection_table[connection_id].state |= STATE_BOND_INFO_UPDATE;
+        m_store_stats[connection_id].requested  += 2;
+    }
+
+    if (gatts_context_is_dirty(connection_id, NULL))
+    {
+        m_store_stats[connection_id].requested++;
+    }
+
+    deferred_store_timer_restart();
+}
+
+
+/**@brief Function for clearing the dirty state of a connection once its contexts have been issued.
+ *
+ * @param[in] connection_id Connection instance identifier.
+ */
+static void deferred_store_commit(uint32_t connection_id)
+{
+    m_connection_table[connection_id].state &= (~STATE_BOND_INFO_UPDATE);
+
+    if ((m_connection_table[connection_id].state & STATE_CONNECTED) == STATE_CONNECTED)
+    {
+        m_gatts_table[connection_id] = m_flush_buffer.gatts;
+    }
+    else
+    {
+        //Reset GATTS information, the staging buffer holds the copy being written.
+        memset(&m_gatts_table[connection_id], 0, sizeof(dm_gatts_context_t));
+    }
+}
+
+
+/**@brief Function for flushing the dirty contexts of a connection in one coalesced write.
+ *
+ * @details The dirty contexts are copied to the staging buffer. If the block is still erased, as is
+ *          the case for a first bond, bond information and service context are stored before the
+ *          peer identification. The peer identification is what identifies a valid block at
+ *          initialization, so a reset between the two leaves the block unassigned instead of half
+ *          written. Otherwise the contexts are updated with a single swap of the flash page.
+ *
+ * @param[in] p_handle Device handle identifying device that is stored.
+ *
+ * @retval NRF_SUCCESS    On success, or if no context was dirty.
+ * @retval NRF_ERROR_BUSY If the staging buffer is in use. Contexts remain marked dirty.
+ * @retval Other          If an operation failed. Contexts remain marked dirty unless the peer
+ *                        identification of an erased block was the only operation that failed.
+ */
+static ret_code_t deferred_store_flush(dm_handle_t const * p_handle)
+{
+    pstorage_handle_t block_handle;
+    uint32_t          size;
+    uint32_t          index;
+    bool              bond_dirty;
+    bool              gatts_dirty;
+    bool              erased = true;
+    ret_code_t        err_code;
+
+    if (p_handle->device_id == DM_INVALID_ID)
+    {
+        return NRF_SUCCESS;
+    }
+
+    if (m_flush_device_id != DM_INVALID_ID)
+    {
+        DM_LOG("[DM]:[DI %02X]: Flush in progress, deferring.\r\n", p_handle->device_id);
+        return NRF_ERROR_BUSY;
+    }
+
+    m_flush_buffer.peer_id = m_peer_table[p_handle->device_id];
+    m_flush_buffer.bond    = m_bond_table[p_handle->connection_id];
+    m_flush_buffer.gatts   = m_gatts_table[p_handle->connection_id];
+
+    //The GATTS table is refreshed only once the changed context has been issued, a failed flush
+    //leaves it dirty.
+    bond_dirty  = ((m_connection_table[p_handle->connection_id].state & STATE_BOND_INFO_UPDATE) ==
+                   STATE_BOND_INFO_UPDATE);
+    gatts_dirty = gatts_context_is_dirty(p_handle->connection_id, &m_flush_buffer.gatts);
+
+    if (!bond_dirty && !gatts_dirty)
+    {
+        DM_LOG("[DM]:[DI %02X]: No dirty context.\r\n", p_handle->device_id);
+        return NRF_SUCCESS;
+    }
+
+    err_code = pstorage_block_identifier_get(&m_storage_handle, p_handle->device_id, &block_handle);
+
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    size = gatts_dirty ? (DEVICE_CONTEXT_SIZE + GATTS_SERVICE_CONTEXT_SIZE) : DEVICE_CONTEXT_SIZE;
+
+    for (index = 0; index < size; index += sizeof(uint32_t))
+    {
+        if (*(uint32_t *)(block_handle.block_id + index) != 0xFFFFFFFF)
+        {
+            erased = false;
+            break;
+        }
+    }
+
+    m_flush_device_id     = p_handle->device_id;
+    m_flush_connection_id = p_handle->connection_id;
+    m_flush_result        = NRF_SUCCESS;
+
+    if (erased)
+    {
+        DM_LOG("[DM]:[DI %02X]:[CI %02X]: -> Storing dirty contexts.\r\n",
+               p_handle->device_id, p_handle->connection_id);
+
+        err_code = pstorage_store(&block_handle,
+                                  (uint8_t *)&m_flush_buffer.bond,
+                                  size - PEER_ID_SIZE,
+                                  BOND_STORAGE_OFFSET);
+
+        if (err_code == NRF_SUCCESS)
+        {
+            m_flush_op_count = 1;
+            deferred_store_commit(p_handle->connection_id);
+
+            //Peer identification is stored last, it commits the block.
+            err_code = pstorage_store(&block_handle,
+                                      (uint8_t *)&m_flush_buffer.peer_id,
+                                      PEER_ID_SIZE,
+                                      PEER_ID_STORAGE_OFFSET);
+        }
+    }
+    else
+    {
+        DM_LOG("[DM]:[DI %02X]:[CI %02X]: -> Updating dirty contexts.\r\n",
+               p_handle->device_id, p_handle->connection_id);
+
+        err_code = pstorage_update(&block_handle,
+                                   (uint8_t *)&m_flush_buffer,
+                                   size,
+                                   PEER_ID_STORAGE_OFFSET);
+    }
+
+    if (err_code == NRF_SUCCESS)
+    {
+        m_flush_op_count++;
+        m_store_stats[p_handle->connection_id].issued += m_flush_op_count;
+
+        if (!erased)
+        {
+            deferred_store_commit(p_handle->connection_id);
+        }
+    }
+    else
+    {
+        DM_ERR("[DM]:[DI %02X]: Failed to flush dirty contexts, reason 0x%08X\r\n",
+               p_handle->device_id, err_code);
+
+        if (m_flush_op_count == 0)
+        {
+            m_flush_device_id = DM_INVALID_ID;
+        }
+        else
+        {
+            //The stored part is released from the storage callback.
+            m_flush_result                                 = err_code;
+            m_store_stats[p_handle->connection_id].issued += m_flush_op_count;
+        }
+    }
+
+    return err_code;
+}
+
+
+/**@brief Function for storing the contexts a failed flush left unwritten, without coalescing.
+ *
+ * @details If only the peer identification of an erased block failed, only that is stored. Otherwise
+ *          the contexts still marked dirty are stored with the immediate store path.
+ *
+ * @param[in] p_handle     Device handle identifying device that is stored.
+ * @param[in] flush_result Result returned by the failed flush.
+ */
+static void deferred_store_fallback(dm_handle_t const * p_handle, ret_code_t flush_result)
+{
+    if ((flush_result != NRF_ERROR_BUSY) && (m_flush_device_id == p_handle->device_id))
+    {
+        m_store_stats[p_handle->connection_id].issued++;
+        device_context_store(p_handle, UPDATE_PEER_ADDR);
+        return;
+    }
+
+    if ((m_connection_table[p_handle->connection_id].state & STATE_BOND_INFO_UPDATE) ==
+        STATE_BOND_INFO_UPDATE)
+    {
+        m_store_stats[p_handle->connection_id].issued += 2;
+    }
+
+    if (gatts_context_is_dirty(p_handle->connection_id, NULL))
+    {
+        m_store_stats[p_handle->connection_id].issued++;
+    }
+
+    device_context_store(p_handle, STORE_ALL_CONTEXT);
+}
+
+
+/**@brief Function for handling completion of a storage operation on the staging buffer.
+ *
+ * @details The device context stored event is notified once the last operation of the flush has
+ *          completed, with the result of the first operation that failed, if any.
+ *
+ * @param[in] p_handle Device handle identifying the flushed device.
+ * @param[in] result   Result of the storage operation.
+ */
+static void deferred_store_cb_handler(dm_handle_t * p_handle, uint32_t result)
+{
+    dm_event_t           dm_event;
+    dm_context_t         context_data;
+    ble_gap_sec_keyset_t keys_exchanged;
+
+    m_flush_op_count--;
+
+    if (m_flush_result == NRF_SUCCESS)
+    {
+        m_flush_result = result;
+    }
+
+    if (m_flush_op_count != 0)
+    {
+        return;
+    }
+
+    if ((m_connection_table[m_flush_connection_id].bonded_dev_id == m_flush_device_id) &&
+        (m_connection_table[m_flush_connection_id].state != STATE_IDLE))
+    {
+        p_handle->connection_id = m_flush_connection_id;
+    }
+
+    keys_exchanged.keys_central.p_enc_key  = NULL;
+    keys_exchanged.keys_central.p_id_key   = &m_local_id_info;
+    keys_exchanged.keys_central.p_sign_key = NULL;
+    keys_exchanged.keys_periph.p_enc_key   = &m_flush_buffer.bond.peer_enc_key;
+    keys_exchanged.keys_periph.p_id_key    = &m_flush_buffer.peer_id.peer_id;
+    keys_exchanged.keys_periph.p_sign_key  = NULL;
+
+    context_data.p_data = (uint8_t *)&keys_exchanged;
+    context_data.len    = sizeof(ble_gap_sec_keyset_t);
+
+    dm_event.event_id                     = DM_EVT_DEVICE_CONTEXT_STORED;
+    dm_event.event_param.p_device_context = &context_data;
+    dm_event.event_paramlen               = sizeof(dm_device_context_t);
+
+    m_flush_device_id = DM_INVALID_ID;
+
+    app_evt_notify(p_handle, &dm_event, m_flush_result);
+}
+
+
+#if (DM_DEFERRED_STORE_IDLE_TIMEOUT != 0)
+/**@brief Function for handling the idle flush timer timeout.
+ *
+ * @details Flushes dirty contexts of all bonded connections with an encrypted link.
+ *
+ * @param[in] p_context Unused.
+ */
+static void deferred_store_timeout_handler(void * p_context)
+{
+    uint32_t    index;
+    dm_handle_t handle;
+    uint8_t     flush_state = (STATE_CONNECTED | STATE_BONDED | STATE_LINK_ENCRYPTED);
+
+    UNUSED_PARAMETER(p_context);
+
+    DM_MUTEX_LOCK();
+
+    for (index = 0; index < DEVICE_MANAGER_MAX_CONNECTIONS; index++)
+    {
+        if ((m_connection_table[index].state & flush_state) == flush_state)
+        {
+            (void)dm_handle_initialize(&handle);
+
+            handle.appl_id       = 0;
+            handle.connection_id = index;
+            handle.device_id     = m_connection_table[index].bonded_dev_id;
+
+            if (deferred_store_flush(&handle) == NRF_ERROR_BUSY)
+            {
+                //Retry once the flush in progress has completed.
+                deferred_store_timer_restart();
+            }
+        }
+    }
+
+    DM_MUTEX_UNLOCK();
+}
+#endif // DM_DEFERRED_STORE_IDLE_TIMEOUT
+#endif // DM_DEFERRED_STORE_ENABLED
+
+
 /**@brief Function for storing when there is no service registered.
  *
  * @param[in] p_block_handle Storage block identifier.
@@ -1120,14 +1563,67 @@ static __INLINE ret_code_t gatts_context_store(pstorage_handle_t const * p_block
  * @param[in] p_block_handle Storage block identifier.
  * @param[in] p_handle       Device handle identifying device that is stored.
  *
- * @retval NRF_SUCCESS Operation success.
+ * @retval NRF_SUCCESS On success, else an error code indicating reason for failure.
  */
 static __INLINE ret_code_t gattc_context_store(pstorage_handle_t const * p_block_handle,
                                                dm_handle_t const       * p_handle)
 {
     DM_LOG("[DM]: --> gattc_context_store\r\n");
 
+#if (DEVICE_MANAGER_GATTC_CONTEXT_SIZE != 0)
+    storage_operation store_fn;
+    ret_code_t        err_code = NRF_SUCCESS;
+
+    //The stored context is read directly from the memory mapped flash.
+    dm_gatt_client_context_t const * p_stored =
+        (dm_gatt_client_context_t const *)(p_block_handle->block_id + GATTC_STORAGE_OFFSET);
+
+    if (m_gattc_table[p_handle->connection_id].size == 0)
+    {
+        //Nothing was set by the application for this connection.
+        DM_LOG("[DM]:[0x%02X]: No GATTC Context information to store.\r\n",
+               p_handle->device_id);
+    }
+    else if (memcmp(p_stored, &m_gattc_table[p_handle->connection_id], GATTC_SERVICE_CONTEXT_SIZE) == 0)
+    {
+        //No store operation is needed.
+        DM_LOG("[DM]:[0x%02X]: No change in GATTC Context information.\r\n",
+               p_handle->device_id);
+    }
+    else
+    {
+        if (p_stored->size <= DEVICE_MANAGER_GATTC_CONTEXT_SIZE)
+        {
+            //There is data already stored in persistent memory, therefore an update is needed.
+            DM_LOG("[DM]:[0x%02X]: Updating stored GATTC context\r\n", p_handle->device_id);
+
+            store_fn = pstorage_update;
+        }
+        else
+        {
+            //Fresh write, a store is needed.
+            DM_LOG("[DM]:[0x%02X]: Storing GATTC context\r\n", p_handle->device_id);
+
+            store_fn = pstorage_store;
+        }
+
+        err_code = store_fn((pstorage_handle_t *)p_block_handle,
+                            (uint8_t *)&m_gattc_table[p_handle->connection_id],
+                            GATTC_SERVICE_CONTEXT_SIZE,
+                            GATTC_STORAGE_OFFSET);
+
+        if (err_code != NRF_SUCCESS)
+        {
+            DM_ERR("[DM]:[0x%02X]:Failed to store GATTC context, reason 0x%08X\r\n",
+                   p_handle->device_id,
+                   err_code);
+        }
+    }
+
+    return err_code;
+#else
     return NRF_SUCCESS;
+#endif // DEVICE_MANAGER_GATTC_CONTEXT_SIZE
 }
 
 
@@ -1218,14 +1714,38 @@ static __INLINE ret_code_t gatts_context_load(pstorage_handle_t const * p_block_
  * @param[in] p_block_handle Storage block identifier.
  * @param[in] p_handle       Device handle identifying device that is loaded.
  *
- * @retval NRF_SUCCESS
+ * @retval NRF_SUCCESS On success, else an error code indicating reason for failure.
  */
 static __INLINE ret_code_t gattc_context_load(pstorage_handle_t const * p_block_handle,
                                               dm_handle_t const       * p_handle)
 {
     DM_LOG("[DM]: --> gattc_context_load\r\n");
 
+#if (DEVICE_MANAGER_GATTC_CONTEXT_SIZE != 0)
+    ret_code_t err_code = pstorage_load((uint8_t *)&m_gattc_table[p_handle->connection_id],
+                                        (pstorage_handle_t *)p_block_handle,
+                                        GATTC_SERVICE_CONTEXT_SIZE,
+                                        GATTC_STORAGE_OFFSET);
+
+    if (err_code == NRF_SUCCESS)
+    {
+        if (m_gattc_table[p_handle->connection_id].size > DEVICE_MANAGER_GATTC_CONTEXT_SIZE)
+        {
+            //Nothing stored for the device.
+            m_gattc_table[p_handle->connection_id].size = 0;
+        }
+    }
+    else
+    {
+        DM_ERR("[DM]:[%02X]: Failed to load GATTC context, reason %08X\r\n",
+               p_handle->connection_id,
+               err_code);
+    }
+
+    return err_code;
+#else
     return NRF_SUCCESS;
+#endif // DEVICE_MANAGER_GATTC_CONTEXT_SIZE
 }
 
 
@@ -1455,6 +1975,36 @@ static void dm_pstorage_cb_handler(pstorage_handle_t * p_handle,
         }
     }
 
+#if (DM_DEFERRED_STORE_ENABLED != 0)
+    if ((p_data >= (uint8_t *)&m_flush_buffer) &&
+        (p_data < ((uint8_t *)&m_flush_buffer + sizeof(flush_buffer_t))))
+    {
+        deferred_store_cb_handler(&dm_handle, result);
+
+        DM_MUTEX_UNLOCK();
+        return;
+    }
+#endif // DM_DEFERRED_STORE_ENABLED
+
+#if (DEVICE_MANAGER_GATTC_CONTEXT_SIZE != 0)
+    if ((p_data >= (uint8_t *)m_gattc_table) &&
+        (p_data < ((uint8_t *)m_gattc_table + sizeof(m_gattc_table))))
+    {
+        //GATT Client context is identified before the other contexts, since its table is not part
+        //of the value ranges checked below.
+        dm_handle.connection_id = ((uint32_t)(p_data - (uint8_t *)m_gattc_table)) /
+                                  GATTC_SERVICE_CONTEXT_SIZE;
+        dm_handle.service_id    = DM_PROTOCOL_CNTXT_GATT_CLI_ID;
+        dm_event.event_id       = DM_EVT_SERVICE_CONTEXT_STORED;
+
+        dm_event.event_param.p_app_context = &context_data;
+        app_evt_notify(&dm_handle, &dm_event, result);
+
+        DM_MUTEX_UNLOCK();
+        return;
+    }
+#endif // DEVICE_MANAGER_GATTC_CONTEXT_SIZE
+
     if (dm_handle.device_id != DM_INVALID_ID)
     {
         if (op_code == PSTORAGE_CLEAR_OP_CODE)
@@ -1650,6 +2200,23 @@ ret_code_t dm_init(dm_init_param_t const * const p_init_param)
 
     memset(m_gatts_table, 0, sizeof(m_gatts_table));
 
+#if (DM_DEFERRED_STORE_ENABLED != 0)
+    m_flush_device_id = DM_INVALID_ID;
+    m_flush_op_count  = 0;
+
+#if (DM_DEFERRED_STORE_IDLE_TIMEOUT != 0)
+    err_code = app_timer_create(&m_flush_timer_id,
+                                APP_TIMER_MODE_SINGLE_SHOT,
+                                deferred_store_timeout_handler);
+
+    if (err_code != NRF_SUCCESS)
+    {
+        DM_MUTEX_UNLOCK();
+        return err_code;
+    }
+#endif // DM_DEFERRED_STORE_IDLE_TIMEOUT
+#endif // DM_DEFERRED_STORE_ENABLED
+
     //Initialization of all device instances.
     for (index = 0; index < DEVICE_MANAGER_MAX_BONDS; index++)
     {
@@ -2009,6 +2576,26 @@ ret_code_t dm_service_context_set(dm_handle_t const          * p_handle,
         }
     }
 
+#if (DEVICE_MANAGER_GATTC_CONTEXT_SIZE != 0)
+    if ((p_context->service_type == DM_PROTOCOL_CNTXT_GATT_CLI_ID) &&
+        (p_context->context_data.p_data != NULL))
+    {
+        if (p_context->context_data.len > DEVICE_MANAGER_GATTC_CONTEXT_SIZE)
+        {
+            DM_TRC("[DM]: << dm_service_context_set\r\n");
+
+            DM_MUTEX_UNLOCK();
+
+            return (NRF_ERROR_INVALID_PARAM | DEVICE_MANAGER_ERR_BASE);
+        }
+
+        m_gattc_table[p_handle->connection_id].size = p_context->context_data.len;
+        memcpy(m_gattc_table[p_handle->connection_id].data,
+               p_context->context_data.p_data,
+               p_context->context_data.len);
+    }
+#endif // DEVICE_MANAGER_GATTC_CONTEXT_SIZE
+
     pstorage_handle_t block_handle;
     uint32_t          err_code = pstorage_block_identifier_get(&m_storage_handle,
                                                                p_handle->device_id,
@@ -2044,6 +2631,22 @@ ret_code_t dm_service_context_get(dm_handle_t const    * p_handle,
 
     DM_TRC("[DM]: >> dm_service_context_get\r\n");
 
+#if (DEVICE_MANAGER_GATTC_CONTEXT_SIZE != 0)
+    if (p_context->service_type == DM_PROTOCOL_CNTXT_GATT_CLI_ID)
+    {
+        //GATT Client context is loaded on connection. It is not loaded again here, as the table is
+        //also the source of a store operation that may be in progress.
+        p_context->context_data.p_data = m_gattc_table[p_handle->connection_id].data;
+        p_context->context_data.len    = m_gattc_table[p_handle->connection_id].size;
+
+        DM_TRC("[DM]: << dm_service_context_get\r\n");
+
+        DM_MUTEX_UNLOCK();
+
+        return NRF_SUCCESS;
+    }
+#endif // DEVICE_MANAGER_GATTC_CONTEXT_SIZE
+
     if ((p_context->context_data.p_data == NULL) &&
         (p_context->context_data.len < DM_GATT_SERVER_ATTR_MAX_SIZE))
     {
@@ -2613,8 +3216,22 @@ void dm_ble_evt_handler(ble_evt_t * p_ble_evt)
             {
                 if ((m_connection_table[index].state & STATE_LINK_ENCRYPTED) == STATE_LINK_ENCRYPTED)
                 {
+#if (DM_DEFERRED_STORE_ENABLED != 0)
+                    deferred_store_mark(index, STORE_ALL_CONTEXT);
+
+                    //Write dirty contexts in one operation, or store what the flush left
+                    //unwritten immediately, for instance if a flush of another device is still in
+                    //progress.
+                    err_code = deferred_store_flush(&handle);
+
+                    if (err_code != NRF_SUCCESS)
+                    {
+                        deferred_store_fallback(&handle, err_code);
+                    }
+#else
                     //Write bond information persistently.
                     device_context_store(&handle, STORE_ALL_CONTEXT);
+#endif // DM_DEFERRED_STORE_ENABLED
                 }
             }
             else
@@ -2794,7 +3411,11 @@ void dm_ble_evt_handler(ble_evt_t * p_ble_evt)
                                 m_peer_table[handle.device_id].id_bitmap &= (~IRK_ENTRY);
                             }
 
+#if (DM_DEFERRED_STORE_ENABLED != 0)
+                            deferred_store_mark(index, FIRST_BOND_STORE);
+#else
                             device_context_store(&handle, FIRST_BOND_STORE);
+#endif // DM_DEFERRED_STORE_ENABLED
                         }
                     }
                 }
@@ -2912,3 +3533,24 @@ ret_code_t dm_handle_get(uint16_t conn_handle, dm_handle_t * p_handle)
     }
     return err_code;
 }
+
+
+ret_code_t dm_store_stats_get(dm_handle_t const * p_handle, dm_store_stats_t * p_stats)
+{
+    VERIFY_MODULE_INITIALIZED();
+    NULL_PARAM_CHECK(p_handle);
+    NULL_PARAM_CHECK(p_stats);
+    VERIFY_CONNECTION_INSTANCE(p_handle->connection_id);
+
+#if (DM_DEFERRED_STORE_ENABLED != 0)
+    DM_MUTEX_LOCK();
+
+    (*p_stats) = m_store_stats[p_handle->connection_id];
+
+    DM_MUTEX_UNLOCK();
+
+    return NRF_SUCCESS;
+#else
+    return (FEATURE_NOT_ENABLED | DEVICE_MANAGER_ERR_BASE);
+#endif // DM_DEFERRED_STORE_ENABLED
+}
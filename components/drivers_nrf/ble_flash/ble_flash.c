@@ -20,10 +20,23 @@
 #include "nrf.h"
 #include "nrf51_bitfields.h"
 #include "app_util.h"
+#include "app_util_platform.h"
 
 
 static volatile bool m_radio_active = false;  /**< TRUE if radio is active (or about to become active), FALSE otherwise. */
 
+/**@brief Block write in progress, programmed in the radio idle windows. */
+typedef struct
+{
+    uint32_t *           p_address;   /**< Next flash location to be written. */
+    uint32_t const *     p_in_array;  /**< Next word to be written. */
+    uint16_t             words_left;  /**< Number of words still to be written. */
+    ble_flash_write_cb_t cb;          /**< Completion callback, NULL when no block write is in progress. */
+} block_write_t;
+
+static volatile block_write_t m_block_write;  /**< Asynchronous block write in progress, written from the radio notification interrupt. */
+static volatile bool m_window_busy = false;   /**< TRUE while the NVMC is being used for programming or erasing. */
+
 
 uint16_t ble_flash_crc16_compute(uint8_t * p_data, uint16_t size, uint16_t * p_crc)
 {
@@ -42,6 +55,26 @@ uint16_t ble_flash_crc16_compute(uint8_t * p_data, uint16_t size, uint16_t * p_c
 }
 
 
+/**@brief Function for taking exclusive use of the NVMC.
+ *
+ * @details The blocking API and the asynchronous block write, which runs from the Radio
+ *          Notification handler, must not program the flash at the same time.
+ *
+ * @return     TRUE if the NVMC was free and is now taken, FALSE if it is in use.
+ */
+static bool window_acquire(void)
+{
+    bool acquired;
+
+    CRITICAL_REGION_ENTER();
+    acquired      = !m_window_busy;
+    m_window_busy = true;
+    CRITICAL_REGION_EXIT();
+
+    return acquired;
+}
+
+
 /**@brief Function for erasing a page in flash.
  * 
  * @param[in]  p_page  Pointer to first word in page to be erased.
@@ -71,17 +104,19 @@ static void flash_page_erase(uint32_t * p_page)
 }
 
 
-/**@brief Function for writing one word to flash. Unprotected write, which can interfere with radio communication.
+/**@brief Function for writing a block of words to flash. Unprotected write, which can interfere with radio communication.
  *
  * @details This function DOES NOT use the m_radio_active variable, but will force the write even
  *          when the radio is active. To be used only from @ref ble_flash_page_write.
+ *          Write is enabled once for the whole block.
  *
- * @note Flash location to be written must have been erased previously.
+ * @note Flash locations to be written must have been erased previously.
  *
- * @param[in]  p_address   Pointer to flash location to be written.
- * @param[in]  value       Value to write to flash.
+ * @param[in]  p_address    Pointer to start of flash location to be written.
+ * @param[in]  p_in_array   Pointer to start of words to be written.
+ * @param[in]  word_count   Number of words to be written.
  */
-static void flash_word_unprotected_write(uint32_t * p_address, uint32_t value)
+static void flash_block_unprotected_write(uint32_t * p_address, uint32_t const * p_in_array, uint16_t word_count)
 {
     // Turn on flash write enable and wait until the NVMC is ready.
     NRF_NVMC->CONFIG = (NVMC_CONFIG_WEN_Wen << NVMC_CONFIG_WEN_Pos);
@@ -89,12 +124,16 @@ static void flash_word_unprotected_write(uint32_t * p_address, uint32_t value)
     {
         // Do nothing.
     }
-    *p_address = value;
-    
-    // Wait flash write to finish
-    while (NRF_NVMC->READY == NVMC_READY_READY_Busy)
+
+    while (word_count-- > 0)
     {
-        // Do nothing.
+        *p_address++ = *p_in_array++;
+
+        // Wait flash write to finish
+        while (NRF_NVMC->READY == NVMC_READY_READY_Busy)
+        {
+            // Do nothing.
+        }
     }
 
     // Turn off flash write enable and wait until the NVMC is ready.
@@ -144,39 +183,199 @@ static void flash_word_write(uint32_t * p_address, uint32_t value)
 }
 
 
+/**@brief Function for writing consecutive words to flash in one radio idle window.
+ *
+ * @details Write is enabled once for the whole window, and each word only waits for the NVMC to
+ *          finish the previous one. Programming stops when the radio becomes active, when
+ *          @ref BLE_FLASH_WINDOW_WORD_COUNT words have been written, or when all words are written.
+ *
+ * @note Flash locations to be written must have been erased previously.
+ *
+ * @param[in,out] pp_address   Pointer to flash location to be written, advanced past the words written.
+ * @param[in,out] pp_in_array  Pointer to words to be written, advanced past the words written.
+ * @param[in]     word_count   Number of words left to be written.
+ *
+ * @return     Number of words written.
+ */
+static uint16_t flash_window_write(uint32_t ** pp_address, uint32_t const ** pp_in_array, uint16_t word_count)
+{
+    uint16_t         written   = 0;
+    uint32_t *       p_address = *pp_address;
+    uint32_t const * p_src     = *pp_in_array;
+
+    if (word_count > BLE_FLASH_WINDOW_WORD_COUNT)
+    {
+        word_count = BLE_FLASH_WINDOW_WORD_COUNT;
+    }
+
+    // Turn on flash write enable and wait until the NVMC is ready.
+    NRF_NVMC->CONFIG = (NVMC_CONFIG_WEN_Wen << NVMC_CONFIG_WEN_Pos);
+    while (NRF_NVMC->READY == NVMC_READY_READY_Busy)
+    {
+        // Do nothing.
+    }
+
+    while ((written < word_count) && !m_radio_active)
+    {
+        *p_address++ = *p_src++;
+        written++;
+
+        // Wait flash write to finish
+        while (NRF_NVMC->READY == NVMC_READY_READY_Busy)
+        {
+            // Do nothing.
+        }
+    }
+
+    // Turn off flash write enable and wait until the NVMC is ready.
+    NRF_NVMC->CONFIG = (NVMC_CONFIG_WEN_Ren << NVMC_CONFIG_WEN_Pos);
+    while (NRF_NVMC->READY == NVMC_READY_READY_Busy)
+    {
+        // Do nothing
+    }
+
+    *pp_address  = p_address;
+    *pp_in_array = p_src;
+
+    return written;
+}
+
+
+/**@brief Function for continuing the asynchronous block write in the current radio idle window.
+ *
+ * @details Calls the completion callback once the last word has been written.
+ */
+static void block_write_window_run(void)
+{
+    ble_flash_write_cb_t cb;
+    uint32_t *           p_address;
+    uint32_t const *     p_in_array;
+
+    if ((m_block_write.cb == NULL) || m_radio_active)
+    {
+        return;
+    }
+
+    if (!window_acquire())
+    {
+        // A blocking write is in progress, continue in the next radio idle window.
+        return;
+    }
+
+    p_address                = m_block_write.p_address;
+    p_in_array               = m_block_write.p_in_array;
+    m_block_write.words_left -= flash_window_write(&p_address, &p_in_array, m_block_write.words_left);
+    m_block_write.p_address  = p_address;
+    m_block_write.p_in_array = p_in_array;
+
+    m_window_busy = false;
+
+    if (m_block_write.words_left == 0)
+    {
+        cb               = m_block_write.cb;
+        m_block_write.cb = NULL;
+
+        cb(m_block_write.p_address, NRF_SUCCESS);
+    }
+}
+
+
 uint32_t ble_flash_word_write(uint32_t * p_address, uint32_t value)
 {
+    if (!window_acquire())
+    {
+        return NRF_ERROR_BUSY;
+    }
+
     flash_word_write(p_address, value);
+
+    m_window_busy = false;
     return NRF_SUCCESS;
 }
 
 
 uint32_t ble_flash_block_write(uint32_t * p_address, uint32_t * p_in_array, uint16_t word_count)
 {
-    uint16_t i;
+    uint32_t const * p_src = p_in_array;
+
+    if (!window_acquire())
+    {
+        return NRF_ERROR_BUSY;
+    }
 
-    for (i = 0; i < word_count; i++)
+    while (word_count > 0)
     {
-        flash_word_write(p_address, p_in_array[i]);
-        p_address++;
+        // If radio is active, wait for it to become inactive.
+        while (m_radio_active)
+        {
+            // Do nothing (just wait for radio to become inactive).
+            (void) sd_app_evt_wait();
+        }
+
+        word_count -= flash_window_write(&p_address, &p_src, word_count);
     }
 
+    m_window_busy = false;
     return NRF_SUCCESS;
 }
 
 
+uint32_t ble_flash_block_write_start(uint32_t *           p_address,
+                                     uint32_t const *     p_in_array,
+                                     uint16_t             word_count,
+                                     ble_flash_write_cb_t cb)
+{
+    if ((p_address == NULL) || (p_in_array == NULL) || (cb == NULL))
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if (word_count == 0)
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    if (m_block_write.cb != NULL)
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    m_block_write.p_address  = p_address;
+    m_block_write.p_in_array = p_in_array;
+    m_block_write.words_left = word_count;
+    m_block_write.cb         = cb;
+
+    // Use the current idle window, if any. The rest is written from the radio notifications.
+    block_write_window_run();
+
+    return NRF_SUCCESS;
+}
+
+
+bool ble_flash_block_write_in_progress(void)
+{
+    return (m_block_write.cb != NULL);
+}
+
+
 uint32_t ble_flash_page_erase(uint8_t page_num)
 {
     uint32_t * p_page = (uint32_t *)(BLE_FLASH_PAGE_SIZE * page_num);
+
+    if (!window_acquire())
+    {
+        return NRF_ERROR_BUSY;
+    }
+
     flash_page_erase(p_page);
 
+    m_window_busy = false;
     return NRF_SUCCESS;
 }
 
 
 uint32_t ble_flash_page_write(uint8_t page_num, uint32_t * p_in_array, uint8_t word_count)
 {
-    int        i;
     uint32_t * p_page;
     uint32_t * p_curr_addr;
     uint16_t   in_data_crc;
@@ -201,6 +400,11 @@ uint32_t ble_flash_page_write(uint8_t page_num, uint32_t * p_in_array, uint8_t w
         return NRF_SUCCESS;
     }
 
+    if (!window_acquire())
+    {
+        return NRF_ERROR_BUSY;
+    }
+
     // Erase flash page
     flash_page_erase(p_page);
 
@@ -211,11 +415,7 @@ uint32_t ble_flash_page_write(uint8_t page_num, uint32_t * p_in_array, uint8_t w
     p_curr_addr++;
 
     // Write data
-    for (i = 0; i < word_count; i++)
-    {
-        flash_word_unprotected_write(p_curr_addr, p_in_array[i]);
-        p_curr_addr++;
-    }
+    flash_block_unprotected_write(p_curr_addr, p_in_array, word_count);
 
     // Write number of elements.
     flash_word_write(p_page + 1, (uint32_t)(word_count));
@@ -224,6 +424,7 @@ uint32_t ble_flash_page_write(uint8_t page_num, uint32_t * p_in_array, uint8_t w
     flash_header = BLE_FLASH_MAGIC_NUMBER | (uint32_t)in_data_crc;
     flash_word_write(p_page, flash_header);
 
+    m_window_busy = false;
     return NRF_SUCCESS;
 }
 
@@ -284,4 +485,9 @@ uint32_t ble_flash_page_addr(uint8_t page_num, uint32_t ** pp_page_addr)
 void ble_flash_on_radio_active_evt(bool radio_active)
 {
     m_radio_active = radio_active;
+
+    if (!radio_active)
+    {
+        block_write_window_run();
+    }
 }
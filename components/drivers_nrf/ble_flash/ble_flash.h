@@ -38,6 +38,17 @@
 #define BLE_FLASH_MAGIC_NUMBER  0x45DE0000                          /**< Magic value to identify if flash contains valid data. */
 #define BLE_FLASH_EMPTY_MASK    0xFFFFFFFF                          /**< Bit mask that defines an empty address in flash. */
 
+#ifndef BLE_FLASH_WINDOW_WORD_COUNT
+#define BLE_FLASH_WINDOW_WORD_COUNT 16                              /**< Maximum number of words programmed in one radio idle window. At most 46 us per word, this fits within the minimum 800 us Radio Notification distance. */
+#endif
+
+/**@brief Block write completion callback.
+ *
+ * @param[in]  p_address   Pointer to the flash location following the last word written.
+ * @param[in]  result      NRF_SUCCESS when all words have been written.
+ */
+typedef void (*ble_flash_write_cb_t)(uint32_t * p_address, uint32_t result);
+
 
 /**@brief Macro for getting the end of the flash available for application.
  * 
@@ -59,7 +70,8 @@
  *                          This area has to be 32 bits aligned.
  * @param[in]  word_count   Number of 32 bits words to write in flash.
  *
- * @return     NRF_SUCCESS on successful flash write, otherwise an error code.
+ * @return     NRF_SUCCESS on successful flash write, NRF_ERROR_BUSY if an asynchronous block write
+ *             is programming the flash.
  */
 uint32_t ble_flash_page_write(uint8_t page_num, uint32_t * p_in_array, uint8_t word_count);
 
@@ -81,7 +93,8 @@ uint32_t ble_flash_page_read(uint8_t page_num, uint32_t * p_out_array, uint8_t *
  *
  * @param[in]  page_num   Page number to erase.
  *
- * @return     NRF_SUCCESS on success, an error_code otherwise.
+ * @return     NRF_SUCCESS on success, NRF_ERROR_BUSY if an asynchronous block write is programming
+ *             the flash.
  */
 uint32_t ble_flash_page_erase(uint8_t page_num);
 
@@ -92,7 +105,7 @@ uint32_t ble_flash_page_erase(uint8_t page_num);
  * @param[in]  p_address   Pointer to flash location to be written.
  * @param[in]  value       Value to write to flash.
  *
- * @return     NRF_SUCCESS.
+ * @return     NRF_SUCCESS, or NRF_ERROR_BUSY if an asynchronous block write is programming the flash.
  */
 uint32_t ble_flash_word_write(uint32_t * p_address, uint32_t value);
 
@@ -104,10 +117,41 @@ uint32_t ble_flash_word_write(uint32_t * p_address, uint32_t value);
  * @param[in]  p_in_array   Pointer to start of flash block to be written.
  * @param[in]  word_count   Number of words to be written.
  *
- * @return     NRF_SUCCESS.
+ * @return     NRF_SUCCESS, or NRF_ERROR_BUSY if an asynchronous block write is programming the flash.
  */
 uint32_t ble_flash_block_write(uint32_t * p_address, uint32_t * p_in_array, uint16_t word_count);
 
+/**@brief Function for starting an asynchronous write of a data block to flash.
+ *
+ * @details Words are programmed in batches of up to @ref BLE_FLASH_WINDOW_WORD_COUNT words in
+ *          each radio idle window signalled through @ref ble_flash_on_radio_active_evt, and the
+ *          write resumes in the next window when the radio becomes active. The callback is called
+ *          once the last word has been written, from the context calling
+ *          @ref ble_flash_on_radio_active_evt (or from this function if the whole block fits in
+ *          the current window).
+ *
+ * @note Flash locations to be written must have been erased previously. The source array must be
+ *       kept unchanged until the callback has been called.
+ *
+ * @param[in]  p_address    Pointer to start of flash location to be written.
+ * @param[in]  p_in_array   Pointer to start of data block to be written.
+ * @param[in]  word_count   Number of words to be written.
+ * @param[in]  cb           Completion callback.
+ *
+ * @return     NRF_SUCCESS if the write was started, NRF_ERROR_BUSY if a block write is already in
+ *             progress, NRF_ERROR_NULL or NRF_ERROR_INVALID_LENGTH on invalid parameters.
+ */
+uint32_t ble_flash_block_write_start(uint32_t *           p_address,
+                                     uint32_t const *     p_in_array,
+                                     uint16_t             word_count,
+                                     ble_flash_write_cb_t cb);
+
+/**@brief Function for checking if an asynchronous block write is in progress.
+ *
+ * @return     TRUE if a block write started with @ref ble_flash_block_write_start has not completed.
+ */
+bool ble_flash_block_write_in_progress(void);
+
 /**@brief Function for computing pointer to start of specified flash page.
  *
  * @param[in]  page_num       Page number.
@@ -128,6 +172,8 @@ uint32_t ble_flash_page_addr(uint8_t page_num, uint32_t ** pp_page_addr);
 uint16_t ble_flash_crc16_compute(uint8_t * p_data, uint16_t size, uint16_t * p_crc);
 
 /**@brief Function for handling flashing module Radio Notification event.
+ *
+ * @details When the radio becomes inactive, an asynchronous block write in progress is continued.
  *
  * @note For flash writing to work safely while in a connection or while advertising, this function
  *       MUST be called from the Radio Notification module's event handler (see
@@ -11,10 +11,12 @@
  */
 
 #include "app_fifo.h"
+#include <string.h>
 #include "nrf_error.h"
 #include "app_util.h"
+#include "nordic_common.h"
 
-static __INLINE uint32_t fifo_length(app_fifo_t * p_fifo)
+static __INLINE uint32_t fifo_length(app_fifo_t const * p_fifo)
 {
   uint32_t tmp = p_fifo->read_pos;
   return p_fifo->write_pos - tmp;
@@ -72,6 +74,49 @@ uint32_t app_fifo_get(app_fifo_t * p_fifo, uint8_t * p_byte)
 
 }
 
+uint32_t app_fifo_read(app_fifo_t * p_fifo, uint8_t * p_byte_array, uint32_t * p_size)
+{
+    uint32_t read_size = MIN(*p_size, FIFO_LENGTH);
+    uint32_t index     = p_fifo->read_pos & p_fifo->buf_size_mask;
+    uint32_t first     = MIN(read_size, (uint32_t)p_fifo->buf_size_mask + 1 - index);
+
+    *p_size = read_size;
+    if (read_size == 0)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    // Copy up to the end of the buffer, then the rest from its start.
+    memcpy(p_byte_array, &p_fifo->p_buf[index], first);
+    memcpy(&p_byte_array[first], p_fifo->p_buf, read_size - first);
+    p_fifo->read_pos += read_size;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_fifo_write(app_fifo_t * p_fifo, uint8_t const * p_byte_array, uint32_t * p_size)
+{
+    uint32_t requested  = *p_size;
+    uint32_t write_size = MIN(requested, (uint32_t)p_fifo->buf_size_mask + 1 - FIFO_LENGTH);
+    uint32_t index      = p_fifo->write_pos & p_fifo->buf_size_mask;
+    uint32_t first      = MIN(write_size, (uint32_t)p_fifo->buf_size_mask + 1 - index);
+
+    memcpy(&p_fifo->p_buf[index], p_byte_array, first);
+    memcpy(p_fifo->p_buf, &p_byte_array[first], write_size - first);
+    p_fifo->write_pos += write_size;
+
+    *p_size = write_size;
+    return (write_size == requested) ? NRF_SUCCESS : NRF_ERROR_NO_MEM;
+}
+
+
+uint32_t app_fifo_length(app_fifo_t const * p_fifo)
+{
+    return FIFO_LENGTH;
+}
+
+
 uint32_t app_fifo_flush(app_fifo_t * p_fifo)
 {
     p_fifo->read_pos = p_fifo->write_pos;
@@ -69,6 +69,41 @@ uint32_t app_fifo_put(app_fifo_t * p_fifo, uint8_t byte);
  */
 uint32_t app_fifo_get(app_fifo_t * p_fifo, uint8_t * p_byte);
 
+/**@brief Function for reading bytes from the FIFO.
+ *
+ * @details Copies the bytes in at most two blocks, which is faster than calling app_fifo_get for
+ *          each byte.
+ *
+ * @param[in]    p_fifo         Pointer to the FIFO.
+ * @param[out]   p_byte_array   Memory to read the bytes into.
+ * @param[inout] p_size         Number of bytes to read. Number of bytes read on return.
+ *
+ * @retval     NRF_SUCCESS              If at least one byte was read.
+ * @retval     NRF_ERROR_NOT_FOUND      If the FIFO is empty.
+ */
+uint32_t app_fifo_read(app_fifo_t * p_fifo, uint8_t * p_byte_array, uint32_t * p_size);
+
+/**@brief Function for writing bytes to the FIFO.
+ *
+ * @details Writes as many bytes as fit in the FIFO.
+ *
+ * @param[in]    p_fifo         Pointer to the FIFO.
+ * @param[in]    p_byte_array   Bytes to write.
+ * @param[inout] p_size         Number of bytes to write. Number of bytes written on return.
+ *
+ * @retval     NRF_SUCCESS              If all bytes were written.
+ * @retval     NRF_ERROR_NO_MEM         If the FIFO could not take all bytes.
+ */
+uint32_t app_fifo_write(app_fifo_t * p_fifo, uint8_t const * p_byte_array, uint32_t * p_size);
+
+/**@brief Function for getting the number of bytes in the FIFO.
+ *
+ * @param[in]  p_fifo   Pointer to the FIFO.
+ *
+ * @return     Number of bytes in the FIFO.
+ */
+uint32_t app_fifo_length(app_fifo_t const * p_fifo);
+
 /**@brief Function for flushing the FIFO.
  *
  * @param[in]  p_fifo   Pointer to the FIFO.
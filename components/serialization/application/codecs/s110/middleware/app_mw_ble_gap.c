@@ -15,6 +15,7 @@
 #include <string.h>
 #include "ble_serialization.h"
 #include "ser_sd_transport.h"
+#include "ser_sd_async.h"
 #include "ser_config.h"
 #include "ble_gap_app.h"
 #include "app_error.h"
@@ -72,6 +73,30 @@ static void tx_buf_alloc(uint8_t * * p_data, uint16_t * p_len)
     *p_data[0] = SER_PKT_TYPE_CMD;
     *p_len    -= 1;
 }
+
+/**@brief Function for allocating a tx buffer for an asynchronous command.
+ *
+ * @details Does not wait for a buffer, as it can be called from a completion callback, in the
+ *          interrupt context in which buffers are released.
+ *
+ * @param[out] p_data   Pointer to the allocated buffer.
+ * @param[out] p_len    Length of the allocated buffer, excluding the packet type.
+ *
+ * @retval NRF_SUCCESS      Buffer allocated.
+ * @retval NRF_ERROR_BUSY   Maximum number of commands waiting for a response reached.
+ * @retval NRF_ERROR_NO_MEM All tx buffers are in use.
+ */
+static uint32_t async_tx_buf_alloc(uint8_t * * p_data, uint16_t * p_len)
+{
+    uint32_t err_code = ser_sd_transport_async_tx_alloc(p_data, p_len);
+
+    if (err_code == NRF_SUCCESS)
+    {
+        *p_data[0] = SER_PKT_TYPE_CMD;
+        *p_len    -= 1;
+    }
+    return err_code;
+}
 /**@brief Command response callback function for @ref sd_ble_gap_adv_start BLE command.
  *
  * Callback for decoding the command response return code.
@@ -419,6 +444,45 @@ uint32_t sd_ble_gap_conn_param_update(uint16_t                            conn_h
 }
 
 
+uint32_t sd_ble_gap_conn_param_update_async(uint16_t                            conn_handle,
+                                            ble_gap_conn_params_t const * const p_conn_params,
+                                            ser_sd_transport_cmd_cb_t           cmd_cb,
+                                            void *                              p_context)
+{
+    uint8_t * p_buffer;
+    uint32_t  buffer_length = 0;
+    uint32_t  err_code;
+
+    if (cmd_cb == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    err_code = async_tx_buf_alloc(&p_buffer, (uint16_t *)&buffer_length);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    err_code = ble_gap_conn_param_update_req_enc(conn_handle,
+                                                 p_conn_params,
+                                                 &(p_buffer[1]),
+                                                 &buffer_length);
+    if (err_code != NRF_SUCCESS)
+    {
+        (void)ser_sd_transport_tx_free(p_buffer);
+        return err_code;
+    }
+
+    //@note: Increment buffer length as internally managed packet type field must be included.
+    return ser_sd_transport_cmd_write_async(p_buffer,
+                                            (++buffer_length),
+                                            gap_conn_param_update_rsp_dec,
+                                            cmd_cb,
+                                            p_context);
+}
+
+
 /**@brief Command response callback function for @ref sd_ble_gap_disconnect BLE command.
  *
  * Callback for decoding the command response return code.
@@ -33,7 +33,7 @@ uint32_t ble_user_mem_reply_req_enc(uint16_t                     conn_handle,
     err_code = uint16_t_enc(&conn_handle, p_buf, *p_buf_len, &index);
     SER_ASSERT(err_code == NRF_SUCCESS, err_code);
 
-    SER_ASSERT_LENGTH_LEQ(1, *p_buf_len - index);
+    SER_ASSERT_LENGTH_LEFT(1, index, *p_buf_len);
     if(p_block != NULL)
     {
         p_buf[index++] = SER_FIELD_PRESENT;
@@ -17,6 +17,7 @@
 #include "ble_gatts_evt_app.h"
 #include "ble_l2cap_evt_app.h"
 #include "ble_serialization.h"
+#include "ser_config.h"
 #include "app_util.h"
 
 uint32_t ble_event_dec(uint8_t const * const p_buf,
@@ -31,7 +32,7 @@ uint32_t ble_event_dec(uint8_t const * const p_buf,
     SER_ASSERT_LENGTH_LEQ(SER_EVT_HEADER_SIZE, packet_len);
 
 
-    const uint16_t  event_id       = uint16_decode(&p_buf[SER_EVT_ID_POS]);
+    uint16_t        event_id       = uint16_decode(&p_buf[SER_EVT_ID_POS]);
     const uint8_t * p_sub_buffer   = &p_buf[SER_EVT_HEADER_SIZE];
     const uint32_t  sub_packet_len = packet_len - SER_EVT_HEADER_SIZE;
 
@@ -221,6 +222,14 @@ uint32_t ble_event_dec(uint8_t const * const p_buf,
             err_code = ble_gap_evt_adv_report_dec(p_sub_buffer, sub_packet_len, p_event, p_event_len);
             break;
 
+#if SER_ADV_REPORT_DELTA_ENABLED
+        case SER_EVT_GAP_ADV_REPORT_DELTA:
+            err_code = ble_gap_evt_adv_report_delta_dec(p_sub_buffer, sub_packet_len, p_event,
+                                                        p_event_len);
+            event_id = BLE_GAP_EVT_ADV_REPORT;
+            break;
+#endif
+
         case BLE_GAP_EVT_SCAN_REQ_REPORT:
             err_code = ble_gap_evt_scan_req_report_dec(p_sub_buffer, sub_packet_len, p_event, p_event_len);
             break;
@@ -13,8 +13,23 @@
 #include "ble_gap_evt_app.h"
 #include "ble_serialization.h"
 #include "ble_gap_struct_serialization.h"
+#include "ser_config.h"
 #include "app_util.h"
 
+#if SER_ADV_REPORT_DELTA_ENABLED
+
+/**@brief Advertiser in the advertising report table. */
+typedef struct
+{
+    uint16_t                 conn_handle; /**< Connection handle of the last report. */
+    ble_gap_evt_adv_report_t adv_report;  /**< Last report from the advertiser. */
+    bool                     in_use;      /**< True if the entry holds an advertiser. */
+} adv_report_entry_t;
+
+static adv_report_entry_t m_adv_report_table[SER_ADV_REPORT_CACHE_SIZE]; /**< Copy of the advertising report table of the connectivity chip. */
+
+#endif // SER_ADV_REPORT_DELTA_ENABLED
+
 
 uint32_t ble_gap_evt_adv_report_dec(uint8_t const * const p_buf,
                                     uint32_t              packet_len,
@@ -65,8 +80,73 @@ uint32_t ble_gap_evt_adv_report_dec(uint8_t const * const p_buf,
         p_event->evt.gap_evt.params.adv_report.data, (uint16_t)(p_event->evt.gap_evt.params.adv_report.dlen));
     SER_ASSERT(err_code == NRF_SUCCESS, err_code);
 
+#if SER_ADV_REPORT_DELTA_ENABLED
+    uint8_t entry_idx;
+
+    err_code = uint8_t_dec(p_buf, packet_len, &index, &entry_idx);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+    SER_ASSERT(entry_idx < SER_ADV_REPORT_CACHE_SIZE, NRF_ERROR_INVALID_DATA);
+#endif // SER_ADV_REPORT_DELTA_ENABLED
+
     SER_ASSERT_LENGTH_EQ(index, packet_len);
     *p_event_len = event_len;
 
+#if SER_ADV_REPORT_DELTA_ENABLED
+    m_adv_report_table[entry_idx].conn_handle = p_event->evt.gap_evt.conn_handle;
+    m_adv_report_table[entry_idx].adv_report  = p_event->evt.gap_evt.params.adv_report;
+    m_adv_report_table[entry_idx].in_use      = true;
+#endif // SER_ADV_REPORT_DELTA_ENABLED
+
+    return err_code;
+}
+
+
+#if SER_ADV_REPORT_DELTA_ENABLED
+
+uint32_t ble_gap_evt_adv_report_delta_dec(uint8_t const * const p_buf,
+                                          uint32_t              packet_len,
+                                          ble_evt_t * const     p_event,
+                                          uint32_t * const      p_event_len)
+{
+    uint32_t index = 0;
+    uint32_t err_code = NRF_SUCCESS;
+    uint8_t  entry_idx;
+
+    SER_ASSERT_NOT_NULL(p_buf);
+    SER_ASSERT_NOT_NULL(p_event_len);
+
+    SER_ASSERT_LENGTH_EQ(1+1, packet_len);
+
+    uint32_t event_len = (uint16_t) (offsetof(ble_evt_t, evt.gap_evt.params.adv_report)) +
+                         sizeof (ble_gap_evt_adv_report_t) -
+                         sizeof (ble_evt_hdr_t);
+
+    if (p_event == NULL)
+    {
+        *p_event_len = event_len;
+        return NRF_SUCCESS;
+    }
+
+    SER_ASSERT(event_len <= *p_event_len, NRF_ERROR_DATA_SIZE);
+
+    err_code = uint8_t_dec(p_buf, packet_len, &index, &entry_idx);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+    SER_ASSERT(entry_idx < SER_ADV_REPORT_CACHE_SIZE, NRF_ERROR_INVALID_DATA);
+    SER_ASSERT(m_adv_report_table[entry_idx].in_use, NRF_ERROR_INVALID_DATA);
+
+    p_event->header.evt_id                 = BLE_GAP_EVT_ADV_REPORT;
+    p_event->header.evt_len                = event_len;
+    p_event->evt.gap_evt.conn_handle       = m_adv_report_table[entry_idx].conn_handle;
+    p_event->evt.gap_evt.params.adv_report = m_adv_report_table[entry_idx].adv_report;
+
+    err_code = uint8_t_dec(p_buf, packet_len, &index, &(p_event->evt.gap_evt.params.adv_report.rssi));
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    m_adv_report_table[entry_idx].adv_report.rssi = p_event->evt.gap_evt.params.adv_report.rssi;
+
+    *p_event_len = event_len;
+
     return err_code;
 }
+
+#endif // SER_ADV_REPORT_DELTA_ENABLED
@@ -31,7 +31,7 @@ uint32_t ble_gattc_evt_char_val_by_uuid_read_rsp_dec(uint8_t const * const p_buf
     uint16_t gatt_status;
     uint16_t error_handle;
 
-    SER_ASSERT_LENGTH_LEQ(6, packet_len - index);
+    SER_ASSERT_LENGTH_LEFT(6, index, packet_len);
 
     uint32_t in_event_len = *p_event_len;
 
@@ -70,7 +70,7 @@ uint32_t ble_gatts_value_get_req_enc(uint16_t                        conn_handle
         err_code = uint16_t_enc(&(p_value->offset), p_buf, total_len, &index);
         SER_ASSERT(err_code == NRF_SUCCESS, err_code);
 
-        SER_ASSERT_LENGTH_LEQ(1, total_len - index);
+        SER_ASSERT_LENGTH_LEFT(1, index, total_len);
         if (p_value->p_value != NULL)
         {
             p_buf[index++] = SER_FIELD_PRESENT;
@@ -13,21 +13,40 @@
 #include <string.h>
 #include "app_mailbox.h"
 #include "nrf_error.h"
+#include "app_util.h"
 #include "app_util_platform.h"
 
+#define SIZED_NO_RESERVATION 0xFFFF     /**< Offset value used when no item is reserved. */
+#define SIZED_WRAP_MARKER    0xFFFFFFFF /**< Item header value telling that the next item is at the beginning of the pool. */
+
+/**
+ * @brief Number of bytes taken by an item of given length in a variable-length mailbox queue.
+ */
+#define SIZED_ITEM_SIZE(size) (sizeof (uint32_t) + (((size) + 3) & ~3uL))
+
 /**
  * @brief Mailbox handle used for managing a mailbox queue.
+ *
+ * @details A variable-length mailbox queue is a byte ring of items, each one prefixed with its
+ *          length. An item never wraps around the end of the pool: when it does not fit, a wrap
+ *          marker is written and the item is stored at the beginning of the pool.
  */
 typedef struct app_mailbox
 {
     uint8_t  r_idx;    /**< Read index for the mailbox queue. */
     uint8_t  w_idx;    /**< Write index for the mailbox queue. */
     uint8_t  len;      /**< Number of elements currently in the mailbox queue. */
-    uint8_t  queue_sz; /**< Capacity of the queue. */
-    uint32_t item_sz;  /**< Size of single item. */
+    uint8_t  queue_sz; /**< Capacity of the queue, 0 for a variable-length queue. */
+    uint32_t item_sz;  /**< Size of single item. Size of the pool for a variable-length queue. */
     void *   pool;     /**< Pointer to the pool where mailbox items are stored. */
+    uint16_t r_ofs;    /**< Offset of the oldest item of a variable-length queue. */
+    uint16_t w_ofs;    /**< Offset following the newest item of a variable-length queue. */
+    uint16_t rsv_ofs;  /**< Offset of the item reserved in a variable-length queue. */
+    uint16_t count;    /**< Number of items in a variable-length queue. */
 } app_mailbox_t;
 
+STATIC_ASSERT(sizeof (app_mailbox_t) <= (APP_MAILBOX_HANDLE_WORDS * sizeof (uint32_t)));
+
 uint32_t app_mailbox_create(const app_mailbox_def_t * queue_def, app_mailbox_id_t * mailbox_id)
 {
     app_mailbox_t * p_mailbox;
@@ -50,7 +69,8 @@ uint32_t app_mailbox_create(const app_mailbox_def_t * queue_def, app_mailbox_id_
         p_mailbox->len      = 0;
         p_mailbox->queue_sz = (uint8_t)queue_def->queue_sz;
         p_mailbox->item_sz  = queue_def->item_sz;
-        p_mailbox->pool     = (void *)((uintptr_t)queue_def->pool + sizeof (app_mailbox_t));
+        p_mailbox->pool     = (void *)((uintptr_t)queue_def->pool +
+                                       (APP_MAILBOX_HANDLE_WORDS * sizeof (uint32_t)));
         *mailbox_id         = (app_mailbox_id_t)p_mailbox;
     }
 
@@ -152,8 +172,218 @@ uint32_t app_mailbox_get_length (app_mailbox_id_t mailbox_id, uint32_t *p_len)
     }
     else
     {
-        *p_len = (uint32_t) p_mailbox->len;
+        *p_len = (p_mailbox->queue_sz == 0) ? (uint32_t) p_mailbox->count :
+                                              (uint32_t) p_mailbox->len;
+    }
+
+    return err_code;
+}
+
+/**
+ * @brief Function for getting an item header of a variable-length mailbox queue.
+ */
+static __INLINE uint32_t * sized_header_get(app_mailbox_t * p_mailbox, uint32_t offset)
+{
+    return (uint32_t *)((uintptr_t)p_mailbox->pool + offset);
+}
+
+uint32_t app_mailbox_sized_create(const app_mailbox_def_t * queue_def, app_mailbox_id_t * mailbox_id)
+{
+    app_mailbox_t * p_mailbox;
+    uint32_t        err_code = NRF_SUCCESS;
+
+    if (mailbox_id == NULL)
+    {
+        err_code = NRF_ERROR_INVALID_PARAM;
+    }
+    else if ((queue_def->queue_sz != 0) ||
+             (queue_def->item_sz >= SIZED_NO_RESERVATION) ||
+             ((queue_def->item_sz % sizeof (uint32_t)) != 0))
+    {
+        *mailbox_id = (app_mailbox_id_t)NULL;
+        err_code    = NRF_ERROR_INVALID_PARAM;
+    }
+    else
+    {
+        p_mailbox           = (app_mailbox_t *)queue_def->pool;
+        p_mailbox->r_idx    = 0;
+        p_mailbox->w_idx    = 0;
+        p_mailbox->len      = 0;
+        p_mailbox->queue_sz = 0;
+        p_mailbox->item_sz  = queue_def->item_sz;
+        p_mailbox->pool     = (void *)((uintptr_t)queue_def->pool +
+                                       (APP_MAILBOX_HANDLE_WORDS * sizeof (uint32_t)));
+        p_mailbox->r_ofs    = 0;
+        p_mailbox->w_ofs    = 0;
+        p_mailbox->rsv_ofs  = SIZED_NO_RESERVATION;
+        p_mailbox->count    = 0;
+        *mailbox_id         = (app_mailbox_id_t)p_mailbox;
+    }
+
+    return err_code;
+}
+
+uint32_t app_mailbox_sized_alloc(app_mailbox_id_t mailbox_id, uint32_t max_size, void ** pp_mail)
+{
+    app_mailbox_t * p_mailbox = (app_mailbox_t *)mailbox_id;
+    uint32_t        err_code  = NRF_ERROR_NO_MEM;
+    uint32_t        need;
+    uint32_t        offset    = 0;
+
+    if (pp_mail == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (max_size >= p_mailbox->item_sz)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    need = SIZED_ITEM_SIZE(max_size);
+
+    CRITICAL_REGION_ENTER();
+
+    if (p_mailbox->count == 0)
+    {
+        // Empty queue, start over at the beginning of the pool.
+        p_mailbox->r_ofs = 0;
+        p_mailbox->w_ofs = 0;
+    }
+
+    if ((p_mailbox->count != 0) && (p_mailbox->w_ofs == p_mailbox->r_ofs))
+    {
+        // Full.
+    }
+    else if (p_mailbox->w_ofs >= p_mailbox->r_ofs)
+    {
+        if ((p_mailbox->item_sz - p_mailbox->w_ofs) >= need)
+        {
+            offset   = p_mailbox->w_ofs;
+            err_code = NRF_SUCCESS;
+        }
+        else if (p_mailbox->r_ofs >= need)
+        {
+            // Wrap around.
+            offset   = 0;
+            err_code = NRF_SUCCESS;
+        }
+    }
+    else if ((p_mailbox->r_ofs - p_mailbox->w_ofs) >= need)
+    {
+        offset   = p_mailbox->w_ofs;
+        err_code = NRF_SUCCESS;
+    }
+
+    if (err_code == NRF_SUCCESS)
+    {
+        p_mailbox->rsv_ofs = (uint16_t)offset;
+        *sized_header_get(p_mailbox, offset) = max_size;
+    }
+
+    CRITICAL_REGION_EXIT();
+
+    if (err_code == NRF_SUCCESS)
+    {
+        *pp_mail = (void *)(sized_header_get(p_mailbox, offset) + 1);
+    }
+
+    return err_code;
+}
+
+uint32_t app_mailbox_sized_commit(app_mailbox_id_t mailbox_id, uint32_t size)
+{
+    app_mailbox_t * p_mailbox = (app_mailbox_t *)mailbox_id;
+    uint32_t        err_code  = NRF_SUCCESS;
+
+    CRITICAL_REGION_ENTER();
+
+    if (p_mailbox->rsv_ofs == SIZED_NO_RESERVATION)
+    {
+        err_code = NRF_ERROR_INVALID_STATE;
+    }
+    else if (size > *sized_header_get(p_mailbox, p_mailbox->rsv_ofs))
+    {
+        err_code = NRF_ERROR_INVALID_LENGTH;
+    }
+    else
+    {
+        if ((p_mailbox->rsv_ofs != p_mailbox->w_ofs) && (p_mailbox->w_ofs < p_mailbox->item_sz))
+        {
+            // The item wrapped around, tell the reader to skip the end of the pool.
+            *sized_header_get(p_mailbox, p_mailbox->w_ofs) = SIZED_WRAP_MARKER;
+        }
+
+        *sized_header_get(p_mailbox, p_mailbox->rsv_ofs) = size;
+
+        p_mailbox->w_ofs   = (uint16_t)(p_mailbox->rsv_ofs + SIZED_ITEM_SIZE(size));
+        p_mailbox->rsv_ofs = SIZED_NO_RESERVATION;
+        p_mailbox->count++;
+    }
+
+    CRITICAL_REGION_EXIT();
+
+    return err_code;
+}
+
+uint32_t app_mailbox_sized_get(app_mailbox_id_t mailbox_id, void ** pp_mail, uint32_t * p_size)
+{
+    app_mailbox_t * p_mailbox = (app_mailbox_t *)mailbox_id;
+    uint32_t        err_code  = NRF_SUCCESS;
+    uint32_t *      p_header  = NULL;
+
+    if ((pp_mail == NULL) || (p_size == NULL))
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    CRITICAL_REGION_ENTER();
+
+    if (p_mailbox->count == 0)
+    {
+        err_code = NRF_ERROR_NO_MEM;
+    }
+    else
+    {
+        p_header = sized_header_get(p_mailbox, p_mailbox->r_ofs);
+    }
+
+    CRITICAL_REGION_EXIT();
+
+    if (err_code == NRF_SUCCESS)
+    {
+        *pp_mail = (void *)(p_header + 1);
+        *p_size  = *p_header;
     }
 
     return err_code;
 }
+
+uint32_t app_mailbox_sized_release(app_mailbox_id_t mailbox_id)
+{
+    app_mailbox_t * p_mailbox = (app_mailbox_t *)mailbox_id;
+    uint32_t        err_code  = NRF_SUCCESS;
+
+    CRITICAL_REGION_ENTER();
+
+    if (p_mailbox->count == 0)
+    {
+        err_code = NRF_ERROR_NO_MEM;
+    }
+    else
+    {
+        p_mailbox->r_ofs += SIZED_ITEM_SIZE(*sized_header_get(p_mailbox, p_mailbox->r_ofs));
+        p_mailbox->count--;
+
+        // Committed items are complete, so a wrap marker is in place before the next one.
+        if ((p_mailbox->count != 0) &&
+            ((p_mailbox->r_ofs == p_mailbox->item_sz) ||
+             (*sized_header_get(p_mailbox, p_mailbox->r_ofs) == SIZED_WRAP_MARKER)))
+        {
+            p_mailbox->r_ofs = 0;
+        }
+    }
+
+    CRITICAL_REGION_EXIT();
+
+    return err_code;
+}
@@ -28,14 +28,34 @@ typedef struct app_mailbox_def  {
   void                       *pool;    /**< memory array for mail. */
 } app_mailbox_def_t;
 
+/**
+ * @brief Number of words reserved for the mailbox handle at the beginning of the pool.
+ */
+#define APP_MAILBOX_HANDLE_WORDS 8
+
 /**
  * @brief A macro used to statically allocate memory for given mailbox queue.
  */
-#define APP_MAILBOX_DEF(name, queue_sz, type)                  \
-uint32_t os_mailQ_q_##name[3+((sizeof(type)+3)/4)*(queue_sz)]; \
-const app_mailbox_def_t os_mailQ_def_##name =                  \
+#define APP_MAILBOX_DEF(name, queue_sz, type)                                         \
+uint32_t os_mailQ_q_##name[APP_MAILBOX_HANDLE_WORDS+((sizeof(type)+3)/4)*(queue_sz)]; \
+const app_mailbox_def_t os_mailQ_def_##name =                                         \
 { (queue_sz), sizeof(type), (os_mailQ_q_##name) }
 
+/**
+ * @brief A macro used to statically allocate memory for given variable-length mailbox queue.
+ *
+ * @details Items are stored packed with their actual length, so the number of items the queue
+ *          holds depends on their size.
+ *
+ * @param[in] name     Name of the mailbox queue.
+ * @param[in] pool_sz  Number of bytes for items. Each item takes 4 bytes more than its length,
+ *                     rounded up to a multiple of 4.
+ */
+#define APP_MAILBOX_SIZED_DEF(name, pool_sz)                               \
+uint32_t os_mailQ_q_##name[APP_MAILBOX_HANDLE_WORDS+(((pool_sz)+3)/4)];    \
+const app_mailbox_def_t os_mailQ_def_##name =                              \
+{ 0, (((pool_sz)+3)/4)*4, (os_mailQ_q_##name) }
+
 
 /**
  * @brief A macro used to identify mailbox queue stucture.
@@ -99,4 +119,76 @@ uint32_t app_mailbox_get (app_mailbox_id_t mailbox_id, void * mail);
  */
 uint32_t app_mailbox_get_length (app_mailbox_id_t mailbox_id, uint32_t *p_len);
 
+/**
+ * @brief Variable-length mailbox queue creation.
+ *
+ * @details Function initialize a variable-length mailbox queue based on provided definition.
+ *          Items are written and read in place in the queue, with @ref app_mailbox_sized_alloc,
+ *          @ref app_mailbox_sized_commit, @ref app_mailbox_sized_get and
+ *          @ref app_mailbox_sized_release. The queue supports one writer and one reader.
+ *
+ * @param[in]  queue_def  Pointer to queue definition created using macro
+ *                        \ref APP_MAILBOX_SIZED_DEF
+ * @param[out] mailbox_id Pointer to identifier which if set after successful queue creation.
+ *
+ * @retval ::NRF_SUCCESS              Queue successfully created.
+ * @retval ::NRF_ERROR_INVALID_PARAM  Queue creation failed. Wrong param provided.
+ */
+uint32_t app_mailbox_sized_create(const app_mailbox_def_t *queue_def, app_mailbox_id_t * mailbox_id);
+
+/**
+ * @brief Reserving space for an item in variable-length mailbox queue.
+ *
+ * @details The item is written in place, and becomes visible to the reader once committed with
+ *          @ref app_mailbox_sized_commit. Only one item can be reserved at a time.
+ *
+ * @param[in]  mailbox_id  Queue identifier.
+ * @param[in]  max_size    Maximum length of the item.
+ * @param[out] pp_mail     Pointer to the space reserved, 4-byte aligned.
+ *
+ * @retval ::NRF_SUCCESS              Space reserved.
+ * @retval ::NRF_ERROR_NO_MEM         Not enough room left in the queue.
+ * @retval ::NRF_ERROR_NULL           Null pointer provided.
+ */
+uint32_t app_mailbox_sized_alloc(app_mailbox_id_t mailbox_id, uint32_t max_size, void ** pp_mail);
+
+/**
+ * @brief Enqueuing the item written in the space reserved in variable-length mailbox queue.
+ *
+ * @param[in] mailbox_id  Queue identifier.
+ * @param[in] size        Actual length of the item, not more than the reserved length. The
+ *                        space past it is returned to the queue.
+ *
+ * @retval ::NRF_SUCCESS              Item enqueued.
+ * @retval ::NRF_ERROR_INVALID_STATE  No space reserved.
+ * @retval ::NRF_ERROR_INVALID_LENGTH Item longer than the space reserved.
+ */
+uint32_t app_mailbox_sized_commit(app_mailbox_id_t mailbox_id, uint32_t size);
+
+/**
+ * @brief Getting the oldest item of variable-length mailbox queue, without copying it.
+ *
+ * @details The item stays in the queue until released with @ref app_mailbox_sized_release.
+ *          Until then, the same item is returned.
+ *
+ * @param[in]  mailbox_id  Queue identifier.
+ * @param[out] pp_mail     Pointer to the item.
+ * @param[out] p_size      Length of the item.
+ *
+ * @retval ::NRF_SUCCESS              Item found.
+ * @retval ::NRF_ERROR_NO_MEM         Queue is empty.
+ * @retval ::NRF_ERROR_NULL           Null pointer provided.
+ */
+uint32_t app_mailbox_sized_get(app_mailbox_id_t mailbox_id, void ** pp_mail, uint32_t * p_size);
+
+/**
+ * @brief Dequeuing the oldest item of variable-length mailbox queue.
+ *
+ * @param[in] mailbox_id  Queue identifier.
+ *
+ * @retval ::NRF_SUCCESS              Item dequeued, its space returned to the queue.
+ * @retval ::NRF_ERROR_NO_MEM         Queue is empty.
+ */
+uint32_t app_mailbox_sized_release(app_mailbox_id_t mailbox_id);
+
 #endif //_APP_MAILBOX_H
@@ -0,0 +1,72 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ser_sd_async Asynchronous SoftDevice calls
+ * @{
+ * @ingroup ser_app
+ *
+ * @brief   Asynchronous variants of serialized SoftDevice calls.
+ *
+ * @details These functions return as soon as the command is sent to the connectivity chip. The
+ *          SoftDevice call return value is given to the completion callback, in serial peripheral
+ *          interrupt context. Several commands can be waiting for a response at the same time,
+ *          which lets the application keep the serial link busy when issuing a burst of calls.
+ *
+ * @note    A completion callback may issue further asynchronous calls, but must not make blocking
+ *          SoftDevice calls.
+ */
+#ifndef SER_SD_ASYNC_H__
+#define SER_SD_ASYNC_H__
+
+#include <stdint.h>
+#include "ble_gap.h"
+#include "ble_gattc.h"
+#include "ser_sd_transport.h"
+
+/**@brief Asynchronous variant of @ref sd_ble_gattc_write.
+ *
+ * @param[in] conn_handle      Connection handle.
+ * @param[in] p_write_params   Write parameters, only used until the function returns.
+ * @param[in] cmd_cb           Completion callback.
+ * @param[in] p_context        Context passed to the completion callback.
+ *
+ * @retval NRF_SUCCESS          Command sent, completion callback will be called.
+ * @retval NRF_ERROR_NULL       NULL pointer supplied.
+ * @retval NRF_ERROR_BUSY       Maximum number of commands waiting for a response reached.
+ * @retval NRF_ERROR_NO_MEM     All transport tx buffers are in use, retry when a packet is sent.
+ */
+uint32_t sd_ble_gattc_write_async(uint16_t                               conn_handle,
+                                  ble_gattc_write_params_t const * const p_write_params,
+                                  ser_sd_transport_cmd_cb_t              cmd_cb,
+                                  void *                                 p_context);
+
+/**@brief Asynchronous variant of @ref sd_ble_gap_conn_param_update.
+ *
+ * @param[in] conn_handle      Connection handle.
+ * @param[in] p_conn_params    Connection parameters, only used until the function returns.
+ * @param[in] cmd_cb           Completion callback.
+ * @param[in] p_context        Context passed to the completion callback.
+ *
+ * @retval NRF_SUCCESS          Command sent, completion callback will be called.
+ * @retval NRF_ERROR_NULL       NULL pointer supplied.
+ * @retval NRF_ERROR_BUSY       Maximum number of commands waiting for a response reached.
+ * @retval NRF_ERROR_NO_MEM     All transport tx buffers are in use, retry when a packet is sent.
+ */
+uint32_t sd_ble_gap_conn_param_update_async(uint16_t                            conn_handle,
+                                            ble_gap_conn_params_t const * const p_conn_params,
+                                            ser_sd_transport_cmd_cb_t           cmd_cb,
+                                            void *                              p_context);
+
+#endif /* SER_SD_ASYNC_H__ */
+/** @} */
@@ -13,15 +13,19 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 #include "ser_sd_transport.h"
 #include "ser_hal_transport.h"
 #include "nrf_error.h"
 #include "app_error.h"
 #include "ble_serialization.h"
+#include "ser_config.h"
+#include "app_util_platform.h"
 
 #include "ser_app_power_system_off.h"
 
 #include "app_util.h"
+#include "nordic_common.h"
 
 #ifdef ENABLE_DEBUG_LOG_SUPPORT
 #include "app_trace.h"
@@ -45,15 +49,327 @@ static ser_sd_transport_rsp_set_handler_t m_os_rsp_set_handler = NULL;
 /** Handler called when hal_transport notifies that packet reception has started. */
 static ser_sd_transport_rx_notification_handler_t m_rx_notify_handler = NULL;
 
-/** User decoder handler for expected response packet. */
-static ser_sd_transport_rsp_handler_t m_rsp_dec_handler = NULL;
-
-/** Flag indicated whether module is waiting for response packet. */
+/** Command sent to the connectivity chip and waiting for its response. */
+typedef struct
+{
+    ser_sd_transport_rsp_handler_t rsp_dec_handler; /**< User decoder handler for the response packet. */
+    ser_sd_transport_cmd_cb_t      cmd_cb;          /**< Completion callback, NULL for a blocking command. */
+    void *                         p_context;       /**< Context passed to the completion callback. */
+    uint8_t                        seq_id;          /**< Sequence ID of a sequenced command. */
+    bool                           is_seq;          /**< True if the command was sent in a sequenced packet. */
+#if SER_SD_TRANSPORT_STATS_ENABLED
+    uint8_t                        op_code;         /**< SoftDevice call op code. */
+    uint32_t                       start_time;      /**< Time the command was sent. */
+#endif
+} pending_cmd_t;
+
+/** Commands waiting for a response, in the order they were sent. The connectivity chip processes
+ *  commands in order, so responses arrive in the same order. */
+static pending_cmd_t m_pending_cmds[SER_SD_TRANSPORT_MAX_PENDING_CMDS];
+
+/** Index of the oldest command waiting for a response. */
+static volatile uint8_t m_pending_head = 0;
+
+/** Number of commands waiting for a response. */
+static volatile uint8_t m_pending_count = 0;
+
+/** Sequence ID of the next sequenced command. */
+static uint8_t m_next_seq_id = 0;
+
+/** Flag indicated whether module is waiting for response packet of a blocking command. */
 static volatile bool m_rsp_wait = false;
 
 /** SoftDevice call return value decoded by user decoder handler. */
 static uint32_t m_return_value;
 
+/** Event batch packet whose events are being processed, NULL if none. */
+static uint8_t * mp_evt_batch = NULL;
+
+/** End of the event batch packet. */
+static uint8_t * mp_evt_batch_end = NULL;
+
+/** Number of events of the batch packet not freed yet, plus one while the batch is dispatched. */
+static volatile uint8_t m_evt_batch_refs = 0;
+
+#if SER_SD_TRANSPORT_STATS_ENABLED
+/** Function for reading the statistics time counter, NULL if statistics are not collected. */
+static ser_sd_transport_stats_time_get_t m_stats_time_get = NULL;
+
+/** Round trip time statistics of the SoftDevice calls made. */
+static ser_sd_transport_call_stats_t m_call_stats[SER_SD_TRANSPORT_STATS_OP_CODE_COUNT];
+
+/** Number of entries of m_call_stats in use. */
+static uint8_t m_call_stats_count = 0;
+
+/** Number of events received. */
+static uint32_t m_evt_count = 0;
+
+/** Time the first and the last event were received. */
+static uint32_t m_evt_time_first = 0;
+static uint32_t m_evt_time_last  = 0;
+
+/**@brief Function for recording the time a command is sent.
+ *
+ * @param[out]  p_cmd      Command.
+ * @param[in]   op_code    SoftDevice call op code.
+ */
+static void stats_cmd_start(pending_cmd_t * p_cmd, uint8_t op_code)
+{
+    p_cmd->op_code    = op_code;
+    p_cmd->start_time = (m_stats_time_get != NULL) ? m_stats_time_get() : 0;
+}
+
+/**@brief Function for recording the round trip time of a command whose response has arrived.
+ *
+ * @param[in]   p_cmd   Command.
+ */
+static void stats_cmd_end(pending_cmd_t const * p_cmd)
+{
+    ser_sd_transport_call_stats_t * p_stats = NULL;
+    uint32_t                        time;
+    uint8_t                         bin = 0;
+    uint8_t                         i;
+
+    if (m_stats_time_get == NULL)
+    {
+        return;
+    }
+    time = m_stats_time_get() - p_cmd->start_time;
+
+    for (i = 0; i < m_call_stats_count; i++)
+    {
+        if (m_call_stats[i].op_code == p_cmd->op_code)
+        {
+            p_stats = &m_call_stats[i];
+            break;
+        }
+    }
+    if (p_stats == NULL)
+    {
+        if (m_call_stats_count == SER_SD_TRANSPORT_STATS_OP_CODE_COUNT)
+        {
+            return;
+        }
+        p_stats = &m_call_stats[m_call_stats_count++];
+        memset(p_stats, 0, sizeof(*p_stats));
+        p_stats->op_code  = p_cmd->op_code;
+        p_stats->time_min = UINT32_MAX;
+    }
+
+    while ((bin < (SER_SD_TRANSPORT_STATS_HIST_SIZE - 1)) && ((time >> bin) != 0))
+    {
+        bin++;
+    }
+
+    p_stats->count++;
+    p_stats->time_total += time;
+    p_stats->time_min    = MIN(p_stats->time_min, time);
+    p_stats->time_max    = MAX(p_stats->time_max, time);
+    if (p_stats->hist[bin] != UINT16_MAX)
+    {
+        p_stats->hist[bin]++;
+    }
+}
+
+/**@brief Function for counting a received event. */
+static void stats_evt_received(void)
+{
+    if (m_stats_time_get != NULL)
+    {
+        m_evt_time_last = m_stats_time_get();
+        if (m_evt_count++ == 0)
+        {
+            m_evt_time_first = m_evt_time_last;
+        }
+    }
+}
+#else
+#define stats_cmd_start(p_cmd, op_code)
+#define stats_cmd_end(p_cmd)
+#define stats_evt_received()
+#endif // SER_SD_TRANSPORT_STATS_ENABLED
+
+/**@brief Function for adding a command to the commands waiting for a response.
+ *
+ * @param[in]   p_cmd   Command.
+ *
+ * @retval NRF_SUCCESS       Command added.
+ * @retval NRF_ERROR_BUSY    Maximum number of commands waiting for a response reached.
+ */
+static uint32_t pending_cmd_push(pending_cmd_t const * p_cmd)
+{
+    uint32_t err_code = NRF_SUCCESS;
+
+    CRITICAL_REGION_ENTER();
+
+    if (m_pending_count == SER_SD_TRANSPORT_MAX_PENDING_CMDS)
+    {
+        err_code = NRF_ERROR_BUSY;
+    }
+    else
+    {
+        m_pending_cmds[(m_pending_head + m_pending_count) % SER_SD_TRANSPORT_MAX_PENDING_CMDS] =
+            *p_cmd;
+        m_pending_count++;
+    }
+
+    CRITICAL_REGION_EXIT();
+
+    return err_code;
+}
+
+/**@brief Function for completing the oldest command waiting for a response.
+ *
+ * @details Called in serial peripheral interrupt context. The command is removed before its
+ *          completion callback is called, so that the callback can send the next command.
+ *
+ * @param[in]   return_value   SoftDevice call return value.
+ */
+static void pending_cmd_complete(uint32_t return_value)
+{
+    pending_cmd_t cmd;
+
+    CRITICAL_REGION_ENTER();
+
+    cmd             = m_pending_cmds[m_pending_head];
+    m_pending_head  = (m_pending_head + 1) % SER_SD_TRANSPORT_MAX_PENDING_CMDS;
+    m_pending_count--;
+
+    CRITICAL_REGION_EXIT();
+
+    if (cmd.cmd_cb != NULL)
+    {
+        cmd.cmd_cb(return_value, cmd.p_context);
+    }
+    else
+    {
+        m_return_value = return_value;
+
+        /* Reset response flag - cmd_write function is pending on it.*/
+        m_rsp_wait = false;
+
+        /* If os handler is set, signal os that response has arrived.*/
+        if (m_os_rsp_set_handler)
+        {
+            m_os_rsp_set_handler();
+        }
+    }
+}
+
+/**@brief Function for handling a response packet.
+ *
+ * @param[in]   packet_type   Packet type.
+ * @param[in]   p_data        Pointer to received response, past the packet type.
+ * @param[in]   length        Size of response.
+ */
+static void ser_sd_transport_rsp_handle(uint8_t packet_type, uint8_t * p_data, uint16_t length)
+{
+    pending_cmd_t const * p_cmd        = &m_pending_cmds[m_pending_head];
+    bool                  is_expected  = (m_pending_count != 0);
+    uint32_t              return_value = NRF_SUCCESS;
+
+    if (is_expected)
+    {
+        if (packet_type == SER_PKT_TYPE_SEQ_RESP)
+        {
+            /* The sequence ID is the last byte of the packet. */
+            is_expected = p_cmd->is_seq &&
+                          (length > SER_PKT_SEQ_SIZE) &&
+                          (p_data[length - SER_PKT_SEQ_SIZE] == p_cmd->seq_id);
+            length     -= SER_PKT_SEQ_SIZE;
+        }
+        else
+        {
+            is_expected = !p_cmd->is_seq;
+        }
+    }
+
+    if (is_expected)
+    {
+        stats_cmd_end(p_cmd);
+
+        return_value = p_cmd->rsp_dec_handler(p_data, length);
+        (void)ser_sd_transport_rx_free(p_data);
+
+        pending_cmd_complete(return_value);
+    }
+    else
+    {
+        /* Unexpected packet. */
+        (void)ser_sd_transport_rx_free(p_data);
+        APP_ERROR_HANDLER(packet_type);
+    }
+}
+
+/**@brief Function for releasing a reference to the event batch packet.
+ *
+ * @return NRF_SUCCESS, or the result of freeing the packet when the last reference is released.
+ */
+static uint32_t evt_batch_release(void)
+{
+    uint32_t err_code = NRF_SUCCESS;
+    bool     is_last;
+
+    CRITICAL_REGION_ENTER();
+    m_evt_batch_refs--;
+    is_last = (m_evt_batch_refs == 0);
+    CRITICAL_REGION_EXIT();
+
+    if (is_last)
+    {
+        err_code     = ser_hal_transport_rx_pkt_free(mp_evt_batch - SER_PKT_TYPE_SIZE);
+        mp_evt_batch = NULL;
+    }
+
+    return err_code;
+}
+
+/**@brief Function for splitting an event batch packet into events.
+ *
+ * @details Each event is given to the event handler as if it had been received alone. The packet
+ *          is freed once the event handler has freed all its events.
+ *
+ * @param[in]   p_data   Pointer to received batch, past the packet type.
+ * @param[in]   length   Size of batch.
+ */
+static void ser_sd_transport_evt_batch_handle(uint8_t * p_data, uint16_t length)
+{
+    uint8_t * p_evt;
+    uint16_t  evt_len;
+
+    /* Events are freed before the next packet is handled, so only one batch is in use. */
+    APP_ERROR_CHECK_BOOL(m_evt_batch_refs == 0);
+
+    mp_evt_batch     = p_data;
+    mp_evt_batch_end = p_data + length;
+    m_evt_batch_refs = 1;
+
+    while ((p_data + SER_EVT_BATCH_LEN_SIZE) <= mp_evt_batch_end)
+    {
+        evt_len = uint16_decode(p_data);
+        p_evt   = p_data + SER_EVT_BATCH_LEN_SIZE;
+
+        if ((evt_len == 0) || (evt_len > (mp_evt_batch_end - p_evt)))
+        {
+            /* Malformed batch. */
+            APP_ERROR_HANDLER(SER_PKT_TYPE_EVT_BATCH);
+            break;
+        }
+
+        CRITICAL_REGION_ENTER();
+        m_evt_batch_refs++;
+        CRITICAL_REGION_EXIT();
+
+        APPL_LOG("\r\n[EVT_ID]: 0x%X \r\n", uint16_decode(&p_evt[SER_EVT_ID_POS]));
+        stats_evt_received();
+        m_evt_handler(p_evt, evt_len);
+
+        p_data = p_evt + evt_len;
+    }
+
+    APP_ERROR_CHECK(evt_batch_release());
+}
+
 /**@brief Function for handling the rx packets comming from hal_transport.
  *
  * @details
@@ -76,35 +392,21 @@ static void ser_sd_transport_rx_packet_handler(uint8_t * p_data, uint16_t length
         {
             case SER_PKT_TYPE_RESP:
             case SER_PKT_TYPE_DTM_RESP:
-
-                if (m_rsp_wait)
-                {
-                    m_return_value = m_rsp_dec_handler(p_data, length);
-                    (void)ser_sd_transport_rx_free(p_data);
-
-                    /* Reset response flag - cmd_write function is pending on it.*/
-                    m_rsp_wait = false;
-
-                    /* If os handler is set, signal os that response has arrived.*/
-                    if (m_os_rsp_set_handler)
-                    {
-                        m_os_rsp_set_handler();
-                    }
-                }
-                else
-                {
-                    /* Unexpected packet. */
-                    (void)ser_sd_transport_rx_free(p_data);
-                    APP_ERROR_HANDLER(packet_type);
-                }
+            case SER_PKT_TYPE_SEQ_RESP:
+                ser_sd_transport_rsp_handle(packet_type, p_data, length);
                 break;
 
             case SER_PKT_TYPE_EVT:
                 /* It is ensured during opening that handler is not NULL. No check needed. */
                 APPL_LOG("\r\n[EVT_ID]: 0x%X \r\n", uint16_decode(&p_data[SER_EVT_ID_POS])); // p_data points to EVT_ID
+                stats_evt_received();
                 m_evt_handler(p_data, length);
                 break;
 
+            case SER_PKT_TYPE_EVT_BATCH:
+                ser_sd_transport_evt_batch_handle(p_data, length);
+                break;
+
             default:
                 (void)ser_sd_transport_rx_free(p_data);
                 APP_ERROR_HANDLER(packet_type);
@@ -139,18 +441,10 @@ static void ser_sd_transport_hal_handler(ser_hal_transport_evt_t event)
         break;
     case SER_HAL_TRANSP_EVT_PHY_ERROR:
 
-        if (m_rsp_wait)
+        /* No response will arrive for the commands sent. */
+        while (m_pending_count != 0)
         {
-            m_return_value = NRF_ERROR_INTERNAL;
-
-            /* Reset response flag - cmd_write function is pending on it.*/
-            m_rsp_wait = false;
-
-            /* If os handler is set, signal os that response has arrived.*/
-            if (m_os_rsp_set_handler)
-            {
-                m_os_rsp_set_handler();
-            }
+            pending_cmd_complete(NRF_ERROR_INTERNAL);
         }
         break;
     default:
@@ -168,6 +462,9 @@ uint32_t ser_sd_transport_open(ser_sd_transport_evt_handler_t             evt_ha
     m_rx_notify_handler   = rx_notify_handler;
     m_ot_rsp_wait_handler = NULL;
     m_evt_handler         = evt_handler;
+    m_pending_head        = 0;
+    m_pending_count       = 0;
+    m_rsp_wait            = false;
 
     if (evt_handler == NULL)
     {
@@ -201,6 +498,23 @@ bool ser_sd_transport_is_busy(void)
     return m_rsp_wait;
 }
 
+/**@brief Function for allocating a command buffer if the pending command queue has room.
+ *
+ * @param[out] pp_data   Pointer to the allocated buffer.
+ * @param[out] p_len     Size of the allocated buffer.
+ *
+ * @retval NRF_SUCCESS      Buffer allocated.
+ * @retval NRF_ERROR_BUSY   Maximum number of commands waiting for a response reached.
+ */
+static uint32_t pending_tx_alloc(uint8_t * * pp_data, uint16_t * p_len)
+{
+    if (m_pending_count == SER_SD_TRANSPORT_MAX_PENDING_CMDS)
+    {
+        return NRF_ERROR_BUSY;
+    }
+    return ser_hal_transport_tx_pkt_alloc(pp_data, p_len);
+}
+
 uint32_t ser_sd_transport_tx_alloc(uint8_t * * pp_data, uint16_t * p_len)
 {
     uint32_t err_code;
@@ -211,7 +525,19 @@ uint32_t ser_sd_transport_tx_alloc(uint8_t * * pp_data, uint16_t * p_len)
     }
     else
     {
-        err_code = ser_hal_transport_tx_pkt_alloc(pp_data, p_len);
+        err_code = pending_tx_alloc(pp_data, p_len);
+    }
+    return err_code;
+}
+
+uint32_t ser_sd_transport_async_tx_alloc(uint8_t * * pp_data, uint16_t * p_len)
+{
+    uint32_t err_code = pending_tx_alloc(pp_data, p_len);
+
+    if (err_code == NRF_SUCCESS)
+    {
+        /* Keep room for the sequence ID. */
+        *p_len -= SER_PKT_SEQ_SIZE;
     }
     return err_code;
 }
@@ -223,6 +549,12 @@ uint32_t ser_sd_transport_tx_free(uint8_t * p_data)
 
 uint32_t ser_sd_transport_rx_free(uint8_t * p_data)
 {
+    if ((m_evt_batch_refs != 0) && (p_data >= mp_evt_batch) && (p_data < mp_evt_batch_end))
+    {
+        /* Event of a batch packet. */
+        return evt_batch_release();
+    }
+
     p_data -= SER_PKT_TYPE_SIZE;
     return ser_hal_transport_rx_pkt_free(p_data);
 }
@@ -231,11 +563,30 @@ uint32_t ser_sd_transport_cmd_write(const uint8_t *                p_buffer,
                                     uint16_t                       length,
                                     ser_sd_transport_rsp_handler_t cmd_rsp_decode_callback)
 {
-    uint32_t err_code = NRF_SUCCESS;
+    uint32_t      err_code = NRF_SUCCESS;
+    pending_cmd_t cmd;
 
-    m_rsp_wait        = true;
-    m_rsp_dec_handler = cmd_rsp_decode_callback;
-    err_code          = ser_hal_transport_tx_pkt_send(p_buffer, length);
+    if (cmd_rsp_decode_callback)
+    {
+        cmd.rsp_dec_handler = cmd_rsp_decode_callback;
+        cmd.cmd_cb          = NULL;
+        cmd.p_context       = NULL;
+        cmd.seq_id          = 0;
+        cmd.is_seq          = false;
+        stats_cmd_start(&cmd, p_buffer[SER_PKT_OP_CODE_POS]);
+
+        m_rsp_wait = true;
+        err_code   = pending_cmd_push(&cmd);
+        if (err_code != NRF_SUCCESS)
+        {
+            /* A completion callback filled the queue since the buffer was allocated. */
+            m_rsp_wait = false;
+            (void)ser_sd_transport_tx_free((uint8_t *)p_buffer);
+            return err_code;
+        }
+    }
+
+    err_code = ser_hal_transport_tx_pkt_send(p_buffer, length);
     APP_ERROR_CHECK(err_code);
 
     /* Execute callback for response decoding only if one was provided.*/
@@ -257,3 +608,104 @@ uint32_t ser_sd_transport_cmd_write(const uint8_t *                p_buffer,
     APPL_LOG("\r\n[SD_CALL_ID]: 0x%X, err_code= 0x%X\r\n", p_buffer[1], err_code);
     return err_code;
 }
+
+uint32_t ser_sd_transport_cmd_write_async(uint8_t *                      p_buffer,
+                                          uint16_t                       length,
+                                          ser_sd_transport_rsp_handler_t cmd_rsp_decode_callback,
+                                          ser_sd_transport_cmd_cb_t      cmd_cb,
+                                          void *                         p_context)
+{
+    uint32_t      err_code;
+    pending_cmd_t cmd;
+
+    if ((p_buffer == NULL) || (cmd_rsp_decode_callback == NULL) || (cmd_cb == NULL))
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    cmd.rsp_dec_handler = cmd_rsp_decode_callback;
+    cmd.cmd_cb          = cmd_cb;
+    cmd.p_context       = p_context;
+    cmd.seq_id          = m_next_seq_id++;
+    cmd.is_seq          = true;
+    stats_cmd_start(&cmd, p_buffer[SER_PKT_OP_CODE_POS]);
+
+    p_buffer[SER_PKT_TYPE_POS] = SER_PKT_TYPE_SEQ_CMD;
+    p_buffer[length]           = cmd.seq_id;
+
+    err_code = pending_cmd_push(&cmd);
+    if (err_code != NRF_SUCCESS)
+    {
+        (void)ser_sd_transport_tx_free(p_buffer);
+        return err_code;
+    }
+
+    err_code = ser_hal_transport_tx_pkt_send(p_buffer, length + SER_PKT_SEQ_SIZE);
+    APP_ERROR_CHECK(err_code);
+
+    APPL_LOG("\r\n[SD_CALL_ID]: 0x%X, seq= 0x%X\r\n", p_buffer[1], cmd.seq_id);
+    return NRF_SUCCESS;
+}
+
+uint8_t ser_sd_transport_pending_cmds_count_get(void)
+{
+    return m_pending_count;
+}
+
+#if SER_SD_TRANSPORT_STATS_ENABLED
+void ser_sd_transport_stats_start(ser_sd_transport_stats_time_get_t time_get)
+{
+    CRITICAL_REGION_ENTER();
+
+    m_stats_time_get   = time_get;
+    m_call_stats_count = 0;
+    m_evt_count        = 0;
+    m_evt_time_first   = 0;
+    m_evt_time_last    = 0;
+
+    CRITICAL_REGION_EXIT();
+}
+
+ser_sd_transport_call_stats_t const * ser_sd_transport_call_stats_get(uint8_t op_code)
+{
+    uint8_t i;
+
+    for (i = 0; i < m_call_stats_count; i++)
+    {
+        if (m_call_stats[i].op_code == op_code)
+        {
+            return &m_call_stats[i];
+        }
+    }
+    return NULL;
+}
+
+uint32_t ser_sd_transport_stats_percentile_get(ser_sd_transport_call_stats_t const * p_stats,
+                                               uint8_t                               percent)
+{
+    uint32_t threshold = ((p_stats->count * percent) + 99) / 100;
+    uint32_t sum       = 0;
+    uint8_t  bin;
+
+    for (bin = 0; bin < (SER_SD_TRANSPORT_STATS_HIST_SIZE - 1); bin++)
+    {
+        sum += p_stats->hist[bin];
+        if (sum >= threshold)
+        {
+            // Bin 0 holds zero, bin i holds times from 2^(i-1) up to 2^i - 1.
+            return MIN((1uL << bin) - 1, p_stats->time_max);
+        }
+    }
+    return p_stats->time_max;
+}
+
+void ser_sd_transport_evt_stats_get(uint32_t * p_count, uint32_t * p_time)
+{
+    CRITICAL_REGION_ENTER();
+
+    *p_count = m_evt_count;
+    *p_time  = m_evt_time_last - m_evt_time_first;
+
+    CRITICAL_REGION_EXIT();
+}
+#endif // SER_SD_TRANSPORT_STATS_ENABLED
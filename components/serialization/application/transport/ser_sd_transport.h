@@ -30,6 +30,15 @@
  *          ser_sd_transport (using response decoder handler provided for each SoftDevice call) but
  *          events are forwarded to the user so it is user's responsibility to free RX buffer.
  *
+ *          Besides blocking calls, commands can be sent asynchronously with
+ *          @ref ser_sd_transport_cmd_write_async. Up to @ref SER_SD_TRANSPORT_MAX_PENDING_CMDS
+ *          commands can then wait for a response at the same time. Such commands are sent in
+ *          sequenced packets, with a sequence ID as the last byte, which the connectivity chip
+ *          returns in the response. Responses are matched in the order the commands were sent.
+ *
+ *          Round trip times of SoftDevice calls and the event rate can be measured on the target
+ *          when @ref SER_SD_TRANSPORT_STATS_ENABLED is set.
+ *
  */
 #ifndef SER_SD_TRANSPORT_H_
 #define SER_SD_TRANSPORT_H_
@@ -44,6 +53,38 @@ typedef void (*ser_sd_transport_rx_notification_handler_t)(void);
 
 typedef uint32_t (*ser_sd_transport_rsp_handler_t)(const uint8_t * p_buffer, uint16_t length);
 
+/**@brief Asynchronous command completion callback.
+ *
+ * @details Called in serial peripheral interrupt context once the response is decoded. The
+ *          callback may send further asynchronous commands, but must not make blocking
+ *          SoftDevice calls.
+ *
+ * @param[in] result_code    SoftDevice call return value, NRF_ERROR_INTERNAL on transport error.
+ * @param[in] p_context      Context given to @ref ser_sd_transport_cmd_write_async.
+ */
+typedef void (*ser_sd_transport_cmd_cb_t)(uint32_t result_code, void * p_context);
+
+/**@brief Function for reading a free running 32-bit time counter, used for statistics. */
+typedef uint32_t (*ser_sd_transport_stats_time_get_t)(void);
+
+#define SER_SD_TRANSPORT_STATS_HIST_SIZE 16 /**< Number of round trip time histogram bins. */
+
+/**@brief Round trip time statistics of a SoftDevice call.
+ *
+ * @details Times are in units of the counter given to @ref ser_sd_transport_stats_start. Bin i
+ *          of the histogram counts the calls whose round trip time needs i bits, the last bin
+ *          also counts longer calls.
+ */
+typedef struct
+{
+    uint8_t  op_code;                                   /**< SoftDevice call op code. */
+    uint32_t count;                                     /**< Number of calls. */
+    uint32_t time_min;                                  /**< Shortest round trip time. */
+    uint32_t time_max;                                  /**< Longest round trip time. */
+    uint32_t time_total;                                /**< Sum of round trip times. */
+    uint16_t hist[SER_SD_TRANSPORT_STATS_HIST_SIZE];    /**< Round trip time histogram. */
+} ser_sd_transport_call_stats_t;
+
 /**@brief Function for opening the module.
  *
  * @note 'Wait for response' and 'Response set' callbacks can be set in RTOS environment.
@@ -99,9 +140,27 @@ uint32_t ser_sd_transport_close(void);
  * @param[out] p_len         Pointer to allocated buffer length.
  *
  * @retval NRF_SUCCESS          Operation success.
+ * @retval NRF_ERROR_BUSY       Waiting for a response of a blocking command, or maximum number of
+ *                              commands waiting for a response reached.
+ * @retval NRF_ERROR_NO_MEM     Previous packet is still being sent.
  */
 uint32_t ser_sd_transport_tx_alloc(uint8_t * * pp_data, uint16_t * p_len);
 
+/**@brief Function for allocating tx packet to be used for asynchronous command.
+ *
+ * @details Unlike @ref ser_sd_transport_tx_alloc, the packet can be allocated while other
+ *          commands are waiting for a response. The length returned leaves room for the sequence
+ *          ID added by @ref ser_sd_transport_cmd_write_async.
+ *
+ * @param[out] pp_data       Pointer to data pointer to be set to point to allocated buffer.
+ * @param[out] p_len         Pointer to allocated buffer length.
+ *
+ * @retval NRF_SUCCESS          Operation success.
+ * @retval NRF_ERROR_BUSY       Maximum number of commands waiting for a response reached.
+ * @retval NRF_ERROR_NO_MEM     Previous packet is still being sent.
+ */
+uint32_t ser_sd_transport_async_tx_alloc(uint8_t * * pp_data, uint16_t * p_len);
+
 
 /**@brief Function for freeing tx packet.
  *
@@ -144,10 +203,78 @@ bool ser_sd_transport_is_busy(void);
  * @param[in] cmd_resp_decode_callback Pointer to function for decoding response packet.
  *
  * @retval NRF_SUCCESS          Operation success.
+ * @retval NRF_ERROR_BUSY       Maximum number of commands waiting for a response reached.
  */
 uint32_t ser_sd_transport_cmd_write(const uint8_t *                p_buffer,
                                     uint16_t                       length,
                                     ser_sd_transport_rsp_handler_t cmd_resp_decode_callback);
 
+/**@brief Function for sending SoftDevice command without waiting for the response.
+ *
+ * @details The packet type is changed to @ref SER_PKT_TYPE_SEQ_CMD and a sequence ID is appended
+ *          to the command. The response is decoded and the completion callback is called in
+ *          serial peripheral interrupt context.
+ *
+ * @param[in] p_buffer                 Pointer to command, allocated by
+ *                                     @ref ser_sd_transport_async_tx_alloc.
+ * @param[in] length                   Command length.
+ * @param[in] cmd_resp_decode_callback Pointer to function for decoding response packet.
+ * @param[in] cmd_cb                   Completion callback.
+ * @param[in] p_context                Context passed to the completion callback.
+ *
+ * @retval NRF_SUCCESS          Command sent.
+ * @retval NRF_ERROR_NULL       NULL pointer supplied.
+ * @retval NRF_ERROR_BUSY       Maximum number of commands waiting for a response reached.
+ */
+uint32_t ser_sd_transport_cmd_write_async(uint8_t *                      p_buffer,
+                                          uint16_t                       length,
+                                          ser_sd_transport_rsp_handler_t cmd_resp_decode_callback,
+                                          ser_sd_transport_cmd_cb_t      cmd_cb,
+                                          void *                         p_context);
+
+/**@brief Function for getting the number of commands waiting for a response.
+ *
+ * @return Number of commands waiting for a response.
+ */
+uint8_t ser_sd_transport_pending_cmds_count_get(void);
+
+/**@brief Function for starting to collect statistics.
+ *
+ * @details Clears the statistics collected so far. Available if
+ *          @ref SER_SD_TRANSPORT_STATS_ENABLED is set.
+ *
+ * @param[in] time_get   Function for reading the time counter, e.g. a TIMER in 32-bit mode.
+ */
+void ser_sd_transport_stats_start(ser_sd_transport_stats_time_get_t time_get);
+
+/**@brief Function for getting the round trip time statistics of a SoftDevice call.
+ *
+ * @details Statistics are kept for the first @ref SER_SD_TRANSPORT_STATS_OP_CODE_COUNT op codes
+ *          called since @ref ser_sd_transport_stats_start.
+ *
+ * @param[in] op_code    SoftDevice call op code.
+ *
+ * @return Pointer to the statistics, or NULL if the call was not made.
+ */
+ser_sd_transport_call_stats_t const * ser_sd_transport_call_stats_get(uint8_t op_code);
+
+/**@brief Function for estimating a percentile of the round trip time of a SoftDevice call.
+ *
+ * @param[in] p_stats    Statistics of the call.
+ * @param[in] percent    Percentile, from 0 to 100.
+ *
+ * @return Upper bound of the histogram bin holding the percentile, limited to the longest round
+ *         trip time.
+ */
+uint32_t ser_sd_transport_stats_percentile_get(ser_sd_transport_call_stats_t const * p_stats,
+                                               uint8_t                               percent);
+
+/**@brief Function for getting the number of events received.
+ *
+ * @param[out] p_count   Number of events received since @ref ser_sd_transport_stats_start.
+ * @param[out] p_time    Time between the first and the last event, to compute the event rate.
+ */
+void ser_sd_transport_evt_stats_get(uint32_t * p_count, uint32_t * p_time);
+
 #endif /* SER_SD_TRANSPORT_H_ */
 /** @} */
@@ -18,6 +18,7 @@
 #include "ser_sd_transport.h"
 #include "ser_app_hal.h"
 #include "ser_config.h"
+#include "ser_softdevice_handler.h"
 #include "nrf_soc.h"
 
 
@@ -33,8 +34,13 @@ typedef struct
 /** @brief
  *   Mailbox used for communication between event handler (called from serial stream
  *   interrupt context) and event processing function (called from scheduler or interrupt context).
+ *
+ *   Events are decoded in place in the mailbox and stored with their actual length, so it holds
+ *   at least SD_BLE_EVT_MAILBOX_QUEUE_SIZE - 1 events of the maximum size, and more short ones.
  */
-APP_MAILBOX_DEF(sd_ble_evt_mailbox, SD_BLE_EVT_MAILBOX_QUEUE_SIZE, ser_sd_handler_evt_data_t);
+APP_MAILBOX_SIZED_DEF(sd_ble_evt_mailbox,
+                      SD_BLE_EVT_MAILBOX_QUEUE_SIZE *
+                      (sizeof (uint32_t) + sizeof (ser_sd_handler_evt_data_t)));
 
 static app_mailbox_id_t m_ble_evt_mailbox_id; /**< mailbox identifier. */
 
@@ -68,17 +74,21 @@ static void connectivity_reset_high(void)
 
 static void ser_softdevice_evt_handler(uint8_t * p_data, uint16_t length)
 {
-    ser_sd_handler_evt_data_t item;
-    uint32_t                  err_code;
-    uint32_t                  len32 = sizeof (item.evt_data);
+    ble_evt_t * p_ble_evt;
+    uint32_t    err_code;
+    uint32_t    len32 = sizeof (ser_sd_handler_evt_data_t);
+
+    err_code = app_mailbox_sized_alloc(m_ble_evt_mailbox_id, len32, (void **)&p_ble_evt);
+    APP_ERROR_CHECK(err_code);
 
-    err_code = ble_event_dec(p_data, length, (ble_evt_t *)item.evt_data, &len32);
+    err_code = ble_event_dec(p_data, length, p_ble_evt, &len32);
     APP_ERROR_CHECK(err_code);
 
     err_code = ser_sd_transport_rx_free(p_data);
     APP_ERROR_CHECK(err_code);
 
-    err_code = app_mailbox_put(m_ble_evt_mailbox_id, &item);
+    err_code = app_mailbox_sized_commit(m_ble_evt_mailbox_id,
+                                        MIN(len32, sizeof (ser_sd_handler_evt_data_t)));
     APP_ERROR_CHECK(err_code);
 
     ser_app_hal_nrf_evt_pending();
@@ -107,20 +117,52 @@ uint32_t sd_evt_get(uint32_t * p_evt_id)
 
 uint32_t sd_ble_evt_get(uint8_t * p_data, uint16_t * p_len)
 {
-    uint32_t err_code;
+    uint32_t    err_code;
+    ble_evt_t * p_ble_evt;
+    uint32_t    size;
 
-    err_code = app_mailbox_get(m_ble_evt_mailbox_id, p_data);
+    err_code = app_mailbox_sized_get(m_ble_evt_mailbox_id, (void **)&p_ble_evt, &size);
 
     if (err_code == NRF_SUCCESS) //if anything in the mailbox
     {
-        if (((ble_evt_t *)p_data)->header.evt_len > *p_len)
+        if (p_ble_evt->header.evt_len > *p_len)
         {
             err_code = NRF_ERROR_DATA_SIZE;
         }
         else
         {
-            *p_len = ((ble_evt_t *)p_data)->header.evt_len;
+            // Copy the decoded part of the event only.
+            memcpy(p_data, p_ble_evt, MIN(size, *p_len));
+            *p_len = p_ble_evt->header.evt_len;
         }
+
+        (void)app_mailbox_sized_release(m_ble_evt_mailbox_id);
+    }
+    else
+    {
+        err_code = NRF_ERROR_NOT_FOUND;
+    }
+
+    return err_code;
+}
+
+uint32_t sd_ble_evt_ptr_get(uint8_t ** pp_data, uint16_t * p_len)
+{
+    uint32_t    err_code;
+    ble_evt_t * p_ble_evt;
+    uint32_t    size;
+
+    if ((pp_data == NULL) || (p_len == NULL))
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    err_code = app_mailbox_sized_get(m_ble_evt_mailbox_id, (void **)&p_ble_evt, &size);
+
+    if (err_code == NRF_SUCCESS)
+    {
+        *pp_data = (uint8_t *)p_ble_evt;
+        *p_len   = p_ble_evt->header.evt_len;
     }
     else
     {
@@ -130,6 +172,15 @@ uint32_t sd_ble_evt_get(uint8_t * p_data, uint16_t * p_len)
     return err_code;
 }
 
+uint32_t sd_ble_evt_release(void)
+{
+    uint32_t err_code;
+
+    err_code = app_mailbox_sized_release(m_ble_evt_mailbox_id);
+
+    return (err_code == NRF_SUCCESS) ? NRF_SUCCESS : NRF_ERROR_NOT_FOUND;
+}
+
 uint32_t sd_ble_evt_mailbox_length_get(uint32_t * p_mailbox_length)
 {
     uint32_t err_code;
@@ -150,7 +201,7 @@ uint32_t sd_softdevice_enable(nrf_clock_lfclksrc_t           clock_source,
     {
         connectivity_reset_low();
 
-        err_code = app_mailbox_create(APP_MAILBOX(sd_ble_evt_mailbox), &m_ble_evt_mailbox_id);
+        err_code = app_mailbox_sized_create(APP_MAILBOX(sd_ble_evt_mailbox), &m_ble_evt_mailbox_id);
 
         if (err_code == NRF_SUCCESS)
         {
@@ -40,5 +40,27 @@
  */
 uint32_t sd_ble_evt_mailbox_length_get(uint32_t * p_mailbox_length);
 
+/**@brief Function for getting the oldest BLE event in the internal mailbox, without copying it.
+ *
+ * @details The event is decoded in place in the mailbox. It stays valid, and is returned again by
+ *          this function, until released with @ref sd_ble_evt_release. Unlike
+ *          @ref sd_ble_evt_get, no buffer of the maximum event size is needed.
+ *
+ * @param[out] pp_data  Pointer to the event.
+ * @param[out] p_len    Length of the event, as in the event header.
+ *
+ * @retval ::NRF_SUCCESS          Event found.
+ * @retval ::NRF_ERROR_NOT_FOUND  No event pending.
+ * @retval ::NRF_ERROR_NULL       Null pointer provided.
+ */
+uint32_t sd_ble_evt_ptr_get(uint8_t ** pp_data, uint16_t * p_len);
+
+/**@brief Function for releasing the event obtained with @ref sd_ble_evt_ptr_get.
+ *
+ * @retval ::NRF_SUCCESS          Event released, its space returned to the mailbox.
+ * @retval ::NRF_ERROR_NOT_FOUND  No event pending.
+ */
+uint32_t sd_ble_evt_release(void);
+
 #endif /* SER_SOFTDEVICE_HANDLER_H_ */
 /** @} */
@@ -47,7 +47,7 @@ uint32_t ser_ble_cmd_rsp_result_code_dec(uint8_t const * const p_buf,
     SER_ASSERT_NOT_NULL(p_pos);
     SER_ASSERT_NOT_NULL(p_result_code);
 
-    if (packet_len < SER_CMD_RSP_HEADER_SIZE)
+    if ((*p_pos > packet_len) || ((packet_len - *p_pos) < SER_CMD_RSP_HEADER_SIZE))
     {
         return NRF_ERROR_DATA_SIZE;
     }
@@ -97,7 +97,7 @@ uint32_t uint32_t_enc(void const * const p_field,
 
     uint32_t * p_uint32 = (uint32_t *)p_field;
 
-    SER_ASSERT_LENGTH_LEQ(4, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(4, *p_index, buf_len);
 
     *p_index += uint32_encode(*p_uint32, &p_buf[*p_index]);
 
@@ -115,7 +115,7 @@ uint32_t uint32_t_dec(uint8_t const * const p_buf,
 
     uint32_t * p_uint32 = (uint32_t *)p_field;
 
-    SER_ASSERT_LENGTH_LEQ(4, ((int32_t)buf_len - *p_index));
+    SER_ASSERT_LENGTH_LEFT(4, *p_index, buf_len);
 
     *p_uint32 = uint32_decode(&p_buf[*p_index]);
     *p_index += 4;
@@ -130,7 +130,7 @@ uint32_t uint16_t_enc(const void * const p_field,
 {
     uint16_t * p_u16 = (uint16_t *)p_field;
 
-    SER_ASSERT_LENGTH_LEQ(2, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(2, *p_index, buf_len);
 
     *p_index += uint16_encode(*p_u16, &p_buf[*p_index]);
 
@@ -144,7 +144,7 @@ uint32_t uint16_t_dec(uint8_t const * const p_buf,
 {
     uint16_t * p_u16 = (uint16_t *)p_field;
 
-    SER_ASSERT_LENGTH_LEQ(2, ((int32_t)buf_len - *p_index));
+    SER_ASSERT_LENGTH_LEFT(2, *p_index, buf_len);
 
     *p_u16    = uint16_decode(&p_buf[*p_index]);
     *p_index += 2;
@@ -167,7 +167,7 @@ uint32_t uint8_t_enc(const void * const p_field,
                      uint32_t           buf_len,
                      uint32_t * const   p_index)
 {
-    SER_ASSERT_LENGTH_LEQ(1, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
 
     uint8_t * p_u8 = (uint8_t *)p_field;
     p_buf[*p_index] = *p_u8;
@@ -183,7 +183,7 @@ uint32_t uint8_t_dec(uint8_t const * const p_buf,
 {
     uint8_t * p_u8 = (uint8_t *)p_field;
 
-    SER_ASSERT_LENGTH_LEQ(1, ((int32_t)buf_len - *p_index));
+    SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
     *p_u8     = p_buf[*p_index];
     *p_index += 1;
 
@@ -289,12 +289,12 @@ uint32_t count16_cond_data16_enc(uint16_t const * const p_data,
 {
     uint32_t i = 0;
 
-    SER_ASSERT_LENGTH_LEQ(3, ((int32_t)buf_len - *p_index));
+    SER_ASSERT_LENGTH_LEFT(3, *p_index, buf_len);
     *p_index += uint16_encode(count, &p_buf[*p_index]);
 
     if (p_data)
     {
-        SER_ASSERT_LENGTH_LEQ((int32_t)(2 * count + 1), ((int32_t)buf_len - (int32_t)*p_index));
+        SER_ASSERT_LENGTH_LEFT(2 * count + 1, *p_index, buf_len);
         p_buf[*p_index] = SER_FIELD_PRESENT;
         *p_index       += 1;
 
@@ -306,7 +306,7 @@ uint32_t count16_cond_data16_enc(uint16_t const * const p_data,
     }
     else
     {
-        SER_ASSERT_LENGTH_LEQ((1), ((int32_t)buf_len - *p_index));
+        SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
         p_buf[*p_index] = SER_FIELD_NOT_PRESENT;
         *p_index       += 1;
     }
@@ -329,7 +329,7 @@ uint32_t count16_cond_data16_dec(uint8_t const * const p_buf,
     SER_ASSERT_NOT_NULL(pp_data);
     SER_ASSERT_NOT_NULL(*pp_data);
 
-    SER_ASSERT_LENGTH_LEQ(3, ((int32_t)buf_len - (*p_index)));
+    SER_ASSERT_LENGTH_LEFT(3, *p_index, buf_len);
 
     uint16_dec(p_buf, buf_len, p_index, &count);
 
@@ -349,6 +349,7 @@ uint32_t count16_cond_data16_dec(uint8_t const * const p_buf,
     }
     else
     {
+        SER_ASSERT_LENGTH_LEFT(2 * count, *p_index, buf_len);
         for (i = 0; i < count; i++ )
         {
             uint16_dec(p_buf, buf_len, p_index, &((&(**pp_data))[i]) );
@@ -371,7 +372,7 @@ uint32_t cond_len16_cond_data_dec(uint8_t const * const p_buf,
     SER_ASSERT_NOT_NULL(pp_data);
     SER_ASSERT_NOT_NULL(*pp_data);
 
-    SER_ASSERT_LENGTH_LEQ(2, ((int32_t)buf_len - (*p_index)));
+    SER_ASSERT_LENGTH_LEFT(2, *p_index, buf_len);
     uint8_t is_present = 0;
 
     uint8_dec(p_buf, buf_len, p_index, &is_present);
@@ -398,7 +399,7 @@ uint32_t op_status_enc(uint8_t          op_code,
     SER_ASSERT_NOT_NULL(p_buff);
     SER_ASSERT_NOT_NULL(p_buff_len);
     SER_ASSERT_NOT_NULL(p_index);
-    SER_ASSERT_LENGTH_LEQ(SER_CMD_RSP_HEADER_SIZE, *p_buff_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(SER_CMD_RSP_HEADER_SIZE, *p_index, *p_buff_len);
 
     //Encode Op Code.
     p_buff[(*p_index)++] = op_code;
@@ -448,7 +449,7 @@ uint32_t buf_enc(uint8_t const * const p_data,
 
     if (p_data)
     {
-        SER_ASSERT_LENGTH_LEQ(dlen, ((int32_t)buf_len - *p_index));
+        SER_ASSERT_LENGTH_LEFT(dlen, *p_index, buf_len);
         memcpy(&p_buf[*p_index], p_data, dlen);
         *p_index += dlen;
     }
@@ -465,7 +466,7 @@ uint32_t buf_dec(uint8_t const * const p_buf,
 {
     uint8_t is_present = 0;
 
-    SER_ASSERT_LENGTH_LEQ(1, ((int32_t)buf_len - *p_index));
+    SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
     uint8_dec(p_buf, buf_len, p_index, &is_present);
 
     if (is_present == SER_FIELD_PRESENT)
@@ -473,7 +474,7 @@ uint32_t buf_dec(uint8_t const * const p_buf,
         SER_ASSERT_NOT_NULL(pp_data);
         SER_ASSERT_NOT_NULL(*pp_data);
         SER_ASSERT_LENGTH_LEQ(dlen, data_len);
-        SER_ASSERT_LENGTH_LEQ(dlen, ((int32_t)buf_len - *p_index));
+        SER_ASSERT_LENGTH_LEFT(dlen, *p_index, buf_len);
         memcpy(*pp_data, &p_buf[*p_index], dlen);
         *p_index += dlen;
     }
@@ -497,7 +498,7 @@ uint32_t uint8_vector_enc(uint8_t const * const p_data,
     SER_ASSERT_NOT_NULL(p_data);
     SER_ASSERT_NOT_NULL(p_buf);
     SER_ASSERT_NOT_NULL(p_index);
-    SER_ASSERT_LENGTH_LEQ(dlen, ((int32_t)buf_len - *p_index));
+    SER_ASSERT_LENGTH_LEFT(dlen, *p_index, buf_len);
     memcpy(&p_buf[*p_index], p_data, dlen);
     *p_index += dlen;
 
@@ -511,7 +512,7 @@ uint32_t uint8_vector_dec(uint8_t const * const p_buf,
                  uint16_t              dlen)
 {
     SER_ASSERT_NOT_NULL(p_data);
-    SER_ASSERT_LENGTH_LEQ(dlen, ((int32_t)buf_len - *p_index));
+    SER_ASSERT_LENGTH_LEFT(dlen, *p_index, buf_len);
     memcpy(p_data, &p_buf[*p_index], dlen);
     *p_index += dlen;
 
@@ -26,6 +26,9 @@ typedef enum
     SER_PKT_TYPE_EVT,         /**< Event packet type. */
     SER_PKT_TYPE_DTM_CMD,     /**< DTM Command packet type. */
     SER_PKT_TYPE_DTM_RESP,    /**< DTM Response packet type. */
+    SER_PKT_TYPE_SEQ_CMD,     /**< Command packet type, followed by a sequence ID. */
+    SER_PKT_TYPE_SEQ_RESP,    /**< Command Response packet type, followed by the sequence ID of the command. */
+    SER_PKT_TYPE_EVT_BATCH,   /**< Event batch packet type, events each preceded by their length. */
     SER_PKT_TYPE_MAX          /**< Upper bound. */
 } ser_pkt_type_t;
 
@@ -39,8 +42,12 @@ typedef enum
 #define SER_ERR_CODE_SIZE              4
 /** Size in bytes of the Packet Type field (@ref ser_pkt_type_t). */
 #define SER_PKT_TYPE_SIZE              1
+/** Size in bytes of the little-endian length field preceding each event in an event batch packet. */
+#define SER_EVT_BATCH_LEN_SIZE         2
 /** Size in bytes of the Operation Code field. */
 #define SER_OP_CODE_SIZE               1
+/** Size in bytes of the Sequence ID field, the last byte of sequenced command and response packets. */
+#define SER_PKT_SEQ_SIZE               1
 
 /** Position of the Packet Type field in a serialized packet buffer. */
 #define SER_PKT_TYPE_POS               0
@@ -69,6 +76,10 @@ typedef enum
 /** Size of event connection handler. */
 #define SER_EVT_CONN_HANDLE_SIZE       2
 
+/** ID of the compact advertising report event, see SER_ADV_REPORT_DELTA_ENABLED. It is the last
+ *  ID of the GAP event range, which is not used by the SoftDevice. */
+#define SER_EVT_GAP_ADV_REPORT_DELTA   0x2F
+
 /** Position of the Op Code in the DTM command buffer.*/
 #define SER_DTM_CMD_OP_CODE_POS        0
 /** Position of the data in the DTM command buffer.*/
@@ -100,6 +111,11 @@ typedef enum
 /** Returns with  \ref NRF_ERROR_INVALID_LENGTH if len is not less or equal to maxlen. */
 #define SER_ASSERT_LENGTH_LEQ(len, maxlen) \
     SER_ASSERT((len) <= (maxlen), NRF_ERROR_INVALID_LENGTH)
+/** Returns with  \ref NRF_ERROR_INVALID_LENGTH if less than len bytes are left from index to
+ *  buf_len. Unlike comparing len with buf_len - index, it also fails if index is past buf_len. */
+#define SER_ASSERT_LENGTH_LEFT(len, index, buf_len)                      \
+    SER_ASSERT(((index) <= (buf_len)) && ((len) <= ((buf_len) - (index))), \
+               NRF_ERROR_INVALID_LENGTH)
 /** Returns with  \ref NRF_ERROR_INVALID_LENGTH if actual_len is not equal to expected_len. */
 #define SER_ASSERT_LENGTH_EQ(actual_len, expected_len) \
     SER_ASSERT((actual_len) == (expected_len), NRF_ERROR_INVALID_LENGTH)
@@ -109,6 +125,7 @@ typedef enum
 #define SER_ASSERT(expr, error_code)
 #define SER_ASSERT_VOID_RETURN(expr)
 #define SER_ASSERT_LENGTH_LEQ(len, maxlen) UNUSED_VARIABLE(maxlen)
+#define SER_ASSERT_LENGTH_LEFT(len, index, buf_len) UNUSED_VARIABLE(buf_len)
 #define SER_ASSERT_LENGTH_EQ(actual_len, expected_len)
 #define SER_ASSERT_NOT_NULL(ptr)
 #endif
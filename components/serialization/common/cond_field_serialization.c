@@ -2,6 +2,8 @@
 #include "cond_field_serialization.h"
 #include "ble_serialization.h"
 #include <stddef.h>
+#include <string.h>
+#include "app_util.h"
 
 uint32_t cond_field_enc(void const * const      p_field,
                         uint8_t * const         p_buf,
@@ -11,7 +13,7 @@ uint32_t cond_field_enc(void const * const      p_field,
 {
     uint32_t err_code = NRF_SUCCESS;
 
-    SER_ASSERT_LENGTH_LEQ(1, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
     p_buf[*p_index] = (p_field == NULL) ? SER_FIELD_NOT_PRESENT : SER_FIELD_PRESENT;
     *p_index       += 1;
 
@@ -33,7 +35,7 @@ uint32_t cond_field_dec(uint8_t const * const   p_buf,
     uint32_t err_code = NRF_SUCCESS;
     uint8_t  is_present;
 
-    SER_ASSERT_LENGTH_LEQ(1, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
     uint8_dec(p_buf, buf_len, p_index, &is_present);
 
     if (is_present == SER_FIELD_PRESENT)
@@ -60,3 +62,172 @@ uint32_t cond_field_dec(uint8_t const * const   p_buf,
 
     return err_code;
 }
+
+
+uint32_t ser_struct_enc(ser_struct_desc_t const * p_desc,
+                        void const * const        p_struct,
+                        uint8_t * const           p_buf,
+                        uint32_t                  buf_len,
+                        uint32_t * const          p_index)
+{
+    uint8_t const * p_src      = (uint8_t const *)p_struct;
+    uint32_t        index      = *p_index;
+    uint32_t        err_code   = NRF_SUCCESS;
+    uint32_t        field_len  = 0;
+    uint32_t        i;
+
+    if (p_desc->enc_len != 0)
+    {
+        SER_ASSERT_LENGTH_LEFT(p_desc->enc_len, index, buf_len);
+    }
+
+    for (i = 0; i < p_desc->field_count; i++)
+    {
+        ser_field_desc_t const * p_field  = &p_desc->p_fields[i];
+        uint8_t const *          p_member = p_src + p_field->offset;
+
+        switch (p_field->type)
+        {
+            case SER_FIELD_TYPE_UINT8:
+            case SER_FIELD_TYPE_UINT16:
+            case SER_FIELD_TYPE_UINT32:
+            case SER_FIELD_TYPE_BYTES:
+                field_len = p_field->len;
+                if (p_desc->enc_len == 0)
+                {
+                    SER_ASSERT_LENGTH_LEFT(field_len, index, buf_len);
+                }
+                if (p_field->type == SER_FIELD_TYPE_UINT16)
+                {
+                    (void)uint16_encode(*(uint16_t const *)p_member, &p_buf[index]);
+                }
+                else if (p_field->type == SER_FIELD_TYPE_UINT32)
+                {
+                    (void)uint32_encode(*(uint32_t const *)p_member, &p_buf[index]);
+                }
+                else
+                {
+                    memcpy(&p_buf[index], p_member, field_len);
+                }
+                index += field_len;
+                break;
+
+            case SER_FIELD_TYPE_STRUCT:
+                err_code = ser_struct_enc((ser_struct_desc_t const *)p_field->p_arg,
+                                          p_member, p_buf, buf_len, &index);
+                break;
+
+            case SER_FIELD_TYPE_COND:
+                p_member = *(uint8_t const * const *)p_member;
+                SER_ASSERT_LENGTH_LEFT(1, index, buf_len);
+                p_buf[index++] = (p_member == NULL) ? SER_FIELD_NOT_PRESENT : SER_FIELD_PRESENT;
+                if (p_member != NULL)
+                {
+                    err_code = ser_struct_enc((ser_struct_desc_t const *)p_field->p_arg,
+                                              p_member, p_buf, buf_len, &index);
+                }
+                break;
+
+            default:
+                err_code = ((ser_field_codec_t const *)p_field->p_arg)->enc(p_member,
+                                                                             p_buf,
+                                                                             buf_len,
+                                                                             &index);
+                break;
+        }
+        SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+    }
+
+    *p_index = index;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ser_struct_dec(ser_struct_desc_t const * p_desc,
+                        uint8_t const * const     p_buf,
+                        uint32_t                  buf_len,
+                        uint32_t * const          p_index,
+                        void * const              p_struct)
+{
+    uint8_t * p_dst     = (uint8_t *)p_struct;
+    uint32_t  index     = *p_index;
+    uint32_t  err_code  = NRF_SUCCESS;
+    uint32_t  field_len = 0;
+    uint32_t  i;
+
+    if (p_desc->enc_len != 0)
+    {
+        SER_ASSERT_LENGTH_LEFT(p_desc->enc_len, index, buf_len);
+    }
+
+    for (i = 0; i < p_desc->field_count; i++)
+    {
+        ser_field_desc_t const * p_field  = &p_desc->p_fields[i];
+        uint8_t *                p_member = p_dst + p_field->offset;
+
+        switch (p_field->type)
+        {
+            case SER_FIELD_TYPE_UINT8:
+            case SER_FIELD_TYPE_UINT16:
+            case SER_FIELD_TYPE_UINT32:
+            case SER_FIELD_TYPE_BYTES:
+                field_len = p_field->len;
+                if (p_desc->enc_len == 0)
+                {
+                    SER_ASSERT_LENGTH_LEFT(field_len, index, buf_len);
+                }
+                if (p_field->type == SER_FIELD_TYPE_UINT16)
+                {
+                    *(uint16_t *)p_member = uint16_decode(&p_buf[index]);
+                }
+                else if (p_field->type == SER_FIELD_TYPE_UINT32)
+                {
+                    *(uint32_t *)p_member = uint32_decode(&p_buf[index]);
+                }
+                else
+                {
+                    memcpy(p_member, &p_buf[index], field_len);
+                }
+                index += field_len;
+                break;
+
+            case SER_FIELD_TYPE_STRUCT:
+                err_code = ser_struct_dec((ser_struct_desc_t const *)p_field->p_arg,
+                                          p_buf, buf_len, &index, p_member);
+                break;
+
+            case SER_FIELD_TYPE_COND:
+                SER_ASSERT_LENGTH_LEFT(1, index, buf_len);
+                if (p_buf[index] == SER_FIELD_PRESENT)
+                {
+                    index++;
+                    SER_ASSERT_NOT_NULL(*(void **)p_member);
+                    err_code = ser_struct_dec((ser_struct_desc_t const *)p_field->p_arg,
+                                              p_buf, buf_len, &index, *(void **)p_member);
+                }
+                else if (p_buf[index] == SER_FIELD_NOT_PRESENT)
+                {
+                    index++;
+                    *(void **)p_member = NULL;
+                }
+                else
+                {
+                    err_code = NRF_ERROR_INVALID_DATA;
+                }
+                break;
+
+            default:
+                err_code = ((ser_field_codec_t const *)p_field->p_arg)->dec(p_buf,
+                                                                             buf_len,
+                                                                             &index,
+                                                                             p_member);
+                break;
+        }
+        SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+    }
+
+    *p_index = index;
+
+    return NRF_SUCCESS;
+}
@@ -9,7 +9,12 @@
  * the file.
  *
  */
+#ifndef COND_FIELD_SERIALIZATION_H__
+#define COND_FIELD_SERIALIZATION_H__
+
 #include "stdint.h"
+#include <stddef.h>
+#include "app_util.h"
 
 typedef uint32_t (*field_encoder_handler_t)(void const * const p_field,
                                             uint8_t * const    p_buf,
@@ -62,3 +67,127 @@ uint32_t cond_field_dec(uint8_t const * const   p_buf,
                         uint32_t * const        p_index,
                         void * * const          pp_field,
                         field_decoder_handler_t field_parser);
+
+/**@brief Types of fields in a structure descriptor. */
+typedef enum
+{
+    SER_FIELD_TYPE_UINT8,   /**< 8-bit field. */
+    SER_FIELD_TYPE_UINT16,  /**< 16-bit field, little endian in the buffer. */
+    SER_FIELD_TYPE_UINT32,  /**< 32-bit field, little endian in the buffer. */
+    SER_FIELD_TYPE_BYTES,   /**< Byte array of fixed length. */
+    SER_FIELD_TYPE_STRUCT,  /**< Nested structure, described by another structure descriptor. */
+    SER_FIELD_TYPE_COND,    /**< Pointer to a structure described by another structure descriptor,
+                                 preceded by a presence flag as with @ref cond_field_enc. */
+    SER_FIELD_TYPE_CODEC    /**< Field with its own encoder and decoder, e.g. bit fields. */
+} ser_field_type_t;
+
+/**@brief Encoder and decoder of a @ref SER_FIELD_TYPE_CODEC field. */
+typedef struct
+{
+    field_encoder_handler_t enc;    /**< Field encoder. */
+    field_decoder_handler_t dec;    /**< Field decoder. */
+} ser_field_codec_t;
+
+/**@brief Descriptor of a structure field. */
+typedef struct
+{
+    uint16_t     offset;            /**< Offset of the field in the structure. */
+    uint8_t      type;              /**< Field type, see @ref ser_field_type_t. */
+    uint8_t      len;               /**< Length of a @ref SER_FIELD_TYPE_BYTES field. */
+    void const * p_arg;             /**< Structure descriptor of a @ref SER_FIELD_TYPE_STRUCT or
+                                         @ref SER_FIELD_TYPE_COND field, codec of a
+                                         @ref SER_FIELD_TYPE_CODEC field. */
+} ser_field_desc_t;
+
+/**@brief Descriptor of a structure, the fields are encoded in the order of the table. */
+typedef struct
+{
+    ser_field_desc_t const * p_fields;      /**< Field descriptors. */
+    uint8_t                  field_count;   /**< Number of fields. */
+    uint8_t                  enc_len;       /**< Encoded length if it is fixed, 0 otherwise. If set,
+                                                 the buffer length is checked once for the whole
+                                                 structure instead of for each field. */
+} ser_struct_desc_t;
+
+#define SER_FIELD_UINT8(type, field)  {offsetof(type, field), SER_FIELD_TYPE_UINT8,  1, NULL}
+#define SER_FIELD_UINT16(type, field) {offsetof(type, field), SER_FIELD_TYPE_UINT16, 2, NULL}
+#define SER_FIELD_UINT32(type, field) {offsetof(type, field), SER_FIELD_TYPE_UINT32, 4, NULL}
+#define SER_FIELD_BYTES(type, field, len) \
+    {offsetof(type, field), SER_FIELD_TYPE_BYTES, (len), NULL}
+#define SER_FIELD_STRUCT(type, field, p_desc) \
+    {offsetof(type, field), SER_FIELD_TYPE_STRUCT, 0, (p_desc)}
+#define SER_FIELD_COND(type, field, p_desc) \
+    {offsetof(type, field), SER_FIELD_TYPE_COND, 0, (p_desc)}
+/** A codec field is given a pointer to the field, or to the whole structure for bit fields
+ *  (offset 0), which cannot be addressed. */
+#define SER_FIELD_CODEC(offset, p_codec) {(offset), SER_FIELD_TYPE_CODEC, 0, (p_codec)}
+
+/**@brief Macro for initializing a structure descriptor from a field descriptor array. */
+#define SER_STRUCT_DESC(fields, enc_len) \
+    {(fields), (uint8_t)(sizeof(fields) / sizeof((fields)[0])), (enc_len)}
+
+/**@brief Macros giving the encoded length of a field, for @ref SER_STRUCT_DESC_CHECK.
+ *
+ * @details The length of an integer or byte array field is checked at compile time against the
+ *          size of the structure member. The length of a nested structure is the encoded length
+ *          given to its descriptor, the length of a codec field is given by hand.
+ */
+#define SER_FIELD_LEN_CHECKED(type, field, len) \
+    sizeof(char[(sizeof(((type *)0)->field) == (len)) ? (len) : -1])
+#define SER_FIELD_UINT8_LEN(type, field)      SER_FIELD_LEN_CHECKED(type, field, 1)
+#define SER_FIELD_UINT16_LEN(type, field)     SER_FIELD_LEN_CHECKED(type, field, 2)
+#define SER_FIELD_UINT32_LEN(type, field)     SER_FIELD_LEN_CHECKED(type, field, 4)
+#define SER_FIELD_BYTES_LEN(type, field, len) SER_FIELD_LEN_CHECKED(type, field, len)
+#define SER_FIELD_STRUCT_LEN(enc_len)         (enc_len)
+#define SER_FIELD_CODEC_LEN(enc_len)          (enc_len)
+
+/**@brief Macro for checking at compile time the encoded length of a structure descriptor.
+ *
+ * @param[in]  fields       Field descriptor array.
+ * @param[in]  enc_len      Encoded length given to @ref SER_STRUCT_DESC.
+ * @param[in]  field_count  Number of fields summed in fields_len.
+ * @param[in]  fields_len   Sum of the SER_FIELD_*_LEN lengths of the fields, in table order.
+ */
+#define SER_STRUCT_DESC_CHECK(fields, enc_len, field_count, fields_len)                 \
+    STATIC_ASSERT(((sizeof(fields) / sizeof((fields)[0])) == (field_count)) &&         \
+                  ((enc_len) == (fields_len)))
+
+/**@brief Function for encoding a structure described by a structure descriptor.
+ *
+ * @param[in]      p_desc           Structure descriptor.
+ * @param[in]      p_struct         Pointer to the structure.
+ * @param[in]      p_buf            Pointer to the beginning of the output buffer.
+ * @param[in]      buf_len          Size of buffer.
+ * @param[in,out]  p_index          \c in: Index to start of the structure in buffer.
+ *                                  \c out: Index in buffer to first byte after the encoded data.
+ *
+ * @return NRF_SUCCESS              Structure encoded successfully.
+ * @retval NRF_ERROR_INVALID_LENGTH Encoding failure. Incorrect buffer length.
+ */
+uint32_t ser_struct_enc(ser_struct_desc_t const * p_desc,
+                        void const * const        p_struct,
+                        uint8_t * const           p_buf,
+                        uint32_t                  buf_len,
+                        uint32_t * const          p_index);
+
+/**@brief Function for decoding a structure described by a structure descriptor.
+ *
+ * @param[in]      p_desc           Structure descriptor.
+ * @param[in]      p_buf            Pointer to the beginning of the input buffer.
+ * @param[in]      buf_len          Size of buffer.
+ * @param[in,out]  p_index          \c in: Index to start of the structure in buffer.
+ *                                  \c out: Index in buffer to first byte after the decoded data.
+ * @param[out]     p_struct         Pointer to the structure. Pointers of
+ *                                  @ref SER_FIELD_TYPE_COND fields must point to output memory.
+ *
+ * @return NRF_SUCCESS              Structure decoded successfully.
+ * @retval NRF_ERROR_INVALID_LENGTH Decoding failure. Incorrect buffer length.
+ * @retval NRF_ERROR_INVALID_DATA   Decoding failure. Invalid presence flag.
+ */
+uint32_t ser_struct_dec(ser_struct_desc_t const * p_desc,
+                        uint8_t const * const     p_buf,
+                        uint32_t                  buf_len,
+                        uint32_t * const          p_index,
+                        void * const              p_struct);
+
+#endif // COND_FIELD_SERIALIZATION_H__
@@ -53,6 +53,36 @@
     #define SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE         SER_HAL_TRANSPORT_CONN_TO_APP_MAX_PKT_SIZE
 #endif /* SER_CONNECTIVITY */
 
+/** Number of TX and RX buffers in serialization HAL Transport layer. With more than one TX buffer
+ *  the next packet can be encoded while the previous one is being sent. With more than one RX
+ *  buffer the next packet can be received while the previous one is being processed. Can be
+ *  overridden per build. */
+#ifndef SER_HAL_TRANSPORT_TX_BUF_COUNT
+    #define SER_HAL_TRANSPORT_TX_BUF_COUNT            2
+#endif
+#ifndef SER_HAL_TRANSPORT_RX_BUF_COUNT
+    #define SER_HAL_TRANSPORT_RX_BUF_COUNT            2
+#endif
+
+/** Set to 1 to let the connectivity chip pack the BLE events generated while a packet is being
+ *  sent into a single event batch packet. The application side always accepts batches. */
+#ifndef SER_EVT_BATCH_ENABLED
+    #define SER_EVT_BATCH_ENABLED                     0
+#endif
+
+/** Set to 1 to send repeated advertising reports in a compact form. The connectivity chip keeps a
+ *  table of recently seen advertisers, and a report whose data did not change since the last one
+ *  from the same advertiser is sent as a table index and an RSSI. The application side rebuilds the
+ *  full report from its copy of the table. Must be set identically on both sides. */
+#ifndef SER_ADV_REPORT_DELTA_ENABLED
+    #define SER_ADV_REPORT_DELTA_ENABLED              0
+#endif
+
+/** Number of advertisers in the advertising report tables. Must not exceed 255. */
+#ifndef SER_ADV_REPORT_CACHE_SIZE
+    #define SER_ADV_REPORT_CACHE_SIZE                 8
+#endif
+
 
 /***********************************************************************************************//**
  * SER_PHY layer configuration.
@@ -68,6 +98,12 @@
 #define SER_PHY_UART_PARITY             true
 #define SER_PHY_UART_BAUDRATE           UART_BAUDRATE_BAUDRATE_Baud1M
 
+/** Set to N to send every Nth HCI packet with a corrupted CRC, so the peer drops it and the
+ *  packet is retransmitted. Used to test the HCI retransmission path, 0 disables. */
+#ifndef SER_PHY_HCI_ERROR_INJECTION_INTERVAL
+    #define SER_PHY_HCI_ERROR_INJECTION_INTERVAL 0
+#endif
+
 /** Find UART baudrate value based on chosen register setting. */
 #if (SER_PHY_UART_BAUDRATE == UART_BAUDRATE_BAUDRATE_Baud1200)
     #define SER_PHY_UART_BAUDRATE_VAL 1200uL
@@ -103,6 +139,22 @@
     #define SER_PHY_UART_BAUDRATE_VAL 1000000uL
 #endif /* SER_PHY_UART_BAUDRATE */
 
+/** Maximum number of commands sent to the connectivity MCU and waiting for a response. */
+#ifndef SER_SD_TRANSPORT_MAX_PENDING_CMDS
+    #define SER_SD_TRANSPORT_MAX_PENDING_CMDS 4
+#endif
+
+/** Set to 1 to collect round trip time statistics of SoftDevice calls and count received events,
+ *  see @ref ser_sd_transport_stats_start. */
+#ifndef SER_SD_TRANSPORT_STATS_ENABLED
+    #define SER_SD_TRANSPORT_STATS_ENABLED    0
+#endif
+
+/** Number of SoftDevice call op codes statistics are collected for. */
+#ifndef SER_SD_TRANSPORT_STATS_OP_CODE_COUNT
+    #define SER_SD_TRANSPORT_STATS_OP_CODE_COUNT 16
+#endif
+
 /** Configuration timeouts of connectivity MCU */
 #define CONN_CHIP_RESET_TIME            50      /**< The time to keep the reset line to the nRF51822 low (in milliseconds). */
 #define CONN_CHIP_WAKEUP_TIME           500     /**< The time for nRF51822 to reset and become ready to receive serialized commands (in milliseconds). */
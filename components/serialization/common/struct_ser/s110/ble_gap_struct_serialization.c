@@ -16,36 +16,140 @@
 #include "app_util.h"
 #include "string.h"
 
-uint32_t ble_gap_irk_enc(void const * const p_data,
-                         uint8_t * const    p_buf,
-                         uint32_t           buf_len,
-                         uint32_t * const   p_index)
+static ser_field_desc_t const m_irk_fields[] =
 {
-    ble_gap_irk_t * p_gap_irk = (ble_gap_irk_t *)p_data;
+    SER_FIELD_BYTES(ble_gap_irk_t, irk, BLE_GAP_SEC_KEY_LEN)
+};
 
-    SER_ASSERT_LENGTH_LEQ(BLE_GAP_SEC_KEY_LEN, buf_len - *p_index);
+#define GAP_IRK_ENC_LEN BLE_GAP_SEC_KEY_LEN /**< Encoded length of @ref ble_gap_irk_t. */
 
-    memcpy(&p_buf[*p_index], p_gap_irk->irk, BLE_GAP_SEC_KEY_LEN);
+static ser_struct_desc_t const m_irk_desc = SER_STRUCT_DESC(m_irk_fields, GAP_IRK_ENC_LEN);
+SER_STRUCT_DESC_CHECK(m_irk_fields, GAP_IRK_ENC_LEN, 1,
+                      SER_FIELD_BYTES_LEN(ble_gap_irk_t, irk, BLE_GAP_SEC_KEY_LEN));
 
-    *p_index += BLE_GAP_SEC_KEY_LEN;
+static ser_field_desc_t const m_addr_fields[] =
+{
+    SER_FIELD_UINT8(ble_gap_addr_t, addr_type),
+    SER_FIELD_BYTES(ble_gap_addr_t, addr, BLE_GAP_ADDR_LEN)
+};
 
-    return NRF_SUCCESS;
+#define GAP_ADDR_ENC_LEN (1 + BLE_GAP_ADDR_LEN) /**< Encoded length of @ref ble_gap_addr_t. */
+
+static ser_struct_desc_t const m_addr_desc = SER_STRUCT_DESC(m_addr_fields, GAP_ADDR_ENC_LEN);
+SER_STRUCT_DESC_CHECK(m_addr_fields, GAP_ADDR_ENC_LEN, 2,
+                      SER_FIELD_UINT8_LEN(ble_gap_addr_t, addr_type) +
+                      SER_FIELD_BYTES_LEN(ble_gap_addr_t, addr, BLE_GAP_ADDR_LEN));
+
+static ser_field_desc_t const m_conn_params_fields[] =
+{
+    SER_FIELD_UINT16(ble_gap_conn_params_t, min_conn_interval),
+    SER_FIELD_UINT16(ble_gap_conn_params_t, max_conn_interval),
+    SER_FIELD_UINT16(ble_gap_conn_params_t, slave_latency),
+    SER_FIELD_UINT16(ble_gap_conn_params_t, conn_sup_timeout)
+};
+
+#define GAP_CONN_PARAMS_ENC_LEN 8 /**< Encoded length of @ref ble_gap_conn_params_t. */
+
+static ser_struct_desc_t const m_conn_params_desc =
+    SER_STRUCT_DESC(m_conn_params_fields, GAP_CONN_PARAMS_ENC_LEN);
+SER_STRUCT_DESC_CHECK(m_conn_params_fields, GAP_CONN_PARAMS_ENC_LEN, 4,
+                      SER_FIELD_UINT16_LEN(ble_gap_conn_params_t, min_conn_interval) +
+                      SER_FIELD_UINT16_LEN(ble_gap_conn_params_t, max_conn_interval) +
+                      SER_FIELD_UINT16_LEN(ble_gap_conn_params_t, slave_latency) +
+                      SER_FIELD_UINT16_LEN(ble_gap_conn_params_t, conn_sup_timeout));
+
+static ser_field_desc_t const m_evt_disconnected_fields[] =
+{
+    SER_FIELD_UINT8(ble_gap_evt_disconnected_t, reason)
+};
+
+#define GAP_EVT_DISCONNECTED_ENC_LEN 1 /**< Encoded length of @ref ble_gap_evt_disconnected_t. */
+
+static ser_struct_desc_t const m_evt_disconnected_desc =
+    SER_STRUCT_DESC(m_evt_disconnected_fields, GAP_EVT_DISCONNECTED_ENC_LEN);
+SER_STRUCT_DESC_CHECK(m_evt_disconnected_fields, GAP_EVT_DISCONNECTED_ENC_LEN, 1,
+                      SER_FIELD_UINT8_LEN(ble_gap_evt_disconnected_t, reason));
+
+static ser_field_desc_t const m_master_id_fields[] =
+{
+    SER_FIELD_UINT16(ble_gap_master_id_t, ediv),
+    SER_FIELD_BYTES(ble_gap_master_id_t, rand, BLE_GAP_SEC_RAND_LEN)
+};
+
+#define GAP_MASTER_ID_ENC_LEN (2 + BLE_GAP_SEC_RAND_LEN) /**< Encoded length of @ref ble_gap_master_id_t. */
+
+static ser_struct_desc_t const m_master_id_desc =
+    SER_STRUCT_DESC(m_master_id_fields, GAP_MASTER_ID_ENC_LEN);
+SER_STRUCT_DESC_CHECK(m_master_id_fields, GAP_MASTER_ID_ENC_LEN, 2,
+                      SER_FIELD_UINT16_LEN(ble_gap_master_id_t, ediv) +
+                      SER_FIELD_BYTES_LEN(ble_gap_master_id_t, rand, BLE_GAP_SEC_RAND_LEN));
+
+static uint32_t evt_connected_irk_match_enc(void const * const p_void_struct,
+                                            uint8_t * const    p_buf,
+                                            uint32_t           buf_len,
+                                            uint32_t * const   p_index)
+{
+    ble_gap_evt_connected_t * p_evt_conn = (ble_gap_evt_connected_t *)p_void_struct;
+    uint8_t                   byte       = p_evt_conn->irk_match | (p_evt_conn->irk_match_idx << 1);
+
+    return uint8_t_enc(&byte, p_buf, buf_len, p_index);
 }
 
-uint32_t ble_gap_irk_dec(uint8_t const * const p_buf,
-                         uint32_t              buf_len,
-                         uint32_t * const      p_index,
-                         void * const          p_data)
+static uint32_t evt_connected_irk_match_dec(uint8_t const * const p_buf,
+                                            uint32_t              buf_len,
+                                            uint32_t * const      p_index,
+                                            void *                p_void_struct)
 {
-    ble_gap_irk_t * p_gap_irk = (ble_gap_irk_t *)p_data;
+    ble_gap_evt_connected_t * p_evt_conn = (ble_gap_evt_connected_t *)p_void_struct;
+    uint32_t                  err_code   = NRF_SUCCESS;
+    uint8_t                   byte       = 0;
 
-    SER_ASSERT_LENGTH_LEQ(BLE_GAP_SEC_KEY_LEN, buf_len - *p_index);
+    err_code = uint8_t_dec(p_buf, buf_len, p_index, &byte);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+    p_evt_conn->irk_match     = byte & 0x01;
+    p_evt_conn->irk_match_idx = (byte & 0xFE) >> 1;
 
-    memcpy(p_gap_irk->irk, &p_buf[*p_index], BLE_GAP_SEC_KEY_LEN);
+    return err_code;
+}
 
-    *p_index += BLE_GAP_SEC_KEY_LEN;
+static ser_field_codec_t const m_evt_connected_irk_match_codec =
+{
+    evt_connected_irk_match_enc,
+    evt_connected_irk_match_dec
+};
 
-    return NRF_SUCCESS;
+static ser_field_desc_t const m_evt_connected_fields[] =
+{
+    SER_FIELD_STRUCT(ble_gap_evt_connected_t, peer_addr, &m_addr_desc),
+    SER_FIELD_STRUCT(ble_gap_evt_connected_t, own_addr, &m_addr_desc),
+    SER_FIELD_CODEC(0, &m_evt_connected_irk_match_codec),
+    SER_FIELD_STRUCT(ble_gap_evt_connected_t, conn_params, &m_conn_params_desc)
+};
+
+#define GAP_EVT_CONNECTED_ENC_LEN 23 /**< Encoded length of @ref ble_gap_evt_connected_t. */
+
+static ser_struct_desc_t const m_evt_connected_desc =
+    SER_STRUCT_DESC(m_evt_connected_fields, GAP_EVT_CONNECTED_ENC_LEN);
+SER_STRUCT_DESC_CHECK(m_evt_connected_fields, GAP_EVT_CONNECTED_ENC_LEN, 4,
+                      SER_FIELD_STRUCT_LEN(GAP_ADDR_ENC_LEN) +
+                      SER_FIELD_STRUCT_LEN(GAP_ADDR_ENC_LEN) +
+                      SER_FIELD_CODEC_LEN(1) +
+                      SER_FIELD_STRUCT_LEN(GAP_CONN_PARAMS_ENC_LEN));
+
+uint32_t ble_gap_irk_enc(void const * const p_data,
+                         uint8_t * const    p_buf,
+                         uint32_t           buf_len,
+                         uint32_t * const   p_index)
+{
+    return ser_struct_enc(&m_irk_desc, p_data, p_buf, buf_len, p_index);
+}
+
+uint32_t ble_gap_irk_dec(uint8_t const * const p_buf,
+                         uint32_t              buf_len,
+                         uint32_t * const      p_index,
+                         void * const          p_data)
+{
+    return ser_struct_dec(&m_irk_desc, p_buf, buf_len, p_index, p_data);
 }
 
 uint32_t ble_gap_addr_enc(void const * const p_data,
@@ -53,16 +157,7 @@ uint32_t ble_gap_addr_enc(void const * const p_data,
                           uint32_t           buf_len,
                           uint32_t * const   p_index)
 {
-    ble_gap_addr_t * p_addr = (ble_gap_addr_t *)p_data;
-
-    SER_ASSERT_LENGTH_LEQ(1 + BLE_GAP_ADDR_LEN, buf_len - *p_index);
-
-    p_buf[*p_index] = p_addr->addr_type;
-    (*p_index)++;
-    memcpy(&p_buf[*p_index], p_addr->addr, BLE_GAP_ADDR_LEN);
-    *p_index += BLE_GAP_ADDR_LEN;
-
-    return NRF_SUCCESS;
+    return ser_struct_enc(&m_addr_desc, p_data, p_buf, buf_len, p_index);
 }
 
 uint32_t ble_gap_addr_dec(uint8_t const * const p_buf,
@@ -70,13 +165,7 @@ uint32_t ble_gap_addr_dec(uint8_t const * const p_buf,
                           uint32_t * const      p_index,
                           void * const          p_addr)
 {
-    ble_gap_addr_t * p_address = (ble_gap_addr_t *) p_addr;
-
-    SER_ASSERT_LENGTH_LEQ(sizeof (ble_gap_addr_t), buf_len - *p_index);
-    memcpy(p_address, &p_buf[*p_index], sizeof (ble_gap_addr_t));
-    *p_index += sizeof (ble_gap_addr_t);
-
-    return NRF_SUCCESS;
+    return ser_struct_dec(&m_addr_desc, p_buf, buf_len, p_index, p_addr);
 }
 
 uint32_t ble_gap_sec_levels_enc(void const * const p_data,
@@ -86,7 +175,7 @@ uint32_t ble_gap_sec_levels_enc(void const * const p_data,
 {
     ble_gap_sec_levels_t * p_sec_levels = (ble_gap_sec_levels_t *)p_data;
 
-    SER_ASSERT_LENGTH_LEQ(1, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
 
     p_buf[*p_index] = (p_sec_levels->lv1 << 0) | (p_sec_levels->lv2 << 1) | (p_sec_levels->lv3 << 2);
     (*p_index)++;
@@ -103,7 +192,7 @@ uint32_t ble_gap_sec_levels_dec(uint8_t const * const p_buf,
     uint32_t err_code;
     uint32_t uint8_temp;
 
-    SER_ASSERT_LENGTH_LEQ(sizeof (ble_gap_sec_levels_t), buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(sizeof (ble_gap_sec_levels_t), *p_index, buf_len);
 
     err_code = uint8_t_dec(p_buf, buf_len, p_index, (void *) &(uint8_temp));
     SER_ASSERT(err_code == NRF_SUCCESS, err_code);
@@ -205,7 +294,7 @@ uint32_t ble_gap_sign_info_enc(void const * const p_sign_info,
                                uint32_t           buf_len,
                                uint32_t * const   p_index)
 {
-    SER_ASSERT_LENGTH_LEQ(sizeof (ble_gap_sign_info_t), buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(sizeof (ble_gap_sign_info_t), *p_index, buf_len);
     memcpy(&p_buf[*p_index], p_sign_info, sizeof (ble_gap_sign_info_t));
     *p_index += sizeof (ble_gap_sign_info_t);
 
@@ -217,7 +306,7 @@ uint32_t ble_gap_sign_info_dec(uint8_t const * const p_buf,
                                uint32_t * const      p_index,
                                void * const          p_sign_info)
 {
-    SER_ASSERT_LENGTH_LEQ(sizeof (ble_gap_sign_info_t), buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(sizeof (ble_gap_sign_info_t), *p_index, buf_len);
     memcpy(p_sign_info, &p_buf[*p_index], sizeof (ble_gap_sign_info_t));
     *p_index += sizeof (ble_gap_sign_info_t);
 
@@ -234,7 +323,7 @@ uint32_t ble_gap_evt_auth_status_t_enc(void const * const p_data,
 
     ble_gap_evt_auth_status_t * p_auth_status = (ble_gap_evt_auth_status_t *)p_data;
 
-    SER_ASSERT_LENGTH_LEQ(6, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(6, *p_index, buf_len);
 
     err_code = uint8_t_enc(&(p_auth_status->auth_status), p_buf, buf_len, p_index);
     SER_ASSERT(err_code == NRF_SUCCESS, err_code);
@@ -269,7 +358,7 @@ uint32_t ble_gap_evt_auth_status_t_dec(uint8_t const * const p_buf,
     uint32_t                    err_code;
     uint8_t                     byte;
 
-    SER_ASSERT_LENGTH_LEQ(6, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(6, *p_index, buf_len);
     SER_ASSERT_NOT_NULL(p_auth_status);
 
     err_code = uint8_t_dec(p_buf, buf_len, p_index, &(p_auth_status->auth_status));
@@ -319,7 +408,7 @@ uint32_t ble_gap_conn_sec_mode_dec(uint8_t const * const p_buf,
     uint32_t                  err_code   = NRF_SUCCESS;
     uint8_t                   temp8;
 
-    SER_ASSERT_LENGTH_LEQ(1, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
     uint8_dec(p_buf, buf_len, p_index, &temp8);
 
     p_sec_mode->sm = temp8;
@@ -372,7 +461,7 @@ uint32_t ble_gap_conn_sec_t_dec(uint8_t const * const p_buf,
     err_code = ble_gap_conn_sec_mode_dec(p_buf, buf_len, p_index, &p_conn_sec->sec_mode);
     SER_ASSERT(err_code == NRF_SUCCESS, err_code);
 
-    SER_ASSERT_LENGTH_LEQ(1, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
     uint8_dec(p_buf, buf_len, p_index, &p_conn_sec->encr_key_size);
 
     return err_code;
@@ -434,24 +523,7 @@ uint32_t ble_gap_evt_connected_t_enc(void const * const p_void_struct,
                                      uint32_t           buf_len,
                                      uint32_t * const   p_index)
 {
-    ble_gap_evt_connected_t * p_evt_conn = (ble_gap_evt_connected_t *)p_void_struct;
-    uint32_t                  err_code   = NRF_SUCCESS;
-    uint8_t                   byte       = 0;
-
-    err_code = ble_gap_addr_enc((void *)&p_evt_conn->peer_addr, p_buf, buf_len, p_index);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-    
-    err_code = ble_gap_addr_enc((void *)&p_evt_conn->own_addr, p_buf, buf_len, p_index);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    byte = p_evt_conn->irk_match | (p_evt_conn->irk_match_idx << 1);
-    err_code = uint8_t_enc(&byte, p_buf, buf_len, p_index);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    err_code = ble_gap_conn_params_t_enc((void *)&p_evt_conn->conn_params, p_buf, buf_len, p_index);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    return err_code;
+    return ser_struct_enc(&m_evt_connected_desc, p_void_struct, p_buf, buf_len, p_index);
 }
 
 uint32_t ble_gap_evt_connected_t_dec(uint8_t const * const p_buf,
@@ -459,25 +531,7 @@ uint32_t ble_gap_evt_connected_t_dec(uint8_t const * const p_buf,
                                      uint32_t * const      p_index,
                                      void * const          p_void_connected)
 {
-    ble_gap_evt_connected_t * p_evt_conn = (ble_gap_evt_connected_t *)p_void_connected;
-    uint32_t                err_code     = NRF_SUCCESS;
-    uint8_t                 byte         = 0;
-
-    err_code = ble_gap_addr_dec(p_buf, buf_len, p_index, &(p_evt_conn->peer_addr));
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    err_code = ble_gap_addr_dec(p_buf, buf_len, p_index, &(p_evt_conn->own_addr));
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    err_code = uint8_t_dec(p_buf, buf_len, p_index, &byte);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-    p_evt_conn->irk_match     = byte & 0x01;
-    p_evt_conn->irk_match_idx = (byte & 0xFE) >> 1;
-
-    err_code = ble_gap_conn_params_t_dec(p_buf, buf_len, p_index, &(p_evt_conn->conn_params));
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    return err_code;
+    return ser_struct_dec(&m_evt_connected_desc, p_buf, buf_len, p_index, p_void_connected);
 }
 
 uint32_t ble_gap_sec_params_t_enc(void const * const p_void_struct,
@@ -596,22 +650,7 @@ uint32_t ble_gap_conn_params_t_enc(void const * const p_void_conn_params,
                                    uint32_t           buf_len,
                                    uint32_t * const   p_index)
 {
-    ble_gap_conn_params_t * p_conn_params = (ble_gap_conn_params_t *)p_void_conn_params;
-    uint32_t                err_code      = NRF_SUCCESS;
-
-    err_code = uint16_t_enc(&p_conn_params->min_conn_interval, p_buf, buf_len, p_index);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    err_code = uint16_t_enc(&p_conn_params->max_conn_interval, p_buf, buf_len, p_index);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    err_code = uint16_t_enc(&p_conn_params->slave_latency, p_buf, buf_len, p_index);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    err_code = uint16_t_enc(&p_conn_params->conn_sup_timeout, p_buf, buf_len, p_index);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    return err_code;
+    return ser_struct_enc(&m_conn_params_desc, p_void_conn_params, p_buf, buf_len, p_index);
 }
 
 uint32_t ble_gap_conn_params_t_dec(uint8_t const * const p_buf,
@@ -619,21 +658,7 @@ uint32_t ble_gap_conn_params_t_dec(uint8_t const * const p_buf,
                                    uint32_t * const      p_index,
                                    void * const          p_void_conn_params)
 {
-    ble_gap_conn_params_t * p_conn_params = (ble_gap_conn_params_t *)p_void_conn_params;
-
-    SER_ASSERT_LENGTH_LEQ(*p_index + 2, buf_len);
-    uint16_dec(p_buf, buf_len, p_index, &p_conn_params->min_conn_interval);
-
-    SER_ASSERT_LENGTH_LEQ(*p_index + 2, buf_len);
-    uint16_dec(p_buf, buf_len, p_index, &p_conn_params->max_conn_interval);
-
-    SER_ASSERT_LENGTH_LEQ(*p_index + 2, buf_len);
-    uint16_dec(p_buf, buf_len, p_index, &p_conn_params->slave_latency);
-
-    SER_ASSERT_LENGTH_LEQ(*p_index + 2, buf_len);
-    uint16_dec(p_buf, buf_len, p_index, &p_conn_params->conn_sup_timeout);
-
-    return NRF_SUCCESS;
+    return ser_struct_dec(&m_conn_params_desc, p_buf, buf_len, p_index, p_void_conn_params);
 }
 
 uint32_t ble_gap_evt_disconnected_t_enc(void const * const p_void_disconnected,
@@ -641,13 +666,7 @@ uint32_t ble_gap_evt_disconnected_t_enc(void const * const p_void_disconnected,
                                         uint32_t           buf_len,
                                         uint32_t * const   p_index)
 {
-    ble_gap_evt_disconnected_t * p_disconnected = (ble_gap_evt_disconnected_t *)p_void_disconnected;
-    uint32_t                     err_code       = NRF_SUCCESS;
-
-    err_code = uint8_t_enc(&p_disconnected->reason, p_buf, buf_len, p_index);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    return err_code;
+    return ser_struct_enc(&m_evt_disconnected_desc, p_void_disconnected, p_buf, buf_len, p_index);
 }
 
 uint32_t ble_gap_evt_disconnected_t_dec(uint8_t const * const p_buf,
@@ -655,13 +674,7 @@ uint32_t ble_gap_evt_disconnected_t_dec(uint8_t const * const p_buf,
                                         uint32_t * const      p_index,
                                         void * const          p_void_disconnected)
 {
-    ble_gap_evt_disconnected_t * p_disconnected = (ble_gap_evt_disconnected_t *)p_void_disconnected;
-    uint32_t                     err_code       = NRF_SUCCESS;
-
-    SER_ASSERT_LENGTH_LEQ(1, buf_len - *p_index);
-    uint8_dec(p_buf, buf_len, p_index, &p_disconnected->reason);
-
-    return err_code;
+    return ser_struct_dec(&m_evt_disconnected_desc, p_buf, buf_len, p_index, p_void_disconnected);
 }
 
 uint32_t ble_gap_opt_ch_map_t_enc(void const * const p_data,
@@ -678,7 +691,7 @@ uint32_t ble_gap_opt_ch_map_t_enc(void const * const p_data,
     err_code = uint16_t_enc(&p_gap_opt_ch_map->conn_handle, p_buf, buf_len, p_index);
     SER_ASSERT(err_code == NRF_SUCCESS, err_code);
 
-    SER_ASSERT_LENGTH_LEQ(5, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(5, *p_index, buf_len);
     memcpy(&p_buf[*p_index], p_gap_opt_ch_map->ch_map, 5);
 
     *p_index += 5;
@@ -700,7 +713,7 @@ uint32_t ble_gap_opt_ch_map_t_dec(uint8_t const * const p_buf,
     err_code = uint16_t_dec(p_buf, buf_len, p_index, &p_gap_opt_ch_map->conn_handle);
     SER_ASSERT(err_code == NRF_SUCCESS, err_code);
     
-    SER_ASSERT_LENGTH_LEQ(5, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(5, *p_index, buf_len);
     memcpy(p_gap_opt_ch_map->ch_map, &p_buf[*p_index], 5);
 
     *p_index += 5;
@@ -921,7 +934,7 @@ uint32_t ble_gap_sec_kdist_t_enc(void const * const p_data,
     ble_gap_sec_kdist_t * p_sec_kdist = (ble_gap_sec_kdist_t *) p_data;
     uint32_t                  err_code    = NRF_SUCCESS;
 
-    SER_ASSERT_LENGTH_LEQ(1, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
 
     p_buf[*p_index]  = p_sec_kdist->enc & 0x01;
     p_buf[*p_index] |= (p_sec_kdist->id & 0x01) << 1;
@@ -942,7 +955,7 @@ uint32_t ble_gap_sec_kdist_t_dec(uint8_t const * const p_buf,
     ble_gap_sec_kdist_t * p_sec_kdist = (ble_gap_sec_kdist_t *)p_data;
     uint32_t err_code = NRF_SUCCESS;
 
-    SER_ASSERT_LENGTH_LEQ(1, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
     p_sec_kdist->enc   = p_buf[*p_index] & 0x01;
     p_sec_kdist->id    = (p_buf[*p_index] >> 1) & 0x01;
     p_sec_kdist->sign  = (p_buf[*p_index] >> 2) & 0x01;
@@ -956,35 +969,15 @@ uint32_t ble_gap_master_id_t_enc(void const * const p_master_idx,
                                  uint32_t           buf_len,
                                  uint32_t * const   p_index)
 {
-    ble_gap_master_id_t * p_master_id = (ble_gap_master_id_t *) p_master_idx;
-    uint32_t err_code = NRF_SUCCESS;
-
-    err_code = uint16_t_enc(&(p_master_id->ediv), p_buf, buf_len, p_index);
-
-    SER_ASSERT_LENGTH_LEQ(BLE_GAP_SEC_RAND_LEN, buf_len - *p_index);
-    memcpy(&p_buf[*p_index], p_master_id->rand, BLE_GAP_SEC_RAND_LEN);
-    *p_index += BLE_GAP_SEC_RAND_LEN;
-
-    return err_code;
+    return ser_struct_enc(&m_master_id_desc, p_master_idx, p_buf, buf_len, p_index);
 }
 
 uint32_t ble_gap_master_id_t_dec(uint8_t const * const p_buf,
-                               uint32_t              buf_len,
-                               uint32_t      * const p_index,
-                               void          * const p_master_idx)
+                                 uint32_t              buf_len,
+                                 uint32_t * const      p_index,
+                                 void * const          p_master_idx)
 {
-    ble_gap_master_id_t *p_master_id = (ble_gap_master_id_t *)p_master_idx;
-
-    uint32_t err_code = NRF_SUCCESS;
-
-    err_code = uint16_t_dec(p_buf, buf_len, p_index, &(p_master_id->ediv));
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    SER_ASSERT_LENGTH_LEQ(BLE_GAP_SEC_RAND_LEN, buf_len - *p_index);
-    memcpy(p_master_id->rand, &p_buf[*p_index], BLE_GAP_SEC_RAND_LEN);
-    *p_index += BLE_GAP_SEC_RAND_LEN;
-
-    return err_code;
+    return ser_struct_dec(&m_master_id_desc, p_buf, buf_len, p_index, p_master_idx);
 }
 
 uint32_t ble_gap_enc_info_enc(void const * const p_data,
@@ -995,7 +988,7 @@ uint32_t ble_gap_enc_info_enc(void const * const p_data,
     uint32_t             err_code = NRF_SUCCESS;
     ble_gap_enc_info_t * p_enc_info = (ble_gap_enc_info_t *)p_data;
 
-    SER_ASSERT_LENGTH_LEQ(BLE_GAP_SEC_KEY_LEN + 1, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(BLE_GAP_SEC_KEY_LEN + 1, *p_index, buf_len);
 
     memcpy(&p_buf[*p_index], p_enc_info->ltk, BLE_GAP_SEC_KEY_LEN);
     *p_index += BLE_GAP_SEC_KEY_LEN;
@@ -1014,11 +1007,11 @@ uint32_t ble_gap_enc_info_dec(uint8_t const * const p_buf,
 {
     ble_gap_enc_info_t * p_enc_info = (ble_gap_enc_info_t *)p_enc_infox;
 
-    SER_ASSERT_LENGTH_LEQ(BLE_GAP_SEC_KEY_LEN, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(BLE_GAP_SEC_KEY_LEN, *p_index, buf_len);
     memcpy(p_enc_info->ltk, &p_buf[*p_index], BLE_GAP_SEC_KEY_LEN);
     *p_index += BLE_GAP_SEC_KEY_LEN;
 
-    SER_ASSERT_LENGTH_LEQ(1, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
     p_enc_info->auth    = p_buf[*p_index] & 0x01;
     p_enc_info->ltk_len = (p_buf[*p_index] >> 1) & 0x7F;
     *p_index            += 1;
@@ -1232,7 +1225,7 @@ uint32_t ble_gap_scan_params_t_enc(void const * const p_data,
     ble_gap_scan_params_t * p_scan_params = (ble_gap_scan_params_t *)p_data;
     uint32_t err_code = NRF_SUCCESS;
 
-    SER_ASSERT_LENGTH_LEQ(1, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
     p_buf[*p_index]  = p_scan_params->active & 0x01;
     p_buf[*p_index] |= (p_scan_params->selective & 0x7F) << 1;
     (*p_index)++;
@@ -1263,7 +1256,7 @@ uint32_t ble_gap_scan_params_t_dec(uint8_t const * const p_buf,
     ble_gap_scan_params_t * p_scan_params = (ble_gap_scan_params_t *)p_data;
     uint32_t err_code = NRF_SUCCESS;
 
-    SER_ASSERT_LENGTH_LEQ(1, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
     p_scan_params->active    = p_buf[*p_index] & 0x01;
     p_scan_params->selective = (p_buf[*p_index] >> 1) & 0x7F;
     (*p_index)++;
@@ -1336,7 +1329,7 @@ uint32_t ble_gap_evt_sec_request_t_enc(void const * const p_void_struct,
     ble_gap_evt_sec_request_t * p_evt_sec_request = (ble_gap_evt_sec_request_t *)p_void_struct;
     uint32_t                  err_code   = NRF_SUCCESS;
     
-    SER_ASSERT_LENGTH_LEQ(1, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
 
     p_buf[*p_index]  = p_evt_sec_request->bond & 0x01;
     p_buf[*p_index] |= (p_evt_sec_request->mitm & 0x01) << 1;
@@ -1356,7 +1349,7 @@ uint32_t ble_gap_evt_sec_request_t_dec(uint8_t const * const p_buf,
     ble_gap_evt_sec_request_t * p_sec_request = (ble_gap_evt_sec_request_t *)p_data;
     uint32_t err_code = NRF_SUCCESS;
 
-    SER_ASSERT_LENGTH_LEQ(1, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
     p_sec_request->bond = p_buf[*p_index] & 0x01;
     p_sec_request->mitm = (p_buf[*p_index] >> 1) & 0x01;
     *p_index            += 1;
@@ -19,22 +19,23 @@
 #include "cond_field_serialization.h"
 #include <string.h>
 
+static ser_field_desc_t const m_uuid_fields[] =
+{
+    SER_FIELD_UINT16(ble_uuid_t, uuid),
+    SER_FIELD_UINT8(ble_uuid_t, type)
+};
+
+ser_struct_desc_t const ble_uuid_t_desc = SER_STRUCT_DESC(m_uuid_fields, BLE_UUID_T_ENC_LEN);
+SER_STRUCT_DESC_CHECK(m_uuid_fields, BLE_UUID_T_ENC_LEN, 2,
+                      SER_FIELD_UINT16_LEN(ble_uuid_t, uuid) +
+                      SER_FIELD_UINT8_LEN(ble_uuid_t, type));
 
 uint32_t ble_uuid_t_enc(void const * const p_void_uuid,
                         uint8_t * const    p_buf,
                         uint32_t           buf_len,
                         uint32_t * const   p_index)
 {
-    ble_uuid_t * p_uuid   = (ble_uuid_t *)p_void_uuid;
-    uint32_t     err_code = NRF_SUCCESS;
-
-    err_code = uint16_t_enc(&p_uuid->uuid, p_buf, buf_len, p_index);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    err_code = uint8_t_enc(&p_uuid->type, p_buf, buf_len, p_index);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    return err_code;
+    return ser_struct_enc(&ble_uuid_t_desc, p_void_uuid, p_buf, buf_len, p_index);
 }
 
 uint32_t ble_uuid_t_dec(uint8_t const * const p_buf,
@@ -42,13 +43,7 @@ uint32_t ble_uuid_t_dec(uint8_t const * const p_buf,
                         uint32_t * const      p_index,
                         void * const          p_void_uuid)
 {
-    ble_uuid_t * p_uuid = (ble_uuid_t *)p_void_uuid;
-
-    SER_ASSERT_LENGTH_LEQ(3, buf_len - *p_index);
-    uint16_dec(p_buf, buf_len, p_index, &p_uuid->uuid);
-    uint8_dec(p_buf, buf_len, p_index, &p_uuid->type);
-
-    return NRF_SUCCESS;
+    return ser_struct_dec(&ble_uuid_t_desc, p_buf, buf_len, p_index, p_void_uuid);
 }
 
 uint32_t ble_uuid128_t_enc(void const * const p_void_uuid,
@@ -59,7 +54,7 @@ uint32_t ble_uuid128_t_enc(void const * const p_void_uuid,
     ble_uuid128_t * p_uuid   = (ble_uuid128_t *)p_void_uuid;
     uint32_t        err_code = NRF_SUCCESS;
 
-    SER_ASSERT_LENGTH_LEQ(16, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(16, *p_index, buf_len);
 
     memcpy(&p_buf[*p_index], p_uuid->uuid128, sizeof (p_uuid->uuid128));
 
@@ -76,7 +71,7 @@ uint32_t ble_uuid128_t_dec(uint8_t const * const p_buf,
     ble_uuid128_t * p_uuid   = (ble_uuid128_t *)p_void_uuid;
     uint32_t        err_code = NRF_SUCCESS;
 
-    SER_ASSERT_LENGTH_LEQ(16, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(16, *p_index, buf_len);
 
     memcpy(p_uuid->uuid128, &p_buf[*p_index], sizeof (p_uuid->uuid128));
 
@@ -142,7 +137,7 @@ uint32_t ble_l2cap_evt_rx_t_enc(void const * const p_void_evt_rx,
     err_code = ble_l2cap_header_t_enc(&(p_evt_rx->header), p_buf, buf_len, p_index);
     SER_ASSERT(err_code == NRF_SUCCESS, err_code);
 
-    SER_ASSERT_LENGTH_LEQ(p_evt_rx->header.len, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(p_evt_rx->header.len, *p_index, buf_len);
     memcpy(&p_buf[*p_index], p_evt_rx->data, p_evt_rx->header.len);
     *p_index += p_evt_rx->header.len;
 
@@ -184,7 +179,7 @@ uint32_t ble_l2cap_evt_rx_t_dec(uint8_t const * const p_buf,
         err_code = ble_l2cap_header_t_dec(p_buf, buf_len, p_index, &(p_evt_rx->header));
         SER_ASSERT(err_code == NRF_SUCCESS, err_code);
 
-        SER_ASSERT_LENGTH_LEQ(p_evt_rx->header.len, buf_len - *p_index);
+        SER_ASSERT_LENGTH_LEFT(p_evt_rx->header.len, *p_index, buf_len);
         memcpy(p_evt_rx->data, &p_buf[*p_index], p_evt_rx->header.len);
         *p_index += p_evt_rx->header.len;
     }
@@ -201,7 +196,7 @@ uint32_t ble_enable_params_t_enc(void const * const p_data,
     
     ble_enable_params_t * p_enable_params = (ble_enable_params_t *)p_data;
 
-    SER_ASSERT_LENGTH_LEQ(1, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
 
     p_buf[*p_index] = p_enable_params->gatts_enable_params.service_changed;
     (*p_index)++;
@@ -220,7 +215,7 @@ uint32_t ble_enable_params_t_dec(uint8_t const * const p_buf,
     
     ble_enable_params_t * p_enable_params = (ble_enable_params_t *) p_data;
 
-    SER_ASSERT_LENGTH_LEQ(1, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
     p_enable_params->gatts_enable_params.service_changed = p_buf[(*p_index)++];
     
     err_code = uint32_t_dec(p_buf, buf_len, p_index, &(p_enable_params->gatts_enable_params.attr_tab_size));
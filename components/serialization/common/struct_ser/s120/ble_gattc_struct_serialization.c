@@ -17,6 +17,48 @@
 #include "cond_field_serialization.h"
 #include <string.h>
 
+static ser_field_desc_t const m_handle_range_fields[] =
+{
+    SER_FIELD_UINT16(ble_gattc_handle_range_t, start_handle),
+    SER_FIELD_UINT16(ble_gattc_handle_range_t, end_handle)
+};
+
+#define GATTC_HANDLE_RANGE_ENC_LEN 4 /**< Encoded length of @ref ble_gattc_handle_range_t. */
+
+static ser_struct_desc_t const m_handle_range_desc =
+    SER_STRUCT_DESC(m_handle_range_fields, GATTC_HANDLE_RANGE_ENC_LEN);
+SER_STRUCT_DESC_CHECK(m_handle_range_fields, GATTC_HANDLE_RANGE_ENC_LEN, 2,
+                      SER_FIELD_UINT16_LEN(ble_gattc_handle_range_t, start_handle) +
+                      SER_FIELD_UINT16_LEN(ble_gattc_handle_range_t, end_handle));
+
+static ser_field_desc_t const m_service_fields[] =
+{
+    SER_FIELD_STRUCT(ble_gattc_service_t, uuid, &ble_uuid_t_desc),
+    SER_FIELD_STRUCT(ble_gattc_service_t, handle_range, &m_handle_range_desc)
+};
+
+#define GATTC_SERVICE_ENC_LEN 7 /**< Encoded length of @ref ble_gattc_service_t. */
+
+static ser_struct_desc_t const m_service_desc =
+    SER_STRUCT_DESC(m_service_fields, GATTC_SERVICE_ENC_LEN);
+SER_STRUCT_DESC_CHECK(m_service_fields, GATTC_SERVICE_ENC_LEN, 2,
+                      SER_FIELD_STRUCT_LEN(BLE_UUID_T_ENC_LEN) +
+                      SER_FIELD_STRUCT_LEN(GATTC_HANDLE_RANGE_ENC_LEN));
+
+static ser_field_desc_t const m_include_fields[] =
+{
+    SER_FIELD_UINT16(ble_gattc_include_t, handle),
+    SER_FIELD_STRUCT(ble_gattc_include_t, included_srvc, &m_service_desc)
+};
+
+#define GATTC_INCLUDE_ENC_LEN 9 /**< Encoded length of @ref ble_gattc_include_t. */
+
+static ser_struct_desc_t const m_include_desc =
+    SER_STRUCT_DESC(m_include_fields, GATTC_INCLUDE_ENC_LEN);
+SER_STRUCT_DESC_CHECK(m_include_fields, GATTC_INCLUDE_ENC_LEN, 2,
+                      SER_FIELD_UINT16_LEN(ble_gattc_include_t, handle) +
+                      SER_FIELD_STRUCT_LEN(GATTC_SERVICE_ENC_LEN));
+
 uint32_t ble_gattc_evt_char_val_by_uuid_read_rsp_t_enc(void const * const p_void_struct,
                                                        uint8_t * const    p_buf,
                                                        uint32_t           buf_len,
@@ -40,7 +82,7 @@ uint32_t ble_gattc_evt_char_val_by_uuid_read_rsp_t_enc(void const * const p_void
         err_code = uint16_t_enc(&(p_handle_value->handle), p_buf, buf_len, p_index);
         SER_ASSERT(err_code == NRF_SUCCESS, err_code);
 
-        SER_ASSERT_LENGTH_LEQ(p_read->value_len, buf_len - *p_index);
+        SER_ASSERT_LENGTH_LEFT(p_read->value_len, *p_index, buf_len);
         memcpy(&p_buf[*p_index], p_handle_value->p_value, p_read->value_len);
         *p_index += p_read->value_len;
 
@@ -63,7 +105,7 @@ uint32_t ble_gattc_evt_char_val_by_uuid_read_rsp_t_dec(uint8_t const * const p_b
     uint16_t count;
     uint32_t i;
 
-    SER_ASSERT_LENGTH_LEQ(4, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(4, *p_index, buf_len);
     uint16_dec(p_buf, buf_len, p_index, &count);
     uint16_dec(p_buf, buf_len, p_index, &value_len);
 
@@ -91,10 +133,10 @@ uint32_t ble_gattc_evt_char_val_by_uuid_read_rsp_t_dec(uint8_t const * const p_b
             p_handle_value          = (ble_gattc_handle_value_t *)&p_read->handle_value[i];
             p_handle_value->p_value = p_value;
 
-            SER_ASSERT_LENGTH_LEQ(2, buf_len - *p_index);
+            SER_ASSERT_LENGTH_LEFT(2, *p_index, buf_len);
             uint16_dec(p_buf, buf_len, p_index, &(p_handle_value->handle));
 
-            SER_ASSERT_LENGTH_LEQ(p_read->value_len, buf_len - *p_index);
+            SER_ASSERT_LENGTH_LEFT(p_read->value_len, *p_index, buf_len);
             memcpy(p_handle_value->p_value, &p_buf[*p_index], p_read->value_len);
             *p_index += p_read->value_len;
 
@@ -123,7 +165,7 @@ uint32_t ble_gattc_evt_char_vals_read_rsp_t_enc(void const * const p_void_struct
     SER_ASSERT(error_code == NRF_SUCCESS, error_code);
 
     //Encode values
-    SER_ASSERT_LENGTH_LEQ(p_read->len, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(p_read->len, *p_index, buf_len);
     memcpy(&p_buf[*p_index], p_read->values, p_read->len);
     *p_index += p_read->len;
 
@@ -140,11 +182,11 @@ uint32_t ble_gattc_evt_char_vals_read_rsp_t_dec(uint8_t const * const p_buf,
     uint32_t error_code = NRF_SUCCESS;
 
     //Decode len
-    SER_ASSERT_LENGTH_LEQ(2, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(2, *p_index, buf_len);
     uint16_dec(p_buf, buf_len, p_index, &(p_read->len));
 
     //Decode values
-    SER_ASSERT_LENGTH_LEQ(p_read->len, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(p_read->len, *p_index, buf_len);
     memcpy(p_read->values, &p_buf[*p_index], p_read->len);
     *p_index += p_read->len;
 
@@ -156,16 +198,7 @@ uint32_t ble_gattc_handle_range_t_enc(void const * const p_void_struct,
                                       uint32_t           buf_len,
                                       uint32_t * const   p_index)
 {
-    ble_gattc_handle_range_t * p_range  = (ble_gattc_handle_range_t *) p_void_struct;
-    uint32_t                   err_code = NRF_SUCCESS;
-
-    err_code = uint16_t_enc(&(p_range->start_handle), p_buf, buf_len, p_index);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    err_code = uint16_t_enc(&(p_range->end_handle), p_buf, buf_len, p_index);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    return err_code;
+    return ser_struct_enc(&m_handle_range_desc, p_void_struct, p_buf, buf_len, p_index);
 }
 
 uint32_t ble_gattc_handle_range_t_dec(uint8_t const * const p_buf,
@@ -173,14 +206,7 @@ uint32_t ble_gattc_handle_range_t_dec(uint8_t const * const p_buf,
                                       uint32_t * const      p_index,
                                       void * const          p_void_struct)
 {
-    ble_gattc_handle_range_t * p_range  = (ble_gattc_handle_range_t *) p_void_struct;
-    uint32_t                   err_code = NRF_SUCCESS;
-
-    SER_ASSERT_LENGTH_LEQ(4, buf_len - *p_index);
-    uint16_dec(p_buf, buf_len, p_index, &(p_range->start_handle));
-    uint16_dec(p_buf, buf_len, p_index, &(p_range->end_handle));
-
-    return err_code;
+    return ser_struct_dec(&m_handle_range_desc, p_buf, buf_len, p_index, p_void_struct);
 }
 
 
@@ -189,15 +215,7 @@ uint32_t ble_gattc_service_t_enc(void const * const p_void_struct,
                                  uint32_t           buf_len,
                                  uint32_t * const   p_index)
 {
-    uint32_t              error_code = NRF_SUCCESS;
-    ble_gattc_service_t * p_service  = (ble_gattc_service_t *) p_void_struct;
-
-    error_code = ble_uuid_t_enc(&(p_service->uuid), p_buf, buf_len, p_index);
-    SER_ASSERT(error_code == NRF_SUCCESS, error_code);
-    error_code = ble_gattc_handle_range_t_enc(&(p_service->handle_range), p_buf, buf_len, p_index);
-    SER_ASSERT(error_code == NRF_SUCCESS, error_code);
-
-    return error_code;
+    return ser_struct_enc(&m_service_desc, p_void_struct, p_buf, buf_len, p_index);
 }
 
 uint32_t ble_gattc_service_t_dec(uint8_t const * const p_buf,
@@ -205,15 +223,7 @@ uint32_t ble_gattc_service_t_dec(uint8_t const * const p_buf,
                                  uint32_t * const      p_index,
                                  void * const          p_void_struct)
 {
-    uint32_t              error_code = NRF_SUCCESS;
-    ble_gattc_service_t * p_service  = (ble_gattc_service_t *) p_void_struct;
-
-    error_code = ble_uuid_t_dec(p_buf, buf_len, p_index, &(p_service->uuid));
-    SER_ASSERT(error_code == NRF_SUCCESS, error_code);
-    error_code = ble_gattc_handle_range_t_dec(p_buf, buf_len, p_index, &(p_service->handle_range));
-    SER_ASSERT(error_code == NRF_SUCCESS, error_code);
-
-    return error_code;
+    return ser_struct_dec(&m_service_desc, p_buf, buf_len, p_index, p_void_struct);
 }
 
 uint32_t ble_gattc_include_t_enc(void const * const p_void_struct,
@@ -221,15 +231,7 @@ uint32_t ble_gattc_include_t_enc(void const * const p_void_struct,
                                  uint32_t           buf_len,
                                  uint32_t * const   p_index)
 {
-    uint32_t              error_code = NRF_SUCCESS;
-    ble_gattc_include_t * p_include  = (ble_gattc_include_t *) p_void_struct;
-
-    error_code = uint16_t_enc(&(p_include->handle), p_buf, buf_len, p_index);
-    SER_ASSERT(error_code == NRF_SUCCESS, error_code);
-    error_code = ble_gattc_service_t_enc(&(p_include->included_srvc), p_buf, buf_len, p_index);
-    SER_ASSERT(error_code == NRF_SUCCESS, error_code);
-
-    return error_code;
+    return ser_struct_enc(&m_include_desc, p_void_struct, p_buf, buf_len, p_index);
 }
 
 uint32_t ble_gattc_include_t_dec(uint8_t const * const p_buf,
@@ -237,15 +239,7 @@ uint32_t ble_gattc_include_t_dec(uint8_t const * const p_buf,
                                  uint32_t * const      p_index,
                                  void * const          p_void_struct)
 {
-    uint32_t              error_code = NRF_SUCCESS;
-    ble_gattc_include_t * p_include  = (ble_gattc_include_t *) p_void_struct;
-
-    error_code = uint16_t_dec(p_buf, buf_len, p_index, &(p_include->handle));
-    SER_ASSERT(error_code == NRF_SUCCESS, error_code);
-    error_code = ble_gattc_service_t_dec(p_buf, buf_len, p_index, &(p_include->included_srvc));
-    SER_ASSERT(error_code == NRF_SUCCESS, error_code);
-
-    return error_code;
+    return ser_struct_dec(&m_include_desc, p_buf, buf_len, p_index, p_void_struct);
 }
 
 uint32_t ble_gattc_evt_rel_disc_rsp_t_enc(void const * const p_void_struct,
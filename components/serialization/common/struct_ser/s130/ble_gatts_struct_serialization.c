@@ -19,22 +19,50 @@
 #include "cond_field_serialization.h"
 #include <string.h>
 
+static ser_field_desc_t const m_char_pf_fields[] =
+{
+    SER_FIELD_UINT8(ble_gatts_char_pf_t, format),
+    SER_FIELD_UINT8(ble_gatts_char_pf_t, exponent),
+    SER_FIELD_UINT16(ble_gatts_char_pf_t, unit),
+    SER_FIELD_UINT8(ble_gatts_char_pf_t, name_space),
+    SER_FIELD_UINT16(ble_gatts_char_pf_t, desc)
+};
+
+#define GATTS_CHAR_PF_ENC_LEN 7 /**< Encoded length of @ref ble_gatts_char_pf_t. */
+
+static ser_struct_desc_t const m_char_pf_desc =
+    SER_STRUCT_DESC(m_char_pf_fields, GATTS_CHAR_PF_ENC_LEN);
+SER_STRUCT_DESC_CHECK(m_char_pf_fields, GATTS_CHAR_PF_ENC_LEN, 5,
+                      SER_FIELD_UINT8_LEN(ble_gatts_char_pf_t, format) +
+                      SER_FIELD_UINT8_LEN(ble_gatts_char_pf_t, exponent) +
+                      SER_FIELD_UINT16_LEN(ble_gatts_char_pf_t, unit) +
+                      SER_FIELD_UINT8_LEN(ble_gatts_char_pf_t, name_space) +
+                      SER_FIELD_UINT16_LEN(ble_gatts_char_pf_t, desc));
+
+static ser_field_desc_t const m_char_handles_fields[] =
+{
+    SER_FIELD_UINT16(ble_gatts_char_handles_t, value_handle),
+    SER_FIELD_UINT16(ble_gatts_char_handles_t, user_desc_handle),
+    SER_FIELD_UINT16(ble_gatts_char_handles_t, cccd_handle),
+    SER_FIELD_UINT16(ble_gatts_char_handles_t, sccd_handle)
+};
+
+#define GATTS_CHAR_HANDLES_ENC_LEN 8 /**< Encoded length of @ref ble_gatts_char_handles_t. */
+
+static ser_struct_desc_t const m_char_handles_desc =
+    SER_STRUCT_DESC(m_char_handles_fields, GATTS_CHAR_HANDLES_ENC_LEN);
+SER_STRUCT_DESC_CHECK(m_char_handles_fields, GATTS_CHAR_HANDLES_ENC_LEN, 4,
+                      SER_FIELD_UINT16_LEN(ble_gatts_char_handles_t, value_handle) +
+                      SER_FIELD_UINT16_LEN(ble_gatts_char_handles_t, user_desc_handle) +
+                      SER_FIELD_UINT16_LEN(ble_gatts_char_handles_t, cccd_handle) +
+                      SER_FIELD_UINT16_LEN(ble_gatts_char_handles_t, sccd_handle));
+
 uint32_t ser_ble_gatts_char_pf_dec(uint8_t const * const p_buf,
                                    uint32_t              buf_len,
                                    uint32_t * const      p_index,
                                    void * const          p_void_char_pf)
 {
-    ble_gatts_char_pf_t * p_char_pf = (ble_gatts_char_pf_t *)p_void_char_pf;
-
-    SER_ASSERT_LENGTH_LEQ(7, buf_len - *p_index);
-
-    uint8_dec(p_buf, buf_len, p_index, &p_char_pf->format);
-    uint8_dec(p_buf, buf_len, p_index, (uint8_t *)&p_char_pf->exponent);
-    uint16_dec(p_buf, buf_len, p_index, &p_char_pf->unit);
-    uint8_dec(p_buf, buf_len, p_index, &p_char_pf->name_space);
-    uint16_dec(p_buf, buf_len, p_index, &p_char_pf->desc);
-
-    return NRF_SUCCESS;
+    return ser_struct_dec(&m_char_pf_desc, p_buf, buf_len, p_index, p_void_char_pf);
 }
 
 uint32_t ser_ble_gatts_char_pf_enc(void const * const p_void_char_pf,
@@ -42,25 +70,7 @@ uint32_t ser_ble_gatts_char_pf_enc(void const * const p_void_char_pf,
                                    uint32_t           buf_len,
                                    uint32_t * const   p_index)
 {
-    ble_gatts_char_pf_t * p_char_pf = (ble_gatts_char_pf_t *)p_void_char_pf;
-    uint32_t              err_code  = NRF_SUCCESS;
-
-    err_code = uint8_t_enc(&p_char_pf->format, p_buf, buf_len, p_index);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    err_code = uint8_t_enc(&p_char_pf->exponent, p_buf, buf_len, p_index);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    err_code = uint16_t_enc(&p_char_pf->unit, p_buf, buf_len, p_index);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    err_code = uint8_t_enc(&p_char_pf->name_space, p_buf, buf_len, p_index);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    err_code = uint16_t_enc(&p_char_pf->desc, p_buf, buf_len, p_index);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    return err_code;
+    return ser_struct_enc(&m_char_pf_desc, p_void_char_pf, p_buf, buf_len, p_index);
 }
 
 uint32_t ble_gatts_attr_md_enc(void const * const p_void_attr_md,
@@ -89,7 +99,7 @@ uint32_t ble_gatts_attr_md_enc(void const * const p_void_attr_md,
             (p_attr_md->rd_auth << 3) |
             (p_attr_md->wr_auth << 4);
 
-    SER_ASSERT_LENGTH_LEQ(1, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
     p_buf[*p_index] = temp8;
     *p_index       += 1;
 
@@ -111,7 +121,7 @@ uint32_t ble_gatts_attr_md_dec(uint8_t const * const p_buf,
     err_code = ble_gap_conn_sec_mode_dec(p_buf, buf_len, p_index, &p_attr_md->write_perm);
     SER_ASSERT(err_code == NRF_SUCCESS, err_code);
 
-    SER_ASSERT_LENGTH_LEQ(1, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
     uint8_dec(p_buf, buf_len, p_index, &temp8);
 
     p_attr_md->vlen    = temp8;
@@ -190,7 +200,7 @@ uint32_t ble_gatts_char_md_dec(uint8_t const * const p_buf,
 
     ble_gatts_char_md_t * p_char_md = (ble_gatts_char_md_t *)p_void_char_md;
 
-    SER_ASSERT_LENGTH_LEQ(2, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(2, *p_index, buf_len);
     uint8_t temp8 = p_buf[*p_index];
 
     p_char_md->char_props.broadcast      = temp8 >> 0;
@@ -207,7 +217,7 @@ uint32_t ble_gatts_char_md_dec(uint8_t const * const p_buf,
 
     *p_index += 2;
 
-    SER_ASSERT_LENGTH_LEQ(2, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(2, *p_index, buf_len);
     uint16_dec(p_buf, buf_len, p_index, &p_char_md->char_user_desc_max_size);
 
     err_code = len16data_dec(p_buf,
@@ -303,7 +313,7 @@ uint32_t ble_gatts_attr_dec(uint8_t const * const p_buf,
                               ble_gatts_attr_md_dec);
     SER_ASSERT(err_code == NRF_SUCCESS, err_code);
 
-    SER_ASSERT_LENGTH_LEQ(4, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(4, *p_index, buf_len);
     uint16_dec(p_buf, buf_len, p_index, &p_gatts_attr->init_offs);
     uint16_dec(p_buf, buf_len, p_index, &p_gatts_attr->max_len);
 
@@ -323,22 +333,7 @@ uint32_t ble_gatts_char_handles_enc(void const * const p_void_char_handles,
                                     uint32_t           buf_len,
                                     uint32_t * const   p_index)
 {
-    ble_gatts_char_handles_t * p_char_handles = (ble_gatts_char_handles_t *)p_void_char_handles;
-    uint32_t                   err_code       = NRF_SUCCESS;
-
-    err_code = uint16_t_enc(&p_char_handles->value_handle, p_buf, buf_len, p_index);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    err_code = uint16_t_enc(&p_char_handles->user_desc_handle, p_buf, buf_len, p_index);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    err_code = uint16_t_enc(&p_char_handles->cccd_handle, p_buf, buf_len, p_index);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    err_code = uint16_t_enc(&p_char_handles->sccd_handle, p_buf, buf_len, p_index);
-    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
-
-    return err_code;
+    return ser_struct_enc(&m_char_handles_desc, p_void_char_handles, p_buf, buf_len, p_index);
 }
 
 uint32_t ble_gatts_char_handles_dec(uint8_t const * const p_buf,
@@ -346,15 +341,7 @@ uint32_t ble_gatts_char_handles_dec(uint8_t const * const p_buf,
                                     uint32_t * const      p_index,
                                     void * const          p_void_char_handles)
 {
-    ble_gatts_char_handles_t * p_char_handles = (ble_gatts_char_handles_t *)p_void_char_handles;
-
-    SER_ASSERT_LENGTH_LEQ(8, buf_len - *p_index);
-    uint16_dec(p_buf, buf_len, p_index, &(p_char_handles->value_handle));
-    uint16_dec(p_buf, buf_len, p_index, &p_char_handles->user_desc_handle);
-    uint16_dec(p_buf, buf_len, p_index, &p_char_handles->cccd_handle);
-    uint16_dec(p_buf, buf_len, p_index, &p_char_handles->sccd_handle);
-
-    return NRF_SUCCESS;
+    return ser_struct_dec(&m_char_handles_desc, p_buf, buf_len, p_index, p_void_char_handles);
 }
 
 uint32_t ble_gatts_hvx_params_t_enc(void const * const p_void_hvx_params,
@@ -366,7 +353,7 @@ uint32_t ble_gatts_hvx_params_t_enc(void const * const p_void_hvx_params,
 
     uint32_t err_code = NRF_SUCCESS;
 
-    SER_ASSERT_LENGTH_LEQ(2 + 1 + 2, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(2 + 1 + 2, *p_index, buf_len);
 
     err_code = uint16_t_enc(&p_hvx_params->handle, p_buf, buf_len, p_index);
     SER_ASSERT(err_code == NRF_SUCCESS, err_code);
@@ -379,7 +366,7 @@ uint32_t ble_gatts_hvx_params_t_enc(void const * const p_void_hvx_params,
 
     if (p_hvx_params->p_len != NULL)
     {
-        SER_ASSERT_LENGTH_LEQ(1, buf_len - *p_index);
+        SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
         p_buf[(*p_index)++] = SER_FIELD_PRESENT;
 
         err_code = uint16_t_enc(p_hvx_params->p_len, p_buf, buf_len, p_index);
@@ -388,10 +375,10 @@ uint32_t ble_gatts_hvx_params_t_enc(void const * const p_void_hvx_params,
 
     if (p_hvx_params->p_data != NULL)
     {
-        SER_ASSERT_LENGTH_LEQ(1, buf_len - *p_index);
+        SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
         p_buf[(*p_index)++] = SER_FIELD_PRESENT;
 
-        SER_ASSERT_LENGTH_LEQ(*p_hvx_params->p_len, buf_len - *p_index);
+        SER_ASSERT_LENGTH_LEFT(*p_hvx_params->p_len, *p_index, buf_len);
         memcpy(&p_buf[*p_index], p_hvx_params->p_data, *p_hvx_params->p_len);
         *p_index += *p_hvx_params->p_len;
     }
@@ -408,7 +395,7 @@ uint32_t ble_gatts_hvx_params_t_dec(uint8_t const * const p_buf,
 
     uint32_t err_code = NRF_SUCCESS;
 
-    SER_ASSERT_LENGTH_LEQ(2 + 1 + 2, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(2 + 1 + 2, *p_index, buf_len);
     uint16_dec(p_buf, buf_len, p_index, &p_hvx_params->handle);
     uint8_dec(p_buf, buf_len, p_index, &p_hvx_params->type);
     uint16_dec(p_buf, buf_len, p_index, &p_hvx_params->offset);
@@ -462,7 +449,7 @@ uint32_t ble_gatts_attr_context_t_dec(uint8_t const * const p_buf,
     error_code = ble_uuid_t_dec(p_buf, buf_len, p_index, &(p_context->desc_uuid));
     SER_ASSERT(error_code == NRF_SUCCESS, error_code);
 
-    SER_ASSERT_LENGTH_LEQ(5, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(5, *p_index, buf_len);
     uint16_dec(p_buf, buf_len, p_index, &(p_context->srvc_handle));
     uint16_dec(p_buf, buf_len, p_index, &(p_context->value_handle));
     uint8_dec(p_buf, buf_len, p_index, &(p_context->type));
@@ -489,7 +476,7 @@ uint32_t ble_gatts_evt_write_t_enc(void const * const p_void_write,
     uint16_t data_len = p_write->len;
     error_code = uint16_t_enc(&data_len, p_buf, buf_len, p_index);
     SER_ASSERT(error_code == NRF_SUCCESS, error_code);
-    SER_ASSERT_LENGTH_LEQ(data_len, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(data_len, *p_index, buf_len);
     memcpy(&p_buf[*p_index], p_write->data, data_len);
     *p_index += data_len;
 
@@ -547,7 +534,7 @@ uint32_t ble_gatts_evt_write_t_dec(uint8_t const * const p_buf,
         p_write->offset = offset;
         p_write->len    = len;
 
-        SER_ASSERT_LENGTH_LEQ(p_write->len, buf_len - *p_index);
+        SER_ASSERT_LENGTH_LEFT(p_write->len, *p_index, buf_len);
         memcpy(p_write->data, &p_buf[*p_index], p_write->len);
     }
 
@@ -773,15 +760,15 @@ uint32_t ble_gatts_read_authorize_params_t_dec(uint8_t const * const p_buf,
         (ble_gatts_read_authorize_params_t *) p_void_struct;
     uint32_t error_code = NRF_SUCCESS;
 
-    SER_ASSERT_LENGTH_LEQ(2, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(2, *p_index, buf_len);
     uint16_dec(p_buf, buf_len, p_index, &p_params->gatt_status);
 
     uint8_t temp_val;
-    SER_ASSERT_LENGTH_LEQ(1, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
     uint8_dec(p_buf, buf_len, p_index, &temp_val);
     p_params->update = temp_val;
 
-    SER_ASSERT_LENGTH_LEQ(2, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(2, *p_index, buf_len);
     uint16_dec(p_buf, buf_len, p_index, &p_params->offset);
 
     error_code = len16data_dec(p_buf, buf_len, p_index, &p_params->p_data, &p_params->len);
@@ -814,7 +801,7 @@ uint32_t ble_gatts_write_authorize_params_t_dec(uint8_t const * const p_buf,
         (ble_gatts_write_authorize_params_t *) p_void_struct;
     uint32_t error_code = NRF_SUCCESS;
 
-    SER_ASSERT_LENGTH_LEQ(2, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(2, *p_index, buf_len);
     uint16_dec(p_buf, buf_len, p_index, &p_params->gatt_status);
 
     return error_code;
@@ -861,7 +848,7 @@ uint32_t ble_gatts_rw_authorize_reply_params_t_dec(uint8_t const * const p_buf,
         (ble_gatts_rw_authorize_reply_params_t *) p_void_struct;
     uint32_t error_code = NRF_SUCCESS;
 
-    SER_ASSERT_LENGTH_LEQ(1, buf_len - *p_index);
+    SER_ASSERT_LENGTH_LEFT(1, *p_index, buf_len);
     uint8_dec(p_buf, buf_len, p_index, &(p_params->type));
 
     if (p_params->type == BLE_GATTS_AUTHORIZE_TYPE_READ)
@@ -11,7 +11,12 @@
  */
 
 #include "ble_types.h"
+#include "cond_field_serialization.h"
 
+#define BLE_UUID_T_ENC_LEN 3 /**< Encoded length of @ref ble_uuid_t. */
+
+/**@brief Descriptor of @ref ble_uuid_t, for nesting in other structure descriptors. */
+extern ser_struct_desc_t const ble_uuid_t_desc;
 
 uint32_t ble_uuid_t_enc(void const * const p_void_uuid,
                         uint8_t * const    p_buf,
@@ -26,9 +26,7 @@ typedef enum
     HAL_TRANSP_RX_STATE_IDLE,
     HAL_TRANSP_RX_STATE_RECEIVING,
     HAL_TRANSP_RX_STATE_DROPPING,
-    HAL_TRANSP_RX_STATE_RECEIVED,
-    HAL_TRANSP_RX_STATE_RECEIVED_PENDING_BUF_REQ,
-    HAL_TRANSP_RX_STATE_RECEIVED_DROPPING,
+    HAL_TRANSP_RX_STATE_PENDING_BUF_REQ,
     HAL_TRANSP_RX_STATE_MAX
 }ser_hal_transp_rx_states_t;
 
@@ -39,12 +37,23 @@ typedef enum
 {
     HAL_TRANSP_TX_STATE_CLOSED = 0,
     HAL_TRANSP_TX_STATE_IDLE,
-    HAL_TRANSP_TX_STATE_TX_ALLOCATED,
     HAL_TRANSP_TX_STATE_TRANSMITTING,
-    HAL_TRANSP_TX_STATE_TRANSMITTED,
     HAL_TRANSP_TX_STATE_MAX
 }ser_hal_transp_tx_states_t;
 
+/**
+ * @brief States of a buffer.
+ */
+typedef enum
+{
+    HAL_TRANSP_BUF_STATE_FREE = 0,
+    HAL_TRANSP_BUF_STATE_TX_ALLOCATED,
+    HAL_TRANSP_BUF_STATE_TX_QUEUED,
+    HAL_TRANSP_BUF_STATE_RX_RECEIVING,
+    HAL_TRANSP_BUF_STATE_RX_RECEIVED,
+    HAL_TRANSP_BUF_STATE_MAX
+}ser_hal_transp_buf_states_t;
+
 /**
  * @brief RX state.
  */
@@ -55,13 +64,44 @@ static ser_hal_transp_rx_states_t m_rx_state = HAL_TRANSP_RX_STATE_CLOSED;
 static ser_hal_transp_tx_states_t m_tx_state = HAL_TRANSP_TX_STATE_CLOSED;
 
 /**
- * @brief Transmission buffer.
+ * @brief Transmission buffers.
+ */
+static uint8_t m_tx_buffer[SER_HAL_TRANSPORT_TX_BUF_COUNT][SER_HAL_TRANSPORT_TX_MAX_PKT_SIZE];
+/**
+ * @brief States of the transmission buffers.
+ */
+static ser_hal_transp_buf_states_t m_tx_buf_state[SER_HAL_TRANSPORT_TX_BUF_COUNT];
+/**
+ * @brief Lengths of the packets in the transmission buffers.
+ */
+static uint16_t m_tx_buf_len[SER_HAL_TRANSPORT_TX_BUF_COUNT];
+/**
+ * @brief Transmission queue, indexes of buffers in the order they are transmitted. The buffer at
+ *        the head of the queue is being transmitted when the TX state is
+ *        HAL_TRANSP_TX_STATE_TRANSMITTING.
+ */
+static uint8_t m_tx_queue[SER_HAL_TRANSPORT_TX_BUF_COUNT];
+/**
+ * @brief Position of the head of the transmission queue.
+ */
+static uint8_t m_tx_queue_head = 0;
+/**
+ * @brief Number of buffers in the transmission queue.
+ */
+static volatile uint8_t m_tx_queue_count = 0;
+
+/**
+ * @brief Reception buffers.
+ */
+static uint8_t m_rx_buffer[SER_HAL_TRANSPORT_RX_BUF_COUNT][SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE];
+/**
+ * @brief States of the reception buffers.
  */
-static uint8_t m_tx_buffer[SER_HAL_TRANSPORT_TX_MAX_PKT_SIZE];
+static ser_hal_transp_buf_states_t m_rx_buf_state[SER_HAL_TRANSPORT_RX_BUF_COUNT];
 /**
- * @brief Reception buffer.
+ * @brief Index of the reception buffer a packet is being received to.
  */
-static uint8_t m_rx_buffer[SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE];
+static uint8_t m_rx_buf_idx = 0;
 
 /**
  * @brief Callback function handler for Serialization HAL Transport layer events.
@@ -69,6 +109,153 @@ static uint8_t m_rx_buffer[SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE];
 static ser_hal_transport_events_handler_t m_events_handler = NULL;
 
 
+/**
+ * @brief A function for resetting the states of all buffers.
+ */
+static void buffers_reset(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < SER_HAL_TRANSPORT_TX_BUF_COUNT; i++)
+    {
+        m_tx_buf_state[i] = HAL_TRANSP_BUF_STATE_FREE;
+    }
+    for (i = 0; i < SER_HAL_TRANSPORT_RX_BUF_COUNT; i++)
+    {
+        m_rx_buf_state[i] = HAL_TRANSP_BUF_STATE_FREE;
+    }
+    m_tx_queue_head  = 0;
+    m_tx_queue_count = 0;
+}
+
+
+/**
+ * @brief A function for finding the TX buffer starting at a given address.
+ *
+ * @return Index of the buffer, SER_HAL_TRANSPORT_TX_BUF_COUNT if the address is not the start of
+ *         a TX buffer.
+ */
+static uint32_t tx_buf_idx_get(const uint8_t * p_buffer)
+{
+    uint32_t i;
+
+    for (i = 0; i < SER_HAL_TRANSPORT_TX_BUF_COUNT; i++)
+    {
+        if (p_buffer == m_tx_buffer[i])
+        {
+            break;
+        }
+    }
+    return i;
+}
+
+
+/**
+ * @brief A function for finding the RX buffer starting at a given address.
+ *
+ * @return Index of the buffer, SER_HAL_TRANSPORT_RX_BUF_COUNT if the address is not the start of
+ *         an RX buffer.
+ */
+static uint32_t rx_buf_idx_get(const uint8_t * p_buffer)
+{
+    uint32_t i;
+
+    for (i = 0; i < SER_HAL_TRANSPORT_RX_BUF_COUNT; i++)
+    {
+        if (p_buffer == m_rx_buffer[i])
+        {
+            break;
+        }
+    }
+    return i;
+}
+
+
+/**
+ * @brief A function for handing the packet at the head of the transmission queue to the PHY
+ *        layer. Must be called with PHY interrupts disabled or from the PHY interrupt context.
+ */
+static uint32_t tx_queue_head_send(void)
+{
+    uint32_t err_code = NRF_SUCCESS;
+    uint8_t  idx;
+
+    if ((HAL_TRANSP_TX_STATE_IDLE == m_tx_state) && (m_tx_queue_count != 0))
+    {
+        idx      = m_tx_queue[m_tx_queue_head];
+        err_code = ser_phy_tx_pkt_send(m_tx_buffer[idx], m_tx_buf_len[idx]);
+
+        if (NRF_SUCCESS == err_code)
+        {
+            m_tx_state = HAL_TRANSP_TX_STATE_TRANSMITTING;
+        }
+    }
+
+    return err_code;
+}
+
+
+/**
+ * @brief A function for releasing the packet at the head of the transmission queue once it has
+ *        been transmitted, and starting transmission of the next one.
+ */
+static void tx_queue_head_release(void)
+{
+    uint32_t err_code;
+
+    m_tx_buf_state[m_tx_queue[m_tx_queue_head]] = HAL_TRANSP_BUF_STATE_FREE;
+    m_tx_queue_head  = (m_tx_queue_head + 1) % SER_HAL_TRANSPORT_TX_BUF_COUNT;
+    m_tx_queue_count--;
+    m_tx_state       = HAL_TRANSP_TX_STATE_IDLE;
+
+    err_code = tx_queue_head_send();
+    APP_ERROR_CHECK(err_code);
+}
+
+
+/**
+ * @brief A function for setting a free RX buffer for the packet the PHY layer is waiting to
+ *        receive. Must be called with PHY interrupts disabled or from the PHY interrupt context.
+ *
+ * @retval NRF_SUCCESS       A buffer was set, the packet is being received.
+ * @retval NRF_ERROR_NO_MEM  No buffer is free, the PHY layer keeps waiting.
+ */
+static uint32_t rx_buf_set(void)
+{
+    uint32_t err_code;
+    uint32_t idx;
+
+    for (idx = 0; idx < SER_HAL_TRANSPORT_RX_BUF_COUNT; idx++)
+    {
+        if (HAL_TRANSP_BUF_STATE_FREE == m_rx_buf_state[idx])
+        {
+            break;
+        }
+    }
+
+    if (idx == SER_HAL_TRANSPORT_RX_BUF_COUNT)
+    {
+        m_rx_state = HAL_TRANSP_RX_STATE_PENDING_BUF_REQ;
+        return NRF_ERROR_NO_MEM;
+    }
+
+    err_code = ser_phy_rx_buf_set(m_rx_buffer[idx]);
+
+    if (NRF_SUCCESS == err_code)
+    {
+        m_rx_buf_state[idx] = HAL_TRANSP_BUF_STATE_RX_RECEIVING;
+        m_rx_buf_idx        = (uint8_t)idx;
+        m_rx_state          = HAL_TRANSP_RX_STATE_RECEIVING;
+    }
+    else
+    {
+        err_code = NRF_ERROR_INTERNAL;
+    }
+
+    return err_code;
+}
+
+
 /**
  * @brief A callback function to be used to handle a PHY module events. This function is called in
  *        an interrupt context.
@@ -87,9 +274,8 @@ static void phy_events_handler(ser_phy_evt_t phy_event)
         {
             if (HAL_TRANSP_TX_STATE_TRANSMITTING == m_tx_state)
             {
-                m_tx_state = HAL_TRANSP_TX_STATE_TRANSMITTED;
-                err_code   = ser_hal_transport_tx_pkt_free(m_tx_buffer);
-                APP_ERROR_CHECK(err_code);
+                /* Release the buffer and start transmitting the next queued packet, if any. */
+                tx_queue_head_release();
                 /* An event to an upper layer that a packet has been transmitted. */
                 hal_transp_event.evt_type = SER_HAL_TRANSP_EVT_TX_PKT_SENT;
                 m_events_handler(hal_transp_event);
@@ -107,51 +293,32 @@ static void phy_events_handler(ser_phy_evt_t phy_event)
             /* An event to an upper layer that a packet is being scheduled to receive or to drop. */
             hal_transp_event.evt_type = SER_HAL_TRANSP_EVT_RX_PKT_RECEIVING;
 
+            if (HAL_TRANSP_RX_STATE_IDLE != m_rx_state)
+            {
+                /* Lower layer should not generate this event in current state. */
+                APP_ERROR_CHECK_BOOL(false);
+            }
             /* Receive or drop a packet. */
-            if (phy_event.evt_params.rx_buf_request.num_of_bytes <= sizeof (m_rx_buffer))
+            else if (phy_event.evt_params.rx_buf_request.num_of_bytes <=
+                     SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE)
             {
-                if (HAL_TRANSP_RX_STATE_IDLE == m_rx_state)
+                m_events_handler(hal_transp_event);
+
+                /* If all buffers are in use, the packet is received when a buffer is freed. It is
+                 * OK to get know higher layer at this point that we are going to receive it. */
+                err_code = rx_buf_set();
+                if (NRF_ERROR_NO_MEM != err_code)
                 {
-                    m_events_handler(hal_transp_event);
-                    err_code = ser_phy_rx_buf_set(m_rx_buffer);
                     APP_ERROR_CHECK(err_code);
-                    m_rx_state = HAL_TRANSP_RX_STATE_RECEIVING;
-                }
-                else if (HAL_TRANSP_RX_STATE_RECEIVED == m_rx_state)
-                {
-                    /* It is OK to get know higher layer at this point that we are going to receive
-                     * a new packet even though we will start receiving when rx buffer is freed. */
-                    m_events_handler(hal_transp_event);
-                    m_rx_state = HAL_TRANSP_RX_STATE_RECEIVED_PENDING_BUF_REQ;
-                }
-                else
-                {
-                    /* Lower layer should not generate this event in current state. */
-                    APP_ERROR_CHECK_BOOL(false);
                 }
             }
             else
             {
                 /* There is not enough memory but packet has to be received to dummy location. */
-                if (HAL_TRANSP_RX_STATE_IDLE == m_rx_state)
-                {
-                    m_events_handler(hal_transp_event);
-                    err_code = ser_phy_rx_buf_set(NULL);
-                    APP_ERROR_CHECK(err_code);
-                    m_rx_state = HAL_TRANSP_RX_STATE_DROPPING;
-                }
-                else if (HAL_TRANSP_RX_STATE_RECEIVED == m_rx_state)
-                {
-                    m_events_handler(hal_transp_event);
-                    err_code = ser_phy_rx_buf_set(NULL);
-                    APP_ERROR_CHECK(err_code);
-                    m_rx_state = HAL_TRANSP_RX_STATE_RECEIVED_DROPPING;
-                }
-                else
-                {
-                    /* Lower layer should not generate this event in current state. */
-                    APP_ERROR_CHECK_BOOL(false);
-                }
+                m_events_handler(hal_transp_event);
+                err_code = ser_phy_rx_buf_set(NULL);
+                APP_ERROR_CHECK(err_code);
+                m_rx_state = HAL_TRANSP_RX_STATE_DROPPING;
             }
             break;
         }
@@ -160,7 +327,10 @@ static void phy_events_handler(ser_phy_evt_t phy_event)
         {
             if (HAL_TRANSP_RX_STATE_RECEIVING == m_rx_state)
             {
-                m_rx_state = HAL_TRANSP_RX_STATE_RECEIVED;
+                /* The buffer is held by an upper layer until freed, the next packet can be
+                 * received to another buffer in the meantime. */
+                m_rx_buf_state[m_rx_buf_idx] = HAL_TRANSP_BUF_STATE_RX_RECEIVED;
+                m_rx_state                   = HAL_TRANSP_RX_STATE_IDLE;
                 /* Generate the event to an upper layer. */
                 hal_transp_event.evt_type =
                     SER_HAL_TRANSP_EVT_RX_PKT_RECEIVED;
@@ -187,13 +357,6 @@ static void phy_events_handler(ser_phy_evt_t phy_event)
                 m_events_handler(hal_transp_event);
                 m_rx_state = HAL_TRANSP_RX_STATE_IDLE;
             }
-            else if (HAL_TRANSP_RX_STATE_RECEIVED_DROPPING == m_rx_state)
-            {
-                /* Generate the event to an upper layer. */
-                hal_transp_event.evt_type = SER_HAL_TRANSP_EVT_RX_PKT_DROPPED;
-                m_events_handler(hal_transp_event);
-                m_rx_state = HAL_TRANSP_RX_STATE_RECEIVED;
-            }
             else
             {
                 /* Lower layer should not generate this event in current state. */
@@ -230,18 +393,18 @@ static void phy_events_handler(ser_phy_evt_t phy_event)
                 SER_HAL_TRANSP_PHY_ERROR_HW_ERROR;
             hal_transp_event.evt_params.phy_error.hw_error_code =
                 phy_event.evt_params.hw_error.error_code;
-            if (HAL_TRANSP_TX_STATE_TRANSMITTING == m_tx_state)
+            if ((HAL_TRANSP_TX_STATE_TRANSMITTING == m_tx_state) &&
+                (phy_event.evt_params.hw_error.p_buffer ==
+                 m_tx_buffer[m_tx_queue[m_tx_queue_head]]))
             {
-                m_tx_state = HAL_TRANSP_TX_STATE_TRANSMITTED;
-                err_code   = ser_hal_transport_tx_pkt_free(phy_event.evt_params.hw_error.p_buffer);
-                APP_ERROR_CHECK(err_code);
-                /* An event to an upper layer that a packet has been transmitted. */
+                /* The packet is lost, go on with the next queued one. */
+                tx_queue_head_release();
             }
-            else if (HAL_TRANSP_RX_STATE_RECEIVING == m_rx_state)
+            else if ((HAL_TRANSP_RX_STATE_RECEIVING == m_rx_state) &&
+                     (phy_event.evt_params.hw_error.p_buffer == m_rx_buffer[m_rx_buf_idx]))
             {
-                m_rx_state = HAL_TRANSP_RX_STATE_RECEIVED;
-                err_code   = ser_hal_transport_rx_pkt_free(phy_event.evt_params.hw_error.p_buffer);
-                APP_ERROR_CHECK(err_code);
+                m_rx_buf_state[m_rx_buf_idx] = HAL_TRANSP_BUF_STATE_FREE;
+                m_rx_state                   = HAL_TRANSP_RX_STATE_IDLE;
             }
             m_events_handler(hal_transp_event);
 
@@ -273,6 +436,7 @@ uint32_t ser_hal_transport_open(ser_hal_transport_events_handler_t events_handle
         /* We have to change states before calling lower layer because ser_phy_open() function is
          * going to enable interrupts. On success an event from PHY layer can be emitted immediately
          * after return from ser_phy_open(). */
+        buffers_reset();
         m_rx_state = HAL_TRANSP_RX_STATE_IDLE;
         m_tx_state = HAL_TRANSP_TX_STATE_IDLE;
 
@@ -304,6 +468,7 @@ void ser_hal_transport_close(void)
     ser_phy_interrupts_disable();
     m_rx_state = HAL_TRANSP_RX_STATE_CLOSED;
     m_tx_state = HAL_TRANSP_TX_STATE_CLOSED;
+    buffers_reset();
 
     m_events_handler = NULL;
 
@@ -314,6 +479,7 @@ void ser_hal_transport_close(void)
 uint32_t ser_hal_transport_rx_pkt_free(uint8_t * p_buffer)
 {
     uint32_t err_code = NRF_SUCCESS;
+    uint32_t idx      = rx_buf_idx_get(p_buffer);
 
     ser_phy_interrupts_disable();
 
@@ -321,29 +487,18 @@ uint32_t ser_hal_transport_rx_pkt_free(uint8_t * p_buffer)
     {
         err_code = NRF_ERROR_NULL;
     }
-    else if (p_buffer != m_rx_buffer)
+    else if (idx == SER_HAL_TRANSPORT_RX_BUF_COUNT)
     {
         err_code = NRF_ERROR_INVALID_ADDR;
     }
-    else if (HAL_TRANSP_RX_STATE_RECEIVED == m_rx_state)
+    else if (HAL_TRANSP_BUF_STATE_RX_RECEIVED == m_rx_buf_state[idx])
     {
-        m_rx_state = HAL_TRANSP_RX_STATE_IDLE;
-    }
-    else if (HAL_TRANSP_RX_STATE_RECEIVED_DROPPING == m_rx_state)
-    {
-        m_rx_state = HAL_TRANSP_RX_STATE_DROPPING;
-    }
-    else if (HAL_TRANSP_RX_STATE_RECEIVED_PENDING_BUF_REQ == m_rx_state)
-    {
-        err_code = ser_phy_rx_buf_set(m_rx_buffer);
+        m_rx_buf_state[idx] = HAL_TRANSP_BUF_STATE_FREE;
 
-        if (NRF_SUCCESS == err_code)
+        if (HAL_TRANSP_RX_STATE_PENDING_BUF_REQ == m_rx_state)
         {
-            m_rx_state = HAL_TRANSP_RX_STATE_RECEIVING;
-        }
-        else
-        {
-            err_code = NRF_ERROR_INTERNAL;
+            /* The PHY layer is waiting for a buffer, resume reception. */
+            err_code = rx_buf_set();
         }
     }
     else
@@ -360,6 +515,7 @@ uint32_t ser_hal_transport_rx_pkt_free(uint8_t * p_buffer)
 uint32_t ser_hal_transport_tx_pkt_alloc(uint8_t * * pp_memory, uint16_t * p_num_of_bytes)
 {
     uint32_t err_code = NRF_SUCCESS;
+    uint32_t idx;
 
     if ((NULL == pp_memory) || (NULL == p_num_of_bytes))
     {
@@ -369,15 +525,30 @@ uint32_t ser_hal_transport_tx_pkt_alloc(uint8_t * * pp_memory, uint16_t * p_num_
     {
         err_code = NRF_ERROR_INVALID_STATE;
     }
-    else if (HAL_TRANSP_TX_STATE_IDLE == m_tx_state)
-    {
-        m_tx_state      = HAL_TRANSP_TX_STATE_TX_ALLOCATED;
-        *pp_memory      = &m_tx_buffer[0];
-        *p_num_of_bytes = (uint16_t)sizeof (m_tx_buffer);
-    }
     else
     {
-        err_code = NRF_ERROR_NO_MEM;
+        ser_phy_interrupts_disable();
+
+        for (idx = 0; idx < SER_HAL_TRANSPORT_TX_BUF_COUNT; idx++)
+        {
+            if (HAL_TRANSP_BUF_STATE_FREE == m_tx_buf_state[idx])
+            {
+                break;
+            }
+        }
+
+        if (idx < SER_HAL_TRANSPORT_TX_BUF_COUNT)
+        {
+            m_tx_buf_state[idx] = HAL_TRANSP_BUF_STATE_TX_ALLOCATED;
+            *pp_memory          = &m_tx_buffer[idx][0];
+            *p_num_of_bytes     = (uint16_t)SER_HAL_TRANSPORT_TX_MAX_PKT_SIZE;
+        }
+        else
+        {
+            err_code = NRF_ERROR_NO_MEM;
+        }
+
+        ser_phy_interrupts_enable();
     }
 
     return err_code;
@@ -387,6 +558,7 @@ uint32_t ser_hal_transport_tx_pkt_alloc(uint8_t * * pp_memory, uint16_t * p_num_
 uint32_t ser_hal_transport_tx_pkt_send(const uint8_t * p_buffer, uint16_t num_of_bytes)
 {
     uint32_t err_code = NRF_SUCCESS;
+    uint32_t idx      = tx_buf_idx_get(p_buffer);
 
     /* The buffer provided to this function must be allocated through ser_hal_transport_tx_alloc()
      * function - this assures correct state and that correct memory buffer is used. */
@@ -398,25 +570,35 @@ uint32_t ser_hal_transport_tx_pkt_send(const uint8_t * p_buffer, uint16_t num_of
     {
         err_code = NRF_ERROR_INVALID_PARAM;
     }
-    else if (p_buffer != m_tx_buffer)
+    else if (idx == SER_HAL_TRANSPORT_TX_BUF_COUNT)
     {
         err_code = NRF_ERROR_INVALID_ADDR;
     }
-    else if (num_of_bytes > sizeof (m_tx_buffer))
+    else if (num_of_bytes > SER_HAL_TRANSPORT_TX_MAX_PKT_SIZE)
     {
         err_code = NRF_ERROR_DATA_SIZE;
     }
-    else if (HAL_TRANSP_TX_STATE_TX_ALLOCATED == m_tx_state)
+    else if ((HAL_TRANSP_TX_STATE_CLOSED != m_tx_state) &&
+             (HAL_TRANSP_BUF_STATE_TX_ALLOCATED == m_tx_buf_state[idx]))
     {
         ser_phy_interrupts_disable();
-        err_code = ser_phy_tx_pkt_send(p_buffer, num_of_bytes);
 
-        if (NRF_SUCCESS == err_code)
-        {
-            m_tx_state = HAL_TRANSP_TX_STATE_TRANSMITTING;
-        }
-        else
+        /* Add the packet to the transmission queue. It is sent immediately if the PHY layer is
+         * idle, otherwise when the packets queued before it have been sent. */
+        m_tx_buf_len[idx]   = num_of_bytes;
+        m_tx_buf_state[idx] = HAL_TRANSP_BUF_STATE_TX_QUEUED;
+        m_tx_queue[(m_tx_queue_head + m_tx_queue_count) % SER_HAL_TRANSPORT_TX_BUF_COUNT] =
+            (uint8_t)idx;
+        m_tx_queue_count++;
+
+        err_code = tx_queue_head_send();
+
+        if (NRF_SUCCESS != err_code)
         {
+            /* The queue was empty, so the packet is the only one in it. */
+            m_tx_queue_count--;
+            m_tx_buf_state[idx] = HAL_TRANSP_BUF_STATE_TX_ALLOCATED;
+
             if (NRF_ERROR_BUSY != err_code)
             {
                 err_code = NRF_ERROR_INTERNAL;
@@ -436,20 +618,20 @@ uint32_t ser_hal_transport_tx_pkt_send(const uint8_t * p_buffer, uint16_t num_of
 uint32_t ser_hal_transport_tx_pkt_free(uint8_t * p_buffer)
 {
     uint32_t err_code = NRF_SUCCESS;
+    uint32_t idx      = tx_buf_idx_get(p_buffer);
 
     if (NULL == p_buffer)
     {
         err_code = NRF_ERROR_NULL;
     }
-    else if (p_buffer != m_tx_buffer)
+    else if (idx == SER_HAL_TRANSPORT_TX_BUF_COUNT)
     {
         err_code = NRF_ERROR_INVALID_ADDR;
     }
-    else if ((HAL_TRANSP_TX_STATE_TX_ALLOCATED == m_tx_state) ||
-             (HAL_TRANSP_TX_STATE_TRANSMITTED == m_tx_state))
+    else if (HAL_TRANSP_BUF_STATE_TX_ALLOCATED == m_tx_buf_state[idx])
     {
-        /* Release TX buffer for use. */
-        m_tx_state = HAL_TRANSP_TX_STATE_IDLE;
+        /* Release TX buffer for use. Queued buffers are released once transmitted. */
+        m_tx_buf_state[idx] = HAL_TRANSP_BUF_STATE_FREE;
     }
     else
     {
@@ -458,3 +640,9 @@ uint32_t ser_hal_transport_tx_pkt_free(uint8_t * p_buffer)
 
     return err_code;
 }
+
+
+bool ser_hal_transport_tx_is_busy(void)
+{
+    return (m_tx_queue_count != 0);
+}
@@ -35,6 +35,7 @@
 #define SER_HAL_TRANSPORT_H__
 
 #include <stdint.h>
+#include <stdbool.h>
 
 
 /**@brief Serialization HAL Transport layer event types. */
@@ -227,5 +228,13 @@ uint32_t ser_hal_transport_tx_pkt_send(const uint8_t * p_buffer, uint16_t num_of
 uint32_t ser_hal_transport_tx_pkt_free(uint8_t * p_buffer);
 
 
+/**@brief A function for checking if packets are waiting to be transmitted or being transmitted.
+ *
+ * @retval true     The transmission queue is not empty.
+ * @retval false    The transmission queue is empty.
+ */
+bool ser_hal_transport_tx_is_busy(void);
+
+
 #endif /* SER_HAL_TRANSPORT_H__ */
 /** @} */
@@ -162,6 +162,9 @@ typedef struct
 _static uint8_t m_tx_packet_header[PKT_HDR_SIZE];
 _static uint8_t m_tx_packet_crc[PKT_CRC_SIZE];
 _static uint8_t m_tx_ack_packet[PKT_HDR_SIZE];
+#if SER_PHY_HCI_ERROR_INJECTION_INTERVAL
+static uint32_t m_tx_error_injection_count = 0; // Packets sent since the last corrupted one
+#endif
 #ifdef HCI_LINK_CONTROL
 _static uint8_t m_tx_link_control_header[PKT_HDR_SIZE];
 _static uint8_t m_tx_link_control_payload[HCI_PKT_CONFIG_SIZE - PKT_HDR_SIZE];
@@ -827,6 +830,15 @@ static void hci_pkt_send(void)
     crc = crc16_compute(m_p_tx_payload, m_tx_payload_length, &crc);
     (void)uint16_encode(crc, m_tx_packet_crc);
 
+#if SER_PHY_HCI_ERROR_INJECTION_INTERVAL
+    if (++m_tx_error_injection_count == SER_PHY_HCI_ERROR_INJECTION_INTERVAL)
+    {
+        // Flip a bit of the CRC, the peer drops the packet and it is retransmitted on timeout.
+        m_tx_error_injection_count = 0;
+        m_tx_packet_crc[0]        ^= 0x01;
+    }
+#endif
+
     ser_phy_hci_pkt_params_t pkt_header;
     ser_phy_hci_pkt_params_t pkt_payload;
     ser_phy_hci_pkt_params_t pkt_crc;
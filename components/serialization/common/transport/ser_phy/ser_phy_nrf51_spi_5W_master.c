@@ -20,6 +20,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include "app_util.h"
 #include "app_util_platform.h"
 #include "boards.h"
@@ -77,7 +78,8 @@ _static uint16_t  m_tx_buf_len = 0;
 
 _static uint8_t * mp_rx_buffer = NULL;
 _static uint16_t  m_rx_buf_len = 0;
-_static uint8_t   m_recv_buffer[SER_PHY_SPI_5W_MTU_SIZE];
+_static uint8_t   m_recv_buffer[2][SER_PHY_SPI_5W_MTU_SIZE]; //next frame is received while the previous one is copied
+_static uint8_t   m_recv_buffer_idx = 0;
 _static uint8_t   m_len_buffer[SER_PHY_HEADER_SIZE + 1] = { 0 }; //len is asymmetric for 5W, there is a 1 byte guard when receiving
 
 _static uint16_t m_tx_packet_length             = 0;
@@ -225,17 +227,6 @@ static __INLINE void callback_mem_request()
     m_callback_events_handler(event);
 }
 
-static __INLINE void copy_buff(uint8_t * const p_dest, uint8_t const * const p_src, uint16_t len)
-{
-    uint16_t index;
-
-    for (index = 0; index < len; index++)
-    {
-        p_dest[index] = p_src[index];
-    }
-    return;
-}
-
 static __INLINE void buffer_release(uint8_t * * const pp_buffer, uint16_t * const p_buf_len)
 {
     *pp_buffer = NULL;
@@ -297,7 +288,7 @@ static __INLINE uint32_t frame_get()
     err_code = spi_master_send_recv(SER_PHY_SPI_MASTER,
                                     NULL,
                                     0,
-                                    m_recv_buffer,
+                                    m_recv_buffer[m_recv_buffer_idx],
                                     m_current_rx_packet_length);
     return err_code;
 }
@@ -504,16 +495,16 @@ static void ser_phy_switch_state(ser_phy_event_source_t evt_src)
 
             if (evt_src == SER_PHY_EVT_SPI_TRANSFER_DONE)
             {
-                if (mp_rx_buffer)
-                {
-                    copy_buff(&(mp_rx_buffer[m_accumulated_rx_packet_length]),
-                              &(m_recv_buffer[1]),
-                              m_current_rx_packet_length - 1); //skip guard byte when receiving
-                }
-                m_accumulated_rx_packet_length += (m_current_rx_packet_length - 1);
+                uint8_t const * p_frame      = &(m_recv_buffer[m_recv_buffer_idx][1]); //skip guard byte when receiving
+                uint16_t        frame_offset = m_accumulated_rx_packet_length;
+                uint16_t        frame_length = m_current_rx_packet_length - 1;
+
+                m_accumulated_rx_packet_length += frame_length;
+                m_recv_buffer_idx              ^= 1;
 
                 if (m_accumulated_rx_packet_length < m_rx_packet_length)
                 {
+                    //start the next frame into the other buffer before copying this one
                     if (m_slave_ready_flag)
                     {
                         err_code = frame_get();
@@ -523,7 +514,13 @@ static void ser_phy_switch_state(ser_phy_event_source_t evt_src)
                         m_waitForReadyFlag = true;
                     }
                 }
-                else
+
+                if (mp_rx_buffer)
+                {
+                    memcpy(&(mp_rx_buffer[frame_offset]), p_frame, frame_length);
+                }
+
+                if (m_accumulated_rx_packet_length >= m_rx_packet_length)
                 {
                     spi_master_raw_assert(m_accumulated_rx_packet_length == m_rx_packet_length);
 
@@ -77,11 +77,13 @@ _static uint16_t m_current_rx_frame_length;
 _static uint16_t m_accumulated_tx_packet_length;
 _static uint16_t m_tx_packet_length;
 _static uint16_t m_current_tx_frame_length;
+_static uint16_t m_next_tx_frame_length; //payload length of the frame prepared in m_tx_frame_buffer[m_next_tx_frame_idx]
+_static uint8_t  m_next_tx_frame_idx;
 
 _static uint8_t m_header_rx_buffer[SER_PHY_HEADER_SIZE + 1]; //+1 for '0' guard in SPI_5W
 _static uint8_t m_header_tx_buffer[SER_PHY_HEADER_SIZE + 1]; //+1 for '0' guard in SPI_5W
 
-_static uint8_t       m_tx_frame_buffer[SER_PHY_SPI_5W_MTU_SIZE];
+_static uint8_t       m_tx_frame_buffer[2][SER_PHY_SPI_5W_MTU_SIZE]; //next frame is prepared while the current one is clocked
 _static uint8_t       m_rx_frame_buffer[SER_PHY_SPI_5W_MTU_SIZE];
 _static uint8_t const m_zero_buff[SER_PHY_SPI_5W_MTU_SIZE] = {  0  }; //ROM'able declaration - all guard bytes
 
@@ -148,17 +150,6 @@ static void callback_packet_transmitted(void)
     return;
 }
 
-static void copy_buff(uint8_t * const p_dest, uint8_t const * const p_src, uint16_t len)
-{
-    uint16_t index;
-
-    for (index = 0; index < len; index++)
-    {
-        p_dest[index] = p_src[index];
-    }
-    return;
-}
-
 /* Function computes current packet length */
 static uint16_t compute_current_frame_length(const uint16_t packet_length,
                                              const uint16_t accumulated_packet_length)
@@ -222,25 +213,45 @@ static uint32_t header_send(uint16_t len)
     return err_code;
 }
 
+/* Function copies the frame starting at the given packet offset into the given frame buffer */
+static uint16_t frame_prepare(uint8_t idx, uint16_t offset)
+{
+    uint16_t frame_length = compute_current_frame_length(m_tx_packet_length, offset);
+
+    if (frame_length == SER_PHY_SPI_5W_MTU_SIZE)
+    {
+        frame_length -= 1; //extra space for guard byte must be taken into account for MTU
+    }
+    m_tx_frame_buffer[idx][0] = 0; //guard byte
+    memcpy(&(m_tx_frame_buffer[idx][1]), &(m_p_tx_buffer[offset]), frame_length);
+
+    return frame_length;
+}
+
+/* Function sends the prepared frame, and prepares the next one while it is clocked out */
 static uint32_t frame_send()
 {
     uint32_t err_code;
+    uint16_t next_offset;
 
-    m_current_tx_frame_length = compute_current_frame_length(m_tx_packet_length,
-                                                             m_accumulated_tx_packet_length);
+    err_code = spi_slave_buffers_set(m_tx_frame_buffer[m_next_tx_frame_idx],
+                                     m_rx_frame_buffer,
+                                     m_next_tx_frame_length + 1,
+                                     m_next_tx_frame_length + 1);
+    if (err_code != NRF_SUCCESS)
+    {
+        //the prepared frame was not handed over, keep it for the next attempt
+        return err_code;
+    }
 
-    if (m_current_tx_frame_length == SER_PHY_SPI_5W_MTU_SIZE)
+    m_current_tx_frame_length = m_next_tx_frame_length;
+    m_next_tx_frame_idx      ^= 1;
+    next_offset               = m_accumulated_tx_packet_length + m_current_tx_frame_length;
+
+    if (next_offset < m_tx_packet_length)
     {
-        m_current_tx_frame_length -= 1; //extra space for guard byte must be taken into account for MTU
+        m_next_tx_frame_length = frame_prepare(m_next_tx_frame_idx, next_offset);
     }
-    m_tx_frame_buffer[0] = 0; //guard byte
-    copy_buff(&(m_tx_frame_buffer[1]),
-              &(m_p_tx_buffer[m_accumulated_tx_packet_length]),
-              m_current_tx_frame_length);
-    err_code = spi_slave_buffers_set(m_tx_frame_buffer,
-                                     m_rx_frame_buffer,
-                                     m_current_tx_frame_length + 1,
-                                     m_current_tx_frame_length + 1);
 
     return err_code;
 }
@@ -528,8 +539,10 @@ uint32_t ser_phy_tx_pkt_send(const uint8_t * p_buffer, uint16_t num_of_bytes)
 
     if ( m_p_tx_buffer == NULL)
     {
-        m_tx_packet_length = num_of_bytes;
-        m_p_tx_buffer      = p_buffer;
+        m_tx_packet_length     = num_of_bytes;
+        m_p_tx_buffer          = p_buffer;
+        m_next_tx_frame_idx    = 0;
+        m_next_tx_frame_length = frame_prepare(0, 0); //first frame is ready before the master asks for it
         set_request_line();
     }
     else
@@ -25,35 +25,31 @@ typedef uint32_t (*conn_mw_handler_t)(uint8_t const * const p_rx_buf,
                                       uint8_t * const       p_tx_buf,
                                       uint32_t * const      p_tx_buf_len);
 
-/**@brief Connectivity middleware item. */
-typedef struct
-{
-    uint8_t           opcode;     /**< Opcode by which specific codec is identified */
-    conn_mw_handler_t fp_handler; /**< Function pointer to handler associated with given opcode */
-} conn_mw_item_t;
+/**@brief First opcode of the connectivity middleware handlers table. */
+#define CONN_MW_OPCODE_BASE  SOC_SVC_BASE
+
+/**@brief Number of opcodes covered by the connectivity middleware handlers table. */
+#define CONN_MW_OPCODE_COUNT (BLE_L2CAP_SVC_LAST - CONN_MW_OPCODE_BASE + 1)
+
+/**@brief Macro for registering the handler of an opcode in the connectivity middleware handlers
+ *        table.
+ *
+ * @details The table is indexed by opcode, so the handler is found without searching.
+ */
+#define CONN_MW_ITEM(opcode, fp_handler) [(opcode) - CONN_MW_OPCODE_BASE] = (fp_handler)
 
 /* Include handlers for given softdevice */
 #include "conn_mw_items.c"
 
-/**@brief Number of registered connectivity middleware handlers. */
-static const uint32_t conn_mw_item_len = sizeof (conn_mw_item) / sizeof (conn_mw_item[0]);
-
-/**@brief Local function for finding connectivity middleware handler in the table.. */
+/**@brief Local function for finding connectivity middleware handler in the table. */
 static conn_mw_handler_t conn_mw_handler_get(uint8_t opcode)
 {
-    conn_mw_handler_t fp_handler = NULL;
-    uint32_t          i;
-
-    for (i = 0; i < conn_mw_item_len; i++)
+    if ((opcode < CONN_MW_OPCODE_BASE) || (opcode >= (CONN_MW_OPCODE_BASE + CONN_MW_OPCODE_COUNT)))
     {
-        if (opcode == conn_mw_item[i].opcode)
-        {
-            fp_handler = conn_mw_item[i].fp_handler;
-            break;
-        }
+        return NULL;
     }
 
-    return fp_handler;
+    return conn_mw_item[opcode - CONN_MW_OPCODE_BASE];
 }
 
 uint32_t conn_mw_handler(uint8_t const * const p_rx_buf,
@@ -0,0 +1,159 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**@file
+ *
+ * @brief Host test of the connectivity middleware handler lookup.
+ *
+ * @details Checks, for every 8-bit opcode, that the opcode indexed table in conn_mw.c dispatches
+ *          to the same handler as a linear search of the items registered in conn_mw_items.c,
+ *          and that opcodes without a handler, including those outside the table, are rejected
+ *          with NRF_ERROR_NOT_SUPPORTED. Each item is also checked to be registered only once,
+ *          since a duplicate designated initializer silently overrides the first one.
+ *
+ *          Build and run from the repository root, with SD being s110, s120 or s130 (SDU in
+ *          upper case). The middleware is linked so that every handler has a distinct address;
+ *          the serializers it calls are not needed and are left unresolved:
+ *
+ * @code
+ * S=components/serialization
+ * gcc -std=gnu99 -DNRF51 -D$SDU -DSVCALL_AS_NORMAL_FUNCTION -no-pie \
+ *     -Wl,--unresolved-symbols=ignore-all \
+ *     -I$S/common -I$S/common/struct_ser/$SD -I$S/connectivity -I$S/connectivity/codecs/common \
+ *     -I$S/connectivity/codecs/$SD/middleware -I$S/connectivity/codecs/$SD/serializers \
+ *     -Icomponents/softdevice/$SD/headers -Icomponents/libraries/util -Icomponents/device \
+ *     -Icomponents/toolchain -Icomponents/toolchain/gcc \
+ *     $S/connectivity/codecs/common/test/conn_mw_test.c \
+ *     $S/connectivity/codecs/$SD/middleware/conn_mw_ble*.c \
+ *     $S/connectivity/codecs/$SD/middleware/conn_mw_nrf_soc.c \
+ *     -o conn_mw_test && ./conn_mw_test
+ * @endcode
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "nrf_error.h"
+#include "nrf_soc.h"
+#include "ble.h"
+#include "ble_l2cap.h"
+#include "ble_gap.h"
+#include "ble_gattc.h"
+#include "ble_gatts.h"
+
+/**@brief Handler registered for an opcode, in the order of conn_mw_items.c. */
+typedef struct
+{
+    uint8_t opcode;
+    uint32_t (*fp_handler)(uint8_t const * const p_rx_buf,
+                           uint32_t              rx_buf_len,
+                           uint8_t * const       p_tx_buf,
+                           uint32_t * const      p_tx_buf_len);
+} linear_item_t;
+
+/* Expand the item list into the table searched before handlers were indexed by opcode. */
+#define conn_mw_handler_t    linear_item_t
+#define conn_mw_item         linear_item
+#define CONN_MW_OPCODE_COUNT
+#define CONN_MW_ITEM(opcode, fp_handler) {(opcode), (fp_handler)}
+#include "conn_mw_items.c"
+#undef conn_mw_handler_t
+#undef conn_mw_item
+#undef CONN_MW_OPCODE_COUNT
+#undef CONN_MW_ITEM
+
+#include "conn_mw.c"
+
+#define LINEAR_ITEM_COUNT (sizeof(linear_item) / sizeof(linear_item[0]))
+
+/**@brief Handler found by a linear search of the registered items, NULL if none. */
+static conn_mw_handler_t linear_handler_get(uint8_t opcode)
+{
+    uint32_t i;
+
+    for (i = 0; i < LINEAR_ITEM_COUNT; i++)
+    {
+        if (linear_item[i].opcode == opcode)
+        {
+            return linear_item[i].fp_handler;
+        }
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    uint32_t failures = 0;
+    uint32_t hits     = 0;
+    uint32_t opcode;
+    uint32_t i;
+    uint32_t j;
+
+    for (i = 0; i < LINEAR_ITEM_COUNT; i++)
+    {
+        if (linear_item[i].fp_handler == NULL)
+        {
+            printf("FAIL: opcode 0x%02X registered without a handler\n", linear_item[i].opcode);
+            failures++;
+        }
+
+        for (j = i + 1; j < LINEAR_ITEM_COUNT; j++)
+        {
+            if (linear_item[i].opcode == linear_item[j].opcode)
+            {
+                printf("FAIL: opcode 0x%02X registered twice\n", linear_item[i].opcode);
+                failures++;
+            }
+        }
+    }
+
+    for (opcode = 0; opcode <= UINT8_MAX; opcode++)
+    {
+        conn_mw_handler_t expected = linear_handler_get((uint8_t)opcode);
+        uint8_t           rx_buf[1];
+        uint8_t           tx_buf[1];
+        uint32_t          tx_buf_len = sizeof(tx_buf);
+
+        if (conn_mw_handler_get((uint8_t)opcode) != expected)
+        {
+            printf("FAIL: opcode 0x%02X dispatched to the wrong handler\n", opcode);
+            failures++;
+        }
+
+        if (expected == NULL)
+        {
+            // Opcodes with a handler are not called, the buffers are not valid commands.
+            rx_buf[SER_CMD_OP_CODE_POS] = (uint8_t)opcode;
+            if (conn_mw_handler(rx_buf, sizeof(rx_buf), tx_buf, &tx_buf_len) !=
+                NRF_ERROR_NOT_SUPPORTED)
+            {
+                printf("FAIL: opcode 0x%02X without a handler not rejected\n", opcode);
+                failures++;
+            }
+        }
+        else
+        {
+            hits++;
+        }
+    }
+
+    if (hits != LINEAR_ITEM_COUNT)
+    {
+        printf("FAIL: %u of %u registered opcodes found\n", hits, (uint32_t)LINEAR_ITEM_COUNT);
+        failures++;
+    }
+
+    printf("%s: %u opcodes registered, %u failures\n",
+           (failures == 0) ? "PASS" : "FAIL", (uint32_t)LINEAR_ITEM_COUNT, failures);
+
+    return (failures == 0) ? 0 : 1;
+}
@@ -29,10 +29,10 @@ uint32_t ble_gap_auth_key_reply_req_dec(uint8_t const * const p_buf,
     uint32_t err_code = NRF_SUCCESS;
     uint8_t  key_len;
 
-    SER_ASSERT_LENGTH_LEQ(2, packet_len - index);
+    SER_ASSERT_LENGTH_LEFT(2, index, packet_len);
     uint16_dec(p_buf, packet_len, &index, p_conn_handle);
 
-    SER_ASSERT_LENGTH_LEQ(1, packet_len - index);
+    SER_ASSERT_LENGTH_LEFT(1, index, packet_len);
     uint8_dec(p_buf, packet_len, &index, p_key_type);
 
     switch (*p_key_type)
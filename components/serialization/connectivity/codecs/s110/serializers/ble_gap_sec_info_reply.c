@@ -36,7 +36,7 @@ uint32_t ble_gap_sec_info_reply_req_dec(uint8_t const * const         p_buf,
     uint32_t index    = SER_CMD_DATA_POS;
     uint32_t err_code = NRF_SUCCESS;
 
-    SER_ASSERT_LENGTH_LEQ(2, packet_len - index);
+    SER_ASSERT_LENGTH_LEFT(2, index, packet_len);
     uint16_dec(p_buf, packet_len, &index, p_conn_handle);
 
     err_code = cond_field_dec(p_buf,
@@ -37,7 +37,7 @@ uint32_t ble_gatts_characteristic_add_req_dec(uint8_t const * const
 
     SER_ASSERT_LENGTH_LEQ(1, buf_len);
     uint32_t err_code;
-    SER_ASSERT_LENGTH_LEQ(2, buf_len - index);
+    SER_ASSERT_LENGTH_LEFT(2, index, buf_len);
     uint16_dec(p_buf, buf_len, &index, service_handle);
 
     err_code = cond_field_dec(p_buf, buf_len, &index, (void * *)pp_char_md, ble_gatts_char_md_dec);
@@ -35,7 +35,7 @@ uint32_t ble_gatts_service_add_req_dec(uint8_t const * const p_buf,
     uint32_t index = SER_CMD_DATA_POS;
 
     uint32_t err_code;
-    SER_ASSERT_LENGTH_LEQ(3, buf_len - index);
+    SER_ASSERT_LENGTH_LEFT(3, index, buf_len);
     err_code = uint8_t_dec(p_buf, buf_len, &index, p_type);
     SER_ASSERT(err_code == NRF_SUCCESS, err_code);
     err_code = cond_field_dec(p_buf, buf_len, &index, (void * *)pp_uuid, ble_uuid_t_dec);
@@ -52,7 +52,7 @@ uint32_t ble_gatts_value_get_req_dec(uint8_t const * const       p_buf,
         err_code = uint16_t_dec(p_buf, packet_len, &index, &((*pp_value)->offset));
         SER_ASSERT(err_code == NRF_SUCCESS, err_code);
 
-        SER_ASSERT_LENGTH_LEQ(1, packet_len - index);
+        SER_ASSERT_LENGTH_LEFT(1, index, packet_len);
         if (p_buf[index++] == SER_FIELD_NOT_PRESENT)
         {
             (*pp_value)->p_value = NULL;
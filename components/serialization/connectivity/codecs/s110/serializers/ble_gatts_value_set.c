@@ -32,7 +32,7 @@ uint32_t ble_gatts_value_set_req_dec(uint8_t const * const       p_buf,
     uint32_t index = SER_CMD_DATA_POS;
     uint32_t err_code = NRF_SUCCESS;
 
-    SER_ASSERT_LENGTH_LEQ(4, packet_len - index); //make sure that payload length is at least 4 bytes
+    SER_ASSERT_LENGTH_LEFT(4, index, packet_len); //make sure that payload length is at least 4 bytes
     uint16_dec(p_buf, packet_len, &index, p_conn_handle);
     uint16_dec(p_buf, packet_len, &index, p_handle);
 
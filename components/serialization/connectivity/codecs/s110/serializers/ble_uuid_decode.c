@@ -30,7 +30,7 @@ uint32_t ble_uuid_decode_req_dec(uint8_t const * const p_buf,
     uint32_t index  = 0;
     uint8_t  opcode = SD_BLE_UUID_DECODE;
 
-    SER_ASSERT_LENGTH_LEQ(1, ((int32_t)buf_len - index));
+    SER_ASSERT_LENGTH_LEFT(1, index, buf_len);
     uint8_dec(p_buf, buf_len, &index, &opcode);
     SER_ASSERT(opcode == SD_BLE_UUID_DECODE, NRF_ERROR_INVALID_DATA);
 
@@ -31,7 +31,7 @@ uint32_t ble_gap_device_name_set_req_dec(uint8_t const * const             p_buf
     uint32_t index = SER_CMD_DATA_POS;
     uint32_t status_code;
 
-    SER_ASSERT_LENGTH_LEQ(4, packet_len - index); //make sure that payload is at least 4 bytes
+    SER_ASSERT_LENGTH_LEFT(4, index, packet_len); //make sure that payload is at least 4 bytes
 
     //decode optional write permissions field
     status_code = cond_field_dec(p_buf,
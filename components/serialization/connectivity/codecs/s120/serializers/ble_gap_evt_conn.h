@@ -312,6 +312,24 @@ uint32_t ble_gap_evt_adv_report_enc(ble_evt_t const * const p_event,
                                     uint8_t * const         p_buf,
                                     uint32_t * const        p_buf_len);
 
+/**
+ * @brief Commits the advertising report table updated by the reports encoded since the last call.
+ *
+ * Used when @ref SER_ADV_REPORT_DELTA_ENABLED is set. Called once the packet holding the encoded
+ * reports has been passed to the transport layer, so that compact reports are only sent for
+ * reports the Application Chip has received in full.
+ */
+void ble_gap_evt_adv_report_table_commit(void);
+
+/**
+ * @brief Discards the advertising report table updates of the reports encoded since the last
+ *        commit.
+ *
+ * Used when @ref SER_ADV_REPORT_DELTA_ENABLED is set. Called when the packet holding the encoded
+ * reports is not sent.
+ */
+void ble_gap_evt_adv_report_table_discard(void);
+
 /**
  * @brief Encodes ble_gap_evt_scan_req_report event.
  *
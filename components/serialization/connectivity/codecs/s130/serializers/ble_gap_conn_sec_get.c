@@ -30,12 +30,12 @@ uint32_t ble_gap_conn_sec_get_req_dec(uint8_t const * const        p_buf,
     uint8_t  opcode;
     uint32_t err_code = NRF_SUCCESS;
 
-    SER_ASSERT_LENGTH_LEQ(1, packet_len - index);
+    SER_ASSERT_LENGTH_LEFT(1, index, packet_len);
     uint8_dec(p_buf, packet_len, &index, &opcode);
 
     SER_ASSERT(opcode == SD_BLE_GAP_CONN_SEC_GET, NRF_ERROR_INVALID_PARAM);
 
-    SER_ASSERT_LENGTH_LEQ(2, packet_len - index);
+    SER_ASSERT_LENGTH_LEFT(2, index, packet_len);
     uint16_dec(p_buf, packet_len, &index, p_conn_handle);
 
     err_code = cond_field_dec(p_buf, packet_len, &index, (void * *)pp_conn_sec, NULL);
@@ -15,8 +15,77 @@
 #include <string.h>
 #include "ble_serialization.h"
 #include "ble_gap_struct_serialization.h"
+#include "ser_config.h"
 #include "app_util.h"
 
+#if SER_ADV_REPORT_DELTA_ENABLED
+
+STATIC_ASSERT(SER_ADV_REPORT_CACHE_SIZE <= 0xFF);
+
+/**@brief Advertiser in the advertising report table. */
+typedef struct
+{
+    ble_gap_addr_t addr;                       /**< Address of the advertiser. */
+    uint8_t        byte;                       /**< Scan response flag, type and data length of the last report. */
+    uint8_t        data[BLE_GAP_ADV_MAX_SIZE]; /**< Data of the last report. */
+    bool           in_use;                     /**< True if the entry holds an advertiser. */
+} adv_report_entry_t;
+
+/**@brief Advertising report table. */
+typedef struct
+{
+    adv_report_entry_t entries[SER_ADV_REPORT_CACHE_SIZE]; /**< Advertisers. */
+    uint8_t            next;                               /**< Entry replaced by the next new advertiser. */
+} adv_report_table_t;
+
+static adv_report_table_t m_adv_report_table;     /**< Table of the application, as of the last packet sent. */
+static adv_report_table_t m_adv_report_table_enc; /**< Table including the reports encoded in the packet being filled. */
+
+
+/**@brief Function for finding the table entry of an advertiser.
+ *
+ * @details Advertising data and scan response data are kept in separate entries.
+ *
+ * @param[in] p_addr     Address of the advertiser.
+ * @param[in] scan_rsp   Scan response flag of the report.
+ *
+ * @return Index of the entry, or SER_ADV_REPORT_CACHE_SIZE if the advertiser is not in the table.
+ */
+static uint8_t adv_report_entry_find(ble_gap_addr_t const * p_addr, uint8_t scan_rsp)
+{
+    adv_report_entry_t const * p_entry;
+    uint8_t                    i;
+
+    for (i = 0; i < SER_ADV_REPORT_CACHE_SIZE; i++)
+    {
+        p_entry = &m_adv_report_table_enc.entries[i];
+
+        if (p_entry->in_use &&
+            ((p_entry->byte & 0x01) == scan_rsp) &&
+            (p_entry->addr.addr_type == p_addr->addr_type) &&
+            (memcmp(p_entry->addr.addr, p_addr->addr, BLE_GAP_ADDR_LEN) == 0))
+        {
+            return i;
+        }
+    }
+
+    return SER_ADV_REPORT_CACHE_SIZE;
+}
+
+
+void ble_gap_evt_adv_report_table_commit(void)
+{
+    m_adv_report_table = m_adv_report_table_enc;
+}
+
+
+void ble_gap_evt_adv_report_table_discard(void)
+{
+    m_adv_report_table_enc = m_adv_report_table;
+}
+
+#endif // SER_ADV_REPORT_DELTA_ENABLED
+
 
 uint32_t ble_gap_evt_adv_report_enc(ble_evt_t const * const p_event,
                                     uint32_t                event_len,
@@ -33,6 +102,45 @@ uint32_t ble_gap_evt_adv_report_enc(ble_evt_t const * const p_event,
     uint8_t        byte;
     const uint16_t evt_header = BLE_GAP_EVT_ADV_REPORT;
 
+    byte = (p_event->evt.gap_evt.params.adv_report.scan_rsp) |
+           ((p_event->evt.gap_evt.params.adv_report.type) << 0x01) |
+           ((p_event->evt.gap_evt.params.adv_report.dlen) << 0x03);
+
+#if SER_ADV_REPORT_DELTA_ENABLED
+    uint8_t entry_idx = adv_report_entry_find(&p_event->evt.gap_evt.params.adv_report.peer_addr,
+                                              byte & 0x01);
+
+    if ((entry_idx < SER_ADV_REPORT_CACHE_SIZE) &&
+        (m_adv_report_table_enc.entries[entry_idx].byte == byte) &&
+        (memcmp(m_adv_report_table_enc.entries[entry_idx].data,
+                p_event->evt.gap_evt.params.adv_report.data,
+                p_event->evt.gap_evt.params.adv_report.dlen) == 0))
+    {
+        /* The application has this report already, only the entry index and the RSSI are sent. */
+        const uint16_t delta_evt_header = SER_EVT_GAP_ADV_REPORT_DELTA;
+
+        err_code = uint16_t_enc((void *)&delta_evt_header, p_buf, total_len, &index);
+        SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+        err_code = uint8_t_enc((void *)&entry_idx, p_buf, total_len, &index);
+        SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+        err_code = uint8_t_enc((void *)&(p_event->evt.gap_evt.params.adv_report.rssi), p_buf, total_len, &index);
+        SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+        *p_buf_len = index;
+
+        return err_code;
+    }
+
+    bool new_entry = (entry_idx == SER_ADV_REPORT_CACHE_SIZE);
+
+    if (new_entry)
+    {
+        entry_idx = m_adv_report_table_enc.next;
+    }
+#endif // SER_ADV_REPORT_DELTA_ENABLED
+
     err_code = uint16_t_enc((void *)&evt_header, p_buf, total_len, &index);
     SER_ASSERT(err_code == NRF_SUCCESS, err_code);
 
@@ -45,16 +153,34 @@ uint32_t ble_gap_evt_adv_report_enc(ble_evt_t const * const p_event,
     err_code = uint8_t_enc((void *)&(p_event->evt.gap_evt.params.adv_report.rssi), p_buf, total_len, &index);
     SER_ASSERT(err_code == NRF_SUCCESS, err_code);
 
-    byte = (p_event->evt.gap_evt.params.adv_report.scan_rsp) |
-           ((p_event->evt.gap_evt.params.adv_report.type) << 0x01) |
-           ((p_event->evt.gap_evt.params.adv_report.dlen) << 0x03);
-
     err_code = uint8_t_enc((void *)&(byte), p_buf, total_len, &index);
     SER_ASSERT(err_code == NRF_SUCCESS, err_code);
 
     err_code = uint8_vector_enc(p_event->evt.gap_evt.params.adv_report.data, (uint16_t)p_event->evt.gap_evt.params.adv_report.dlen, p_buf, total_len, &index);
     SER_ASSERT(err_code == NRF_SUCCESS, err_code);
 
+#if SER_ADV_REPORT_DELTA_ENABLED
+    /* The full report is followed by the table entry the application stores it in. */
+    err_code = uint8_t_enc((void *)&entry_idx, p_buf, total_len, &index);
+    SER_ASSERT(err_code == NRF_SUCCESS, err_code);
+
+    /* The entry is updated only once the report is encoded, so that an event which did not fit in
+     * the buffer can be encoded again. The table of the application follows once the packet is
+     * sent, see ble_gap_evt_adv_report_table_commit(). */
+    adv_report_entry_t * p_entry = &m_adv_report_table_enc.entries[entry_idx];
+
+    if (new_entry)
+    {
+        m_adv_report_table_enc.next = (m_adv_report_table_enc.next + 1) % SER_ADV_REPORT_CACHE_SIZE;
+    }
+    p_entry->addr   = p_event->evt.gap_evt.params.adv_report.peer_addr;
+    p_entry->byte   = byte;
+    p_entry->in_use = true;
+    memcpy(p_entry->data,
+           p_event->evt.gap_evt.params.adv_report.data,
+           p_event->evt.gap_evt.params.adv_report.dlen);
+#endif // SER_ADV_REPORT_DELTA_ENABLED
+
     *p_buf_len = index;
 
     return err_code;
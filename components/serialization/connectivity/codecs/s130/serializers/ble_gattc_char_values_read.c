@@ -31,7 +31,7 @@ uint32_t ble_gattc_char_values_read_req_dec(uint8_t const * const p_buf,
     uint32_t index = SER_CMD_DATA_POS;
     uint32_t status_code;
 
-    SER_ASSERT_LENGTH_LEQ(5, packet_len - index); //make sure that payload length is at least 5 bytes
+    SER_ASSERT_LENGTH_LEFT(5, index, packet_len); //make sure that payload length is at least 5 bytes
     uint16_dec(p_buf, packet_len, &index, p_conn_handle);
     //decode handle table count with optional handle table
     status_code = count16_cond_data16_dec(p_buf, packet_len, &index, pp_handles, p_handle_count);
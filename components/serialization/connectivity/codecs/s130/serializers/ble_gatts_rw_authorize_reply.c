@@ -32,7 +32,7 @@ uint32_t ble_gatts_rw_authorize_reply_req_dec(
     uint32_t index    = SER_CMD_HEADER_SIZE;
     uint32_t err_code = NRF_SUCCESS;
 
-    SER_ASSERT_LENGTH_LEQ(2, packet_len - index);
+    SER_ASSERT_LENGTH_LEFT(2, index, packet_len);
     uint16_dec(p_buf, packet_len, &index, p_conn_handle);
 
     err_code = cond_field_dec(p_buf, packet_len, &index,
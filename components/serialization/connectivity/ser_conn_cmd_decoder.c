@@ -19,9 +19,20 @@
 #include "conn_mw.h"
 #include "ser_hal_transport.h"
 #include "ser_conn_cmd_decoder.h"
+#include "ser_conn_event_encoder.h"
 
 
-uint32_t ser_conn_command_process(uint8_t * p_command, uint16_t command_len)
+/**@brief A function decodes an encoded command and sends a response packet of given type.
+ *
+ * @param[in]   p_command      The encoded command.
+ * @param[in]   command_len    Length of the encoded command including opcode.
+ * @param[in]   rsp_type       Type of the response packet.
+ * @param[in]   p_seq_id       Sequence ID appended to the response, NULL if none.
+ */
+static uint32_t command_process(uint8_t *       p_command,
+                                uint16_t        command_len,
+                                uint8_t         rsp_type,
+                                uint8_t const * p_seq_id)
 {
     SER_ASSERT_NOT_NULL(p_command);
     SER_ASSERT_LENGTH_LEQ(SER_OP_CODE_SIZE, command_len);
@@ -32,6 +43,12 @@ uint32_t ser_conn_command_process(uint8_t * p_command, uint16_t command_len)
     uint8_t   opcode     = p_command[SER_CMD_OP_CODE_POS];
     uint32_t  index      = 0;
 
+#if SER_EVT_BATCH_ENABLED
+    /* Events collected before the command must not be overtaken by its response. Send them first,
+     * this also leaves their TX buffer to be freed for the response. */
+    ser_conn_ble_event_batch_flush();
+#endif
+
     /* Allocate a memory buffer from HAL Transport layer for transmitting the Command Response.
      * Loop until a buffer is available. */
     do
@@ -43,9 +60,15 @@ uint32_t ser_conn_command_process(uint8_t * p_command, uint16_t command_len)
     if (NRF_SUCCESS == err_code)
     {
         /* Create a new response packet. */
-        p_tx_buf[SER_PKT_TYPE_POS] = SER_PKT_TYPE_RESP;
+        p_tx_buf[SER_PKT_TYPE_POS] = rsp_type;
         tx_buf_len                -= SER_PKT_TYPE_SIZE;
 
+        if (p_seq_id != NULL)
+        {
+            /* Keep room for the sequence ID. */
+            tx_buf_len -= SER_PKT_SEQ_SIZE;
+        }
+
         /* Decode a request, pass a memory for a response command (opcode + data) and encode it. */
         err_code = conn_mw_handler
                        (p_command, command_len, &p_tx_buf[SER_PKT_OP_CODE_POS], &tx_buf_len);
@@ -58,10 +81,18 @@ uint32_t ser_conn_command_process(uint8_t * p_command, uint16_t command_len)
                            (opcode, NRF_ERROR_NOT_SUPPORTED,
                            &p_tx_buf[SER_PKT_OP_CODE_POS], &tx_buf_len, &index);
         }
-        else if (NRF_SUCCESS == err_code) /* Send a response. */
+
+        if (NRF_SUCCESS == err_code) /* Send a response. */
         {
             tx_buf_len += SER_PKT_TYPE_SIZE;
-            err_code    = ser_hal_transport_tx_pkt_send(p_tx_buf, (uint16_t)tx_buf_len);
+
+            if (p_seq_id != NULL)
+            {
+                p_tx_buf[tx_buf_len] = *p_seq_id;
+                tx_buf_len          += SER_PKT_SEQ_SIZE;
+            }
+
+            err_code = ser_hal_transport_tx_pkt_send(p_tx_buf, (uint16_t)tx_buf_len);
 
             /* TX buffer is going to be freed automatically in the HAL Transport layer. */
             if (NRF_SUCCESS != err_code)
@@ -81,3 +112,15 @@ uint32_t ser_conn_command_process(uint8_t * p_command, uint16_t command_len)
 
     return err_code;
 }
+
+
+uint32_t ser_conn_command_process(uint8_t * p_command, uint16_t command_len)
+{
+    return command_process(p_command, command_len, SER_PKT_TYPE_RESP, NULL);
+}
+
+
+uint32_t ser_conn_seq_command_process(uint8_t * p_command, uint16_t command_len, uint8_t seq_id)
+{
+    return command_process(p_command, command_len, SER_PKT_TYPE_SEQ_RESP, &seq_id);
+}
@@ -48,6 +48,24 @@
  */
 uint32_t ser_conn_command_process(uint8_t * p_command, uint16_t command_len);
 
+/**@brief A function decodes an encoded sequenced command and sends a response to an Application
+ *        Chip.
+ *
+ * @details Same as @ref ser_conn_command_process, but the response is a sequenced response packet
+ *          carrying the sequence ID of the command, so that an Application Chip can keep several
+ *          commands in flight and match each response to its command.
+ *
+ * @param[in]   p_command      The encoded command.
+ * @param[in]   command_len    Length of the encoded command including opcode, excluding the
+ *                             sequence ID.
+ * @param[in]   seq_id         Sequence ID of the command.
+ *
+ * @retval    NRF_SUCCESS           Operation success.
+ * @retval    NRF_ERROR_NULL        Operation failure. NULL pointer supplied.
+ * @retval    NRF_ERROR_INTERNAL    Operation failure. Internal error ocurred.
+ */
+uint32_t ser_conn_seq_command_process(uint8_t * p_command, uint16_t command_len, uint8_t seq_id);
+
 #endif /* SER_CONN_CMD_DECODER_H__ */
 
 /** @} */
@@ -19,7 +19,196 @@
 #include "ser_config.h"
 #include "ser_hal_transport.h"
 #include "ser_conn_event_encoder.h"
+#include "app_util.h"
+#if SER_ADV_REPORT_DELTA_ENABLED
+#include "ble_gap_evt_conn.h"
+#endif
 
+#if SER_EVT_BATCH_ENABLED
+
+/* A batch is filled in one TX buffer while another one is being sent. */
+STATIC_ASSERT(SER_HAL_TRANSPORT_TX_BUF_COUNT >= 2);
+
+static uint8_t *     mp_batch_buf     = NULL;  /**< Batch packet being filled, NULL if none. */
+static uint32_t      m_batch_buf_size = 0;     /**< Size of the TX buffer holding the batch packet. */
+static uint32_t      m_batch_len      = 0;     /**< Length of the batch packet. */
+static uint32_t      m_batch_count    = 0;     /**< Number of events in the batch packet. */
+static volatile bool m_flush_pending  = false; /**< True if a batch flush is in the scheduler queue. */
+
+
+/**@brief A function for allocating a TX buffer for a new batch packet. */
+static void batch_open(void)
+{
+    uint32_t err_code;
+    uint32_t tx_buf_len = 0;
+
+    /* Loop until a buffer is available. */
+    do
+    {
+        err_code = ser_hal_transport_tx_pkt_alloc(&mp_batch_buf, (uint16_t *)&tx_buf_len);
+    }
+    while (err_code == NRF_ERROR_NO_MEM);
+    APP_ERROR_CHECK(err_code);
+
+    mp_batch_buf[SER_PKT_TYPE_POS] = SER_PKT_TYPE_EVT_BATCH;
+    m_batch_buf_size               = tx_buf_len;
+    m_batch_len                    = SER_PKT_TYPE_SIZE;
+    m_batch_count                  = 0;
+}
+
+
+/**@brief A function for encoding an event at the end of the batch packet.
+ *
+ * @param[in]   p_ble_evt   Event to encode.
+ *
+ * @return NRF_SUCCESS if the event was added, otherwise the error returned by the event encoder.
+ */
+static uint32_t batch_append(ble_evt_t * p_ble_evt)
+{
+    uint32_t err_code;
+    uint32_t evt_len;
+
+    if ((m_batch_len + SER_EVT_BATCH_LEN_SIZE) >= m_batch_buf_size)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+    evt_len = m_batch_buf_size - m_batch_len - SER_EVT_BATCH_LEN_SIZE;
+
+    err_code = ble_event_enc(p_ble_evt, 0,
+                             &mp_batch_buf[m_batch_len + SER_EVT_BATCH_LEN_SIZE], &evt_len);
+
+    if (NRF_SUCCESS == err_code)
+    {
+        (void)uint16_encode((uint16_t)evt_len, &mp_batch_buf[m_batch_len]);
+        m_batch_len += SER_EVT_BATCH_LEN_SIZE + evt_len;
+        m_batch_count++;
+    }
+
+    return err_code;
+}
+
+
+/**@brief A function for sending the batch packet. */
+static void batch_send(void)
+{
+    uint32_t err_code;
+
+    if (m_batch_count == 1)
+    {
+        /* A single event is sent as a plain event packet. */
+        m_batch_len -= SER_EVT_BATCH_LEN_SIZE;
+        memmove(&mp_batch_buf[SER_PKT_OP_CODE_POS],
+                &mp_batch_buf[SER_PKT_OP_CODE_POS + SER_EVT_BATCH_LEN_SIZE],
+                m_batch_len - SER_PKT_TYPE_SIZE);
+        mp_batch_buf[SER_PKT_TYPE_POS] = SER_PKT_TYPE_EVT;
+    }
+
+    err_code = ser_hal_transport_tx_pkt_send(mp_batch_buf, (uint16_t)m_batch_len);
+    APP_ERROR_CHECK(err_code);
+
+#if SER_ADV_REPORT_DELTA_ENABLED
+    /* The reports in the batch can now be sent in the compact form. */
+    ble_gap_evt_adv_report_table_commit();
+#endif
+
+    /* TX buffer is going to be freed automatically in the HAL Transport layer. */
+    mp_batch_buf = NULL;
+}
+
+
+/**@brief A function for sending the batch packet once the previous packets have been sent.
+ *
+ * @details Called by the application scheduler.
+ */
+static void batch_flush(void * p_event_data, uint16_t event_size)
+{
+    UNUSED_PARAMETER(p_event_data);
+    UNUSED_PARAMETER(event_size);
+
+    m_flush_pending = false;
+
+    if ((mp_batch_buf != NULL) && !ser_hal_transport_tx_is_busy())
+    {
+        batch_send();
+    }
+}
+
+
+void ser_conn_ble_event_batch_flush_request(void)
+{
+    uint32_t err_code;
+
+    if (!m_flush_pending && (mp_batch_buf != NULL))
+    {
+        m_flush_pending = true;
+        err_code        = app_sched_event_put(NULL, 0, batch_flush);
+        APP_ERROR_CHECK(err_code);
+    }
+}
+
+
+void ser_conn_ble_event_batch_flush(void)
+{
+    if (mp_batch_buf != NULL)
+    {
+        /* The transport queues the batch behind the packets already being sent. */
+        batch_send();
+    }
+}
+
+
+void ser_conn_ble_event_encoder(void * p_event_data, uint16_t event_size)
+{
+    if (NULL == p_event_data)
+    {
+        APP_ERROR_CHECK(NRF_ERROR_NULL);
+    }
+    UNUSED_PARAMETER(event_size);
+
+    uint32_t    err_code  = NRF_SUCCESS;
+    ble_evt_t * p_ble_evt = (ble_evt_t *)p_event_data;
+
+    if (mp_batch_buf == NULL)
+    {
+        batch_open();
+    }
+
+    err_code = batch_append(p_ble_evt);
+
+    if ((NRF_SUCCESS != err_code) && (NRF_ERROR_NOT_SUPPORTED != err_code) && (m_batch_count != 0))
+    {
+        /* The event does not fit in the batch, send it and start a new one. */
+        batch_send();
+        batch_open();
+        err_code = batch_append(p_ble_evt);
+    }
+
+    if (NRF_ERROR_NOT_SUPPORTED != err_code)
+    {
+        APP_ERROR_CHECK(err_code);
+    }
+    else
+    {
+        if (m_batch_count == 0)
+        {
+            /* Nothing to send, the buffer is freed immediately. */
+            err_code     = ser_hal_transport_tx_pkt_free(mp_batch_buf);
+            APP_ERROR_CHECK(err_code);
+            mp_batch_buf = NULL;
+        }
+        APP_ERROR_CHECK(SER_WARNING_CODE);
+    }
+
+    /* Events are collected in the batch while the transport is sending, and the batch is sent when
+     * the transport becomes idle, see ser_conn_ble_event_batch_flush_request(). The scheduler is not
+     * paused because a TX buffer is left for command responses. */
+    if ((mp_batch_buf != NULL) && !ser_hal_transport_tx_is_busy())
+    {
+        batch_send();
+    }
+}
+
+#else
 
 void ser_conn_ble_event_encoder(void * p_event_data, uint16_t event_size)
 {
@@ -56,6 +245,9 @@ void ser_conn_ble_event_encoder(void * p_event_data, uint16_t event_size)
         tx_buf_len += SER_PKT_TYPE_SIZE;
         err_code    = ser_hal_transport_tx_pkt_send(p_tx_buf, (uint16_t)tx_buf_len);
         APP_ERROR_CHECK(err_code);
+#if SER_ADV_REPORT_DELTA_ENABLED
+        ble_gap_evt_adv_report_table_commit();
+#endif
         /* TX buffer is going to be freed automatically in the HAL Transport layer.
          * Scheduler must be paused because this function returns before a packet is physically sent
          * by transport layer. This can cause start processing of a next event from the application
@@ -67,9 +259,13 @@ void ser_conn_ble_event_encoder(void * p_event_data, uint16_t event_size)
     else
     {
         /* Event was NOT encoded, therefore the buffer is freed immediately. */
+#if SER_ADV_REPORT_DELTA_ENABLED
+        ble_gap_evt_adv_report_table_discard();
+#endif
         err_code = ser_hal_transport_tx_pkt_free(p_tx_buf);
         APP_ERROR_CHECK(err_code);
         APP_ERROR_CHECK(SER_WARNING_CODE);
     }
 }
 
+#endif /* SER_EVT_BATCH_ENABLED */
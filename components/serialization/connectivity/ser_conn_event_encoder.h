@@ -45,6 +45,22 @@
  */
 void ser_conn_ble_event_encoder(void * p_event_data, uint16_t event_size);
 
+/**@brief A function for requesting that the pending event batch packet is sent.
+ *
+ * @details Used when @ref SER_EVT_BATCH_ENABLED is set. Events encoded while a packet is being
+ *          sent are collected in a batch packet. The function is called when a packet has been
+ *          sent, and schedules sending of the batch packet once the transport is idle.
+ */
+void ser_conn_ble_event_batch_flush_request(void);
+
+/**@brief A function for sending the pending event batch packet immediately.
+ *
+ * @details Used when @ref SER_EVT_BATCH_ENABLED is set. Called before a command response is sent,
+ *          so that the events encoded before the command was processed reach the Application Chip
+ *          before the response.
+ */
+void ser_conn_ble_event_batch_flush(void);
+
 #endif /* SER_CONN_EVENT_ENCODER_H__ */
 
 /** @} */
@@ -13,6 +13,7 @@
 #include <string.h>
 #include "app_error.h"
 #include "app_scheduler.h"
+#include "app_util_platform.h"
 #include "ser_config.h"
 #include "ser_conn_handlers.h"
 #include "ser_conn_event_encoder.h"
@@ -32,11 +33,17 @@
  *          the SoftDevice and events generated by the HAL Transport layer.
  */
 
-/** Parameters of a received packet. */
-static ser_hal_transport_evt_rx_pkt_received_params_t m_rx_pkt_received_params;
+/** Parameters of received packets, in the order they were received. HAL Transport layer can
+ *  receive a next packet before the previous one is processed, so there is one entry per RX
+ *  buffer. */
+static ser_hal_transport_evt_rx_pkt_received_params_t
+    m_rx_pkt_received_params[SER_HAL_TRANSPORT_RX_BUF_COUNT];
 
-/** Indicator of received packet that should be process. */
-static bool m_rx_pkt_to_process = false;
+/** Index of the oldest received packet that should be processed. */
+static uint8_t m_rx_pkt_head = 0;
+
+/** Number of received packets that should be processed. */
+static volatile uint8_t m_rx_pkt_to_process = 0;
 
 
 void ser_conn_hal_transport_event_handle(ser_hal_transport_evt_t event)
@@ -52,6 +59,11 @@ void ser_conn_hal_transport_event_handle(ser_hal_transport_evt_t event)
             /* Check if chip is ready to enter DTM mode. */
             ser_conn_is_ready_to_enter_dtm();
 
+#if SER_EVT_BATCH_ENABLED
+            /* Send events collected while the packet was being sent. */
+            ser_conn_ble_event_batch_flush_request();
+#endif
+
             break;
         }
 
@@ -69,9 +81,12 @@ void ser_conn_hal_transport_event_handle(ser_hal_transport_evt_t event)
             /* We can NOT add received packets as events to the application scheduler queue because
              * received packets have to be processed before SoftDevice events but the scheduler
              * queue do not have priorities. */
-            memcpy(&m_rx_pkt_received_params, &event.evt_params.rx_pkt_received,
+            APP_ERROR_CHECK_BOOL(m_rx_pkt_to_process < SER_HAL_TRANSPORT_RX_BUF_COUNT);
+            memcpy(&m_rx_pkt_received_params[(m_rx_pkt_head + m_rx_pkt_to_process) %
+                                             SER_HAL_TRANSPORT_RX_BUF_COUNT],
+                   &event.evt_params.rx_pkt_received,
                    sizeof (ser_hal_transport_evt_rx_pkt_received_params_t));
-            m_rx_pkt_to_process = true;
+            m_rx_pkt_to_process++;
             break;
         }
 
@@ -98,14 +113,21 @@ void ser_conn_hal_transport_event_handle(ser_hal_transport_evt_t event)
 
 uint32_t ser_conn_rx_process(void)
 {
-    uint32_t err_code = NRF_SUCCESS;
+    uint32_t                                       err_code = NRF_SUCCESS;
+    ser_hal_transport_evt_rx_pkt_received_params_t rx_pkt_params;
 
-    if (m_rx_pkt_to_process)
+    if (m_rx_pkt_to_process != 0)
     {
-        /* No critical section needed on m_rx_pkt_to_process parameter because it is not possible
-         * to get next packet before sending a response. */
-        m_rx_pkt_to_process = false;
-        err_code            = ser_conn_received_pkt_process(&m_rx_pkt_received_params);
+        /* Packets are processed one at a time, in the order they were received. The entry is
+         * copied because freeing the packet lets HAL Transport layer receive the next one. */
+        rx_pkt_params = m_rx_pkt_received_params[m_rx_pkt_head];
+        m_rx_pkt_head = (m_rx_pkt_head + 1) % SER_HAL_TRANSPORT_RX_BUF_COUNT;
+
+        CRITICAL_REGION_ENTER();
+        m_rx_pkt_to_process--;
+        CRITICAL_REGION_EXIT();
+
+        err_code = ser_conn_received_pkt_process(&rx_pkt_params);
     }
 
     return err_code;
@@ -42,6 +42,23 @@ uint32_t ser_conn_received_pkt_process(
                 break;
             }
 
+            case SER_PKT_TYPE_SEQ_CMD:
+            {
+                /* The sequence ID is the last byte of the packet. */
+                if (command_len > SER_PKT_SEQ_SIZE)
+                {
+                    command_len -= SER_PKT_SEQ_SIZE;
+                    err_code     = ser_conn_seq_command_process(p_command,
+                                                                command_len,
+                                                                p_command[command_len]);
+                }
+                else
+                {
+                    APP_ERROR_CHECK(SER_WARNING_CODE);
+                }
+                break;
+            }
+
             case SER_PKT_TYPE_DTM_CMD:
             {
                 err_code = ser_conn_dtm_command_process(p_command, command_len);
@@ -26,6 +26,10 @@
     #include "ble.h"
 #endif
 
+#if defined(BLE_STACK_SUPPORT_REQD) && defined(SVCALL_AS_NORMAL_FUNCTION)
+    #include "ser_softdevice_handler.h"
+#endif
+
 
 static softdevice_evt_schedule_func_t m_evt_schedule_func;              /**< Pointer to function for propagating SoftDevice events to the scheduler. */
 
@@ -111,6 +115,29 @@ void intern_softdevice_events_execute(void)
         // Fetch BLE Events.
         if (!no_more_ble_evts)
         {
+#ifdef SVCALL_AS_NORMAL_FUNCTION
+            // Serialized SoftDevice: handle the event in place in the event mailbox.
+            uint8_t * p_ble_evt;
+            uint16_t  evt_len;
+
+            err_code = sd_ble_evt_ptr_get(&p_ble_evt, &evt_len);
+            if (err_code == NRF_ERROR_NOT_FOUND)
+            {
+                no_more_ble_evts = true;
+            }
+            else if (err_code != NRF_SUCCESS)
+            {
+                APP_ERROR_HANDLER(err_code);
+            }
+            else
+            {
+                // Call application's BLE stack event handler.
+                m_ble_evt_handler((ble_evt_t *)p_ble_evt);
+
+                err_code = sd_ble_evt_release();
+                APP_ERROR_CHECK(err_code);
+            }
+#else
             // Pull event from stack
             uint16_t evt_len = m_ble_evt_buffer_size;
 
@@ -128,6 +155,7 @@ void intern_softdevice_events_execute(void)
                 // Call application's BLE stack event handler.
                 m_ble_evt_handler((ble_evt_t *)mp_ble_evt_buffer);
             }
+#endif
         }
 #endif
 
@@ -6,7 +6,7 @@ All rights reserved.
 */
 
 /**@file
- * @brief The memory simulator interface.
+ * @brief The file store interface.
  * This file is based on implementation originally made by Dynastream Innovations Inc. - August 2012
  * @defgroup ant_fs_client_main ANT-FS client device simulator
  * @{
@@ -14,6 +14,20 @@ All rights reserved.
  *
  * @brief The ANT-FS client device simulator.
  *
+ * @details Files are stored in flash, at the top of the code area. The directory is kept in RAM,
+ *          with a lookup table from file index to directory entry, and is written alternately to
+ *          one of two flash pages on every change. Each file owns a fixed extent of
+ *          @ref MEM_FILE_PAGE_COUNT flash pages.
+ *
+ *          Uploaded data is collected in one of two page buffers. When a buffer is full, it is
+ *          programmed to flash in the background while the next one is being filled, so flash
+ *          access does not stall burst reception. After each programmed buffer, a checkpoint
+ *          (offset and CRC of the data written so far) is appended to a journal page. An
+ *          interrupted upload, even across a reset, is resumed from the last checkpoint.
+ *
+ *          Flash is accessed through the SoftDevice, so the application must forward SoC events
+ *          to @ref mem_sys_evt_handle, and call @ref mem_init after enabling the SoftDevice. While
+ *          waiting for a page buffer, the store extracts SoC events itself.
  */
 
 #ifndef MEM_H__
@@ -23,7 +37,37 @@ All rights reserved.
 #include <stdbool.h>
 #include "antfs.h"
 
+#define MEM_FILE_PAGE_COUNT 4u                                   /**< Number of flash pages of each file. */
+#define MEM_FILE_MAX_SIZE   (MEM_FILE_PAGE_COUNT * 1024u)        /**< Maximum size of a file, in bytes. */
+
+/**@brief Function for initializing the file system.
+ *
+ * @details Restores the directory and the upload checkpoints from flash. If no directory is
+ *          found, the file system is formatted with the sample directory, and the files which
+ *          can be downloaded are filled with a test pattern.
+ */
+void mem_init(void);
+
+/**@brief Function for handling SoC events.
+ *
+ * @param[in] sys_evt      The SoC event.
+ */
+void mem_sys_evt_handle(uint32_t sys_evt);
+
+/**@brief Function for starting to write a file.
+ *
+ * @param[in] index        The file index.
+ * @param[in] offset       The offset the write starts at.
+ * @param[in] crc          The CRC of the file data preceding the offset, as used by ANT-FS.
+ *
+ * @retval true Operation success.
+ * @retval false Operation failure.
+ */
+bool mem_file_write_start(uint16_t index, uint32_t offset, uint16_t crc);
+
 /**@brief Function for writing data to file system.
+ *
+ * @details The data must follow the data previously written since @ref mem_file_write_start.
  *
  * @param[in] index        The file index.
  * @param[in] offset       The write data offset.
@@ -31,10 +75,53 @@ All rights reserved.
  * @param[in] size         The number of bytes to be written.
  *
  * @retval true Operation success.
- * @retval true Operation failure.
+ * @retval false Operation failure.
  */
 bool mem_file_write(uint16_t index, uint32_t offset, const void * p_data, uint32_t size);
 
+/**@brief Function for suspending the write of a file.
+ *
+ * @details Programs the data written so far and records it as a checkpoint, from which the write
+ *          can be resumed.
+ *
+ * @param[in] index        The file index.
+ */
+void mem_file_write_suspend(uint16_t index);
+
+/**@brief Function for completing the write of a file.
+ *
+ * @details Programs the data written so far, and sets the file size in the directory to the end
+ *          of the data written.
+ *
+ * @param[in] index        The file index.
+ *
+ * @retval true Operation success.
+ * @retval false Operation failure.
+ */
+bool mem_file_write_complete(uint16_t index);
+
+/**@brief Function for getting the checkpoint an interrupted write can be resumed from.
+ *
+ * @param[in] index        The file index.
+ * @param[out] p_offset    The offset of the data programmed.
+ * @param[out] p_crc       The CRC of the data programmed.
+ *
+ * @retval true A checkpoint exists.
+ * @retval false There is no checkpoint for the file.
+ */
+bool mem_file_checkpoint_get(uint16_t index, uint32_t * p_offset, uint16_t * p_crc);
+
+/**@brief Function for getting a pointer to file data.
+ *
+ * @details Files are memory mapped, so data can be given to ANT-FS without being copied.
+ *
+ * @param[in] index        The file index, 0 for directory.
+ * @param[in] offset       The data offset.
+ *
+ * @return Pointer to the data, or NULL if the file does not exist.
+ */
+const uint8_t * mem_file_data_get(uint16_t index, uint32_t offset);
+
 /**@brief Function for reading data from file system.
  *
  * @param[in] index        The file index, 0 for directory.
@@ -49,7 +136,7 @@ void mem_file_read(uint16_t index, uint32_t offset, void * p_data, uint32_t size
  * @param[in] index        The file index.
  *
  * @retval true Operation success.
- * @retval true Operation failure.
+ * @retval false Operation failure.
  */
 bool mem_file_erase(uint16_t index);
 
@@ -59,7 +146,7 @@ bool mem_file_erase(uint16_t index);
  * @param[out] p_file_info The container where information is read.
  *
  * @retval true Operation success.
- * @retval true Operation failure.
+ * @retval false Operation failure.
  */
 bool mem_file_info_get(uint16_t index, antfs_dir_struct_t * p_file_info);
 
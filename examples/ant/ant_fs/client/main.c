@@ -21,6 +21,7 @@ All rights reserved.
 #include "antfs.h"
 #include "nrf.h"
 #include "nrf_sdm.h"
+#include "nrf_soc.h"
 #include "ant_interface.h"
 #include "mem.h"
 #include "bsp.h"
@@ -211,25 +212,24 @@ static void event_download_request_handle(const antfs_event_return_t * p_event)
  */
 static void event_download_data_handle(const antfs_event_return_t * p_event)
 {
-    // This example does not interact with a file system, and it does not account for latency for 
-    // reading or writing a file from EEPROM/flash. Prefetching the file might be useful to feed the 
-    // data to download in order to maintain the burst timing.           
+    // Files are memory mapped, so the data to download is fed to the burst straight from flash, 
+    // without being copied. This maintains the burst timing.           
     if (m_file_index == p_event->file_index)     
     {
         // Only send data for a file index matching the download request.
 
-        // Burst data block size * 8 bytes per burst packet.
-        uint8_t buffer[ANTFS_BURST_BLOCK_SIZE * 8]; 
         // Offset specified by client.        
         const uint32_t offset     = p_event->offset;    
         // Size of requested block of data.        
         const uint32_t data_bytes = p_event->bytes; 
+        // Block of data in memory.
+        const uint8_t * p_data    = mem_file_data_get(m_file_index, offset);
 
-        // Read block of data from memory.
-        mem_file_read(m_file_index, offset, buffer, data_bytes);    
-                
-        // @note: Suppress return value as no use case for handling it exists.
-        UNUSED_VARIABLE(antfs_input_data_download(m_file_index, offset, data_bytes, buffer));
+        if (p_data != NULL)
+        {
+            // @note: Suppress return value as no use case for handling it exists.
+            UNUSED_VARIABLE(antfs_input_data_download(m_file_index, offset, data_bytes, p_data));
+        }
     }
 }
 
@@ -244,9 +244,9 @@ static void event_upload_request_handle(const antfs_event_return_t * p_event)
 
     if ((p_event->offset == MAX_ULONG))  
     {
-        // Requesting to resume an upload.
+        // Requesting to resume an upload, from the last save point stored with the file.
         
-        if (m_file_index != p_event->file_index)
+        if (!mem_file_checkpoint_get(p_event->file_index, &m_file_offset, &m_current_crc))
         {
             // We do not have a save point for this file.
             m_file_offset = 0;
@@ -278,12 +278,19 @@ static void event_upload_request_handle(const antfs_event_return_t * p_event)
         m_response_info.file_index.data           = m_file_index;   
         // Current valid file size is the last offset written to the file.
         m_response_info.file_size.data            = m_file_offset;   
-        // Space available for writing is the file size, as specified on directory.
-        m_response_info.max_file_size             = m_temp_dir_structure.file_size_in_bytes;          
+        // Space available for writing is the flash space reserved for the file.
+        m_response_info.max_file_size             = MEM_FILE_MAX_SIZE;          
         // Get the entire file in a single burst if possible.
-        m_response_info.max_burst_block_size.data = m_temp_dir_structure.file_size_in_bytes;  
+        m_response_info.max_burst_block_size.data = MEM_FILE_MAX_SIZE;  
         // Last valid CRC.
         m_response_info.file_crc                  = m_current_crc;      
+
+        if ((response == RESPONSE_MESSAGE_OK) && 
+            !mem_file_write_start(m_file_index, m_file_offset, m_current_crc))
+        {
+            response = RESPONSE_MESSAGE_NOT_AVAILABLE;
+            printf("Upload request denied: file can not be written\n");
+        }
     }
     else    
     {
@@ -311,9 +318,8 @@ static void event_upload_request_handle(const antfs_event_return_t * p_event)
  */
 static void event_upload_data_handle(const antfs_event_return_t * p_event)
 {
-    // This example does not interact with a file system, and it does not account for latency for 
-    // reading or writing a file from EEPROM/flash. Buffering and other strategies might be useful 
-    // to handle a received upload, while maintaining the burst timing.             
+    // Received data is collected in page buffers, which are programmed to flash in the background 
+    // while the burst goes on, so flash latency does not break the burst timing.             
     if (m_upload_success && (m_file_index == p_event->file_index)) 
     {
         // Offset requested for upload. 
@@ -348,6 +354,13 @@ static __INLINE void event_upload_complete_handle(void)
 {
     printf("ANTFS_EVENT_UPLOAD_COMPLETE\n");
     
+    // Program the remaining data and update the file size in the directory.
+    if (m_upload_success && !mem_file_write_complete(m_file_index))
+    {
+        m_upload_success = false;
+        printf("Failed to complete file write\n");
+    }
+
     // @note: Suppress return value as no use case for handling it exists.
     UNUSED_VARIABLE(antfs_upload_data_resp_transmit(m_upload_success));
     if (m_upload_success)
@@ -478,6 +491,8 @@ static void antfs_event_process(const antfs_event_return_t * p_event)
             
         case ANTFS_EVENT_UPLOAD_FAIL:
             printf("ANTFS_EVENT_UPLOAD_FAIL\n");
+            // Keep the data received so far, the upload can be resumed from it.
+            mem_file_write_suspend(m_file_index);
             // @note: Suppress return value as no use case for handling it exists.
             UNUSED_VARIABLE(antfs_upload_data_resp_transmit(false));
             break;
@@ -603,6 +618,9 @@ int main(void)
     APP_ERROR_CHECK(err_code);
 
     softdevice_setup();
+
+    // Restore the file system from flash.
+    mem_init();
         
     const antfs_params_t params =
     {
@@ -620,10 +638,11 @@ int main(void)
 
     m_pairing_state = PAIRING_OFF; 
     
-    uint8_t event;
-    uint8_t ant_channel;
-    uint8_t event_message_buffer[ANT_EVENT_MSG_BUFFER_MIN_SIZE];  
-    bool    allow_sleep;    
+    uint8_t  event;
+    uint8_t  ant_channel;
+    uint32_t soc_event;
+    uint8_t  event_message_buffer[ANT_EVENT_MSG_BUFFER_MIN_SIZE];  
+    bool     allow_sleep;    
     for (;;)
     {
         allow_sleep = true;
@@ -642,6 +661,13 @@ int main(void)
             allow_sleep = false;
         }
 
+        // Process SoC event queue, reporting the file system flash operations.
+        if (sd_evt_get(&soc_event) == NRF_SUCCESS)
+        {
+            mem_sys_evt_handle(soc_event);
+            allow_sleep = false;
+        }
+
         // Process user feedback for pairing authentication request.
         if (m_pairing_state != PAIRING_OFF)
         {
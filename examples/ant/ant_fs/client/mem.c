@@ -8,19 +8,106 @@ All rights reserved.
 #include "mem.h"
 #include <stdio.h>
 #include <string.h>
+#include "nrf.h"
+#include "nrf_soc.h"
+#include "nrf_error.h"
+#include "app_error.h"
+#include "app_util.h"
+#include "nordic_common.h"
+#include "crc.h"
 
-#define MEM_DIR_SIZE          9u                     /**< Example directory size. */
-#define MEM_DIR_INVALID_INDEX 0xFFFFu                /**< Defined invalid index value. */
+#define MEM_DIR_SIZE            9u                                       /**< Example directory size. */
+#define MEM_FILE_INDEX_MAX      15u                                      /**< Highest file index of the file index lookup table. */
+#define MEM_SLOT_INVALID        0xFFu                                    /**< Defined invalid directory slot value. */
 
-// Sample constant directory structure.
+#define MEM_FLASH_PAGE_SIZE     1024u                                    /**< Size of an nRF51 flash page. */
+#define MEM_FLASH_PAGE_WORDS    (MEM_FLASH_PAGE_SIZE / sizeof(uint32_t)) /**< Number of words in a flash page. */
+#define MEM_DIR_PAGE_COUNT      2u                                       /**< Number of flash pages the directory is alternately written to. */
+#define MEM_JOURNAL_PAGE_COUNT  1u                                       /**< Number of flash pages of the checkpoint journal. */
+#define MEM_FLASH_PAGE_COUNT    (MEM_DIR_PAGE_COUNT + MEM_JOURNAL_PAGE_COUNT + \
+                                 (MEM_DIR_SIZE * MEM_FILE_PAGE_COUNT))   /**< Number of flash pages used by the file system. */
+#define MEM_ERASED_WORD         0xFFFFFFFFu                              /**< Value of an erased flash word. */
+#define MEM_DIR_MAGIC           0x46534449u                              /**< Value marking a completely written directory. */
+
+#define MEM_PAGE_BUFFER_COUNT   2u                                       /**< Number of page buffers, one being filled while the other one is programmed. */
+#define MEM_FLASH_OP_QUEUE_SIZE 8u                                       /**< Number of flash operations that can be queued. */
+#define MEM_FLASH_OP_RETRIES    3u                                       /**< Number of attempts of a flash operation. */
+#define MEM_FORMAT_CHUNK_SIZE   32u                                      /**< Number of test pattern bytes written at a time when formatting. */
+
+// Directory structure.
 typedef struct
 {
     antfs_dir_header_t header;                       /**< Directory header. */
     antfs_dir_struct_t directory_file[MEM_DIR_SIZE]; /**< Array of directory entry structures. */
 } directory_file_t;
 
-// Sample constant directory.
-static const directory_file_t m_directory =
+// Directory as stored in flash. The magic word is written last.
+typedef struct
+{
+    directory_file_t directory;                      /**< Directory. */
+    uint32_t         generation;                     /**< Incremented on every write, the highest one is the current directory. */
+    uint32_t         magic;                          /**< MEM_DIR_MAGIC once the directory has been written. */
+} directory_record_t;
+
+// Upload checkpoint, as stored in the journal.
+typedef struct
+{
+    uint16_t slot;                                   /**< Directory slot of the file. */
+    uint16_t crc;                                    /**< CRC of the data programmed. */
+    uint32_t offset;                                 /**< End of the data programmed, 0 if there is no checkpoint. */
+} journal_entry_t;
+
+#define MEM_JOURNAL_ENTRY_COUNT (MEM_FLASH_PAGE_SIZE / sizeof(journal_entry_t)) /**< Number of checkpoints in the journal page. */
+
+STATIC_ASSERT((sizeof(directory_record_t) % sizeof(uint32_t)) == 0);
+STATIC_ASSERT(sizeof(directory_record_t) <= MEM_FLASH_PAGE_SIZE);
+STATIC_ASSERT(sizeof(journal_entry_t) == (2 * sizeof(uint32_t)));
+
+// Page buffer state.
+typedef enum
+{
+    BUFFER_FREE = 0,                                 /**< Buffer not in use. */
+    BUFFER_FILLING,                                  /**< Buffer receiving upload data. */
+    BUFFER_COMMITTING                                /**< Buffer being programmed to flash. */
+} buffer_state_t;
+
+// Page of upload data.
+typedef struct
+{
+    uint32_t        data[MEM_FLASH_PAGE_WORDS];      /**< Page content. */
+    uint32_t        page_addr;                       /**< Address of the flash page. */
+    uint16_t        start;                           /**< First byte to program, word aligned. */
+    uint16_t        end;                             /**< Byte following the last valid byte. */
+    bool            erase;                           /**< The flash page must be erased before being programmed. */
+    journal_entry_t checkpoint;                      /**< Checkpoint recorded once the page has been programmed. */
+    buffer_state_t  state;                           /**< Buffer state. */
+} page_buffer_t;
+
+// Flash operation phases. Each queued operation goes through a sequence of phases.
+typedef enum
+{
+    PHASE_PAGE_ERASE,                                /**< Erase the page of a page buffer. */
+    PHASE_PAGE_WRITE,                                /**< Program a page buffer. */
+    PHASE_JOURNAL,                                   /**< Record a checkpoint, resolved to one of the two phases below. */
+    PHASE_JOURNAL_WRITE,                             /**< Append a checkpoint to the journal. */
+    PHASE_JOURNAL_ERASE,                             /**< Erase the full journal page. */
+    PHASE_JOURNAL_COMPACT,                           /**< Write the latest checkpoint of every file to the journal. */
+    PHASE_DIR_ERASE,                                 /**< Erase the directory page not holding the current directory. */
+    PHASE_DIR_WRITE,                                 /**< Write the directory. */
+    PHASE_DONE                                       /**< Operation completed. */
+} flash_phase_t;
+
+// Queued flash operation.
+typedef struct
+{
+    flash_phase_t   phase;                           /**< Current phase. */
+    page_buffer_t * p_buffer;                        /**< Page buffer to program, NULL once programmed. */
+    journal_entry_t entry;                           /**< Checkpoint to record. Source of the journal write. */
+    uint8_t         attempts;                        /**< Number of failed attempts of the current phase. */
+} flash_op_t;
+
+// Sample directory, written to flash when formatting.
+static const directory_file_t m_default_directory =
 {
     {
         ANTFS_DIR_STRUCT_VERSION,                             // Version 1, length of each subsequent entry = 16 bytes, system time not used.
@@ -35,146 +122,860 @@ static const directory_file_t m_directory =
         {2, 0x80,     2, 0, 0, 0xC0, 0x0000014E, 0x00007E65}, // Index 2, data type 128, identifier 2, read and write, 334 bytes in length.
         {3, 0x80,     3, 0, 0, 0xC0, 0x0000037B, 0x00007E67}, // Index 3, data type 128, identifier 3, read and write, 891 bytes in length.
         {4, 0x80,     3, 0, 0, 0xC0, 0x0000037B, 0x00007E6A}, // Index 4, data type 128, identifier 3, read and write, 891 bytes in length.
-        {5, 0x80,     3, 0, 0, 0xF0, 0x0001D4C0, 0x00007E6C}, // Index 5, data type 128, identifier 3, read, write, erase, archive, 120000 bytes in length.
+        {5, 0x80,     3, 0, 0, 0xF0, MEM_FILE_MAX_SIZE, 0x00007E6C}, // Index 5, data type 128, identifier 3, read, write, erase, archive, as long as a file can be.
         {6, 0x80,  0x0A, 0, 0, 0x80, 0x00000000, 0x00007E6F}  // Index 6, data type 128, identifier 10, read-only, 0 bytes in length.
     }
 };
 
+static uint32_t           m_flash_base;                              /**< Address of the first flash page of the file system. */
+static directory_file_t   m_directory;                               /**< Current directory. */
+static uint8_t            m_slot_of_index[MEM_FILE_INDEX_MAX + 1u];  /**< Directory slot of each file index. */
+static uint8_t            m_dir_page;                                /**< Directory page holding the current directory. */
+static uint32_t           m_dir_generation;                          /**< Generation of the current directory. */
+static directory_record_t m_dir_record;                              /**< Source of the directory write. */
+static journal_entry_t    m_checkpoints[MEM_DIR_SIZE];               /**< Latest checkpoint recorded for each file. */
+static journal_entry_t    m_journal_compact[MEM_DIR_SIZE];           /**< Source of the journal compaction. */
+static uint16_t           m_journal_count;                           /**< Number of entries written to the journal page. */
+static page_buffer_t      m_buffers[MEM_PAGE_BUFFER_COUNT];          /**< Upload page buffers. */
+static flash_op_t         m_ops[MEM_FLASH_OP_QUEUE_SIZE];            /**< Flash operation queue. */
+static uint8_t            m_op_head;                                 /**< Flash operation in progress. */
+static uint8_t            m_op_count;                                /**< Number of queued flash operations. */
+static bool               m_write_error;                             /**< A page of the current write could not be programmed. */
+
+// Current write stream.
+static struct
+{
+    uint8_t         slot;                                            /**< Directory slot of the file written, MEM_SLOT_INVALID if none. */
+    uint32_t        offset;                                          /**< Offset of the next byte. */
+    uint16_t        crc;                                             /**< CRC of the data up to the offset. */
+    page_buffer_t * p_buffer;                                        /**< Page buffer being filled, NULL if none. */
+} m_stream;
+
 
-/**@brief Function for getting an array index of a particular directory structure matching the
- *        requested file index.
+/**@brief Function for getting the directory slot of a file index.
  *
- * @param[in] index The file index identifier used for lookup.
+ * @param[in] index The file index.
  *
- * @return Upon success the array index, otherwise MEM_DIR_INVALID_INDEX.
+ * @return Upon success the directory slot, otherwise MEM_SLOT_INVALID.
  */
-static uint32_t index_lookup(uint32_t index)
+static uint8_t slot_get(uint16_t index)
 {
-    if (index)
+    if ((index == 0) || (index > MEM_FILE_INDEX_MAX))
     {
-        uint32_t idx;
-        for (idx = 0; idx < MEM_DIR_SIZE; idx++)
+        return MEM_SLOT_INVALID;
+    }
+
+    return m_slot_of_index[index];
+}
+
+
+/**@brief Function for building the file index lookup table from the directory.
+ */
+static void index_build(void)
+{
+    uint32_t slot;
+
+    memset(m_slot_of_index, MEM_SLOT_INVALID, sizeof(m_slot_of_index));
+
+    for (slot = 0; slot < MEM_DIR_SIZE; slot++)
+    {
+        const uint16_t index = m_directory.directory_file[slot].data_file_index;
+
+        if ((index != 0) && (index <= MEM_FILE_INDEX_MAX))
         {
-            if (m_directory.directory_file[idx].data_file_index == index)
-            {
-                return idx;
-            }
+            m_slot_of_index[index] = (uint8_t)slot;
         }
+    }
+}
+
+
+/**@brief Function for getting the address of a directory page.
+ *
+ * @param[in] page The directory page, 0 or 1.
+ */
+static __INLINE uint32_t dir_page_addr_get(uint32_t page)
+{
+    return m_flash_base + (page * MEM_FLASH_PAGE_SIZE);
+}
+
+
+/**@brief Function for getting the address of the journal page.
+ */
+static __INLINE uint32_t journal_addr_get(void)
+{
+    return m_flash_base + (MEM_DIR_PAGE_COUNT * MEM_FLASH_PAGE_SIZE);
+}
 
+
+/**@brief Function for getting the address of the data of a file.
+ *
+ * @param[in] slot The directory slot of the file.
+ */
+static __INLINE uint32_t file_addr_get(uint32_t slot)
+{
+    return m_flash_base +
+           ((MEM_DIR_PAGE_COUNT + MEM_JOURNAL_PAGE_COUNT + (slot * MEM_FILE_PAGE_COUNT)) *
+            MEM_FLASH_PAGE_SIZE);
+}
+
+
+/**@brief Function for starting the current phase of the flash operation in progress.
+ *
+ * @param[in] p_op The flash operation.
+ *
+ * @return NRF_SUCCESS if the SoftDevice accepted the flash access, otherwise an error code.
+ */
+static uint32_t op_phase_start(flash_op_t * p_op)
+{
+    page_buffer_t * p_buffer = p_op->p_buffer;
+    uint32_t        addr;
+
+    if (p_op->phase == PHASE_JOURNAL)
+    {
+        p_op->phase = (m_journal_count < MEM_JOURNAL_ENTRY_COUNT) ? PHASE_JOURNAL_WRITE
+                                                                   : PHASE_JOURNAL_ERASE;
     }
 
-    return MEM_DIR_INVALID_INDEX;
+    switch (p_op->phase)
+    {
+        case PHASE_PAGE_ERASE:
+            return sd_flash_page_erase(p_buffer->page_addr / MEM_FLASH_PAGE_SIZE);
+
+        case PHASE_PAGE_WRITE:
+            return sd_flash_write((uint32_t *)(p_buffer->page_addr + p_buffer->start),
+                                  &p_buffer->data[p_buffer->start / sizeof(uint32_t)],
+                                  (p_buffer->end - p_buffer->start + sizeof(uint32_t) - 1u) /
+                                  sizeof(uint32_t));
+
+        case PHASE_JOURNAL_WRITE:
+            addr = journal_addr_get() + (m_journal_count * sizeof(journal_entry_t));
+            return sd_flash_write((uint32_t *)addr,
+                                  (uint32_t *)&p_op->entry,
+                                  sizeof(journal_entry_t) / sizeof(uint32_t));
+
+        case PHASE_JOURNAL_ERASE:
+            return sd_flash_page_erase(journal_addr_get() / MEM_FLASH_PAGE_SIZE);
+
+        case PHASE_JOURNAL_COMPACT:
+            memcpy(m_journal_compact, m_checkpoints, sizeof(m_journal_compact));
+            m_journal_compact[p_op->entry.slot] = p_op->entry;
+            return sd_flash_write((uint32_t *)journal_addr_get(),
+                                  (uint32_t *)m_journal_compact,
+                                  (MEM_DIR_SIZE * sizeof(journal_entry_t)) / sizeof(uint32_t));
+
+        case PHASE_DIR_ERASE:
+            return sd_flash_page_erase(dir_page_addr_get(m_dir_page ^ 1u) / MEM_FLASH_PAGE_SIZE);
+
+        case PHASE_DIR_WRITE:
+            m_dir_record.directory  = m_directory;
+            m_dir_record.generation = m_dir_generation + 1u;
+            m_dir_record.magic      = MEM_DIR_MAGIC;
+            return sd_flash_write((uint32_t *)dir_page_addr_get(m_dir_page ^ 1u),
+                                  (uint32_t *)&m_dir_record,
+                                  sizeof(m_dir_record) / sizeof(uint32_t));
+
+        default:
+            return NRF_ERROR_INVALID_STATE;
+    }
 }
 
 
-bool mem_file_write(uint16_t index, uint32_t offset, const void * p_data, uint32_t size)
+/**@brief Function for moving the flash operation in progress to its next phase, once the current
+ *        phase has completed.
+ *
+ * @param[in] p_op The flash operation.
+ */
+static void op_phase_complete(flash_op_t * p_op)
 {
-    if ((index < MEM_DIR_SIZE + 1u) && (index > 0))
+    p_op->attempts = 0;
+
+    switch (p_op->phase)
     {
-        const uint32_t array_index = index_lookup(index);
-        if (array_index != MEM_DIR_INVALID_INDEX)
-        {
-            uint32_t loop_count = size / 8u;
-#ifndef TRACE_MEM_WRITE_OFF
-            uint8_t * p_trace = (uint8_t *)p_data;
-#endif // TRACE_MEM_WRITE_OFF
-            while (loop_count)
-            {
-#ifndef TRACE_MEM_WRITE_OFF // Do not define this if you want to trace out the upload buffer content.
-                printf("%#x-%#x-%#x-%#x-%#x-%#x-%#x-%#x\n",
-                    p_trace[0], p_trace[1], p_trace[2], p_trace[3],
-                    p_trace[4], p_trace[5], p_trace[6], p_trace[7]);
-#endif // TRACE_MEM_WRITE_OFF
-                --loop_count;
-            }
+        case PHASE_PAGE_ERASE:
+            p_op->phase = PHASE_PAGE_WRITE;
+            break;
+
+        case PHASE_PAGE_WRITE:
+            // The page is programmed: release the buffer and record the checkpoint.
+            p_op->entry           = p_op->p_buffer->checkpoint;
+            p_op->p_buffer->state = BUFFER_FREE;
+            p_op->p_buffer        = NULL;
+            p_op->phase           = PHASE_JOURNAL;
+            break;
+
+        case PHASE_JOURNAL_WRITE:
+            m_journal_count++;
+            m_checkpoints[p_op->entry.slot] = p_op->entry;
+            p_op->phase                     = PHASE_DONE;
+            break;
+
+        case PHASE_JOURNAL_ERASE:
+            p_op->phase = PHASE_JOURNAL_COMPACT;
+            break;
+
+        case PHASE_JOURNAL_COMPACT:
+            m_journal_count                 = MEM_DIR_SIZE;
+            m_checkpoints[p_op->entry.slot] = p_op->entry;
+            p_op->phase                     = PHASE_DONE;
+            break;
+
+        case PHASE_DIR_ERASE:
+            p_op->phase = PHASE_DIR_WRITE;
+            break;
+
+        case PHASE_DIR_WRITE:
+            m_dir_page      ^= 1u;
+            m_dir_generation = m_dir_record.generation;
+            p_op->phase      = PHASE_DONE;
+            break;
+
+        default:
+            p_op->phase = PHASE_DONE;
+            break;
+    }
+}
+
+
+/**@brief Function for handling a failed attempt of the current phase of the flash operation in
+ *        progress.
+ *
+ * @details The phase is attempted again, up to MEM_FLASH_OP_RETRIES times. Then the operation is
+ *          abandoned. If it was programming upload data, the current write fails.
+ *
+ * @param[in] p_op The flash operation.
+ */
+static void op_phase_fail(flash_op_t * p_op)
+{
+    if (++p_op->attempts < MEM_FLASH_OP_RETRIES)
+    {
+        return;
+    }
+
+    if (p_op->p_buffer != NULL)
+    {
+        p_op->p_buffer->state = BUFFER_FREE;
+        m_write_error         = true;
+    }
+    if (p_op->phase == PHASE_JOURNAL_WRITE)
+    {
+        // The entry may be partially written, do not write over it.
+        m_journal_count++;
+    }
 
-            return true;
+    p_op->phase = PHASE_DONE;
+}
+
+
+/**@brief Function for starting the next flash access, removing completed operations from the
+ *        queue.
+ */
+static void op_run(void)
+{
+    while (m_op_count > 0)
+    {
+        flash_op_t * p_op = &m_ops[m_op_head];
+
+        if (p_op->phase == PHASE_DONE)
+        {
+            m_op_head = (m_op_head + 1u) % MEM_FLASH_OP_QUEUE_SIZE;
+            m_op_count--;
+        }
+        else if (op_phase_start(p_op) == NRF_SUCCESS)
+        {
+            return;
         }
         else
+        {
+            op_phase_fail(p_op);
+        }
+    }
+}
+
+
+/**@brief Function for waiting for a flash operation to complete.
+ *
+ * @details Extracts one SoC event, or sleeps until the next one.
+ */
+static void flash_event_wait(void)
+{
+    uint32_t sys_evt;
+
+    if (sd_evt_get(&sys_evt) == NRF_SUCCESS)
+    {
+        mem_sys_evt_handle(sys_evt);
+    }
+    else
+    {
+        uint32_t err_code = sd_app_evt_wait();
+        APP_ERROR_CHECK(err_code);
+    }
+}
+
+
+/**@brief Function for waiting for all queued flash operations to complete.
+ */
+static void flash_idle_wait(void)
+{
+    while (m_op_count > 0)
+    {
+        flash_event_wait();
+    }
+}
+
+
+/**@brief Function for queuing a flash operation.
+ *
+ * @details Waits for a free queue element if the queue is full.
+ *
+ * @param[in] phase    The first phase of the operation.
+ * @param[in] p_buffer The page buffer to program, or NULL.
+ * @param[in] p_entry  The checkpoint to record, or NULL.
+ */
+static void op_queue(flash_phase_t phase, page_buffer_t * p_buffer, const journal_entry_t * p_entry)
+{
+    flash_op_t * p_op;
+
+    while (m_op_count == MEM_FLASH_OP_QUEUE_SIZE)
+    {
+        flash_event_wait();
+    }
+
+    p_op           = &m_ops[(m_op_head + m_op_count) % MEM_FLASH_OP_QUEUE_SIZE];
+    p_op->phase    = phase;
+    p_op->p_buffer = p_buffer;
+    p_op->attempts = 0;
+    if (p_entry != NULL)
+    {
+        p_op->entry = *p_entry;
+    }
+
+    if (m_op_count++ == 0)
+    {
+        op_run();
+    }
+}
+
+
+/**@brief Function for writing the directory to flash.
+ */
+static void dir_commit(void)
+{
+    op_queue(PHASE_DIR_ERASE, NULL, NULL);
+}
+
+
+/**@brief Function for recording that a file has no checkpoint.
+ *
+ * @param[in] slot The directory slot of the file.
+ */
+static void checkpoint_clear(uint8_t slot)
+{
+    const journal_entry_t entry = {slot, 0, 0};
+
+    op_queue(PHASE_JOURNAL, NULL, &entry);
+}
+
+
+/**@brief Function for checking that flash bytes are erased.
+ *
+ * @param[in] p_flash The first byte.
+ * @param[in] size    The number of bytes.
+ */
+static bool flash_is_erased(const uint8_t * p_flash, uint32_t size)
+{
+    while (size--)
+    {
+        if (*p_flash++ != 0xFFu)
         {
             return false;
         }
+    }
+
+    return true;
+}
+
+
+/**@brief Function for getting a page buffer to receive the data at a file offset.
+ *
+ * @details Waits for a free page buffer. If the rest of the page is erased, only the new data is
+ *          programmed. Otherwise the page is erased before being programmed, and the data
+ *          preceding the offset is kept.
+ *
+ * @param[in] slot   The directory slot of the file.
+ * @param[in] offset The file offset.
+ *
+ * @return The page buffer.
+ */
+static page_buffer_t * buffer_begin(uint8_t slot, uint32_t offset)
+{
+    const uint32_t  page_offset = offset % MEM_FLASH_PAGE_SIZE;
+    const uint32_t  page_addr   = file_addr_get(slot) + offset - page_offset;
+    const uint8_t * p_flash     = (const uint8_t *)page_addr;
+    page_buffer_t * p_buffer    = NULL;
+
+    while (p_buffer == NULL)
+    {
+        uint32_t i;
+
+        for (i = 0; i < MEM_PAGE_BUFFER_COUNT; i++)
+        {
+            if (m_buffers[i].state == BUFFER_FREE)
+            {
+                p_buffer = &m_buffers[i];
+                break;
+            }
+        }
 
+        if (p_buffer == NULL)
+        {
+            // Both buffers are being programmed.
+            flash_event_wait();
+        }
     }
 
-    return false;
+    memset(p_buffer->data, 0xFF, sizeof(p_buffer->data));
+
+    p_buffer->page_addr = page_addr;
+    p_buffer->erase     = !flash_is_erased(p_flash + page_offset, MEM_FLASH_PAGE_SIZE - page_offset);
+    p_buffer->start     = p_buffer->erase ? 0 : (page_offset & ~(sizeof(uint32_t) - 1u));
+    p_buffer->end       = page_offset;
+    p_buffer->state     = BUFFER_FILLING;
+
+    memcpy((uint8_t *)p_buffer->data + p_buffer->start,
+           p_flash + p_buffer->start,
+           p_buffer->end - p_buffer->start);
+
+    return p_buffer;
 }
 
 
-void mem_file_read(uint16_t index, uint32_t offset, void * p_data, uint32_t size)
+/**@brief Function for programming the page buffer of the current write stream to flash.
+ */
+static void stream_flush(void)
 {
-    if (index == 0)
+    page_buffer_t * p_buffer = m_stream.p_buffer;
+
+    if (p_buffer == NULL)
     {
-        // Directory.
+        return;
+    }
+
+    m_stream.p_buffer = NULL;
+
+    p_buffer->checkpoint.slot   = m_stream.slot;
+    p_buffer->checkpoint.crc    = m_stream.crc;
+    p_buffer->checkpoint.offset = m_stream.offset;
 
-        uint8_t * p_directory = (uint8_t*) &m_directory;
-        memcpy((uint8_t*)p_data, p_directory + offset, size);
+    if (p_buffer->erase || (p_buffer->end > p_buffer->start))
+    {
+        p_buffer->state = BUFFER_COMMITTING;
+        op_queue(p_buffer->erase ? PHASE_PAGE_ERASE : PHASE_PAGE_WRITE, p_buffer, NULL);
     }
     else
     {
-        // Fake data (no actual files stored in memory for this reference design).
+        p_buffer->state = BUFFER_FREE;
+    }
+}
 
-        uint32_t idx;
-        uint8_t* p_data_access = (uint8_t*)p_data;
-        for (idx = 0; idx < size; idx++)
+
+/**@brief Function for appending data to the current write stream.
+ *
+ * @details Full page buffers are programmed in the background while the next one is filled.
+ *
+ * @param[in] p_data The data.
+ * @param[in] size   The number of bytes.
+ */
+static void stream_write(const void * p_data, uint32_t size)
+{
+    const uint8_t * p_source = (const uint8_t *)p_data;
+
+    while (size > 0)
+    {
+        page_buffer_t * p_buffer;
+        uint32_t        chunk;
+
+        if (m_stream.p_buffer == NULL)
+        {
+            m_stream.p_buffer = buffer_begin(m_stream.slot, m_stream.offset);
+        }
+        p_buffer = m_stream.p_buffer;
+
+        chunk = MIN(size, MEM_FLASH_PAGE_SIZE - p_buffer->end);
+        memcpy((uint8_t *)p_buffer->data + p_buffer->end, p_source, chunk);
+
+        m_stream.crc     = crc_crc16_update(m_stream.crc, p_source, chunk);
+        m_stream.offset += chunk;
+        p_buffer->end   += chunk;
+        p_source        += chunk;
+        size            -= chunk;
+
+        if (p_buffer->end == MEM_FLASH_PAGE_SIZE)
         {
-            p_data_access[idx] = ((uint8_t)(offset + idx));
+            stream_flush();
         }
     }
 }
 
 
-bool mem_file_erase(uint16_t index)
+/**@brief Function for formatting the file system.
+ *
+ * @details Writes the sample directory, and fills the files which can be downloaded with a test
+ *          pattern.
+ */
+static void format(void)
 {
-    if ((index < MEM_DIR_SIZE + 1u) && (index > 0))
+    uint8_t  pattern[MEM_FORMAT_CHUNK_SIZE];
+    uint32_t slot;
+
+    printf("Formatting file system\n");
+
+    m_directory      = m_default_directory;
+    m_dir_page       = 1u;
+    m_dir_generation = 0;
+    index_build();
+
+    // Start the journal over.
+    m_journal_count = MEM_JOURNAL_ENTRY_COUNT;
+    checkpoint_clear(0);
+
+    for (slot = 0; slot < MEM_DIR_SIZE; slot++)
     {
-        const uint32_t array_index = index_lookup(index);
-        if (array_index != MEM_DIR_INVALID_INDEX)
+        const antfs_dir_struct_t * p_file = &m_directory.directory_file[slot];
+        uint32_t                   offset = 0;
+
+        if (!(p_file->general_flags & ANTFS_DIR_READ_MASK) || (p_file->file_size_in_bytes == 0))
         {
-            // Erase file. This function is implementation specific. There are no actual files in
-            // memory for this reference design, so there is nothing to erase.
-            return true;
+            continue;
         }
-        else
+
+        UNUSED_VARIABLE(mem_file_write_start(p_file->data_file_index, 0, 0));
+        while (offset < p_file->file_size_in_bytes)
         {
-            return false;
+            const uint32_t size = MIN(sizeof(pattern), p_file->file_size_in_bytes - offset);
+            uint32_t       idx;
+
+            for (idx = 0; idx < size; idx++)
+            {
+                pattern[idx] = (uint8_t)(offset + idx);
+            }
+            stream_write(pattern, size);
+            offset += size;
         }
+        stream_flush();
+        m_stream.slot = MEM_SLOT_INVALID;
+
+        checkpoint_clear(slot);
     }
 
-    return false;
+    dir_commit();
+    flash_idle_wait();
 }
 
 
-bool mem_file_info_get(uint16_t index, antfs_dir_struct_t * p_file_info)
+void mem_init(void)
 {
-    if (index < (MEM_DIR_SIZE + 1u))
+    const journal_entry_t * p_journal;
+    uint32_t                end_page;
+    uint32_t                page;
+    uint32_t                idx;
+    bool                    is_found = false;
+
+    end_page = (NRF_UICR->BOOTLOADERADDR != MEM_ERASED_WORD) ?
+               (NRF_UICR->BOOTLOADERADDR / MEM_FLASH_PAGE_SIZE) : NRF_FICR->CODESIZE;
+
+    m_flash_base    = (end_page - MEM_FLASH_PAGE_COUNT) * MEM_FLASH_PAGE_SIZE;
+    m_op_head       = 0;
+    m_op_count      = 0;
+    m_write_error   = false;
+    m_stream.slot   = MEM_SLOT_INVALID;
+    m_stream.p_buffer = NULL;
+
+    for (idx = 0; idx < MEM_PAGE_BUFFER_COUNT; idx++)
     {
-        if (index == 0)
-        {
-            // Requested directory.
+        m_buffers[idx].state = BUFFER_FREE;
+    }
 
-            // Set can download flag.
-            p_file_info->general_flags = 0x80u;
+    // Restore the checkpoints, the latest entry of a file being the valid one.
+    for (idx = 0; idx < MEM_DIR_SIZE; idx++)
+    {
+        m_checkpoints[idx].slot   = (uint16_t)idx;
+        m_checkpoints[idx].crc    = 0;
+        m_checkpoints[idx].offset = 0;
+    }
 
-            p_file_info->file_size_in_bytes =
-                // Header + directory structures.
-                (uint32_t)(MEM_DIR_SIZE + 1u) * sizeof(antfs_dir_struct_t);
+    p_journal       = (const journal_entry_t *)journal_addr_get();
+    m_journal_count = 0;
+    for (idx = 0; idx < MEM_JOURNAL_ENTRY_COUNT; idx++)
+    {
+        if (*(const uint32_t *)&p_journal[idx] == MEM_ERASED_WORD)
+        {
+            break;
+        }
 
-            // Directory is index 0
-            p_file_info->data_file_index = 0;
+        m_journal_count = (uint16_t)(idx + 1u);
+        if ((p_journal[idx].offset != MEM_ERASED_WORD) && (p_journal[idx].slot < MEM_DIR_SIZE))
+        {
+            m_checkpoints[p_journal[idx].slot] = p_journal[idx];
         }
-        else
+    }
+
+    // Restore the directory with the highest generation.
+    for (page = 0; page < MEM_DIR_PAGE_COUNT; page++)
+    {
+        const directory_record_t * p_record = (const directory_record_t *)dir_page_addr_get(page);
+
+        if ((p_record->magic == MEM_DIR_MAGIC) &&
+            (!is_found || (p_record->generation > m_dir_generation)))
         {
-            // Requested a file.
+            m_directory      = p_record->directory;
+            m_dir_page       = (uint8_t)page;
+            m_dir_generation = p_record->generation;
+            is_found         = true;
+        }
+    }
+
+    if (is_found)
+    {
+        index_build();
+    }
+    else
+    {
+        format();
+    }
+}
+
+
+void mem_sys_evt_handle(uint32_t sys_evt)
+{
+    if ((m_op_count == 0) ||
+        ((sys_evt != NRF_EVT_FLASH_OPERATION_SUCCESS) && (sys_evt != NRF_EVT_FLASH_OPERATION_ERROR)))
+    {
+        return;
+    }
+
+    if (sys_evt == NRF_EVT_FLASH_OPERATION_SUCCESS)
+    {
+        op_phase_complete(&m_ops[m_op_head]);
+    }
+    else
+    {
+        op_phase_fail(&m_ops[m_op_head]);
+    }
+
+    op_run();
+}
+
+
+bool mem_file_write_start(uint16_t index, uint32_t offset, uint16_t crc)
+{
+    const uint8_t slot = slot_get(index);
+
+    if ((slot == MEM_SLOT_INVALID) || (offset > MEM_FILE_MAX_SIZE))
+    {
+        return false;
+    }
+
+    // Pages are checked for being erased, so earlier writes must have reached the flash.
+    stream_flush();
+    flash_idle_wait();
+
+    m_write_error     = false;
+    m_stream.slot     = slot;
+    m_stream.offset   = offset;
+    m_stream.crc      = crc;
+    m_stream.p_buffer = NULL;
 
-            const uint32_t array_index = index_lookup(index);
-            memcpy(p_file_info,
-                   &m_directory.directory_file[array_index],
-                   sizeof(antfs_dir_struct_t));
+    return true;
+}
+
+
+bool mem_file_write(uint16_t index, uint32_t offset, const void * p_data, uint32_t size)
+{
+    const uint8_t slot = slot_get(index);
+
+    if ((slot == MEM_SLOT_INVALID) || (slot != m_stream.slot) || (offset != m_stream.offset) ||
+        ((offset + size) > MEM_FILE_MAX_SIZE) || m_write_error)
+    {
+        return false;
+    }
+
+    uint32_t loop_count = size / 8u;
+#ifndef TRACE_MEM_WRITE_OFF
+    const uint8_t * p_trace = (const uint8_t *)p_data;
+#endif // TRACE_MEM_WRITE_OFF
+    while (loop_count)
+    {
+#ifndef TRACE_MEM_WRITE_OFF // Do not define this if you want to trace out the upload buffer content.
+        printf("%#x-%#x-%#x-%#x-%#x-%#x-%#x-%#x\n",
+            p_trace[0], p_trace[1], p_trace[2], p_trace[3],
+            p_trace[4], p_trace[5], p_trace[6], p_trace[7]);
+#endif // TRACE_MEM_WRITE_OFF
+        --loop_count;
+    }
+
+    stream_write(p_data, size);
+
+    return true;
+}
+
+
+void mem_file_write_suspend(uint16_t index)
+{
+    if ((slot_get(index) != MEM_SLOT_INVALID) && (slot_get(index) == m_stream.slot))
+    {
+        stream_flush();
+        m_stream.slot = MEM_SLOT_INVALID;
+    }
+}
+
+
+bool mem_file_write_complete(uint16_t index)
+{
+    const uint8_t slot = slot_get(index);
+
+    if ((slot == MEM_SLOT_INVALID) || (slot != m_stream.slot))
+    {
+        return false;
+    }
+
+    stream_flush();
+    m_stream.slot = MEM_SLOT_INVALID;
+    flash_idle_wait();
+
+    if (m_write_error)
+    {
+        return false;
+    }
+
+    m_directory.directory_file[slot].file_size_in_bytes = m_stream.offset;
+    dir_commit();
+    checkpoint_clear(slot);
+
+    return true;
+}
+
+
+bool mem_file_checkpoint_get(uint16_t index, uint32_t * p_offset, uint16_t * p_crc)
+{
+    const uint8_t slot = slot_get(index);
+
+    if (slot == MEM_SLOT_INVALID)
+    {
+        return false;
+    }
+
+    flash_idle_wait();
+
+    if (m_checkpoints[slot].offset == 0)
+    {
+        return false;
+    }
+
+    *p_offset = m_checkpoints[slot].offset;
+    *p_crc    = m_checkpoints[slot].crc;
+
+    return true;
+}
+
+
+const uint8_t * mem_file_data_get(uint16_t index, uint32_t offset)
+{
+    uint8_t slot;
+
+    if (index == 0)
+    {
+        // Directory.
+
+        return (offset <= sizeof(m_directory)) ? ((const uint8_t *)&m_directory + offset) : NULL;
+    }
+
+    slot = slot_get(index);
+    if ((slot == MEM_SLOT_INVALID) || (offset > MEM_FILE_MAX_SIZE))
+    {
+        return NULL;
+    }
+
+    // The data read must have reached the flash.
+    flash_idle_wait();
+
+    return (const uint8_t *)file_addr_get(slot) + offset;
+}
+
+
+void mem_file_read(uint16_t index, uint32_t offset, void * p_data, uint32_t size)
+{
+    const uint8_t * p_file_data = mem_file_data_get(index, offset);
+
+    if (p_file_data != NULL)
+    {
+        memcpy(p_data, p_file_data, size);
+    }
+    else
+    {
+        memset(p_data, 0, size);
+    }
+}
+
+
+bool mem_file_erase(uint16_t index)
+{
+    const uint8_t slot = slot_get(index);
+
+    if (slot == MEM_SLOT_INVALID)
+    {
+        return false;
+    }
+
+    if (slot == m_stream.slot)
+    {
+        // Drop the data not programmed yet.
+        if (m_stream.p_buffer != NULL)
+        {
+            m_stream.p_buffer->state = BUFFER_FREE;
+            m_stream.p_buffer        = NULL;
         }
+        m_stream.slot = MEM_SLOT_INVALID;
+    }
+
+    // The data pages are erased when the file is written again.
+    m_directory.directory_file[slot].file_size_in_bytes = 0;
+    dir_commit();
+    checkpoint_clear(slot);
+
+    return true;
+}
+
+
+bool mem_file_info_get(uint16_t index, antfs_dir_struct_t * p_file_info)
+{
+    if (index == 0)
+    {
+        // Requested directory.
+
+        // Set can download flag.
+        p_file_info->general_flags = 0x80u;
+
+        p_file_info->file_size_in_bytes =
+            // Header + directory structures.
+            (uint32_t)(MEM_DIR_SIZE + 1u) * sizeof(antfs_dir_struct_t);
+
+        // Directory is index 0
+        p_file_info->data_file_index = 0;
 
         return true;
     }
+    else
+    {
+        // Requested a file.
+
+        const uint8_t slot = slot_get(index);
+        if (slot == MEM_SLOT_INVALID)
+        {
+            return false;
+        }
 
-    return false;
+        memcpy(p_file_info, &m_directory.directory_file[slot], sizeof(antfs_dir_struct_t));
+
+        return true;
+    }
 }
@@ -21,6 +21,7 @@
 #include "ble.h"
 #include "ble_hci.h"
 #include "ble_db_discovery.h"
+#include "ble_gattc_queue.h"
 #include "softdevice_handler.h"
 #include "app_util.h"
 #include "app_error.h"
@@ -461,6 +462,7 @@ static void ble_evt_dispatch(ble_evt_t * p_ble_evt)
     ble_db_discovery_on_ble_evt(&m_ble_db_discovery, p_ble_evt);
     ble_hrs_c_on_ble_evt(&m_ble_hrs_c, p_ble_evt);
     ble_bas_c_on_ble_evt(&m_ble_bas_c, p_ble_evt);
+    ble_gattc_queue_on_ble_evt(p_ble_evt);
     bsp_btn_ble_on_ble_evt(p_ble_evt);
     on_ble_evt(p_ble_evt);
 }
@@ -719,6 +721,15 @@ static void bas_c_init(void)
 }
 
 
+/**@brief Function for initializing the GATT Client Request Queue module.
+ */
+static void gattc_queue_init(void)
+{
+    uint32_t err_code = ble_gattc_queue_init();
+    APP_ERROR_CHECK(err_code);
+}
+
+
 /**
  * @brief Database discovery collector initialization.
  */
@@ -864,6 +875,7 @@ int main(void)
     ble_stack_init();
     device_manager_init(erase_bonds);
     db_discovery_init();
+    gattc_queue_init();
     hrs_c_init();
     bas_c_init();
 
@@ -21,6 +21,7 @@
 #include "ble.h"
 #include "ble_hci.h"
 #include "ble_db_discovery.h"
+#include "ble_gattc_queue.h"
 #include "softdevice_handler.h"
 #include "app_util.h"
 #include "app_error.h"
@@ -460,6 +461,7 @@ static void ble_evt_dispatch(ble_evt_t * p_ble_evt)
     dm_ble_evt_handler(p_ble_evt);
     ble_db_discovery_on_ble_evt(&m_ble_db_discovery, p_ble_evt);
     ble_rscs_c_on_ble_evt(&m_ble_rsc_c, p_ble_evt);
+    ble_gattc_queue_on_ble_evt(p_ble_evt);
     bsp_btn_ble_on_ble_evt(p_ble_evt);
     on_ble_evt(p_ble_evt);
 }
@@ -678,6 +680,15 @@ static void rscs_c_init(void)
 }
 
 
+/**@brief Function for initializing the GATT Client Request Queue module.
+ */
+static void gattc_queue_init(void)
+{
+    uint32_t err_code = ble_gattc_queue_init();
+    APP_ERROR_CHECK(err_code);
+}
+
+
 /**
  * @brief Database discovery collector initialization.
  */
@@ -823,6 +834,7 @@ int main(void)
     ble_stack_init();
     device_manager_init(erase_bonds);
     db_discovery_init();
+    gattc_queue_init();
     rscs_c_init();
 
     // Start scanning for peripherals and initiate connection
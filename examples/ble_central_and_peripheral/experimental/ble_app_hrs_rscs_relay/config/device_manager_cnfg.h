@@ -91,6 +91,46 @@
  */
 #define DEVICE_MANAGER_APP_CONTEXT_SIZE    20
 
+
+/**
+ * @brief Size of GATT Client context.
+ *
+ * @details Size of GATT Client context, for example a cache of the handles found by service
+ *          discovery, that Device Manager should manage for each bonded device. Size has to be a
+ *          multiple of word size.
+ *          Minimum value : 0, GATT Client context is not managed.
+ *          Maximum value : 256.
+ *          Dependencies  : Needed only if the application registers with
+ *                          DM_PROTOCOL_CNTXT_GATT_CLI_ID or DM_PROTOCOL_CNTXT_ALL.
+ */
+#define DEVICE_MANAGER_GATTC_CONTEXT_SIZE  96 /**< Holds a ble_db_discovery_cache_t. */
+
+
+/**
+ * @brief Defer persistent storage of device and service contexts.
+ *
+ * @details When set to 1, bond information and GATT Server context are marked dirty on security
+ *          and GATT events instead of being written immediately. Dirty contexts are flushed in
+ *          one coalesced write on disconnection, or after DM_DEFERRED_STORE_IDLE_TIMEOUT.
+ *          Minimum value : 0
+ *          Maximum value : 1
+ *          Dependencies  : None.
+ */
+#define DM_DEFERRED_STORE_ENABLED          1
+
+
+/**
+ * @brief Idle time after which dirty contexts of an active connection are flushed.
+ *
+ * @details Time in app_timer ticks after the last context change before dirty contexts of an
+ *          encrypted link are flushed without waiting for disconnection.
+ *          Minimum value : 0, contexts are only flushed on disconnection.
+ *          Maximum value : Maximum app_timer timeout.
+ *          Dependencies  : DM_DEFERRED_STORE_ENABLED, app_timer and one extra timer in
+ *                          APP_TIMER_MAX_TIMERS if non-zero.
+ */
+#define DM_DEFERRED_STORE_IDLE_TIMEOUT     (30 * 32768) /**< 30 seconds with APP_TIMER_PRESCALER 0. */
+
 /** @} */
 /** @} */
 /** @endcond */
@@ -40,7 +40,8 @@ static __INLINE uint32_t pstorage_flash_page_end()
 
 #define PSTORAGE_FLASH_PAGE_END pstorage_flash_page_end()
 
-#define PSTORAGE_NUM_OF_PAGES       1                                                           /**< Number of flash pages allocated for the pstorage module excluding the swap page, configurable based on system requirements. */
+#define BLE_BPRS_DB_FLASH_PAGES     60                                                          /**< Number of flash pages holding the blood pressure records (32 records per page). */
+#define PSTORAGE_NUM_OF_PAGES       (1 + BLE_BPRS_DB_FLASH_PAGES)                               /**< Number of flash pages allocated for the pstorage module excluding the swap page, configurable based on system requirements. */
 #define PSTORAGE_MIN_BLOCK_SIZE     0x0010                                                      /**< Minimum size of block that can be registered with the module. Should be configured based on system requirements, recommendation is not have this value to be at least size of word. */
 
 #define PSTORAGE_DATA_START_ADDR    ((PSTORAGE_FLASH_PAGE_END - PSTORAGE_NUM_OF_PAGES - 1) \
@@ -48,6 +49,17 @@ static __INLINE uint32_t pstorage_flash_page_end()
 #define PSTORAGE_DATA_END_ADDR      ((PSTORAGE_FLASH_PAGE_END - 1) * PSTORAGE_FLASH_PAGE_SIZE)  /**< End address for persistent data, configurable according to system requirements. */
 #define PSTORAGE_SWAP_ADDR          PSTORAGE_DATA_END_ADDR                                      /**< Top-most page is used as swap area for clear and update. */
 
+#ifndef FLASH_LAYOUT_APP_END
+#define FLASH_LAYOUT_APP_END        0x40000                                                     /**< End of the flash available to the application: the end of the 256 kB flash, or the start of the bootloader if one is present. */
+#endif
+#define FLASH_LAYOUT_PAGE_SIZE      0x400                                                       /**< Size of one nRF51 flash page. */
+#define FLASH_LAYOUT_APP_START      0x1C000                                                     /**< Start of the application, following the S130 SoftDevice. Must match the start of IROM1 in the project. */
+#define FLASH_LAYOUT_APP_CODE_SIZE  0x14800                                                     /**< Flash reserved for the application code. Must match the size of IROM1 in the project. */
+
+#if (FLASH_LAYOUT_APP_START + FLASH_LAYOUT_APP_CODE_SIZE + ((PSTORAGE_NUM_OF_PAGES + 1) * FLASH_LAYOUT_PAGE_SIZE)) > FLASH_LAYOUT_APP_END
+#error "The persistent storage pages, swap page included, overlap the application code. Reduce BLE_BPRS_DB_FLASH_PAGES or the application code size."
+#endif
+
 #define PSTORAGE_MAX_BLOCK_SIZE     PSTORAGE_FLASH_PAGE_SIZE                                    /**< Maximum size of block that can be registered with the module. Should be configured based on system requirements. And should be greater than or equal to the minimum size. */
 #define PSTORAGE_CMD_QUEUE_SIZE     10                                                          /**< Maximum number of flash access commands that can be maintained by the module for all applications. Configurable. */
 
@@ -51,6 +51,8 @@
 #include "ble.h"
 #include "ble_hci.h"
 #include "ble_db_discovery.h"
+#include "ble_gattc_queue.h"
+#include "ble_evt_router.h"
 #include "softdevice_handler.h"
 #include "app_util.h"
 #include "app_error.h"
@@ -68,9 +70,12 @@
 #include "bsp_btn_ble.h"
 
 #include "ble_advdata.h"
+#include "ble_scan_filter.h"
+#include "ble_conn_mgr.h"
 #include "ble_advertising.h"
 #include "ble_hrs.h"
 #include "ble_rscs.h"
+#include "ble_bprs.h"
 #include "ble_conn_params.h"
 #include "app_timer.h"
 
@@ -86,8 +91,9 @@
 #define BOND_DELETE_ALL_BUTTON_ID  0                                  /**< Button used for deleting all bonded centrals during startup. */
 
 #define APP_TIMER_PRESCALER        0                                  /**< Value of the RTC1 PRESCALER register. */
-#define APP_TIMER_MAX_TIMERS       (2+BSP_APP_TIMERS_NUMBER)          /**< Maximum number of simultaneously created timers. */
+#define APP_TIMER_MAX_TIMERS       (3+BSP_APP_TIMERS_NUMBER)          /**< Maximum number of simultaneously created timers. */
 #define APP_TIMER_OP_QUEUE_SIZE    2                                  /**< Size of timer operation queues. */
+#define TICKS_TO_MS(TICKS)         ((uint32_t)ROUNDED_DIV((TICKS) * (uint64_t)1000 * (APP_TIMER_PRESCALER + 1), APP_TIMER_CLOCK_FREQ)) /**< Converts a number of timer ticks to milliseconds. */
 
 //#define APPL_LOG                   app_trace_log                      /**< Debug logger macro that will be used in this file to do logging of debug information over UART. */
 
@@ -108,10 +114,14 @@
 
 #define TARGET_UUID                0x180D                             /**< Target device name that application is looking for. */
 #define MAX_PEER_COUNT             DEVICE_MANAGER_MAX_CONNECTIONS     /**< Maximum number of peer's application intends to manage. */
-#define UUID16_SIZE                2                                  /**< Size of 16 bit UUID */
 
 #define PERIPHERALS_MAX_NUM        2
 
+#define SCAN_DUP_TIMEOUT           APP_TIMER_TICKS(1000, APP_TIMER_PRESCALER) /**< Time during which a repeated advertising report is dropped (1 second). */
+#define CONNECT_TIMEOUT            5                                  /**< Timeout of a connection procedure in seconds, after which scanning resumes. */
+#define CONNECT_BACKOFF_MIN        APP_TIMER_TICKS(500, APP_TIMER_PRESCALER)  /**< Delay before retrying after the first failed connection procedure (0.5 seconds). */
+#define CONNECT_BACKOFF_MAX        APP_TIMER_TICKS(8000, APP_TIMER_PRESCALER) /**< Largest delay between connection procedures (8 seconds). */
+
 #define APP_BEACON_MANUF_DATA_LEN       0x17                              /**< Total length of information advertised by the beacon. */
 #define APP_ADV_DATA_LENGTH             0x15                              /**< Length of manufacturer specific data in the advertisement. */
 #define APP_DEVICE_TYPE                 0x02                              /**< 0x02 refers to beacon. */
@@ -136,22 +146,6 @@
 #define APP_BEACON_ADV_TIMEOUT               0
 #define NON_CONNECTABLE_ADV_INTERVAL    MSEC_TO_UNITS(100, UNIT_0_625_MS) /**< The advertising interval for non-connectable advertisement (100 ms). This value can vary between 100ms to 10.24s). */
 
-/**@breif Macro to unpack 16bit unsigned UUID from octet stream. */
-#define UUID16_EXTRACT(DST, SRC) \
-    do                           \
-    {                            \
-        (*(DST))   = (SRC)[1];   \
-        (*(DST)) <<= 8;          \
-        (*(DST))  |= (SRC)[0];   \
-    } while (0)
-
-/**@brief Variable length data encapsulation in terms of length and pointer to data */
-typedef struct
-{
-    uint8_t     * p_data;    /**< Pointer to data. */
-    uint16_t      data_len;  /**< Length of data. */
-}data_t;
-
 typedef enum
 {
     BLE_NO_SCAN,         /**< No advertising running. */
@@ -182,7 +176,8 @@ typedef union
 }beacon_flash_db_t;
 
 
-static ble_db_discovery_t        m_ble_db_discovery;                               /**< Structure used to identify the DB Discovery module. */
+static ble_db_discovery_t        m_ble_db_discovery[DEVICE_MANAGER_MAX_CONNECTIONS]; /**< DB Discovery instance of each link, indexed by Device Manager connection instance, so that links are discovered concurrently. */
+static uint8_t                   m_db_discovery_route[DEVICE_MANAGER_MAX_CONNECTIONS]; /**< Event router registration of each DB Discovery instance. */
 static ble_hrs_c_t               m_ble_hrs_c;                                      /**< Structure used to identify the heart rate client module. */
 static ble_rscs_c_t              m_ble_rsc_c;                                      /**< Structure used to identify the running speed and cadence client module. */
 static beacon_mode_t        m_beacon_mode;                                          /**< Current beacon mode */
@@ -204,12 +199,17 @@ static volatile bool             m_whitelist_temporarily_disabled = false;
 
 static bool                      m_memory_access_in_progress = false;              /**< Flag to keep track of ongoing operations on persistent memory. */
 
+STATIC_ASSERT(sizeof(ble_db_discovery_cache_t) <= DEVICE_MANAGER_GATTC_CONTEXT_SIZE); /**< The GATT Client context of a bonded peer holds its discovered database. */
+
 
 //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<,
 #include "ble_bp_c.h"
-static uint16_t                  m_conn_handle_central_bp = BLE_CONN_HANDLE_INVALID;
-ble_gap_addr_t                   m_bp_peripheral_address;
-static ble_bp_c_t               m_ble_bp_c; 
+static uint16_t                  m_conn_handle_central_bp[BLE_BP_C_MAX_INSTANCES]; /**< Connection handle of each cuff, BLE_CONN_HANDLE_INVALID if not connected. */
+static ble_gap_addr_t            m_bp_peripheral_address[BLE_BP_C_MAX_INSTANCES];  /**< Address of each cuff found by scanning. */
+static uint8_t                   m_bp_peripheral_count;                            /**< Number of cuffs found by scanning. */
+static ble_bp_c_t                m_ble_bp_c[BLE_BP_C_MAX_INSTANCES];               /**< Blood Pressure Service Client instance of each cuff. */
+static ble_bp_c_meas_t           m_bp_meas[BLE_BP_C_MAX_INSTANCES];                /**< Last blood pressure measurement of each cuff. */
+static ieee_float16_t            m_cuff_pressure[BLE_BP_C_MAX_INSTANCES];          /**< Current cuff pressure of each cuff, while a measurement is in progress. */
 //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>....
 
 /**
@@ -242,13 +242,37 @@ static void scan_start(void);
 #define SLAVE_LATENCY                    0                                          /**< Slave latency. */
 #define CONN_SUP_TIMEOUT                 MSEC_TO_UNITS(4000, UNIT_10_MS)            /**< Connection supervisory timeout (4 seconds). */
 
-#define FIRST_CONN_PARAMS_UPDATE_DELAY   APP_TIMER_TICKS(5000, APP_TIMER_PRESCALER) /**< Time from initiating event (connect or start of notification) to first time sd_ble_gap_conn_param_update is called (5 seconds). */
-#define NEXT_CONN_PARAMS_UPDATE_DELAY    APP_TIMER_TICKS(30000, APP_TIMER_PRESCALER)/**< Time between each call to sd_ble_gap_conn_param_update after the first call (30 seconds). */
-#define MAX_CONN_PARAMS_UPDATE_COUNT     3                                          /**< Number of attempts before giving up the connection parameter negotiation. */
+#define FAST_MIN_CONN_INTERVAL           MSEC_TO_UNITS(7.5, UNIT_1_25_MS)           /**< Minimum connection interval while records are sent (7.5 ms). */
+#define FAST_MAX_CONN_INTERVAL           MSEC_TO_UNITS(30, UNIT_1_25_MS)            /**< Maximum connection interval while records are sent (30 ms). */
+
+#define FIRST_CONN_PARAMS_UPDATE_DELAY   APP_TIMER_TICKS(5000, APP_TIMER_PRESCALER) /**< Time from the connect event to the first time sd_ble_gap_conn_param_update is called (5 seconds). */
+#define CONN_PARAMS_SAMPLE_PERIOD        APP_TIMER_TICKS(1000, APP_TIMER_PRESCALER) /**< Period of the traffic samples of the adaptive connection parameters (1 second). */
+#define CONN_PARAMS_RELAX_SAMPLES        5                                          /**< Number of quiet samples in a row before the slow connection parameters are requested. */
+#define CONN_PARAMS_MIN_UPDATE_INTERVAL  APP_TIMER_TICKS(3000, APP_TIMER_PRESCALER) /**< Minimum time between two connection parameters update requests (3 seconds). */
+#define CONN_PARAMS_BURST_PACKETS        8                                          /**< Packets per sample from which the fast connection parameters are requested. The live measurements take about 2 per second. */
+#define CONN_PARAMS_MAX_ATTEMPTS         4                                          /**< Number of requests for a parameter set the central does not grant, after which the parameters granted are kept. */
 
 static uint16_t                          m_conn_handle_peripheral = BLE_CONN_HANDLE_INVALID;  /**< Handle of the current connection. */
 static ble_hrs_t                         m_hrs;                                               /**< Structure used to identify the heart rate service. */
 static ble_rscs_t                        m_rscs;                                              /**< Structure used to identify the running speed and cadence service. */
+static ble_bprs_t                        m_bprs;                                              /**< Structure used to identify the blood pressure record service. */
+
+/**@brief Connection parameters of the peripheral link, from the fastest to the slowest. */
+static const ble_gap_conn_params_t       m_periph_conn_param_sets[] =
+{
+    {
+        (uint16_t)FAST_MIN_CONN_INTERVAL,
+        (uint16_t)FAST_MAX_CONN_INTERVAL,
+        0,
+        (uint16_t)CONN_SUP_TIMEOUT
+    },
+    {
+        (uint16_t)MIN_CONN_INTERVAL,
+        (uint16_t)MAX_CONN_INTERVAL,
+        SLAVE_LATENCY,
+        (uint16_t)CONN_SUP_TIMEOUT
+    }
+};
 
 static uint8_t m_beacon_info[APP_BEACON_MANUF_DATA_LEN] =                    /**< Information advertised by the Beacon. */
 {
@@ -496,6 +520,82 @@ void uart_event_handle(app_uart_evt_t * p_event)
     }*/
 }
 
+/**@brief Function for storing the discovered database of a bonded peer.
+ *
+ * @details The database is stored in the GATT Client context of the peer, and used instead of a
+ *          discovery when the peer reconnects. Called both when discovery completes and when
+ *          bonding completes, so whichever comes last stores the database.
+ *
+ * @param[in]   p_dm_handle   Device Manager handle of the link to the peer.
+ */
+static void db_discovery_cache_store(dm_handle_t const * p_dm_handle)
+{
+    uint32_t                 err_code;
+    ble_db_discovery_cache_t cache;
+    dm_service_context_t     service_context;
+
+    if (p_dm_handle->device_id == DM_INVALID_ID)
+    {
+        // Not bonded.
+        return;
+    }
+
+    if (ble_db_discovery_cache_get(&m_ble_db_discovery[p_dm_handle->connection_id],
+                                   &cache) != NRF_SUCCESS)
+    {
+        // Discovery not complete.
+        return;
+    }
+
+    service_context.service_type        = DM_PROTOCOL_CNTXT_GATT_CLI_ID;
+    service_context.context_data.p_data = (uint8_t *)&cache;
+    service_context.context_data.len    = sizeof(cache);
+
+    err_code = dm_service_context_set(p_dm_handle, &service_context);
+    APP_ERROR_CHECK(err_code);
+}
+
+
+/**@brief Function for finding a cuff from its address.
+ *
+ * @param[in]   p_addr   Address of the peer.
+ *
+ * @return Index of the cuff, or m_bp_peripheral_count if the peer is not a cuff.
+ */
+static uint8_t bp_peripheral_find(ble_gap_addr_t const * p_addr)
+{
+    uint8_t i;
+
+    for (i = 0; i < m_bp_peripheral_count; i++)
+    {
+        if (memcmp(&m_bp_peripheral_address[i], p_addr, sizeof(ble_gap_addr_t)) == 0)
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+
+
+/**@brief Function for checking if every cuff found by scanning is connected.
+ */
+static bool bp_peripherals_connected(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < m_bp_peripheral_count; i++)
+    {
+        if (m_conn_handle_central_bp[i] == BLE_CONN_HANDLE_INVALID)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
 /**@brief Callback handling device manager events.
  *
  * @details This function is called to notify the application of device manager events.
@@ -510,6 +610,7 @@ static ret_code_t device_manager_event_handler(const dm_handle_t    * p_handle,
                                                  const ret_code_t     event_result)
 {
     uint32_t err_code;
+    uint8_t  cuff;
 
     switch (p_event->event_id)
     {
@@ -526,6 +627,11 @@ static ret_code_t device_manager_event_handler(const dm_handle_t    * p_handle,
 
             LEDS_ON(CENTRAL_CONNECTED_LED);
 
+            // The DB Discovery instance of the link only gets the events of the link.
+            err_code = ble_evt_router_conn_handle_set(m_db_discovery_route[p_handle->connection_id],
+                                                      p_event->event_param.p_gap_param->conn_handle);
+            APP_ERROR_CHECK(err_code);
+
             if(memcmp(&m_hrs_peripheral_address, &p_event->event_param.p_gap_param->params.connected.peer_addr, sizeof(ble_gap_addr_t)) == 0)
             {
                 m_conn_handle_central_hrs = p_event->event_param.p_gap_param->conn_handle;
@@ -535,14 +641,15 @@ static ret_code_t device_manager_event_handler(const dm_handle_t    * p_handle,
                 m_conn_handle_central_rsc = p_event->event_param.p_gap_param->conn_handle;
             }
 						//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-						if(memcmp(&m_bp_peripheral_address, &p_event->event_param.p_gap_param->params.connected.peer_addr, sizeof(ble_gap_addr_t)) == 0)
+						cuff = bp_peripheral_find(&p_event->event_param.p_gap_param->params.connected.peer_addr);
+						if (cuff < m_bp_peripheral_count)
             {
-                m_conn_handle_central_bp = p_event->event_param.p_gap_param->conn_handle;
+                m_conn_handle_central_bp[cuff] = p_event->event_param.p_gap_param->conn_handle;
             }
 						//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
             if((m_conn_handle_central_rsc != BLE_CONN_HANDLE_INVALID) &&
                (m_conn_handle_central_hrs != BLE_CONN_HANDLE_INVALID) &&
-						   (m_conn_handle_central_bp != BLE_CONN_HANDLE_INVALID)
+						   bp_peripherals_connected()
 						  )
             {
                 LEDS_OFF(CENTRAL_SCANNING_LED);
@@ -550,10 +657,27 @@ static ret_code_t device_manager_event_handler(const dm_handle_t    * p_handle,
                   
             m_dm_device_handle = (*p_handle);
 
-            // Discover peer's services. 
-						//printf("call ble_db_discovery_start,conn_handle=0x%x\r\n",p_event->event_param.p_gap_param->conn_handle);
-            err_code = ble_db_discovery_start(&m_ble_db_discovery,
-                                              p_event->event_param.p_gap_param->conn_handle);
+            // Use the database cached for a bonded peer, else discover peer's services.
+            dm_service_context_t service_context;
+
+            service_context.service_type        = DM_PROTOCOL_CNTXT_GATT_CLI_ID;
+            service_context.context_data.p_data = NULL;
+            service_context.context_data.len    = 0;
+
+            if ((p_handle->device_id != DM_INVALID_ID) &&
+                (dm_service_context_get(p_handle, &service_context) == NRF_SUCCESS) &&
+                (service_context.context_data.len == sizeof(ble_db_discovery_cache_t)))
+            {
+                err_code = ble_db_discovery_start_cached(
+                    &m_ble_db_discovery[p_handle->connection_id],
+                    p_event->event_param.p_gap_param->conn_handle,
+                    (ble_db_discovery_cache_t *)service_context.context_data.p_data);
+            }
+            else
+            {
+                err_code = ble_db_discovery_start(&m_ble_db_discovery[p_handle->connection_id],
+                                                  p_event->event_param.p_gap_param->conn_handle);
+            }
             APP_ERROR_CHECK(err_code);
 
             m_peer_count++;
@@ -569,7 +693,21 @@ static ret_code_t device_manager_event_handler(const dm_handle_t    * p_handle,
         case DM_EVT_DISCONNECTION:
         {
            //APPL_LOG("[APPL]: >> DM_EVT_DISCONNECTION\r\n");
-            memset(&m_ble_db_discovery, 0 , sizeof (m_ble_db_discovery));
+            memset(&m_ble_db_discovery[p_handle->connection_id], 0 , sizeof (ble_db_discovery_t));
+            err_code = ble_evt_router_conn_handle_set(m_db_discovery_route[p_handle->connection_id],
+                                                      BLE_CONN_HANDLE_INVALID);
+            APP_ERROR_CHECK(err_code);
+
+            // Report flash operations saved by deferring bond and service context writes.
+            dm_store_stats_t store_stats;
+            if (dm_store_stats_get(p_handle, &store_stats) == NRF_SUCCESS)
+            {
+                char temp[sizeof("DM: flash ops issued , saved \n") + 2 * 5]; // Digits of two uint16_t.
+                snprintf(temp, sizeof(temp), "DM: flash ops issued %lu, saved %lu\n",
+                         (unsigned long)store_stats.issued,
+                         (unsigned long)(store_stats.requested - store_stats.issued));
+                SEGGER_RTT_WriteString(0, temp);
+            }
 
              if(p_event->event_param.p_gap_param->conn_handle == m_conn_handle_central_hrs)
              {
@@ -580,9 +718,12 @@ static ret_code_t device_manager_event_handler(const dm_handle_t    * p_handle,
                  m_conn_handle_central_rsc = BLE_CONN_HANDLE_INVALID;
              }
 						 //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-						 else if (p_event->event_param.p_gap_param->conn_handle == m_conn_handle_central_bp)
+						 for (cuff = 0; cuff < m_bp_peripheral_count; cuff++)
 						 {
-							 m_conn_handle_central_bp = BLE_CONN_HANDLE_INVALID;
+							 if (p_event->event_param.p_gap_param->conn_handle == m_conn_handle_central_bp[cuff])
+							 {
+								 m_conn_handle_central_bp[cuff] = BLE_CONN_HANDLE_INVALID;
+							 }
 						 }
 						 //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
              
@@ -603,10 +744,12 @@ static ret_code_t device_manager_event_handler(const dm_handle_t    * p_handle,
 
         case DM_EVT_SECURITY_SETUP:
         {
+            dm_handle_t handle = (*p_handle);
+
             //APPL_LOG("[APPL]:[0x%02X] >> DM_EVT_SECURITY_SETUP\r\n", p_handle->connection_id);
             // Slave securtiy request received from peer, if from a non bonded device, 
             // initiate security setup, else, wait for encryption to complete.
-            err_code = dm_security_setup_req(&m_dm_device_handle);
+            err_code = dm_security_setup_req(&handle);
             APP_ERROR_CHECK(err_code);
             //APPL_LOG("[APPL]:[0x%02X] << DM_EVT_SECURITY_SETUP\r\n", p_handle->connection_id);
             break;
@@ -615,9 +758,8 @@ static ret_code_t device_manager_event_handler(const dm_handle_t    * p_handle,
         case DM_EVT_SECURITY_SETUP_COMPLETE:
         {
             //APPL_LOG("[APPL]: >> DM_EVT_SECURITY_SETUP_COMPLETE\r\n");
-            // Heart rate service discovered. Enable notification of Heart Rate Measurement.
-            err_code = ble_hrs_c_hrm_notif_enable(&m_ble_hrs_c);
-            APP_ERROR_CHECK(err_code);
+            m_dm_device_handle = (*p_handle);
+            db_discovery_cache_store(p_handle);
             //APPL_LOG("[APPL]: << DM_EVT_SECURITY_SETUP_COMPLETE\r\n");
             break;
         }
@@ -653,42 +795,6 @@ static ret_code_t device_manager_event_handler(const dm_handle_t    * p_handle,
 }
 
 
-/**
- * @brief Parses advertisement data, providing length and location of the field in case
- *        matching data is found.
- *
- * @param[in]  Type of data to be looked for in advertisement data.
- * @param[in]  Advertisement report length and pointer to report.
- * @param[out] If data type requested is found in the data report, type data length and
- *             pointer to data will be populated here.
- *
- * @retval NRF_SUCCESS if the data type is found in the report.
- * @retval NRF_ERROR_NOT_FOUND if the data type could not be found.
- */
-static uint32_t adv_report_parse(uint8_t type, data_t * p_advdata, data_t * p_typedata)
-{
-    uint32_t  index = 0;
-    uint8_t * p_data;
-
-    p_data = p_advdata->p_data;
-
-    while (index < p_advdata->data_len)
-    {
-        uint8_t field_length = p_data[index];
-        uint8_t field_type   = p_data[index+1];
-
-        if (field_type == type)
-        {
-            p_typedata->p_data   = &p_data[index+2];
-            p_typedata->data_len = field_length-1;
-            return NRF_SUCCESS;
-        }
-        index += field_length + 1;
-    }
-    return NRF_ERROR_NOT_FOUND;
-}
-
-
 /**@brief Function for handling advertising events.
  *
  * @details This function will be called for advertising events which are passed to the application.
@@ -722,6 +828,15 @@ static void conn_params_error_handler(uint32_t nrf_error)
     APP_ERROR_HANDLER(nrf_error);
 }
 
+/**@brief Function for handling a service error.
+ *
+ * @param[in] nrf_error  Error code containing information about what went wrong.
+ */
+static void service_error_handler(uint32_t nrf_error)
+{
+    APP_ERROR_HANDLER(nrf_error);
+}
+
 /**@brief Function for the GAP initialization.
  *
  * @details This function sets up all the necessary GAP (Generic Access Profile) parameters of the
@@ -755,91 +870,34 @@ static void gap_params_init(void)
 }
 
 
-/**@brief Function for handling the Application's BLE Stack events.
+/**@brief Function for handling the Application's BLE Stack events of the central role.
  *
  * @param[in]   p_ble_evt   Bluetooth stack event.
+ * @param[in]   p_context   Unused.
  */
-bool is_done = 1;
-static void on_ble_central_evt(ble_evt_t * p_ble_evt)
+static void on_ble_central_evt(ble_evt_t * p_ble_evt, void * p_context)
 {
     uint32_t                err_code;
     const ble_gap_evt_t   * p_gap_evt = &p_ble_evt->evt.gap_evt;
 
+    UNUSED_PARAMETER(p_context);
+
     switch (p_ble_evt->header.evt_id)
     {
         case BLE_GAP_EVT_ADV_REPORT:
         {
-            data_t adv_data;
-            data_t type_data;
-
-            // Initialize advertisement report for parsing.
-            adv_data.p_data = (uint8_t *)p_gap_evt->params.adv_report.data;
-            adv_data.data_len = p_gap_evt->params.adv_report.dlen;
-
-            err_code = adv_report_parse(BLE_GAP_AD_TYPE_16BIT_SERVICE_UUID_MORE_AVAILABLE,
-                                        &adv_data,
-                                        &type_data);
-
-            if (err_code != NRF_SUCCESS)
-            {
-                // Look for the services in 'complete' if it was not found in 'more available'.
-                err_code = adv_report_parse(BLE_GAP_AD_TYPE_16BIT_SERVICE_UUID_COMPLETE,
-                                            &adv_data,
-                                            &type_data);
-            }
-
-            // Verify if short or complete name matches target.
-            if (err_code == NRF_SUCCESS)
+            if (ble_scan_filter_match(&p_gap_evt->params.adv_report))
             {
-
-                uint16_t extracted_uuid;
-
-                // UUIDs found, look for matching UUID
-                for (uint32_t u_index = 0; u_index < (type_data.data_len/UUID16_SIZE); u_index++)
+                // The connection manager connects to the device, and reconnects when the link drops.
+                err_code = ble_conn_mgr_target_add(&p_gap_evt->params.adv_report.peer_addr, NULL, NULL);
+                if ((err_code == NRF_SUCCESS) &&
+                    (bp_peripheral_find(&p_gap_evt->params.adv_report.peer_addr) == m_bp_peripheral_count) &&
+                    (m_bp_peripheral_count < BLE_BP_C_MAX_INSTANCES))
                 {
-                    UUID16_EXTRACT(&extracted_uuid,&type_data.p_data[u_index * UUID16_SIZE]);
-
-                    //APPL_LOG("\t[APPL]: %x\r\n",extracted_uuid);
-                    //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-                    if((/*extracted_uuid == BLE_UUID_HEART_RATE_SERVICE || extracted_uuid == BLE_UUID_RUNNING_SPEED_AND_CADENCE ||*/ extracted_uuid == BLE_UUID_BLOOD_PRESSURE_SERVICE) && (is_done))
-                    {
-												is_done = 0;
-                        if(extracted_uuid == BLE_UUID_HEART_RATE_SERVICE)
-                        {
-                            //printf("HRS found\n\r");
-                            memcpy(&m_hrs_peripheral_address, &p_gap_evt->params.adv_report.peer_addr,sizeof(ble_gap_addr_t));
-													  
-                        }
-                        if(extracted_uuid == BLE_UUID_RUNNING_SPEED_AND_CADENCE)
-                        {
-                            //printf("RSC found\n\r");
-                            memcpy(&m_rscs_peripheral_address, &p_gap_evt->params.adv_report.peer_addr,sizeof(ble_gap_addr_t));
-                        }
-												
-												 if(extracted_uuid == BLE_UUID_BLOOD_PRESSURE_SERVICE)
-                        {
-                            //printf("BP found\n\r");
-                            memcpy(&m_bp_peripheral_address, &p_gap_evt->params.adv_report.peer_addr,sizeof(ble_gap_addr_t));
-                        }
-
-                        m_scan_param.selective = 0; 
-
-                        // Initiate connection.
-                        err_code = sd_ble_gap_connect(&p_gap_evt->params.adv_report.peer_addr,
-                                                      &m_scan_param,
-                                                      &m_connection_param);
-
-                        m_whitelist_temporarily_disabled = false;
-
-                        if (err_code != NRF_SUCCESS)
-                        {
-                            //APPL_LOG("[APPL]: Connection Request Failed, reason %d\r\n", err_code);
-                        }
-                        break;
-												
-                    }
-										 //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>.
-										
+                    m_bp_peripheral_address[m_bp_peripheral_count]  = p_gap_evt->params.adv_report.peer_addr;
+                    m_conn_handle_central_bp[m_bp_peripheral_count] = BLE_CONN_HANDLE_INVALID;
+                    m_bp_peripheral_count++;
+                    m_whitelist_temporarily_disabled = false;
                 }
             }
             break;
@@ -854,6 +912,8 @@ static void on_ble_central_evt(ble_evt_t * p_ble_evt)
             else if (p_gap_evt->params.timeout.src == BLE_GAP_TIMEOUT_SRC_CONN)
             {
                 //APPL_LOG("[APPL]: Connection Request timed out.\r\n");
+                // Scan for new devices until the connection manager retries.
+                scan_start();
             }
             break;
 
@@ -887,14 +947,17 @@ static void on_ble_central_evt(ble_evt_t * p_ble_evt)
     }
 }
 
-/**@brief Function for handling the Application's BLE Stack events.
+/**@brief Function for handling the Application's BLE Stack events of the peripheral role.
  *
  * @param[in] p_ble_evt  Bluetooth stack event.
+ * @param[in] p_context  Unused.
  */
-static void on_ble_peripheral_evt(ble_evt_t * p_ble_evt)
+static void on_ble_peripheral_evt(ble_evt_t * p_ble_evt, void * p_context)
 {
     uint32_t err_code;
 
+    UNUSED_PARAMETER(p_context);
+
     switch (p_ble_evt->header.evt_id)
             {
         case BLE_GAP_EVT_CONNECTED:
@@ -904,9 +967,25 @@ static void on_ble_peripheral_evt(ble_evt_t * p_ble_evt)
             break;
 
         case BLE_GAP_EVT_DISCONNECTED:
+        {
+            ble_conn_params_adapt_stats_t stats;
+            char                          temp[sizeof("Conn params: fast , slow , other  ms,  updates\n") + 3 * 10 + 5]; // Digits of three uint32_t and a uint16_t.
+
             LEDS_OFF(PERIPHERAL_CONNECTED_LED);
             m_conn_handle_peripheral = BLE_CONN_HANDLE_INVALID;
+
+            // Time spent in each connection parameter set so far, in milliseconds.
+            if (ble_conn_params_adapt_stats_get(&stats) == NRF_SUCCESS)
+            {
+                snprintf(temp, sizeof(temp), "Conn params: fast %lu, slow %lu, other %lu ms, %u updates\n",
+                         (unsigned long)TICKS_TO_MS(stats.set_ticks[0]),
+                         (unsigned long)TICKS_TO_MS(stats.set_ticks[1]),
+                         (unsigned long)TICKS_TO_MS(stats.set_ticks[2]),
+                         stats.update_count);
+                SEGGER_RTT_WriteString(0, temp);
+            }
             break;
+        }
 
         case BLE_GAP_EVT_SEC_PARAMS_REQUEST:
             // Pairing not supported
@@ -952,42 +1031,155 @@ static void on_sys_evt(uint32_t sys_evt)
 }
 
 
-/**@brief Function for dispatching a BLE stack event to all modules with a BLE stack event handler.
- *
- * @details This function is called from the scheduler in the main loop after a BLE stack event has
- *  been received.
+/**@brief Functions for passing a BLE stack event from the event router to a module.
  *
  * @param[in]   p_ble_evt   Bluetooth stack event.
+ * @param[in]   p_context   Instance of the module, unused by modules without instances.
  */
-static void ble_evt_dispatch(ble_evt_t * p_ble_evt)
+static void dm_evt_route(ble_evt_t * p_ble_evt, void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+    dm_ble_evt_handler(p_ble_evt);
+}
+
+static void db_discovery_evt_route(ble_evt_t * p_ble_evt, void * p_context)
+{
+    ble_db_discovery_on_ble_evt((ble_db_discovery_t *)p_context, p_ble_evt);
+}
+
+static void bp_c_evt_route(ble_evt_t * p_ble_evt, void * p_context)
 {
-    if((p_ble_evt->evt.gap_evt.params.connected.role == BLE_GAP_ROLE_CENTRAL) ||
-       (m_conn_handle_central_hrs == p_ble_evt->evt.gap_evt.conn_handle) ||
-       (m_conn_handle_central_rsc == p_ble_evt->evt.gap_evt.conn_handle) ||
-       (m_conn_handle_central_bp == p_ble_evt->evt.gap_evt.conn_handle) 
-		  )
+    ble_bp_c_on_ble_evt((ble_bp_c_t *)p_context, p_ble_evt);
+}
+
+static void bsp_btn_evt_route(ble_evt_t * p_ble_evt, void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+    bsp_btn_ble_on_ble_evt(p_ble_evt);
+}
+
+static void hrs_evt_route(ble_evt_t * p_ble_evt, void * p_context)
+{
+    ble_hrs_on_ble_evt((ble_hrs_t *)p_context, p_ble_evt);
+}
+
+static void rscs_evt_route(ble_evt_t * p_ble_evt, void * p_context)
+{
+    ble_rscs_on_ble_evt((ble_rscs_t *)p_context, p_ble_evt);
+}
+
+static void bprs_evt_route(ble_evt_t * p_ble_evt, void * p_context)
+{
+    ble_bprs_on_ble_evt((ble_bprs_t *)p_context, p_ble_evt);
+}
+
+static void conn_params_evt_route(ble_evt_t * p_ble_evt, void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+    ble_conn_params_on_ble_evt(p_ble_evt);
+}
+
+static void advertising_evt_route(ble_evt_t * p_ble_evt, void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+    ble_advertising_on_ble_evt(p_ble_evt);
+}
+
+static void gattc_queue_evt_route(ble_evt_t * p_ble_evt, void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+    ble_gattc_queue_on_ble_evt(p_ble_evt);
+}
+
+static void conn_mgr_evt_route(ble_evt_t * p_ble_evt, void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+    ble_conn_mgr_on_ble_evt(p_ble_evt);
+}
+
+
+/**@brief Function for registering a module with the event router.
+ *
+ * @param[in]   handler        Event handler of the module.
+ * @param[in]   p_context      Instance of the module.
+ * @param[in]   evt_id_first   First event ID handled by the module.
+ * @param[in]   evt_id_last    Last event ID handled by the module.
+ * @param[in]   role_mask      Roles of the events handled by the module.
+ * @param[in]   conn_handle    Connection handle of the events handled by the module.
+ * @param[out]  p_reg_id       Identifier of the registration, may be NULL.
+ */
+static void evt_route_add(ble_evt_router_handler_t handler,
+                          void                   * p_context,
+                          uint16_t                 evt_id_first,
+                          uint16_t                 evt_id_last,
+                          uint8_t                  role_mask,
+                          uint16_t                 conn_handle,
+                          uint8_t                * p_reg_id)
+{
+    uint32_t             err_code;
+    ble_evt_router_reg_t reg;
+
+    reg.handler      = handler;
+    reg.p_context    = p_context;
+    reg.evt_id_first = evt_id_first;
+    reg.evt_id_last  = evt_id_last;
+    reg.role_mask    = role_mask;
+    reg.conn_handle  = conn_handle;
+
+    err_code = ble_evt_router_register(&reg, p_reg_id);
+    APP_ERROR_CHECK(err_code);
+}
+
+
+/**@brief Function for registering the modules with a BLE stack event handler with the event router.
+ *
+ * @details Each module only gets the events of the role and event groups it handles, so that
+ *          notifications received on the central links are not passed to the peripheral role
+ *          services, and the reverse. Modules are called in the order they are registered.
+ */
+static void evt_router_init(void)
+{
+    uint32_t i;
+
+    // Central role.
+    evt_route_add(dm_evt_route, NULL, BLE_GAP_EVT_BASE, BLE_GATTS_EVT_LAST,
+                  BLE_EVT_ROUTER_ROLE_CENTRAL, BLE_CONN_HANDLE_ALL, NULL);
+    for (i = 0; i < DEVICE_MANAGER_MAX_CONNECTIONS; i++)
     {
-        dm_ble_evt_handler(p_ble_evt);
-        ble_db_discovery_on_ble_evt(&m_ble_db_discovery, p_ble_evt);
-			  //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-        //ble_hrs_c_on_ble_evt(&m_ble_hrs_c, p_ble_evt);
-        //ble_rscs_c_on_ble_evt(&m_ble_rsc_c, p_ble_evt);
-			  ble_bp_c_on_ble_evt(&m_ble_bp_c, p_ble_evt);
-			  //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-        bsp_btn_ble_on_ble_evt(p_ble_evt);
-        on_ble_central_evt(p_ble_evt);
+        // Given the connection handle of its link on DM_EVT_CONNECTION. BLE_EVT_TX_COMPLETE restarts a
+        // discovery delayed by a write without response.
+        evt_route_add(db_discovery_evt_route, &m_ble_db_discovery[i], BLE_EVT_BASE, BLE_GATTC_EVT_LAST,
+                      BLE_EVT_ROUTER_ROLE_CENTRAL, BLE_CONN_HANDLE_INVALID, &m_db_discovery_route[i]);
     }
-    
-
-    if((p_ble_evt->evt.gap_evt.params.connected.role == BLE_GAP_ROLE_PERIPH) ||
-       (m_conn_handle_peripheral == p_ble_evt->evt.gap_evt.conn_handle))
+    for (i = 0; i < BLE_BP_C_MAX_INSTANCES; i++)
     {
-        ble_hrs_on_ble_evt(&m_hrs, p_ble_evt);
-        ble_rscs_on_ble_evt(&m_rscs, p_ble_evt);
-        ble_conn_params_on_ble_evt(p_ble_evt);
-        on_ble_peripheral_evt(p_ble_evt);
-        ble_advertising_on_ble_evt(p_ble_evt);
+        evt_route_add(bp_c_evt_route, &m_ble_bp_c[i], BLE_GAP_EVT_BASE, BLE_GATTC_EVT_LAST,
+                      BLE_EVT_ROUTER_ROLE_CENTRAL, BLE_CONN_HANDLE_ALL, NULL);
     }
+    evt_route_add(bsp_btn_evt_route, NULL, BLE_GAP_EVT_BASE, BLE_GAP_EVT_LAST,
+                  BLE_EVT_ROUTER_ROLE_CENTRAL, BLE_CONN_HANDLE_ALL, NULL);
+    evt_route_add(on_ble_central_evt, NULL, BLE_GAP_EVT_BASE, BLE_GAP_EVT_LAST,
+                  BLE_EVT_ROUTER_ROLE_CENTRAL, BLE_CONN_HANDLE_ALL, NULL);
+
+    // Peripheral role.
+    evt_route_add(hrs_evt_route, &m_hrs, BLE_GAP_EVT_BASE, BLE_GATTS_EVT_LAST,
+                  BLE_EVT_ROUTER_ROLE_PERIPH, BLE_CONN_HANDLE_ALL, NULL);
+    evt_route_add(rscs_evt_route, &m_rscs, BLE_GAP_EVT_BASE, BLE_GATTS_EVT_LAST,
+                  BLE_EVT_ROUTER_ROLE_PERIPH, BLE_CONN_HANDLE_ALL, NULL);
+    evt_route_add(bprs_evt_route, &m_bprs, BLE_EVT_BASE, BLE_GATTS_EVT_LAST,
+                  BLE_EVT_ROUTER_ROLE_PERIPH, BLE_CONN_HANDLE_ALL, NULL);
+    evt_route_add(conn_params_evt_route, NULL, BLE_EVT_BASE, BLE_GATTS_EVT_LAST,
+                  BLE_EVT_ROUTER_ROLE_PERIPH, BLE_CONN_HANDLE_ALL, NULL);
+    evt_route_add(on_ble_peripheral_evt, NULL, BLE_GAP_EVT_BASE, BLE_GATTS_EVT_LAST,
+                  BLE_EVT_ROUTER_ROLE_PERIPH, BLE_CONN_HANDLE_ALL, NULL);
+    evt_route_add(advertising_evt_route, NULL, BLE_GAP_EVT_BASE, BLE_GAP_EVT_LAST,
+                  BLE_EVT_ROUTER_ROLE_PERIPH, BLE_CONN_HANDLE_ALL, NULL);
+
+    // Transmit buffers are shared by all links, so the queue gets the events of every link.
+    evt_route_add(gattc_queue_evt_route, NULL, BLE_EVT_BASE, BLE_GATTC_EVT_LAST,
+                  BLE_EVT_ROUTER_ROLE_ALL, BLE_CONN_HANDLE_ALL, NULL);
+    evt_route_add(conn_mgr_evt_route, NULL, BLE_GAP_EVT_BASE, BLE_GAP_EVT_LAST,
+                  BLE_EVT_ROUTER_ROLE_CENTRAL, BLE_CONN_HANDLE_ALL, NULL);
 }
 
 
@@ -1032,7 +1224,8 @@ static void ble_stack_init(void)
     APP_ERROR_CHECK(err_code);
 
     // Register with the SoftDevice handler module for BLE events.
-    err_code = softdevice_ble_evt_handler_set(ble_evt_dispatch);
+    evt_router_init();
+    err_code = softdevice_ble_evt_handler_set(ble_evt_router_on_ble_evt);
     APP_ERROR_CHECK(err_code);
 
     // Register with the SoftDevice handler module for System events.
@@ -1182,104 +1375,102 @@ static void rscs_c_evt_handler(ble_rscs_c_t * p_rsc_c, ble_rscs_c_evt_t * p_rsc_
 }
 
 //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>.
-//#include "ble_bp_c.h"
-void bp_c_evt_handler(ble_bp_c_t * p_bp_c, ble_bp_c_evt_t * p_bp_c_evt)
+/**@brief Function for handling the events of the Blood Pressure Service Client instances.
+ *
+ * @details Measurements are decoded by the client, values are only formatted for the log when a
+ *          measurement is complete, not for each intermediate cuff pressure.
+ *
+ * @param[in]   p_bp_c       Instance of the cuff.
+ * @param[in]   p_bp_c_evt   Event.
+ */
+static void bp_c_evt_handler(ble_bp_c_t * p_bp_c, ble_bp_c_evt_t * p_bp_c_evt)
 {
-	uint32_t err_code;
+    uint32_t    err_code;
+    uint32_t    cuff = (uint32_t)(p_bp_c - m_ble_bp_c);
+    dm_handle_t dm_handle;
+
     switch (p_bp_c_evt->evt_type)
     {
         case BLE_BP_C_EVT_DISCOVERY_COMPLETE:
-				  bp_log("BLE_BP_C_EVT_DISCOVERY_COMPLETE\r\n");
-					SEGGER_RTT_WriteString(0, "BLE_BP_C_EVT_DISCOVERY_COMPLETE\n");
-				  //printf("abcdefghijklmnopqrstuvwxyz\r\n");
-				 //7err_code = dm_security_setup_req(&m_dm_device_handle);
-				 //err_code = ble_bp_c_test_notif_enable(p_bp_c);
-				 err_code = ble_bp_c_cuff_notif_enable(p_bp_c);
-				 err_code = ble_bp_c_mea_notif_enable(p_bp_c);
-				
-				  //printf("ble_bp_c_test_notif_enable: err_code=%d\r\n",err_code);
-         // APP_ERROR_CHECK(err_code);
-					/*
-            // Initiate bonding.
-            err_code = dm_security_setup_req(&m_dm_device_handle);
-            APP_ERROR_CHECK(err_code);
+            SEGGER_RTT_WriteString(0, "BLE_BP_C_EVT_DISCOVERY_COMPLETE\n");
+            dm_handle.appl_id = m_dm_app_id;
+            if (dm_handle_get(p_bp_c->conn_handle, &dm_handle) == NRF_SUCCESS)
+            {
+                db_discovery_cache_store(&dm_handle);
+            }
+            UNUSED_VARIABLE(ble_conn_mgr_state_set(p_bp_c->conn_handle, BLE_CONN_MGR_STATE_STREAMING));
 
-            // Heart rate service discovered. Enable notification of Heart Rate Measurement.
-            err_code = ble_hrs_c_hrm_notif_enable(p_hrs_c);
+            // Intermediate Cuff Pressure is optional.
+            err_code = ble_bp_c_cuff_notif_enable(p_bp_c);
+            if (err_code != NRF_ERROR_NOT_SUPPORTED)
+            {
+                APP_ERROR_CHECK(err_code);
+            }
+            err_code = ble_bp_c_mea_notif_enable(p_bp_c);
             APP_ERROR_CHECK(err_code);
+            break;
 
-            printf("Heart rate service discovered \r\n");
-        */  
-				break;
+        case BLE_BP_C_EVT_CUFF_NOTIFICATION:
+            m_cuff_pressure[cuff] = p_bp_c_evt->params.bp.meas.systolic;
+            break;
 
         case BLE_BP_C_EVT_MEA_NOTIFICATION:
         {
-					//printf("BLE_BP_C_EVT_HRM_NOTIFICATION\r\n");
-					/*
-            APPL_LOG("[APPL]: HR Measurement received %d \r\n", p_hrs_c_evt->params.hrm.hr_value);
+            char    temp[48];
+            int32_t systolic;
+            int32_t diastolic;
 
-            printf("Heart Rate = %d\r\n", p_hrs_c_evt->params.hrm.hr_value);
-            err_code = ble_hrs_heart_rate_measurement_send(&m_hrs, p_hrs_c_evt->params.hrm.hr_value);
-            if ((err_code != NRF_SUCCESS) &&
-                (err_code != NRF_ERROR_INVALID_STATE) &&
-                (err_code != BLE_ERROR_NO_TX_BUFFERS) &&
-                (err_code != BLE_ERROR_GATTS_SYS_ATTR_MISSING)
-                )
+            m_bp_meas[cuff] = p_bp_c_evt->params.bp.meas;
+
+            if ((ble_bp_c_sfloat_to_int(m_bp_meas[cuff].systolic, &systolic) != NRF_SUCCESS) ||
+                (ble_bp_c_sfloat_to_int(m_bp_meas[cuff].diastolic, &diastolic) != NRF_SUCCESS))
             {
-                APP_ERROR_HANDLER(err_code);
+                SEGGER_RTT_WriteString(0, "BP measurement without a value dropped\n");
+                break;
+            }
+            sprintf(temp, "Cuff %lu: %ld/%ld %s\n", (unsigned long)cuff, (long)systolic, (long)diastolic,
+                    m_bp_meas[cuff].units_in_kpa ? "kPa" : "mmHg");
+            SEGGER_RTT_WriteString(0, temp);
+
+            // Relayed as received.
+            memset(bpsval, 0, sizeof(bpsval));
+            memcpy(bpsval, p_bp_c_evt->params.bp.p_data, MIN(p_bp_c_evt->params.bp.len, sizeof(bpsval)));
+
+            // Keep the measurement until the peer retrieves it, even if it is not connected now.
+            err_code = ble_bprs_meas_store(&m_bprs, p_bp_c_evt->params.bp.p_data, p_bp_c_evt->params.bp.len);
+            if (err_code == NRF_ERROR_BUSY)
+            {
+                SEGGER_RTT_WriteString(0, "BPRS store queue full, measurement dropped\n");
+            }
+            else
+            {
+                APP_ERROR_CHECK(err_code);
             }
-					*/
             break;
-				}
-				 case BLE_BP_C_EVT_CUFF_NOTIFICATION:
-				 {
-					 	//printf("BLE_BP_C_EVT_CUFF_NOTIFICATION\r\n");
-					break;
-				 }
-        case BLE_BP_C_EVT_GOT_VAL:
-					{
-						char temp[20];
-						char response[20];
-						SEGGER_RTT_WriteString(0, "BLE_BP_C_EVT_GOT_VAL\n");
-					 	//printf("BLE_BP_C_EVT_GOT_VAL\r\n");
-						//printf("Hi mmHG: %d\r\n", p_bp_c_evt->params.bp.bp_value[1]);
-						//printf("Lo mmHG: %d\r\n", p_bp_c_evt->params.bp.bp_value[3]);
-						sprintf(&temp[0],"Hi mmHG = %d \n",p_bp_c_evt->params.bp.bp_value[1]);
-						SEGGER_RTT_WriteString(0, &temp[0]);
-						sprintf(&temp[0],"Lo mmHG = %d \n",p_bp_c_evt->params.bp.bp_value[3]);
-						SEGGER_RTT_WriteString(0, &temp[0]);
-						sprintf(&temp[0],"HR = %d \n",p_bp_c_evt->params.bp.bp_value[14]);
-						SEGGER_RTT_WriteString(0, &temp[0]);
-						
-						for (int i=0;i < 19; i++) {
-							bpsval[i] = p_bp_c_evt->params.bp.bp_value[i];
-						}
-						
-						
-					break;
-				 }
+        }
+
         case BLE_BP_C_EVT_DISCONNECTED:
-				{
-						//printf("BLE_BP_C_EVT_DISCONNECTED\r\n");
-						SEGGER_RTT_WriteString(0, "BLE_BP_C_EVT_DISCONNECTED\n");
-						NVIC_SystemReset();
-					  break;
-				}
+            SEGGER_RTT_WriteString(0, "BLE_BP_C_EVT_DISCONNECTED\n");
+            // The connection manager reconnects, and discovery runs again on the new link.
+            break;
+
         default:
             break;
     }
-
-	
 }
 
+/**@brief Function for initializing a Blood Pressure Service Client instance for each cuff.
+ */
 static void bp_c_init(void)
 {
-   // ble_hrs_c_init_t hrs_c_init_obj;
-
-    //hrs_c_init_obj.evt_handler = hrs_c_evt_handler;
+    uint32_t err_code;
+    uint32_t i;
 
-    uint32_t err_code = ble_bp_c_init(&m_ble_bp_c, bp_c_evt_handler);
-    APP_ERROR_CHECK(err_code);
+    for (i = 0; i < BLE_BP_C_MAX_INSTANCES; i++)
+    {
+        err_code = ble_bp_c_init(&m_ble_bp_c[i], bp_c_evt_handler);
+        APP_ERROR_CHECK(err_code);
+    }
 }
 
 
@@ -1312,6 +1503,87 @@ static void rscs_c_init(void)
 }
 
 
+/**@brief Function for initializing the GATT Client Request Queue module.
+ */
+static void gattc_queue_init(void)
+{
+    uint32_t err_code = ble_gattc_queue_init();
+    APP_ERROR_CHECK(err_code);
+}
+
+
+/**@brief Function for handling Central Connection Manager events.
+ *
+ * @param[in]   p_evt   Event.
+ */
+static void conn_mgr_evt_handler(ble_conn_mgr_evt_t const * p_evt)
+{
+    char temp[48];
+
+    if ((p_evt->evt_type == BLE_CONN_MGR_EVT_CONNECTED) && (p_evt->p_link->connect_count > 1))
+    {
+        sprintf(temp, "Reconnected in %lu ticks\n", (unsigned long)p_evt->p_link->recover_ticks);
+        SEGGER_RTT_WriteString(0, temp);
+    }
+}
+
+
+/**@brief Function for handling Central Connection Manager errors.
+ *
+ * @param[in]   nrf_error   Error code containing information about what went wrong.
+ */
+static void conn_mgr_error_handler(uint32_t nrf_error)
+{
+    APP_ERROR_HANDLER(nrf_error);
+}
+
+
+/**@brief Function for initializing the Central Connection Manager.
+ */
+static void conn_mgr_init(void)
+{
+    uint32_t              err_code;
+    ble_conn_mgr_init_t   conn_mgr_init_obj;
+    ble_gap_scan_params_t connect_scan_param;
+
+    // Only the interval, window and timeout are used, the module builds the whitelist.
+    memset(&connect_scan_param, 0, sizeof(connect_scan_param));
+    connect_scan_param.interval = SCAN_INTERVAL;
+    connect_scan_param.window   = SCAN_WINDOW;
+    connect_scan_param.timeout  = CONNECT_TIMEOUT;
+
+    conn_mgr_init_obj.evt_handler   = conn_mgr_evt_handler;
+    conn_mgr_init_obj.error_handler = conn_mgr_error_handler;
+    conn_mgr_init_obj.p_scan_params = &connect_scan_param;
+    conn_mgr_init_obj.p_conn_params = &m_connection_param;
+    conn_mgr_init_obj.backoff_min   = CONNECT_BACKOFF_MIN;
+    conn_mgr_init_obj.backoff_max   = CONNECT_BACKOFF_MAX;
+
+    err_code = ble_conn_mgr_init(&conn_mgr_init_obj);
+    APP_ERROR_CHECK(err_code);
+}
+
+
+/**@brief Function for initializing the scan filter with the devices to connect to.
+ */
+static void scan_filter_init(void)
+{
+    uint32_t              err_code;
+    uint16_t              uuid16[] = {BLE_UUID_BLOOD_PRESSURE_SERVICE};
+    ble_scan_filter_set_t filters;
+
+    memset(&filters, 0, sizeof(filters));
+
+    filters.p_uuid16     = uuid16;
+    filters.uuid16_count = sizeof(uuid16) / sizeof(uuid16[0]);
+    filters.rssi_min     = BLE_SCAN_FILTER_RSSI_NONE;
+    filters.dup_timeout  = SCAN_DUP_TIMEOUT;
+
+    err_code = ble_scan_filter_init(&filters);
+    APP_ERROR_CHECK(err_code);
+}
+
+
 /**
  * @brief Database discovery collector initialization.
  */
@@ -1378,6 +1650,11 @@ static void scan_start(void)
     }
 
     err_code = sd_ble_gap_scan_start(&m_scan_param);
+    if (err_code == NRF_ERROR_INVALID_STATE)
+    {
+        // The connection manager is initiating a connection, scanning restarts when it is done.
+        return;
+    }
     APP_ERROR_CHECK(err_code);
 
     LEDS_ON(CENTRAL_SCANNING_LED);
@@ -1442,6 +1719,7 @@ static void services_init(void)
     uint32_t       err_code;
     ble_hrs_init_t hrs_init;
     ble_rscs_init_t rscs_init;
+    ble_bprs_init_t bprs_init;
     uint8_t        body_sensor_location;
 
 		
@@ -1483,6 +1761,14 @@ static void services_init(void)
 
     err_code = ble_rscs_init(&m_rscs, &rscs_init);
     APP_ERROR_CHECK(err_code);
+
+    // Initialize Blood Pressure Record Service, storing the measurements relayed from the sensor.
+    memset(&bprs_init, 0, sizeof(bprs_init));
+
+    bprs_init.error_handler = service_error_handler;
+
+    err_code = ble_bprs_init(&m_bprs, &bprs_init);
+    APP_ERROR_CHECK(err_code);
 }
 
 /**@brief Function for handling the Connection Parameters Module.
@@ -1506,23 +1792,56 @@ static void on_conn_params_evt(ble_conn_params_evt_t * p_evt)
     }
 }
 
+/**@brief Function for getting the number of bytes waiting to be sent on the peripheral link.
+ *
+ * @details Counts the records left in a Record Access Control Point report, each as the largest
+ *          measurement.
+ *
+ * @return Number of bytes waiting to be sent.
+ */
+static uint32_t periph_tx_queued_get(void)
+{
+    ble_racp_engine_t const * p_engine = &m_bprs.racp_engine;
+
+    if (p_engine->state != BLE_RACP_ENGINE_STATE_PROC_ACTIVE)
+    {
+        return 0;
+    }
+    return (uint32_t)(p_engine->proc_end_pos - p_engine->proc_pos) * BLE_BP_C_MEAS_MAX_LEN;
+}
+
+
 /**@brief Function for initializing the Connection Parameters module.
+ *
+ * @details The peripheral link uses short connection intervals while stored records are sent, and
+ *          relaxes to the long ones once the link has been quiet for a few seconds.
  */
 static void conn_params_init(void)
 {
-    uint32_t               err_code;
-    ble_conn_params_init_t cp_init;
+    uint32_t                     err_code;
+    ble_conn_params_init_t       cp_init;
+    ble_conn_params_adapt_init_t adapt_init;
+
+    memset(&adapt_init, 0, sizeof(adapt_init));
+
+    adapt_init.p_param_sets        = m_periph_conn_param_sets;
+    adapt_init.param_set_count     = sizeof(m_periph_conn_param_sets) / sizeof(m_periph_conn_param_sets[0]);
+    adapt_init.policy              = NULL;
+    adapt_init.tx_queued_get       = periph_tx_queued_get;
+    adapt_init.burst_packets       = CONN_PARAMS_BURST_PACKETS;
+    adapt_init.sample_period       = CONN_PARAMS_SAMPLE_PERIOD;
+    adapt_init.relax_samples       = CONN_PARAMS_RELAX_SAMPLES;
+    adapt_init.min_update_interval = CONN_PARAMS_MIN_UPDATE_INTERVAL;
+    adapt_init.max_attempts        = CONN_PARAMS_MAX_ATTEMPTS;
 
     memset(&cp_init, 0, sizeof(cp_init));
 
     cp_init.p_conn_params                  = NULL;
     cp_init.first_conn_params_update_delay = FIRST_CONN_PARAMS_UPDATE_DELAY;
-    cp_init.next_conn_params_update_delay  = NEXT_CONN_PARAMS_UPDATE_DELAY;
-    cp_init.max_conn_params_update_count   = MAX_CONN_PARAMS_UPDATE_COUNT;
-    cp_init.start_on_notify_cccd_handle    = m_hrs.hrm_handles.cccd_handle;
     cp_init.disconnect_on_fail             = false;
     cp_init.evt_handler                    = on_conn_params_evt;
     cp_init.error_handler                  = conn_params_error_handler;
+    cp_init.p_adapt                        = &adapt_init;
 
     err_code = ble_conn_params_init(&cp_init);
     APP_ERROR_CHECK(err_code);
@@ -1602,6 +1921,9 @@ int main(void)
     ble_stack_init();
     device_manager_init(erase_bonds);
     db_discovery_init();
+    gattc_queue_init();
+    scan_filter_init();
+    conn_mgr_init();
     //hrs_c_init();
    // rscs_c_init();
 	//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -25,6 +25,7 @@
 #include <string.h>
 
 #include "ble_ans_c.h"
+#include "ble_gattc_queue.h"
 #include "nordic_common.h"
 #include "nrf.h"
 #include "app_error.h"
@@ -472,6 +473,15 @@ static void conn_params_error_handler(uint32_t nrf_error)
 }
 
 
+/**@brief Function for initializing the GATT Client Request Queue module.
+ */
+static void gattc_queue_init(void)
+{
+    uint32_t err_code = ble_gattc_queue_init();
+    APP_ERROR_CHECK(err_code);
+}
+
+
 /**@brief Function for initializing the Connection Parameters module.
  */
 static void conn_params_init(void)
@@ -709,6 +719,7 @@ static void ble_evt_dispatch(ble_evt_t * p_ble_evt)
     dm_ble_evt_handler(p_ble_evt);
     ble_conn_params_on_ble_evt(p_ble_evt);
     ble_ans_c_on_ble_evt(&m_ans_c, p_ble_evt);
+    ble_gattc_queue_on_ble_evt(p_ble_evt);
     bsp_btn_ble_on_ble_evt(p_ble_evt);
     on_ble_evt(p_ble_evt);
     ble_advertising_on_ble_evt(p_ble_evt);
@@ -832,6 +843,7 @@ int main(void)
     buttons_leds_init(&erase_bonds);
     ble_stack_init();
     device_manager_init(erase_bonds);
+    gattc_queue_init();
     gap_params_init();
     advertising_init();
     alert_notification_init(erase_bonds);
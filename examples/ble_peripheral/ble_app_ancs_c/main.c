@@ -32,6 +32,7 @@
 
 #include "ble_ancs_c.h"
 #include "ble_db_discovery.h"
+#include "ble_gattc_queue.h"
 #include "nordic_common.h"
 #include "nrf.h"
 #include "app_error.h"
@@ -678,6 +679,7 @@ static void ble_evt_dispatch(ble_evt_t * p_ble_evt)
     ble_db_discovery_on_ble_evt(&m_ble_db_discovery, p_ble_evt);
     ble_conn_params_on_ble_evt(p_ble_evt);
     ble_ancs_c_on_ble_evt(&m_ancs_c, p_ble_evt);
+    ble_gattc_queue_on_ble_evt(p_ble_evt);
     bsp_btn_ble_on_ble_evt(p_ble_evt);
     on_ble_evt(p_ble_evt);
     ble_advertising_on_ble_evt(p_ble_evt);
@@ -873,6 +875,15 @@ static void scheduler_init(void)
 }
 
 
+/**@brief Function for initializing the GATT Client Request Queue module.
+ */
+static void gattc_queue_init(void)
+{
+    uint32_t err_code = ble_gattc_queue_init();
+    APP_ERROR_CHECK(err_code);
+}
+
+
 /**@brief Function for initializing the database discovery module.
  */
 static void db_discovery_init(void)
@@ -907,6 +918,7 @@ int main(void)
     printf("BLE ANCS\n");
     device_manager_init(erase_bonds);
     db_discovery_init();
+    gattc_queue_init();
     scheduler_init();
     gap_params_init();
     service_init();
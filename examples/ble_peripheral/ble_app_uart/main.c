@@ -66,8 +66,18 @@
 #define UART_TX_BUF_SIZE                256                                         /**< UART TX buffer size. */
 #define UART_RX_BUF_SIZE                256                                         /**< UART RX buffer size. */
 
+#define NUS_TX_BUF_SIZE                 512                                         /**< Size of the ring of bytes to send over BLE. */
+#define NUS_RX_BUF_SIZE                 512                                         /**< Size of the ring of bytes received over BLE. */
+#define NUS_RX_LOW_WATER                (2 * BLE_NUS_MAX_DATA_LEN)                  /**< Free space of the receive ring below which the ring is full. */
+
 static ble_nus_t                        m_nus;                                      /**< Structure to identify the Nordic UART Service. */
+static uint8_t                          m_nus_tx_buf[NUS_TX_BUF_SIZE];              /**< Ring of bytes to send over BLE. */
+static uint8_t                          m_nus_rx_buf[NUS_RX_BUF_SIZE];              /**< Ring of bytes received over BLE. */
 static uint16_t                         m_conn_handle = BLE_CONN_HANDLE_INVALID;    /**< Handle of the current connection. */
+static uint8_t                          m_uart_tx_data[BLE_NUS_MAX_DATA_LEN];       /**< Data read from the receive ring, being passed to the UART. */
+static uint16_t                         m_uart_tx_index;                            /**< Index of the next byte of m_uart_tx_data to pass to the UART. */
+static uint16_t                         m_uart_tx_length;                           /**< Number of bytes in m_uart_tx_data. */
+static uint32_t                         m_uart_fifo_error_count;                    /**< Number of bytes received over the UART and dropped because the UART buffer was full. */
 
 static ble_uuid_t                       m_adv_uuids[] = {{BLE_UUID_NUS_SERVICE, NUS_SERVICE_UUID_TYPE}};  /**< Universally unique service identifier. */
 
@@ -119,27 +129,122 @@ static void gap_params_init(void)
 }
 
 
-/**@brief Function for handling the data from the Nordic UART Service.
- *
- * @details This function will process the data received from the Nordic UART BLE Service and send
- *          it to the UART module.
+/**@brief Function for moving the data received over BLE to the UART.
  *
- * @param[in] p_nus    Nordic UART Service structure.
- * @param[in] p_data   Data to be send to UART module.
- * @param[in] length   Length of the data.
+ * @details Called when data is received over BLE, and when the UART has sent its buffer. Stops when
+ *          the UART buffer is full, the rest stays in the receive ring of the Nordic UART Service.
  */
 /**@snippet [Handling the data received over BLE] */
-static void nus_data_handler(ble_nus_t * p_nus, uint8_t * p_data, uint16_t length)
+static void nus_to_uart_pump(void)
 {
-    for (uint32_t i = 0; i < length; i++)
+    for (;;)
     {
-        while(app_uart_put(p_data[i]) != NRF_SUCCESS);
+        if (m_uart_tx_index == m_uart_tx_length)
+        {
+            m_uart_tx_index  = 0;
+            m_uart_tx_length = sizeof(m_uart_tx_data);
+            if (ble_nus_stream_read(&m_nus, m_uart_tx_data, &m_uart_tx_length) != NRF_SUCCESS)
+            {
+                m_uart_tx_length = 0;
+                return;
+            }
+        }
+
+        if (app_uart_put(m_uart_tx_data[m_uart_tx_index]) != NRF_SUCCESS)
+        {
+            return;
+        }
+        m_uart_tx_index++;
     }
-    while(app_uart_put('\n') != NRF_SUCCESS);
 }
 /**@snippet [Handling the data received over BLE] */
 
 
+/**@brief Function for moving the data received over the UART to BLE.
+ *
+ * @details Called when data is received over the UART, and when the send ring of the Nordic UART
+ *          Service has room again. Stops when the ring is full, the rest stays in the UART buffer.
+ *          Data is dropped while the peer has not enabled notifications.
+ */
+/**@snippet [Handling the data received over UART] */
+static void uart_to_nus_pump(void)
+{
+    static uint8_t  data_array[BLE_NUS_MAX_DATA_LEN];
+    static uint16_t length = 0;
+    uint16_t        written;
+    uint32_t        err_code;
+
+    for (;;)
+    {
+        while ((length < sizeof(data_array)) && (app_uart_get(&data_array[length]) == NRF_SUCCESS))
+        {
+            length++;
+        }
+
+        if (length == 0)
+        {
+            return;
+        }
+
+        if ((m_conn_handle == BLE_CONN_HANDLE_INVALID) || !m_nus.is_notification_enabled)
+        {
+            length = 0;
+            continue;
+        }
+
+        written  = length;
+        err_code = ble_nus_stream_write(&m_nus, data_array, &written);
+        if (err_code != NRF_ERROR_INVALID_STATE)
+        {
+            APP_ERROR_CHECK(err_code);
+        }
+
+        length -= written;
+        memmove(data_array, &data_array[written], length);
+        if (length != 0)
+        {
+            // Resumed on BLE_NUS_EVT_TX_RDY.
+            return;
+        }
+    }
+}
+/**@snippet [Handling the data received over UART] */
+
+
+/**@brief Function for handling the stream events from the Nordic UART Service.
+ *
+ * @param[in] p_nus      Nordic UART Service structure.
+ * @param[in] evt_type   Event type.
+ */
+static void nus_evt_handler(ble_nus_t * p_nus, ble_nus_evt_type_t evt_type)
+{
+    switch (evt_type)
+    {
+        case BLE_NUS_EVT_RX_DATA:
+            nus_to_uart_pump();
+            break;
+
+        case BLE_NUS_EVT_TX_RDY:
+            uart_to_nus_pump();
+            break;
+
+        default:
+            // The UART cannot ask the peer to pause, data that does not fit in the ring is dropped.
+            break;
+    }
+}
+
+
+/**@brief Function for handling errors from the Nordic UART Service.
+ *
+ * @param[in] nrf_error  Error code containing information about what went wrong.
+ */
+static void nus_error_handler(uint32_t nrf_error)
+{
+    APP_ERROR_HANDLER(nrf_error);
+}
+
+
 /**@brief Function for initializing services that will be used by the application.
  */
 static void services_init(void)
@@ -149,7 +254,13 @@ static void services_init(void)
     
     memset(&nus_init, 0, sizeof(nus_init));
 
-    nus_init.data_handler = nus_data_handler;
+    nus_init.evt_handler   = nus_evt_handler;
+    nus_init.error_handler = nus_error_handler;
+    nus_init.p_tx_buf      = m_nus_tx_buf;
+    nus_init.tx_buf_size   = sizeof(m_nus_tx_buf);
+    nus_init.p_rx_buf      = m_nus_rx_buf;
+    nus_init.rx_buf_size   = sizeof(m_nus_rx_buf);
+    nus_init.rx_low_water  = NUS_RX_LOW_WATER;
     
     err_code = ble_nus_init(&m_nus, &nus_init);
     APP_ERROR_CHECK(err_code);
@@ -276,6 +387,10 @@ static void on_ble_evt(ble_evt_t * p_ble_evt)
             err_code = bsp_indication_set(BSP_INDICATE_IDLE);
             APP_ERROR_CHECK(err_code);
             m_conn_handle = BLE_CONN_HANDLE_INVALID;
+
+            // Data of the previous connection not yet passed to the UART is dropped.
+            m_uart_tx_index  = 0;
+            m_uart_tx_length = 0;
             break;
 
         case BLE_GAP_EVT_SEC_PARAMS_REQUEST:
@@ -380,34 +495,21 @@ void bsp_event_handler(bsp_event_t event)
 
 /**@brief   Function for handling app_uart events.
  *
- * @details This function will receive a single character from the app_uart module and append it to 
- *          a string. The string will be be sent over BLE when the last character received was a 
- *          'new line' i.e '\n' (hex 0x0D) or if the string has reached a length of 
- *          @ref NUS_MAX_DATA_LENGTH.
+ * @details This function will pass the characters received from the app_uart module to the
+ *          Nordic UART Service stream, which sends them over BLE in notifications of up to
+ *          @ref BLE_NUS_MAX_DATA_LEN bytes, and pass more data received over BLE to the app_uart
+ *          module when it has sent its buffer.
  */
-/**@snippet [Handling the data received over UART] */
 void uart_event_handle(app_uart_evt_t * p_event)
 {
-    static uint8_t data_array[BLE_NUS_MAX_DATA_LEN];
-    static uint8_t index = 0;
-    uint32_t       err_code;
-
     switch (p_event->evt_type)
     {
         case APP_UART_DATA_READY:
-            UNUSED_VARIABLE(app_uart_get(&data_array[index]));
-            index++;
+            uart_to_nus_pump();
+            break;
 
-            if ((data_array[index - 1] == '\n') || (index >= (BLE_NUS_MAX_DATA_LEN)))
-            {
-                err_code = ble_nus_string_send(&m_nus, data_array, index);
-                if (err_code != NRF_ERROR_INVALID_STATE)
-                {
-                    APP_ERROR_CHECK(err_code);
-                }
-                
-                index = 0;
-            }
+        case APP_UART_TX_EMPTY:
+            nus_to_uart_pump();
             break;
 
         case APP_UART_COMMUNICATION_ERROR:
@@ -415,14 +517,14 @@ void uart_event_handle(app_uart_evt_t * p_event)
             break;
 
         case APP_UART_FIFO_ERROR:
-            APP_ERROR_HANDLER(p_event->data.error_code);
+            // The UART buffer is full and the received byte is dropped, BLE is not keeping up.
+            m_uart_fifo_error_count++;
             break;
 
         default:
             break;
     }
 }
-/**@snippet [Handling the data received over UART] */
 
 
 /**@brief  Function for initializing the UART module.